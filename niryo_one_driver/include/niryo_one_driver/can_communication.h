@@ -22,8 +22,10 @@
 
 #include <boost/shared_ptr.hpp>
 #include <ros/ros.h>
+#include <atomic>
 #include <string>
 #include <thread>
+#include <vector>
 #include <cmath>
 
 #include "niryo_one_driver/stepper_motor_state.h"
@@ -57,6 +59,41 @@
 
 #define CAN_STEPPERS_WRITE_OFFSET_FAIL -3
 
+// auto calibration scheduler
+#define CALIBRATION_TASK_SENSOR 1 // calibration command, finished when CAN_DATA_CALIBRATION_RESULT is received
+#define CALIBRATION_TASK_MOVE   2 // relative move, finished when streamed position is stable
+
+#define CALIBRATION_TASK_PENDING 0
+#define CALIBRATION_TASK_RUNNING 1
+#define CALIBRATION_TASK_DONE    2
+
+#define CALIBRATION_MOVE_STABLE_TIME 0.1 // sec without position change to consider a move finished
+#define CALIBRATION_MOVE_NO_FEEDBACK_MARGIN 0.5 // sec added to the theoretical move time if no position is received
+
+/*
+ * One step of the auto calibration for one motor.
+ * A task starts as soon as all the tasks in 'wait_for' are finished, so that
+ * independent axes are calibrated/moved at the same time.
+ */
+struct CalibrationTask {
+    StepperMotorState* motor;
+    int type;
+    int delay; // delay between steps (micros)
+    int direction; // CALIBRATION_TASK_SENSOR only
+    int steps; // CALIBRATION_TASK_MOVE only
+    std::vector<int> wait_for; // indexes of tasks to wait for
+
+    int status;
+    double time_start;
+    double time_done;
+
+    // move completion detection
+    bool position_received;
+    bool has_moved;
+    int32_t last_position;
+    double time_last_position_change;
+};
+
 class CanCommunication {
 
     public:
@@ -96,10 +133,10 @@ class CanCommunication {
         int autoCalibrationStep2();
         int sendCalibrationCommandForOneMotor(StepperMotorState* motor, int delay_between_steps,
                 int calibration_direction, int calibration_timeout);
-        int getCalibrationResults(std::vector<StepperMotorState*> steppers, int calibration_timeout,
-                std::vector<int> &sensor_offset_ids, std::vector<int> &sensor_offset_steps);
         
         int scanAndCheck();
+        bool hasFaultedMotors();
+        int checkFaultedMotors();
 
         bool canProcessManualCalibration(std::string &result_message);
         void validateMotorsCalibrationFromUserInput(int mode);
@@ -107,6 +144,9 @@ class CanCommunication {
 
         void synchronizeSteppers(bool begin_traj);
 
+        // time (s) of the last position write which changed the command of a motor, 0 if none yet
+        double getLastPositionChangeWriteTime() { return time_last_position_change_write; }
+
     private:
         
         // Niryo One hardware version
@@ -160,6 +200,10 @@ class CanCommunication {
         bool write_micro_steps_enable;
         bool write_max_effort_enable;
 
+        // last position commands sent on the bus (same order as motors), written by the control loop only
+        std::vector<int32_t> last_position_commands_written;
+        std::atomic<double> time_last_position_change_write;
+
         // calibration
         bool waiting_for_user_trigger_calibration;
         int steppers_calibration_mode;
@@ -169,6 +213,13 @@ class CanCommunication {
 
         int relativeMoveMotor(StepperMotorState* motor, int steps, int delay, bool wait);
 
+        int addCalibrationTask(std::vector<CalibrationTask> &tasks, StepperMotorState* motor, int type,
+                int delay, int direction_or_steps, std::vector<int> wait_for);
+        int runCalibrationTasks(std::vector<CalibrationTask> &tasks,
+                std::vector<int> &sensor_offset_ids, std::vector<int> &sensor_offset_steps);
+        int startCalibrationTask(CalibrationTask &task);
+        void printCalibrationTimeline(const std::vector<CalibrationTask> &tasks, double time_begin);
+
         // conversions steps <-> rad angle
         int32_t rad_pos_to_steps(double position_rad, double gear_ratio, double direction);
         double steps_to_rad_pos(int32_t steps, double gear_ratio, double direction);
@@ -50,6 +50,8 @@ class CommunicationBase {
                 std::vector<std::string> &firmware_versions) = 0;
         
         virtual void sendPositionToRobot(const double cmd[6]) = 0;
+        // time (s) at which a changed position command was last written on the bus, 0 if none yet
+        virtual double getLastPositionChangeWriteTime() = 0;
         virtual void activateLearningMode(bool activate) = 0;
         virtual bool setLeds(std::vector<int> &leds, std::string &message) = 0;
 
@@ -0,0 +1,61 @@
+/*
+    connection_recovery.h
+    Copyright (C) 2018 Niryo
+    All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CONNECTION_RECOVERY_H
+#define CONNECTION_RECOVERY_H
+
+#include <string>
+
+/*
+ * Exponential backoff between reconnection attempts on a bus (CAN, Dxl),
+ * and time-to-recover statistics (from fault detection to resumed control)
+ */
+class ConnectionRecovery {
+
+    public:
+
+        ConnectionRecovery(const std::string &bus_name, double min_delay, double max_delay);
+
+        void start(); // call when the fault is detected
+        bool isInProgress();
+        double getNextDelay(); // delay to wait before next attempt, doubled at each call
+        void finish(); // call when control is resumed
+
+        int getRecoveryCount()       { return recovery_count; }
+        double getLastTimeToRecover() { return last_time_to_recover; }
+        double getMaxTimeToRecover()  { return max_time_to_recover; }
+
+    private:
+
+        std::string bus_name;
+        double min_delay;
+        double max_delay;
+
+        bool in_progress;
+        double time_fault_detected;
+        double current_delay;
+        int attempt_counter;
+
+        int recovery_count;
+        double last_time_to_recover;
+        double max_time_to_recover;
+        double total_time_to_recover;
+};
+
+#endif
@@ -108,6 +108,9 @@ class DxlCommunication {
         int scanAndCheck();
         int detectVersion();
 
+        bool isDegraded();
+        int pingFaultedMotors();
+
         void moveAllMotorsToHomePosition();
         void addCustomDxlCommand(int motor_type, uint8_t id, uint32_t value,
                 uint32_t reg_address, uint32_t byte_number);
@@ -150,6 +153,10 @@ class DxlCommunication {
         void hardwareControlRead();
         void hardwareControlWrite();
 
+        void isolateFaultedMotors(std::vector<DxlMotorState*> &xl320_motor_list,
+                std::vector<DxlMotorState*> &xl430_motor_list);
+        void updateDegradedModeMessage();
+
         void resetHardwareControlLoopRates();
 
         boost::shared_ptr<std::thread> hardware_control_loop_thread;
@@ -59,6 +59,7 @@ class DxlMotorState {
             this->type = type;
             this->init_position = init_position;
             is_enabled = false;
+            is_faulted = false;
 
             resetState();
             resetCommand();
@@ -87,6 +88,8 @@ class DxlMotorState {
         void enable()                { is_enabled = true; }
         void disable()               { is_enabled = false; }
         bool isEnabled()             { return is_enabled; }
+        bool isFaulted()             { return is_faulted; }
+        void setFaulted(bool f)      { is_faulted = f; }
         
         // getters - state
         uint32_t getPositionState()      { return state_pos; }
@@ -122,6 +125,7 @@ class DxlMotorState {
         uint8_t id;
         int type;
         bool is_enabled;
+        bool is_faulted; // motor does not answer anymore, excluded from sync read/write
         uint32_t init_position;
 
         // read variables
@@ -54,6 +54,7 @@ class FakeCommunication : public CommunicationBase {
                 std::vector<std::string> &firmware_versions);
         
         void sendPositionToRobot(const double cmd[6]); 
+        double getLastPositionChangeWriteTime();
         void activateLearningMode(bool activate);
         bool setLeds(std::vector<int> &leds, std::string &message);
         
@@ -83,6 +84,7 @@ class FakeCommunication : public CommunicationBase {
         int hardware_version;
         
         double echo_pos[6]; // just store cmd in this array, and echo position
+        double time_last_position_change_write; // echo_pos is the fake bus
 
 };
 
@@ -29,6 +29,7 @@
 #include "niryo_one_driver/can_communication.h"
 
 #include "niryo_one_driver/communication_base.h"
+#include "niryo_one_driver/connection_recovery.h"
 
 #include "niryo_one_driver/change_hardware_version.h"
 
@@ -58,6 +59,7 @@ class NiryoOneCommunication : public CommunicationBase {
                 std::vector<std::string> &firmware_versions);
         
         void sendPositionToRobot(const double cmd[6]); 
+        double getLastPositionChangeWriteTime();
         void activateLearningMode(bool activate);
         bool setLeds(std::vector<int> &leds, std::string &message);
         
@@ -107,6 +109,10 @@ class NiryoOneCommunication : public CommunicationBase {
 
         bool scanAndCheckMotors();
 
+        // reconnection backoff + time to recover
+        boost::shared_ptr<ConnectionRecovery> can_recovery;
+        boost::shared_ptr<ConnectionRecovery> dxl_recovery;
+
         // used when can or dxl is disabled
         double pos_can_disabled_v1[4] = { 0.0, 0.628, -1.4, 0.0 };
         double pos_dxl_disabled_v1[2] = { 0.0, 0.0 };
@@ -0,0 +1,93 @@
+/*
+    niryo_one_driver.h
+    Copyright (C) 2017 Niryo
+    All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef NIRYO_ONE_DRIVER_H
+#define NIRYO_ONE_DRIVER_H
+
+#include <boost/shared_ptr.hpp>
+#include <controller_manager/controller_manager.h>
+#include <realtime_tools/realtime_publisher.h>
+#include <ros/ros.h>
+#include <thread>
+
+#include "niryo_one_driver/niryo_one_hardware_interface.h"
+#include "niryo_one_driver/communication_base.h"
+#include "niryo_one_driver/ros_interface.h"
+#include "niryo_one_driver/rpi_diagnostics.h"
+
+#include "control_msgs/FollowJointTrajectoryActionResult.h"
+#include "std_msgs/Empty.h"
+#include "std_msgs/Time.h"
+
+/*
+ * Owns the hardware communication, the ros_control loop and the ROS interface.
+ *
+ * Used both by the standalone niryo_one_driver node and by the driver nodelet,
+ * which is why all ROS handles are given by the caller.
+ *
+ * With ~publish_bus_writes, the time of each bus write which changes the position
+ * command is published on /niryo_one/bus_write, to measure the end-to-end latency of
+ * the clients (ex : orthopus_space_control input_latency_benchmark).
+ */
+class NiryoOneDriver {
+
+    public:
+
+        NiryoOneDriver(ros::NodeHandle &nh, ros::NodeHandle &nh_private);
+        ~NiryoOneDriver();
+
+        void rosControlLoop();
+
+        void callbackTrajectoryGoal(const std_msgs::Empty& msg);
+        void callbackTrajectoryResult(const control_msgs::FollowJointTrajectoryActionResult& msg);
+
+    private:
+
+        void publishBusWrite();
+
+        int hardware_version;
+
+        boost::shared_ptr<CommunicationBase> comm;
+
+        boost::shared_ptr<NiryoOneHardwareInterface> robot;
+        boost::shared_ptr<controller_manager::ControllerManager> cm;
+
+        boost::shared_ptr<RosInterface> ros_interface;
+
+        boost::shared_ptr<RpiDiagnostics> rpi_diagnostics;
+
+        boost::shared_ptr<ros::Rate> ros_control_loop_rate;
+
+        boost::shared_ptr<std::thread> ros_control_thread;
+
+        ros::NodeHandle nh_;
+        ros::NodeHandle nh_private_;
+
+        bool flag_reset_controllers;
+        bool ros_control_loop_running;
+
+        ros::Subscriber reset_controller_subscriber; // workaround to compensate missed steps
+        ros::Subscriber trajectory_result_subscriber;
+
+        boost::shared_ptr<realtime_tools::RealtimePublisher<std_msgs::Time>> bus_write_publisher;
+        double last_published_bus_write;
+
+};
+
+#endif
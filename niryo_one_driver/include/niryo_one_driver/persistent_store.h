@@ -0,0 +1,85 @@
+/*
+    persistent_store.h
+    Copyright (C) 2018 Niryo
+    All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PERSISTENT_STORE_H
+#define PERSISTENT_STORE_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#define PERSISTENT_STORE_MAGIC   0x53504f4e // "NOPS" (Niryo One Persistent Store)
+#define PERSISTENT_STORE_VERSION 1
+
+// sections of the store, a section groups values of the same kind (key = motor id, ...)
+#define PERSISTENT_STORE_SECTION_STEPPER_CALIBRATION_OFFSET 1
+
+/*
+ * Per-robot persistent values (calibration offsets, ...), saved in a binary file
+ *
+ * File layout (little endian, as written by the Raspberry Pi) :
+ *  - header  : magic (u32), version (u16), entry count (u16), crc32 of entries (u32)
+ *  - entries : fixed-size records { section (u16), id (u16), value (i32) }
+ *
+ * The file is memory-mapped and checked (magic, version, size, crc) on load. It is written
+ * to a temporary file, synced and then renamed over the previous one, so that a crash during
+ * a write never leaves a partial file. The previous file is kept as <file>.bak and used
+ * if the main file is missing or corrupted.
+ */
+class PersistentStore {
+
+    public:
+
+        struct Entry {
+            uint16_t section;
+            uint16_t id;
+            int32_t value;
+        };
+
+        PersistentStore(const std::string &file_name);
+
+        bool load();
+        bool save();
+
+        bool getValue(uint16_t section, uint16_t id, int32_t &value) const;
+        void setValue(uint16_t section, uint16_t id, int32_t value);
+        void clearSection(uint16_t section);
+        void getSection(uint16_t section, std::vector<int> &id_list, std::vector<int> &value_list) const;
+
+        const std::string& getFileName() const;
+
+    private:
+
+        struct Header {
+            uint32_t magic;
+            uint16_t version;
+            uint16_t entry_count;
+            uint32_t crc;
+        };
+
+        std::string file_name;
+        std::vector<Entry> entries;
+
+        bool loadFile(const std::string &path);
+        bool writeFile(const std::string &path);
+
+        static uint32_t computeCrc32(const unsigned char *data, size_t length);
+};
+
+#endif
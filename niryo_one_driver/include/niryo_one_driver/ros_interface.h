@@ -23,6 +23,9 @@
 #include <boost/shared_ptr.hpp>
 #include <vector>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 
 #include <ros/ros.h>
 
@@ -52,6 +55,7 @@ class RosInterface {
 
         RosInterface(CommunicationBase* niryo_one_comm, RpiDiagnostics* rpi_diagnostics,
                 bool *flag_reset_controllers, bool learning_mode_on, int hardware_version);
+        ~RosInterface();
 
         void startServiceServers();
         void startPublishers();
@@ -75,19 +79,36 @@ class RosInterface {
         // publishers
 
         ros::Publisher hardware_status_publisher;
-        boost::shared_ptr<std::thread> publish_hardware_status_thread;
-
         ros::Publisher software_version_publisher;
-        boost::shared_ptr<std::thread> publish_software_version_thread;
-
         ros::Publisher learning_mode_publisher;
-        boost::shared_ptr<std::thread> publish_learning_mode_thread;
+
+        // status publishing : one thread, publish on change, or at keep-alive rate
+        
+        boost::shared_ptr<std::thread> publish_status_thread;
+        bool publish_status_loop_running;
+        std::mutex status_mutex;
+        std::condition_variable status_condition;
+        bool status_changed;
+
+        niryo_one_msgs::HardwareStatus hardware_status_msg; // last published values
+        niryo_one_msgs::SoftwareVersion software_version_msg;
+        bool learning_mode_published;
+
+        // reused between checks, to avoid allocations
+        std::vector<std::string> motor_names;
+        std::vector<std::string> motor_types;
+        std::vector<int32_t> temperatures;
+        std::vector<double> voltages;
+        std::vector<int32_t> hw_errors;
+        std::vector<std::string> firmware_motor_names;
+        std::vector<std::string> firmware_versions;
 
         // publish methods
         
-        void publishHardwareStatus();
-        void publishSoftwareVersion();
-        void publishLearningMode();
+        void publishStatusLoop();
+        void notifyStatusChanged();
+        bool updateHardwareStatus();
+        bool updateSoftwareVersion();
         
         // services
 
@@ -35,6 +35,7 @@ class StepperMotorState {
             this->offset_position = offset_position;
             
             is_enabled = false;
+            is_faulted = false;
             
             cmd_micro_steps = micro_steps;
             cmd_max_effort = max_effort;
@@ -69,6 +70,7 @@ class StepperMotorState {
         double getDirection()           { return direction; }
         std::string getName()           { return name; }
         bool isEnabled()                { return is_enabled; }
+        bool isFaulted()                { return is_faulted; }
         double getLastTimeRead()        { return time_last_read; }
         int getHwFailCounter()          { return hw_fail_counter; }
         int32_t getHomePosition()       { return home_position; }
@@ -79,6 +81,7 @@ class StepperMotorState {
         void setDirection(double dir)   { direction = dir; } 
         void enable()                   { is_enabled = true; }
         void disable()                  { is_enabled = false; }
+        void setFaulted(bool f)         { is_faulted = f; }
         void setLastTimeRead(double t)  { time_last_read = t; }
         void setHwFailCounter(int c)    { hw_fail_counter = c; }
 
@@ -120,6 +123,7 @@ class StepperMotorState {
         int32_t home_position;
         double direction; 
         bool is_enabled;
+        bool is_faulted; // motor stopped answering, waiting for it to come back
         
         double time_last_read; // used for ping purpose
         int hw_fail_counter; // keeps consecutive ping failures
@@ -0,0 +1,130 @@
+/*
+    streaming_joint_position_controller.h
+    Copyright (C) 2018 Niryo
+    All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef STREAMING_JOINT_POSITION_CONTROLLER_H
+#define STREAMING_JOINT_POSITION_CONTROLLER_H
+
+#include <boost/shared_ptr.hpp>
+#include <controller_interface/controller.h>
+#include <hardware_interface/joint_command_interface.h>
+#include <realtime_tools/realtime_publisher.h>
+#include <ros/ros.h>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "sensor_msgs/JointState.h"
+#include "niryo_one_msgs/JointStreamingStatus.h"
+
+namespace niryo_one_driver {
+
+/*
+ * Fixed capacity FIFO of timestamped joint setpoints (no allocation after init)
+ * When full, the oldest setpoint is overwritten.
+ */
+class SetpointQueue {
+
+    public:
+
+        void init(int capacity, int joint_number);
+
+        bool empty() const { return count == 0; }
+        bool full() const  { return count == (int)stamps.size(); }
+        int size() const   { return count; }
+
+        const ros::Time& frontStamp() const { return stamps[head]; }
+        const std::vector<double>& frontPositions() const { return positions[head]; }
+        const ros::Time& backStamp() const { return stamps[(head + count - 1) % stamps.size()]; }
+
+        // return false if the oldest setpoint was overwritten
+        bool push(const ros::Time &stamp, const std::vector<double> &position);
+        void pop();
+        void clear() { head = 0; count = 0; }
+
+    private:
+
+        std::vector<ros::Time> stamps;
+        std::vector<std::vector<double>> positions;
+        int head;
+        int count;
+};
+
+/*
+ * Position controller fed with a stream of timestamped setpoints, for clients which compute a new joint
+ * position at each cycle (ex : orthopus cartesian controller). Unlike a one-point trajectory sent to the
+ * JointTrajectoryController, a setpoint does not replace a spline : it is queued, and the command is linearly
+ * interpolated between consecutive setpoints at the hardware loop rate.
+ *
+ * Setpoints are received on ~command (sensor_msgs/JointState). The header stamp is the time at which the
+ * position must be reached. Joint names are optional (controller joint order is used if empty).
+ *
+ * The command is interpolated at (time - ~interpolation_delay), so that jitter on the client side is absorbed
+ * by the delay. Statistics are published on ~status :
+ *  - late samples : setpoints received after their stamp (at the interpolation time). The latest one is still
+ *    reached within a control period, older ones are dropped.
+ *  - dropped samples : setpoints overwritten in a full queue, or out of order
+ *  - underruns : the queue ran dry and the last setpoint was held before the next one arrived (not counted
+ *    when the stream was stopped for more than ~stream_timeout)
+ */
+class StreamingJointPositionController
+    : public controller_interface::Controller<hardware_interface::PositionJointInterface> {
+
+    public:
+
+        bool init(hardware_interface::PositionJointInterface *hw, ros::NodeHandle &nh);
+        void starting(const ros::Time &time);
+        void update(const ros::Time &time, const ros::Duration &period);
+
+    private:
+
+        void callbackCommand(const sensor_msgs::JointStateConstPtr &msg);
+        void publishStatus(const ros::Time &time);
+
+        std::vector<hardware_interface::JointHandle> joints;
+        std::vector<std::string> joint_names;
+        int joint_number;
+
+        double interpolation_delay;
+        double stream_timeout;
+        double status_publish_period;
+
+        // filled by the subscriber thread, emptied by the control loop
+        std::mutex incoming_mutex;
+        SetpointQueue incoming;
+        std::vector<double> incoming_buffer;
+        uint64_t dropped_incoming_samples;
+
+        // control loop only
+        SetpointQueue setpoints;
+        std::vector<double> previous_position; // last setpoint reached (or hold position)
+        ros::Time previous_stamp;
+        ros::Time last_sample_time;
+        ros::Time last_status_time;
+        uint64_t received_samples;
+        uint64_t late_samples;
+        uint64_t dropped_samples;
+        uint64_t underruns;
+
+        ros::Subscriber command_subscriber;
+        boost::shared_ptr<realtime_tools::RealtimePublisher<niryo_one_msgs::JointStreamingStatus>> status_publisher;
+};
+
+} // namespace niryo_one_driver
+
+#endif
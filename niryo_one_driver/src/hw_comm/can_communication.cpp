@@ -31,7 +31,7 @@ double CanCommunication::steps_to_rad_pos(int32_t steps, double gear_ratio, doub
 
 CanCommunication::CanCommunication()
 {
-
+    time_last_position_change_write = 0.0;
 }
 
 int CanCommunication::init(int hardware_version)
@@ -154,6 +154,10 @@ int CanCommunication::init(int hardware_version)
     if (hardware_version == 1) {
         motors.push_back(&m4);
     }
+    last_position_commands_written.resize(motors.size());
+    for (int i = 0 ; i < motors.size(); i++) {
+        last_position_commands_written.at(i) = motors.at(i)->getPositionCommand();
+    }
 
     // set hw control init state
     torque_on = 0;
@@ -394,14 +398,23 @@ void CanCommunication::hardwareControlWrite()
 
         // write position
         if (write_position_enable) {
+            bool position_command_changed = false;
             
             for (int i = 0 ; i < motors.size(); i++) {
                 if (motors.at(i)->isEnabled()) {
-                    if (can->sendPositionCommand(motors.at(i)->getId(), motors.at(i)->getPositionCommand()) != CAN_OK) {
+                    int32_t position_command = motors.at(i)->getPositionCommand();
+                    if (can->sendPositionCommand(motors.at(i)->getId(), position_command) != CAN_OK) {
                         //ROS_ERROR("Failed to send position");
                     }
+                    position_command_changed |= (position_command != last_position_commands_written.at(i));
+                    last_position_commands_written.at(i) = position_command;
                 }
             }
+
+            // end of the write of a new command (measured by latency benchmarks, see NiryoOneDriver)
+            if (position_command_changed) {
+                time_last_position_change_write = ros::Time::now().toSec();
+            }
         }
        
         // write micro steps
@@ -462,16 +475,18 @@ void CanCommunication::hardwareControlCheckConnection()
         double timeout_read = 1.0/hw_check_connection_frequency;
         int max_fail_counter = (int) (hw_check_connection_frequency + 0.5); // connection error will be detected after 1 sec
 
+        std::string faulted_motors_names;
+
         for (int i = 0; i < motors.size(); i++) {
             if (motors.at(i)->isEnabled()) {
                 if (time_now - motors.at(i)->getLastTimeRead() > timeout_read * (motors.at(i)->getHwFailCounter() + 1)) {
                     ROS_ERROR("CAN connection problem with motor %d, hw fail counter : %d", motors.at(i)->getId(), motors.at(i)->getHwFailCounter());
                     if (motors.at(i)->getHwFailCounter() >= max_fail_counter) {
-                        is_can_connection_ok = false;
-                        debug_error_message = "Connection problem with CAN bus. Motor ";
-                        debug_error_message += motors.at(i)->getName();
-                        debug_error_message += " is not connected";
-                        return;
+                        // keep checking other motors, so that only missing ones are waited for (see checkFaultedMotors())
+                        motors.at(i)->setFaulted(true);
+                        faulted_motors_names += (faulted_motors_names.empty()) ? "" : ", ";
+                        faulted_motors_names += motors.at(i)->getName();
+                        continue;
                     }
 
                     // reset MCP_2515
@@ -484,9 +499,52 @@ void CanCommunication::hardwareControlCheckConnection()
                 }
             }
         }        
+
+        if (!faulted_motors_names.empty()) {
+            is_can_connection_ok = false;
+            debug_error_message = "Connection problem with CAN bus. Motor(s) ";
+            debug_error_message += faulted_motors_names;
+            debug_error_message += " not connected";
+        }
     }
 }
 
+bool CanCommunication::hasFaultedMotors()
+{
+    for (int i = 0; i < motors.size(); i++) {
+        if (motors.at(i)->isEnabled() && motors.at(i)->isFaulted()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Check only the motors which stopped answering, without a full bus scan
+ * The hardware control loop must be running (limited mode), as it updates the last read time of each motor
+ */
+int CanCommunication::checkFaultedMotors()
+{
+    double time_now = ros::Time::now().toSec();
+    double timeout_read = 1.0/hw_check_connection_frequency;
+    bool all_motors_ok = true;
+
+    for (int i = 0; i < motors.size(); i++) {
+        if (motors.at(i)->isEnabled() && motors.at(i)->isFaulted()) {
+            if (time_now - motors.at(i)->getLastTimeRead() < timeout_read) {
+                ROS_INFO("CAN motor %d is answering again", motors.at(i)->getId());
+                motors.at(i)->setFaulted(false);
+                motors.at(i)->setHwFailCounter(0);
+            }
+            else {
+                all_motors_ok = false;
+            }
+        }
+    }
+
+    return (all_motors_ok) ? CAN_SCAN_OK : CAN_SCAN_TIMEOUT;
+}
+
 void CanCommunication::hardwareControlLoop()
 {
     ros::Rate hw_control_loop_rate = ros::Rate(hw_control_loop_frequency); 
@@ -719,114 +777,6 @@ int CanCommunication::sendCalibrationCommandForOneMotor(StepperMotorState* motor
     return CAN_OK;
 }
 
-int CanCommunication::getCalibrationResults(std::vector<StepperMotorState*> steppers, int calibr_timeout,
-        std::vector<int> &sensor_offset_ids, std::vector<int> &sensor_offset_steps)
-{
-    std::vector<int> motors_ids;
-    std::vector<bool> calibration_results;
-
-    for (int i = 0 ; i < steppers.size() ; i++) {
-        if (steppers.at(i)->isEnabled()) {
-            motors_ids.push_back(steppers.at(i)->getId());
-            calibration_results.push_back(false);
-        }
-    }
-
-    double time_begin_calibration = ros::Time::now().toSec();
-    double timeout = time_begin_calibration + (double)calibr_timeout;
-    ROS_INFO("Waiting for motor calibration");
-    //ROS_INFO("Waiting for motor %d calibration response...", motor->getId());
-    
-    while (ros::Time::now().toSec() < timeout) {
-        ros::Duration(0.0005).sleep(); // check at 2000 Hz
-
-        // check if success
-        bool success = true;
-        for (int i = 0 ; i < calibration_results.size() ; i++) {
-            if (calibration_results.at(i) == false) {
-                success = false;
-            }
-        }
-        if (success) {
-            return CAN_STEPPERS_CALIBRATION_OK;
-        }
-
-        if (can->canReadData()) {
-            long unsigned int rxId;
-            unsigned char len;
-            unsigned char rxBuf[8];
-            
-            can->readMsgBuf(&rxId, &len, rxBuf);
-            
-            // 1. Get motor id
-            int motor_id = rxId & 0x00F; // 0x101 for id 1, 0x102 for id 2, ...
-
-            // 2. Check if motor id is in array
-            for (int i = 0 ; i < motors_ids.size() ; i++) {
-                if (motors_ids.at(i) == motor_id) {
-                    if (len == 2) {
-                        // 3. Check control byte
-                        int control_byte = rxBuf[0];
-
-                        if (control_byte == CAN_DATA_CALIBRATION_RESULT) { // only check this frame
-                            int result = rxBuf[1];
-                            
-                            if (result == CAN_STEPPERS_CALIBRATION_TIMEOUT) {
-                                ROS_ERROR("Motor %d had calibration timeout", motor_id);
-                                return result;
-                            }
-                            else if (result == CAN_STEPPERS_CALIBRATION_BAD_PARAM) {
-                                ROS_ERROR("Bad params given to motor %d", motor_id);
-                                return result;
-                            }
-                            else if (result == CAN_STEPPERS_CALIBRATION_OK) {
-                                ROS_INFO("Motor %d calibration OK", motor_id);
-                                calibration_results.at(i) = true;
-                            }
-                        }
-                    }
-                    else if (len == 4) { // new firmware version -> get result + absolute sensor steps at offset position
-                        // 3. Check control byte
-                        int control_byte = rxBuf[0];
-                        
-                        if (control_byte == CAN_DATA_CALIBRATION_RESULT) { // only check this frame
-                            int result = rxBuf[1];
-                            
-                            if (result == CAN_STEPPERS_CALIBRATION_TIMEOUT) {
-                                ROS_ERROR("Motor %d had calibration timeout", motor_id);
-                                return result;
-                            }
-                            else if (result == CAN_STEPPERS_CALIBRATION_BAD_PARAM) {
-                                ROS_ERROR("Bad params given to motor %d", motor_id);
-                                return result;
-                            }
-                            else if (result == CAN_STEPPERS_CALIBRATION_OK) {
-                                ROS_INFO("Motor %d - Calibration OK", motor_id);
-                                int steps_at_offset_pos = (rxBuf[2] << 8) + rxBuf[3];
-                                ROS_INFO("Motor %d - Absolute steps at offset position : %d", motor_id, steps_at_offset_pos);
-                                sensor_offset_ids.push_back(motor_id);
-                                sensor_offset_steps.push_back(steps_at_offset_pos);
-                                calibration_results.at(i) = true;
-                                
-                                // keep torque ON for axis 2 
-                                // (if torsion spring is too strong the axis might move too much for the following calibration steps)
-                                if (motor_id == m2.getId()) {
-                                    can->sendTorqueOnCommand(m2.getId(), true);
-                                }
-                                // keep torque ON for axis 1
-                                if (motor_id == m1.getId()) {
-                                    can->sendTorqueOnCommand(m1.getId(), true);
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-    return CAN_STEPPERS_CALIBRATION_TIMEOUT; 
-}
-
 /*
  * To use only during calibration phase, or for debug purposes
  * - Move motor from whatever current position to current_steps + steps
@@ -847,7 +797,7 @@ int CanCommunication::relativeMoveMotor(StepperMotorState* motor, int steps, int
         return CAN_FAIL;
     }
     if (wait) {
-        ros::Duration(steps*delay/1000000 + 0.5).sleep(); // wait for 0.5 sec more to finish
+        ros::Duration((double)abs(steps) * delay / 1000000.0 + 0.5).sleep(); // wait for 0.5 sec more to finish
     }
 
     return CAN_OK;
@@ -863,7 +813,11 @@ int CanCommunication::autoCalibrationStep1()
     }
 
     // 1. Move axis 3 up
-    if (relativeMoveMotor(&m3, rad_pos_to_steps(0.5, m3.getGearRatio(), m3.getDirection()), 1500, true) != CAN_OK) {
+    std::vector<CalibrationTask> tasks;
+    std::vector<int> sensor_offset_ids;
+    std::vector<int> sensor_offset_steps;
+    addCalibrationTask(tasks, &m3, CALIBRATION_TASK_MOVE, 1500, rad_pos_to_steps(0.5, m3.getGearRatio(), m3.getDirection()), {});
+    if (runCalibrationTasks(tasks, sensor_offset_ids, sensor_offset_steps) != CAN_STEPPERS_CALIBRATION_OK) {
         return CAN_STEPPERS_CALIBRATION_FAIL; 
     }
    
@@ -872,87 +826,279 @@ int CanCommunication::autoCalibrationStep1()
 
 int CanCommunication::autoCalibrationStep2()
 {
-    int result;
     std::vector<int> sensor_offset_ids;
     std::vector<int> sensor_offset_steps; // absolute steps at offset position
 
-    // 2. Send calibration cmd 1 + 2 + 4 (+3 if hw version == 2)
-    if (sendCalibrationCommandForOneMotor(&m1, 800, 1, calibration_timeout) != CAN_OK) {
-        return CAN_STEPPERS_CALIBRATION_FAIL;
-    }
+    // Axes are scheduled by dependencies instead of fixed sleeps : a task starts as soon as
+    // the tasks it depends on are finished, so the total time is given by the longest chain.
+    std::vector<CalibrationTask> tasks;
 
-    if (sendCalibrationCommandForOneMotor(&m2, 1100, 1, calibration_timeout) != CAN_OK) {
-        return CAN_STEPPERS_CALIBRATION_FAIL;
+    // 2. Calibration cmd 1 + 2 + 4 (+3 if hw version == 2)
+    int cal_m1 = addCalibrationTask(tasks, &m1, CALIBRATION_TASK_SENSOR, 800, 1, {});
+    int cal_m2 = addCalibrationTask(tasks, &m2, CALIBRATION_TASK_SENSOR, 1100, 1, {});
+    int cal_m4 = addCalibrationTask(tasks, &m4, CALIBRATION_TASK_SENSOR, 800, 1, {});
+    if (hardware_version == 2) {
+        addCalibrationTask(tasks, &m3, CALIBRATION_TASK_SENSOR, 1100, -1, {});
     }
 
-    if (sendCalibrationCommandForOneMotor(&m4, 800, 1, calibration_timeout) != CAN_OK) {
-        return CAN_STEPPERS_CALIBRATION_FAIL;
+    // 3. Move motor 1,2,4 to 0.0
+    // axis 1 only rotates when axis 1 and 2 are calibrated, axis 4 is independent
+    int move_m1 = addCalibrationTask(tasks, &m1, CALIBRATION_TASK_MOVE, 1300, -m1.getOffsetPosition(), { cal_m1, cal_m2 });
+    int move_m4 = addCalibrationTask(tasks, &m4, CALIBRATION_TASK_MOVE, 1500, -m4.getOffsetPosition(), { cal_m4 });
+
+    if (hardware_version == 1) {
+        addCalibrationTask(tasks, &m2, CALIBRATION_TASK_MOVE, 3000, -m2.getOffsetPosition(), { cal_m1, cal_m2 });
+    }
+    else if (hardware_version == 2) {
+        // 3.1 Move axis 2 to home position after axis 1
+        // --> in case a gripper is attached, so it won't collide with the base while moving
+        addCalibrationTask(tasks, &m2, CALIBRATION_TASK_MOVE, 3000, -m2.getOffsetPosition(), { move_m1 });
     }
     
-    if (hardware_version == 2) {
-        if (sendCalibrationCommandForOneMotor(&m3, 1100, -1, calibration_timeout) != CAN_OK) {
-            return CAN_STEPPERS_CALIBRATION_FAIL;
-        }
+    // 4. Calibration cmd m3 (only for hw version 1), when axis 4 is at home position
+    if (hardware_version == 1) {
+        addCalibrationTask(tasks, &m3, CALIBRATION_TASK_SENSOR, 1100, -1, { cal_m1, cal_m2, move_m4 });
     }
 
-    // 2.1 Wait calibration result
-    std::vector<StepperMotorState*> steppers = { &m1, &m2, &m4 };
-    if (hardware_version == 2) {
-        steppers.push_back(&m3);
-    }
-    if (getCalibrationResults(steppers, calibration_timeout, sensor_offset_ids, sensor_offset_steps) != CAN_STEPPERS_CALIBRATION_OK) {
+    // 5. Run all tasks and wait for every motor to be calibrated and stopped
+    if (runCalibrationTasks(tasks, sensor_offset_ids, sensor_offset_steps) != CAN_STEPPERS_CALIBRATION_OK) {
         return CAN_STEPPERS_CALIBRATION_FAIL;
     }
 
-    // 3. Move motor 1,2,4 to 0.0
-    int delay_micros = 2000;
-    if (relativeMoveMotor(&m1, -m1.getOffsetPosition(), 1300, false) != CAN_OK) {
-        return CAN_STEPPERS_CALIBRATION_FAIL;
-    }
-    if (hardware_version == 1) {
-        if (relativeMoveMotor(&m2, -m2.getOffsetPosition(), 3000, false) != CAN_OK) {
-            return CAN_STEPPERS_CALIBRATION_FAIL;
-        }
-    }
-    if (relativeMoveMotor(&m4, -m4.getOffsetPosition(), 1500, false) != CAN_OK) {
-        return CAN_STEPPERS_CALIBRATION_FAIL;
+    // 6. Write sensor_offset_steps to file
+    set_motors_calibration_offsets(sensor_offset_ids, sensor_offset_steps);
+
+    return CAN_STEPPERS_CALIBRATION_OK;
+}
+
+/*
+ * Add a task to the calibration schedule, returns task index (to be used in 'wait_for')
+ * - CALIBRATION_TASK_SENSOR : direction_or_steps is the calibration direction
+ * - CALIBRATION_TASK_MOVE : direction_or_steps is the relative move in steps
+ */
+int CanCommunication::addCalibrationTask(std::vector<CalibrationTask> &tasks, StepperMotorState* motor, int type,
+        int delay, int direction_or_steps, std::vector<int> wait_for)
+{
+    CalibrationTask task;
+    task.motor = motor;
+    task.type = type;
+    task.delay = delay;
+    task.direction = (type == CALIBRATION_TASK_SENSOR) ? direction_or_steps : 0;
+    task.steps = (type == CALIBRATION_TASK_MOVE) ? direction_or_steps : 0;
+    task.wait_for = wait_for;
+    task.status = CALIBRATION_TASK_PENDING;
+    task.time_start = 0.0;
+    task.time_done = 0.0;
+    task.position_received = false;
+    task.has_moved = false;
+    task.last_position = 0;
+    task.time_last_position_change = 0.0;
+
+    tasks.push_back(task);
+    return tasks.size() - 1;
+}
+
+int CanCommunication::startCalibrationTask(CalibrationTask &task)
+{
+    double now = ros::Time::now().toSec();
+    task.time_start = now;
+    task.time_last_position_change = now;
+
+    // disabled motors are considered as calibrated and at home position
+    if (!task.motor->isEnabled()) {
+        task.status = CALIBRATION_TASK_DONE;
+        task.time_done = now;
+        return CAN_OK;
     }
-    
-    // 3.1 Wait for motors to finish moving (at least m4, so we can start m3 calibration)
-    // For hw version 2, just wait for m1 to be at home position
-    if (hardware_version == 1) {
-        ros::Duration(abs(m4.getOffsetPosition()) * 1500 / 1000000).sleep();
+
+    int result = CAN_OK;
+    if (task.type == CALIBRATION_TASK_SENSOR) {
+        result = sendCalibrationCommandForOneMotor(task.motor, task.delay, task.direction, calibration_timeout);
     }
-    else if (hardware_version == 2) {
-        ros::Duration(abs(m1.getOffsetPosition()) * 1300 / 1000000).sleep();
+    else if (task.type == CALIBRATION_TASK_MOVE) {
+        result = relativeMoveMotor(task.motor, task.steps, task.delay, false);
     }
-    
-    // 3.2 Move axis 2 to home position after axis 1
-    // --> in case a gripper is attached, so it won't collide with the base while moving
-    if (hardware_version == 2) {
-        if (relativeMoveMotor(&m2, -m2.getOffsetPosition(), 3000, false) != CAN_OK) {
-            return CAN_STEPPERS_CALIBRATION_FAIL;
+
+    task.status = CALIBRATION_TASK_RUNNING;
+    return result;
+}
+
+/*
+ * Run calibration tasks, following their dependencies
+ * - sensor tasks are finished when a CAN_DATA_CALIBRATION_RESULT frame is received
+ * - move tasks are finished when the position streamed by the motor stops changing.
+ *   If the motor does not send its position, the theoretical move time is used instead.
+ */
+int CanCommunication::runCalibrationTasks(std::vector<CalibrationTask> &tasks,
+        std::vector<int> &sensor_offset_ids, std::vector<int> &sensor_offset_steps)
+{
+    double time_begin = ros::Time::now().toSec();
+    ROS_INFO("Waiting for motor calibration");
+
+    while (ros::ok()) {
+        double now = ros::Time::now().toSec();
+
+        // 1. Start tasks whose dependencies are finished, and check if all tasks are done
+        bool all_tasks_done = true;
+        for (int i = 0 ; i < tasks.size() ; i++) {
+            CalibrationTask &task = tasks.at(i);
+
+            if (task.status == CALIBRATION_TASK_PENDING) {
+                bool can_start = true;
+                for (int j = 0 ; j < task.wait_for.size() ; j++) {
+                    if (tasks.at(task.wait_for.at(j)).status != CALIBRATION_TASK_DONE) {
+                        can_start = false;
+                        break;
+                    }
+                }
+                if (can_start && startCalibrationTask(task) != CAN_OK) {
+                    return CAN_STEPPERS_CALIBRATION_FAIL;
+                }
+            }
+
+            // check move completion
+            if (task.status == CALIBRATION_TASK_RUNNING && task.type == CALIBRATION_TASK_MOVE) {
+                double theoretical_move_time = (double)abs(task.steps) * task.delay / 1000000.0;
+                bool done = false;
+
+                if (task.position_received) {
+                    // position must be stable, after the motor started moving (or should have finished)
+                    done = (now - task.time_last_position_change > CALIBRATION_MOVE_STABLE_TIME)
+                        && (task.has_moved || now - task.time_start > theoretical_move_time);
+                }
+                else {
+                    done = (now - task.time_start > theoretical_move_time + CALIBRATION_MOVE_NO_FEEDBACK_MARGIN);
+                }
+
+                if (done) {
+                    task.status = CALIBRATION_TASK_DONE;
+                    task.time_done = now;
+                }
+                else if (now - task.time_start > theoretical_move_time + calibration_timeout) {
+                    ROS_ERROR("Motor %d did not reach home position", task.motor->getId());
+                    printCalibrationTimeline(tasks, time_begin);
+                    return CAN_STEPPERS_CALIBRATION_TIMEOUT;
+                }
+            }
+            else if (task.status == CALIBRATION_TASK_RUNNING && task.type == CALIBRATION_TASK_SENSOR) {
+                if (now - task.time_start > calibration_timeout) {
+                    ROS_ERROR("No calibration result received from motor %d", task.motor->getId());
+                    printCalibrationTimeline(tasks, time_begin);
+                    return CAN_STEPPERS_CALIBRATION_TIMEOUT;
+                }
+            }
+
+            if (task.status != CALIBRATION_TASK_DONE) {
+                all_tasks_done = false;
+            }
         }
-        ros::Duration(abs(m2.getOffsetPosition()) * 3000 / 1000000 + 0.5).sleep();
-    }
-    
-    // 5. Send calibration cmd m3 (only for hw version 1)
-    if (hardware_version == 1) {
-        if (sendCalibrationCommandForOneMotor(&m3, 1100, -1, calibration_timeout) != CAN_OK) {
-            return CAN_STEPPERS_CALIBRATION_FAIL;
+
+        if (all_tasks_done) {
+            printCalibrationTimeline(tasks, time_begin);
+            return CAN_STEPPERS_CALIBRATION_OK;
+        }
+
+        // 2. Read frames (position and calibration result)
+        if (!can->canReadData()) {
+            ros::Duration(0.0005).sleep(); // check at 2000 Hz
+            continue;
+        }
+
+        long unsigned int rxId;
+        unsigned char len;
+        unsigned char rxBuf[8];
+        can->readMsgBuf(&rxId, &len, rxBuf);
+
+        if (len < 1) {
+            continue;
         }
 
-        // 5.1 Wait calibration result
-        std::vector<StepperMotorState*> stepper = { &m3 };
-        if (getCalibrationResults(stepper, calibration_timeout, sensor_offset_ids, sensor_offset_steps) != CAN_STEPPERS_CALIBRATION_OK) {
-            return CAN_STEPPERS_CALIBRATION_FAIL;
+        int motor_id = rxId & 0x0F;
+        int control_byte = rxBuf[0];
+
+        for (int i = 0 ; i < tasks.size() ; i++) {
+            CalibrationTask &task = tasks.at(i);
+            if (task.status != CALIBRATION_TASK_RUNNING || task.motor->getId() != motor_id) {
+                continue;
+            }
+
+            if (task.type == CALIBRATION_TASK_MOVE && control_byte == CAN_DATA_POSITION && len == 4) {
+                int32_t pos = (rxBuf[1] << 16) + (rxBuf[2] << 8) + rxBuf[3];
+                if (pos & (1 << 15)) {
+                    pos = -1 * ((~pos + 1) & 0xFFFF);
+                }
+                task.motor->setPositionState(pos);
+
+                if (!task.position_received) {
+                    task.position_received = true;
+                    task.last_position = pos;
+                }
+                else if (pos != task.last_position) {
+                    task.has_moved = true;
+                    task.last_position = pos;
+                    task.time_last_position_change = now;
+                }
+            }
+            else if (task.type == CALIBRATION_TASK_SENSOR && control_byte == CAN_DATA_CALIBRATION_RESULT && len >= 2) {
+                int result = rxBuf[1];
+
+                if (result == CAN_STEPPERS_CALIBRATION_TIMEOUT) {
+                    ROS_ERROR("Motor %d had calibration timeout", motor_id);
+                    return result;
+                }
+                else if (result == CAN_STEPPERS_CALIBRATION_BAD_PARAM) {
+                    ROS_ERROR("Bad params given to motor %d", motor_id);
+                    return result;
+                }
+                else if (result == CAN_STEPPERS_CALIBRATION_OK) {
+                    ROS_INFO("Motor %d - Calibration OK", motor_id);
+
+                    if (len == 4) { // new firmware version -> get result + absolute sensor steps at offset position
+                        int steps_at_offset_pos = (rxBuf[2] << 8) + rxBuf[3];
+                        ROS_INFO("Motor %d - Absolute steps at offset position : %d", motor_id, steps_at_offset_pos);
+                        sensor_offset_ids.push_back(motor_id);
+                        sensor_offset_steps.push_back(steps_at_offset_pos);
+
+                        // keep torque ON for axis 1 and 2
+                        // (if torsion spring is too strong the axis might move too much for the following calibration steps)
+                        if (motor_id == m1.getId() || motor_id == m2.getId()) {
+                            can->sendTorqueOnCommand(motor_id, true);
+                        }
+                    }
+
+                    task.status = CALIBRATION_TASK_DONE;
+                    task.time_done = now;
+                }
+            }
         }
     }
 
-    // 6. Write sensor_offset_steps to file
-    set_motors_calibration_offsets(sensor_offset_ids, sensor_offset_steps);
+    return CAN_STEPPERS_CALIBRATION_FAIL; // node shutdown
+}
 
-    return CAN_STEPPERS_CALIBRATION_OK;
+void CanCommunication::printCalibrationTimeline(const std::vector<CalibrationTask> &tasks, double time_begin)
+{
+    ROS_INFO("Calibration timeline :");
+    for (int i = 0 ; i < tasks.size() ; i++) {
+        const CalibrationTask &task = tasks.at(i);
+        if (!task.motor->isEnabled()) {
+            continue;
+        }
+
+        std::string task_name = (task.type == CALIBRATION_TASK_SENSOR) ? "calibration" : "move to home";
+        if (task.status == CALIBRATION_TASK_DONE) {
+            ROS_INFO("Motor %d - %s : %.3lf s -> %.3lf s (%.3lf s)%s", task.motor->getId(), task_name.c_str(),
+                    task.time_start - time_begin, task.time_done - time_begin, task.time_done - task.time_start,
+                    (task.type == CALIBRATION_TASK_MOVE && !task.position_received) ? " - no position feedback" : "");
+        }
+        else if (task.status == CALIBRATION_TASK_RUNNING) {
+            ROS_INFO("Motor %d - %s : %.3lf s -> not finished", task.motor->getId(), task_name.c_str(),
+                    task.time_start - time_begin);
+        }
+        else {
+            ROS_INFO("Motor %d - %s : not started", task.motor->getId(), task_name.c_str());
+        }
+    }
 }
 
 void CanCommunication::setGoalPositionV1(double axis_1_pos_goal, double axis_2_pos_goal, double axis_3_pos_goal, double axis_4_pos_goal)
@@ -1166,6 +1312,9 @@ int CanCommunication::scanAndCheck()
     }
 
     //ROS_INFO("CAN Connection ok");
+    for (int i = 0; i < motors.size(); i++) {
+        motors.at(i)->setFaulted(false);
+    }
     hw_is_busy = false;
     is_can_connection_ok = true;
     debug_error_message = "";
@@ -0,0 +1,81 @@
+/*
+    connection_recovery.cpp
+    Copyright (C) 2018 Niryo
+    All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "niryo_one_driver/connection_recovery.h"
+
+#include <ros/ros.h>
+#include <algorithm>
+
+ConnectionRecovery::ConnectionRecovery(const std::string &bus_name, double min_delay, double max_delay)
+{
+    this->bus_name = bus_name;
+    this->min_delay = min_delay;
+    this->max_delay = std::max(min_delay, max_delay);
+
+    in_progress = false;
+    time_fault_detected = 0.0;
+    current_delay = min_delay;
+    attempt_counter = 0;
+
+    recovery_count = 0;
+    last_time_to_recover = 0.0;
+    max_time_to_recover = 0.0;
+    total_time_to_recover = 0.0;
+}
+
+void ConnectionRecovery::start()
+{
+    if (in_progress) {
+        return;
+    }
+    in_progress = true;
+    time_fault_detected = ros::Time::now().toSec();
+    current_delay = min_delay;
+    attempt_counter = 0;
+}
+
+bool ConnectionRecovery::isInProgress()
+{
+    return in_progress;
+}
+
+double ConnectionRecovery::getNextDelay()
+{
+    double delay = current_delay;
+    current_delay = std::min(current_delay * 2.0, max_delay);
+    attempt_counter++;
+    return delay;
+}
+
+void ConnectionRecovery::finish()
+{
+    if (!in_progress) {
+        return;
+    }
+    in_progress = false;
+
+    last_time_to_recover = ros::Time::now().toSec() - time_fault_detected;
+    max_time_to_recover = std::max(max_time_to_recover, last_time_to_recover);
+    total_time_to_recover += last_time_to_recover;
+    recovery_count++;
+
+    ROS_INFO("%s connection recovered in %.3lf s (%d attempts) - recoveries : %d, mean : %.3lf s, max : %.3lf s",
+            bus_name.c_str(), last_time_to_recover, attempt_counter, recovery_count,
+            total_time_to_recover / recovery_count, max_time_to_recover);
+}
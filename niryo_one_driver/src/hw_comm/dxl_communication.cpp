@@ -263,7 +263,7 @@ void DxlCommunication::hardwareControlRead()
     std::vector<DxlMotorState *> xl430_motor_list;
 
     for (int i = 0; i < motors.size(); i++) {
-        if (motors.at(i)->isEnabled()) {
+        if (motors.at(i)->isEnabled() && !motors.at(i)->isFaulted()) {
             if (motors.at(i)->getType() == MOTOR_TYPE_XL320) {
                 xl320_id_list.push_back(motors.at(i)->getId());
                 xl320_motor_list.push_back(motors.at(i));
@@ -275,7 +275,7 @@ void DxlCommunication::hardwareControlRead()
         }
     }
 
-    if (is_tool_connected) {
+    if (is_tool_connected && !tool.isFaulted()) {
         xl320_id_list.push_back(tool.getId());
         xl320_motor_list.push_back(&tool);
     }
@@ -488,9 +488,140 @@ void DxlCommunication::hardwareControlRead()
         ROS_ERROR("Dxl connection problem - Failed to read from Dxl bus");
         xl320_hw_fail_counter_read = 0;
         xl430_hw_fail_counter_read = 0;
+        isolateFaultedMotors(xl320_motor_list, xl430_motor_list);
+    }
+}
+
+/*
+ * Sync read fails as soon as one motor does not answer
+ * --> ping motors one by one to find which ones are missing
+ *
+ * If only some motors are missing, they are excluded from sync read/write and the
+ * other motors are still controlled (degraded mode). The connection is considered
+ * lost only if no motor answers anymore.
+ */
+void DxlCommunication::isolateFaultedMotors(std::vector<DxlMotorState*> &xl320_motor_list,
+        std::vector<DxlMotorState*> &xl430_motor_list)
+{
+    std::vector<DxlMotorState*> faulted_motors;
+    int answering_motors_counter = 0;
+
+    for (int i = 0; i < xl320_motor_list.size(); i++) {
+        if (xl320->ping(xl320_motor_list.at(i)->getId()) == COMM_SUCCESS) {
+            answering_motors_counter++;
+        }
+        else {
+            faulted_motors.push_back(xl320_motor_list.at(i));
+        }
+    }
+    for (int i = 0; i < xl430_motor_list.size(); i++) {
+        if (xl430->ping(xl430_motor_list.at(i)->getId()) == COMM_SUCCESS) {
+            answering_motors_counter++;
+        }
+        else {
+            faulted_motors.push_back(xl430_motor_list.at(i));
+        }
+    }
+
+    if (answering_motors_counter == 0) {
         is_dxl_connection_ok = false;
         debug_error_message = "Connection problem with Dynamixel Bus.";
+        return;
+    }
+
+    if (faulted_motors.size() == 0) {
+        ROS_WARN("Dxl read failures, but all motors answer to ping");
+        return;
+    }
+
+    for (int i = 0; i < faulted_motors.size(); i++) {
+        faulted_motors.at(i)->setFaulted(true);
+    }
+    updateDegradedModeMessage();
+    ROS_ERROR("%s", debug_error_message.c_str());
+}
+
+void DxlCommunication::updateDegradedModeMessage()
+{
+    if (!isDegraded()) {
+        debug_error_message = "";
+        return;
+    }
+
+    debug_error_message = "Dynamixel motor(s) not responding, running in degraded mode : ";
+    for (int i = 0; i < motors.size(); i++) {
+        if (motors.at(i)->isEnabled() && motors.at(i)->isFaulted()) {
+            debug_error_message += motors.at(i)->getName();
+            debug_error_message += ", ";
+        }
+    }
+    if (is_tool_connected && tool.isFaulted()) {
+        debug_error_message += tool.getName();
+    }
+}
+
+bool DxlCommunication::isDegraded()
+{
+    for (int i = 0; i < motors.size(); i++) {
+        if (motors.at(i)->isEnabled() && motors.at(i)->isFaulted()) {
+            return true;
+        }
     }
+    return (is_tool_connected && tool.isFaulted());
+}
+
+/*
+ * Ping only the motors excluded in degraded mode, returns the number of motors still missing
+ */
+int DxlCommunication::pingFaultedMotors()
+{
+    int counter = 0;
+
+    while (hw_is_busy && counter < 100) { 
+        ros::Duration(TIME_TO_WAIT_IF_BUSY).sleep();    
+        counter++;
+    }
+    
+    std::vector<DxlMotorState*> faulted_motors;
+    for (int i = 0; i < motors.size(); i++) {
+        if (motors.at(i)->isEnabled() && motors.at(i)->isFaulted()) {
+            faulted_motors.push_back(motors.at(i));
+        }
+    }
+    if (is_tool_connected && tool.isFaulted()) {
+        faulted_motors.push_back(&tool);
+    }
+
+    if (counter == 100) {
+        ROS_WARN("Failed to ping missing Dxl motors, dxl bus is too busy. Will retry...");
+        return faulted_motors.size();
+    }
+
+    hw_is_busy = true;
+
+    int missing_motors_counter = 0;
+    for (int i = 0; i < faulted_motors.size(); i++) {
+        int result;
+        if (faulted_motors.at(i)->getType() == MOTOR_TYPE_XL430) {
+            result = xl430->ping(faulted_motors.at(i)->getId());
+        }
+        else {
+            result = xl320->ping(faulted_motors.at(i)->getId());
+        }
+
+        if (result == COMM_SUCCESS) {
+            ROS_INFO("Dxl motor %d is answering again", (int)faulted_motors.at(i)->getId());
+            faulted_motors.at(i)->setFaulted(false);
+            write_torque_on_enable = true; // motor may have rebooted, apply torque state again
+        }
+        else {
+            missing_motors_counter++;
+        }
+    }
+
+    hw_is_busy = false;
+    updateDegradedModeMessage();
+    return missing_motors_counter;
 }
 
 void DxlCommunication::hardwareControlWrite()
@@ -504,7 +635,7 @@ void DxlCommunication::hardwareControlWrite()
     std::vector<DxlMotorState *> xl430_motor_list;
 
     for (int i = 0; i < motors.size(); i++) {
-        if (motors.at(i)->isEnabled()) {
+        if (motors.at(i)->isEnabled() && !motors.at(i)->isFaulted()) {
             if (motors.at(i)->getType() == MOTOR_TYPE_XL320) {
                 xl320_id_list.push_back(motors.at(i)->getId());
                 xl320_motor_list.push_back(motors.at(i));
@@ -573,7 +704,8 @@ void DxlCommunication::hardwareControlWrite()
                 xl320_torque_enable_list.push_back(torque_on); 
             }
 
-            if (is_tool_connected) {
+            bool write_tool_torque = is_tool_connected && !tool.isFaulted();
+            if (write_tool_torque) {
                 xl320_id_list.push_back(tool.getId());
                 xl320_torque_enable_list.push_back(torque_on);
             }
@@ -593,7 +725,7 @@ void DxlCommunication::hardwareControlWrite()
                 write_torque_on_enable = false; // disable writing torque ON/OFF after success on all motors
             } 
 
-            if (is_tool_connected) {
+            if (write_tool_torque) {
                 xl320_id_list.pop_back();
             }
         }
@@ -1173,6 +1305,12 @@ int DxlCommunication::scanAndCheck()
         return DXL_SCAN_UNALLOWED_MOTOR;
     }
 
+    // all motors found, stop degraded mode if any
+    for (int i = 0; i < motors.size(); i++) {
+        motors.at(i)->setFaulted(false);
+    }
+    tool.setFaulted(false);
+
     is_dxl_connection_ok = true;
     debug_error_message = "";
     return DXL_SCAN_OK;
@@ -24,6 +24,7 @@ FakeCommunication::FakeCommunication(int hardware_version)
     ROS_INFO("Starting Fake Communication... It will just echo cmd into current position");
 
     this->hardware_version = hardware_version;
+    time_last_position_change_write = 0.0;
 
     double pos_0, pos_1, pos_2;
     ros::param::get("/niryo_one/motors/stepper_1_home_position", pos_0);
@@ -104,9 +105,19 @@ bool FakeCommunication::isCalibrationInProgress()
 
 void FakeCommunication::sendPositionToRobot(const double cmd[6])
 {
+    bool position_command_changed = false;
     for (int i = 0 ; i < 6 ; i++) {
+        position_command_changed |= (echo_pos[i] != cmd[i]);
         echo_pos[i] = cmd[i]; 
     }
+    if (position_command_changed) {
+        time_last_position_change_write = ros::Time::now().toSec();
+    }
+}
+
+double FakeCommunication::getLastPositionChangeWriteTime()
+{
+    return time_last_position_change_write;
 }
 
 void FakeCommunication::getCurrentPosition(double pos[6])
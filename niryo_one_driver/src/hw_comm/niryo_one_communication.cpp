@@ -27,6 +27,13 @@ NiryoOneCommunication::NiryoOneCommunication(int hardware_version)
     ros::param::get("~dxl_enabled", dxl_enabled);
     ros::param::get("~niryo_one_hw_check_connection_frequency", niryo_one_hw_check_connection_frequency);
 
+    double hw_recovery_min_delay = 0.05;
+    double hw_recovery_max_delay = 2.0;
+    ros::param::get("~hw_recovery_min_delay", hw_recovery_min_delay);
+    ros::param::get("~hw_recovery_max_delay", hw_recovery_max_delay);
+    can_recovery.reset(new ConnectionRecovery("CAN", hw_recovery_min_delay, hw_recovery_max_delay));
+    dxl_recovery.reset(new ConnectionRecovery("Dxl", hw_recovery_min_delay, hw_recovery_max_delay));
+
     if (!can_enabled) {
         ROS_WARN("CAN communication is disabled for debug purposes");
     }
@@ -104,13 +111,25 @@ void NiryoOneCommunication::manageCanConnectionLoop()
     while (ros::ok()) {
         if (!canComm->isConnectionOk() || new_calibration_requested) {
             new_calibration_requested = false;
+            can_recovery->start();
+
+            // Some motors stopped answering : keep reading the other ones (limited mode),
+            // and wait only for the missing ones, instead of rescanning the whole bus
+            if (!canComm->isConnectionOk() && canComm->hasFaultedMotors()) {
+                ROS_WARN("Wait for missing stepper motors...");
+                canComm->startHardwareControlLoop(true);
+                while (ros::ok() && canComm->checkFaultedMotors() != CAN_SCAN_OK) {
+                    ros::Duration(can_recovery->getNextDelay()).sleep();
+                }
+            }
+
             ROS_WARN("Stop Can hw control");
             canComm->stopHardwareControlLoop();
             ros::Duration(0.1).sleep();
            
             while (canComm->scanAndCheck() != CAN_SCAN_OK) { // wait for connection to be up
                 ROS_WARN("Scan to find stepper motors...");
-                ros::Duration(0.25).sleep();
+                ros::Duration(can_recovery->getNextDelay()).sleep();
             }
             
             // once connected, set calibration flag
@@ -149,7 +168,7 @@ void NiryoOneCommunication::manageCanConnectionLoop()
                     if (!canComm->isConnectionOk()) {
                         while (canComm->scanAndCheck() != CAN_SCAN_OK) { // wait for connection to be up
                             ROS_WARN("Scan to find stepper motors...");
-                            ros::Duration(0.25).sleep();
+                            ros::Duration(can_recovery->getNextDelay()).sleep();
                         }
                     }
 
@@ -172,6 +191,7 @@ void NiryoOneCommunication::manageCanConnectionLoop()
             else {
                 canComm->startHardwareControlLoop(false);
             }
+            can_recovery->finish(); // time to recover includes calibration
         }
         else { // can connection ok + calibrated
             if (dxl_enabled && !dxlComm->isConnectionOk()) {
@@ -233,12 +253,13 @@ void NiryoOneCommunication::manageDxlConnectionLoop()
     while (ros::ok()) {
         if (!dxlComm->isConnectionOk()) {
             ROS_WARN("Stop Dxl hw control");
+            dxl_recovery->start();
             dxlComm->stopHardwareControlLoop();
             ros::Duration(0.1).sleep();
 
             while (dxlComm->scanAndCheck() != DXL_SCAN_OK) { // wait for connection to be up
                 ROS_WARN("Scan to find Dxl motors");
-                ros::Duration(0.25).sleep();
+                ros::Duration(dxl_recovery->getNextDelay()).sleep();
             }
 
             ROS_WARN("Resume Dxl hw control");
@@ -250,6 +271,18 @@ void NiryoOneCommunication::manageDxlConnectionLoop()
             else {
                 dxlComm->startHardwareControlLoop(false);
             }
+            dxl_recovery->finish();
+        }
+        else if (dxlComm->isDegraded()) {
+            // Degraded mode : healthy motors are still controlled by the hw control loop,
+            // only ping missing motors, with exponential backoff
+            dxl_recovery->start();
+            ros::Duration(dxl_recovery->getNextDelay()).sleep();
+            if (dxlComm->pingFaultedMotors() == 0) {
+                ROS_WARN("All Dxl motors are connected again");
+                dxl_recovery->finish();
+            }
+            continue;
         }
         else { // dxl connection ok
             if (can_enabled && !canComm->isConnectionOk()) {
@@ -493,6 +526,17 @@ void NiryoOneCommunication::sendPositionToRobot(const double cmd[6])
         }
     }
 }
+
+/*
+ * Only the CAN bus (steppers) is covered : the Dynamixel position writes are not timestamped
+ */
+double NiryoOneCommunication::getLastPositionChangeWriteTime()
+{
+    if (can_enabled) {
+        return canComm->getLastPositionChangeWriteTime();
+    }
+    return 0.0;
+}
         
 void NiryoOneCommunication::addCustomDxlCommand(int motor_type, uint8_t id, uint32_t value,
         uint32_t reg_address, uint32_t byte_number)
@@ -0,0 +1,182 @@
+/*
+    niryo_one_driver.cpp
+    Copyright (C) 2017 Niryo
+    All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "niryo_one_driver/niryo_one_driver.h"
+
+#include "niryo_one_driver/niryo_one_communication.h"
+#include "niryo_one_driver/fake_communication.h"
+
+void NiryoOneDriver::rosControlLoop()
+{
+    ros::Time last_time = ros::Time::now();
+    ros::Time current_time = ros::Time::now();
+    ros::Duration elapsed_time;
+
+    while(ros::ok() && ros_control_loop_running) {
+
+      robot->read();
+      current_time = ros::Time::now();
+      elapsed_time = ros::Duration(current_time - last_time);
+      last_time = current_time;
+
+      if (flag_reset_controllers) {
+        robot->setCommandToCurrentPosition();
+        cm->update(ros::Time::now(), elapsed_time, true);
+        flag_reset_controllers = false;
+      }
+      else {
+        cm->update(ros::Time::now(), elapsed_time, false);
+      }
+      robot->write();
+      if (bus_write_publisher) {
+        publishBusWrite();
+      }
+
+      ros_control_loop_rate->sleep();
+    }
+}
+
+NiryoOneDriver::NiryoOneDriver(ros::NodeHandle &nh, ros::NodeHandle &nh_private)
+    : nh_(nh), nh_private_(nh_private)
+{
+    ros_control_loop_running = false;
+
+    reset_controller_subscriber = nh_.subscribe("/niryo_one/steppers_reset_controller", 10,  &NiryoOneDriver::callbackTrajectoryGoal, this);
+
+    trajectory_result_subscriber = nh_.subscribe("/niryo_one_follow_joint_trajectory_controller/follow_joint_trajectory/result",
+            10, &NiryoOneDriver::callbackTrajectoryResult, this);
+
+    ros::param::get("/niryo_one/hardware_version", hardware_version);
+
+    if (hardware_version != 1 && hardware_version != 2) {
+        ROS_ERROR("Incorrect hardware version, should be 1 or 2");
+        return;
+    }
+
+    double ros_control_frequency;
+    nh_private_.getParam("ros_control_loop_frequency", ros_control_frequency);
+
+    bool fake_communication;
+    nh_private_.getParam("fake_communication", fake_communication);
+
+    ROS_INFO("Starting niryo_one driver thread (frequency : %lf)", ros_control_frequency);
+
+    if (fake_communication) {
+        comm.reset(new FakeCommunication(hardware_version));
+    }
+    else {
+        comm.reset(new NiryoOneCommunication(hardware_version));
+    }
+
+    int init_result = comm->init();
+    if (init_result != 0) {
+        return; // need to check last ROS_ERROR to get more info
+    }
+
+    ROS_INFO("NiryoOne communication has been successfully started");
+
+    ros::Duration(0.1).sleep();
+    flag_reset_controllers = true;
+
+    ROS_INFO("Start hardware control loop");
+    comm->manageHardwareConnection();
+    ros::Duration(0.5).sleep();
+
+    ROS_INFO("Start hardware interface");
+    robot.reset(new NiryoOneHardwareInterface(comm.get()));
+
+    ROS_INFO("Create controller manager");
+    cm.reset(new controller_manager::ControllerManager(robot.get(), nh_));
+    ros::Duration(0.1).sleep();
+
+    bool publish_bus_writes = false;
+    nh_private_.getParam("publish_bus_writes", publish_bus_writes);
+    if (publish_bus_writes) {
+        ROS_INFO("Publishing bus write times on /niryo_one/bus_write");
+        last_published_bus_write = comm->getLastPositionChangeWriteTime();
+        bus_write_publisher.reset(new realtime_tools::RealtimePublisher<std_msgs::Time>(nh_, "/niryo_one/bus_write", 10));
+    }
+
+    ROS_INFO("Starting ros control thread...");
+    ros_control_loop_rate.reset(new ros::Rate(ros_control_frequency));
+    ros_control_loop_running = true;
+    ros_control_thread.reset(new std::thread(boost::bind(&NiryoOneDriver::rosControlLoop, this)));
+
+    ROS_INFO("Start Rpi Diagnostics...");
+    rpi_diagnostics.reset(new RpiDiagnostics());
+
+    ROS_INFO("Starting ROS interface...");
+    bool learning_mode_activated_on_startup = true;
+    ros_interface.reset(new RosInterface(comm.get(), rpi_diagnostics.get(),
+                &flag_reset_controllers, learning_mode_activated_on_startup, hardware_version));
+
+    // activate learning mode
+    comm->activateLearningMode(learning_mode_activated_on_startup);
+}
+
+NiryoOneDriver::~NiryoOneDriver()
+{
+    // the control loop uses robot and cm, so stop it before they are released
+    ros_control_loop_running = false;
+    if (ros_control_thread && ros_control_thread->joinable()) {
+        ros_control_thread->join();
+    }
+}
+
+/*
+ * The control loop runs faster than the bus writes (see can_hw_write_frequency), so that
+ * each write of a new position command is published once
+ */
+void NiryoOneDriver::publishBusWrite()
+{
+    double write_time = comm->getLastPositionChangeWriteTime();
+    if (write_time != last_published_bus_write && bus_write_publisher->trylock()) {
+        bus_write_publisher->msg_.data = ros::Time(write_time);
+        bus_write_publisher->unlockAndPublish();
+        last_published_bus_write = write_time;
+    }
+}
+
+/*
+ * Problem : for joint_trajectory_controller, position command has no discontinuity
+ * --> If the stepper motor missed some steps, we need to start at current position (given by the encoder)
+ *  So current real position != current trajectory command, we need a discontinuity in controller command.
+ *  We have to reset controllers to start from sensor position.
+ *  If we subscribe to trajectory /goal topic and reset when we receive a goal, it is often
+ *  too late and trajectory will just be preempted.
+ *
+ *  So, in order to start from encoder position, we need to reset controller before we send the goal. If you
+ *  send a new goal, be sure to send a message on /niryo_one_steppers_reset_controller BEFORE sending the goal.
+ *
+ *  This behavior is used in robot_commander node.
+ *
+ */
+void NiryoOneDriver::callbackTrajectoryGoal(const std_msgs::Empty& msg)
+{
+    ROS_INFO("Received trajectory GOAL");
+    robot->setCommandToCurrentPosition();  // set current command to encoder position
+    cm->update(ros::Time::now(), ros::Duration(0.00), true); // reset controllers to allow a discontinuity in position command
+    comm->synchronizeMotors(true);
+}
+
+void NiryoOneDriver::callbackTrajectoryResult(const control_msgs::FollowJointTrajectoryActionResult& msg)
+{
+    ROS_INFO("Received trajectory RESULT");
+    comm->synchronizeMotors(false);
+}
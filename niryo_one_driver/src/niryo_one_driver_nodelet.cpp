@@ -0,0 +1,60 @@
+/*
+    niryo_one_driver_nodelet.cpp
+    Copyright (C) 2017 Niryo
+    All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <boost/shared_ptr.hpp>
+#include <nodelet/nodelet.h>
+#include <pluginlib/class_list_macros.h>
+
+#include "niryo_one_driver/niryo_one_driver.h"
+
+namespace niryo_one_driver {
+
+/*
+ * Runs the driver inside a nodelet manager, so that nodes loaded in the same
+ * manager (ex : cartesian controller) exchange messages without serialization.
+ *
+ * Hardware classes read their parameters with "~", which resolves to the
+ * manager node. The driver parameters are thus read from the manager private
+ * namespace : the manager must be started with the niryo_one_driver parameters
+ * (see niryo_one_bringup/launch/controllers.launch).
+ */
+class NiryoOneDriverNodelet : public nodelet::Nodelet {
+
+    public:
+
+        virtual void onInit()
+        {
+            // multi-threaded callback queue, as the standalone node uses an AsyncSpinner
+            ros::NodeHandle &nh = getMTNodeHandle();
+            manager_nh_private = ros::NodeHandle("~");
+
+            NODELET_INFO("Loading niryo_one driver nodelet");
+            driver.reset(new NiryoOneDriver(nh, manager_nh_private));
+        }
+
+    private:
+
+        ros::NodeHandle manager_nh_private;
+        boost::shared_ptr<NiryoOneDriver> driver;
+
+};
+
+} // namespace niryo_one_driver
+
+PLUGINLIB_EXPORT_CLASS(niryo_one_driver::NiryoOneDriverNodelet, nodelet::Nodelet)
@@ -28,6 +28,9 @@ RosInterface::RosInterface(CommunicationBase* niryo_one_comm, RpiDiagnostics* rp
     this->flag_reset_controllers = flag_reset_controllers;
     this->hardware_version = hardware_version;
     last_connection_up_flag = true;
+    publish_status_loop_running = false;
+    status_changed = false;
+    learning_mode_published = learning_mode_on;
     
     ros::param::get("/niryo_one/info/image_version", rpi_image_version);
     ros::param::get("/niryo_one/info/ros_version", ros_niryo_one_version);
@@ -45,6 +48,15 @@ RosInterface::RosInterface(CommunicationBase* niryo_one_comm, RpiDiagnostics* rp
     calibration_needed = 0;
 }
 
+RosInterface::~RosInterface()
+{
+    publish_status_loop_running = false;
+    notifyStatusChanged();
+    if (publish_status_thread && publish_status_thread->joinable()) {
+        publish_status_thread->join();
+    }
+}
+
 bool RosInterface::callbackCalibrateMotors(niryo_one_msgs::SetInt::Request &req, niryo_one_msgs::SetInt::Response &res) 
 {
     int calibration_mode = req.value; 
@@ -71,9 +83,7 @@ bool RosInterface::callbackRequestNewCalibration(niryo_one_msgs::SetInt::Request
     comm->activateLearningMode(learning_mode_on);
     
     // publish one time
-    std_msgs::Bool msg;
-    msg.data = learning_mode_on;
-    learning_mode_publisher.publish(msg);
+    notifyStatusChanged();
 
     // 2. Set calibration flag (user will have to validate for calibration to start)
     comm->requestNewCalibration();
@@ -112,9 +122,7 @@ bool RosInterface::callbackActivateLearningMode(niryo_one_msgs::SetInt::Request
     comm->activateLearningMode(learning_mode_on);
     
     // publish one time
-    std_msgs::Bool msg;
-    msg.data = learning_mode_on;
-    learning_mode_publisher.publish(msg);
+    notifyStatusChanged();
    
     res.status = 200;
     res.message = (learning_mode_on) ? "Activating learning mode" : "Deactivating learning mode";
@@ -225,104 +233,144 @@ void RosInterface::startServiceServers()
     reboot_motors_server = nh_.advertiseService("niryo_one/reboot_motors", &RosInterface::callbackRebootMotors, this);
 }
 
-void RosInterface::publishHardwareStatus()
+void RosInterface::notifyStatusChanged()
 {
-    double publish_hw_status_frequency;
-    ros::param::get("~publish_hw_status_frequency", publish_hw_status_frequency);
-    ros::Rate publish_hardware_status_rate = ros::Rate(publish_hw_status_frequency);
+    std::lock_guard<std::mutex> lock(status_mutex);
+    status_changed = true;
+    status_condition.notify_one();
+}
 
-    while (ros::ok()) {
-        ros::Time time_now = ros::Time::now();
+/*
+ * Read hardware status from comm, returns true if the connection, calibration
+ * or error state has changed (temperatures and voltages are published at keep-alive rate)
+ */
+bool RosInterface::updateHardwareStatus()
+{
+    bool connection_up = false;
+    bool calibration_in_progress = false;
+    std::string error_message;
 
-        bool connection_up = false;
-        bool calibration_in_progress = false;
-        std::string error_message;
-        std::vector<std::string> motor_names;
-        std::vector<std::string> motor_types;
-        std::vector<int32_t> temperatures;
-        std::vector<double> voltages;
-        std::vector<int32_t> hw_errors;
-
-        comm->getHardwareStatus(&connection_up, error_message, &calibration_needed, 
-                &calibration_in_progress, motor_names, motor_types, temperatures, voltages, hw_errors);
-
-        if (connection_up && !last_connection_up_flag) {
-            learning_mode_on = true;
-            comm->activateLearningMode(learning_mode_on);
-            
-            // publish one time
-            std_msgs::Bool msg;
-            msg.data = learning_mode_on;
-            learning_mode_publisher.publish(msg);
-        }
-        last_connection_up_flag = connection_up;
-
-        niryo_one_msgs::HardwareStatus msg;
-        msg.header.stamp = ros::Time::now();
-        msg.rpi_temperature = rpi_diagnostics->getRpiCpuTemperature();
-        msg.hardware_version = hardware_version;
-        msg.connection_up = connection_up;
-        msg.error_message = error_message;
-        msg.calibration_needed = calibration_needed;
-        msg.calibration_in_progress = calibration_in_progress;
-        msg.motor_names = motor_names;
-        msg.motor_types = motor_types;
-        msg.temperatures = temperatures;
-        msg.voltages = voltages;
-        msg.hardware_errors = hw_errors;
-
-        hardware_status_publisher.publish(msg);
-
-        publish_hardware_status_rate.sleep();
+    comm->getHardwareStatus(&connection_up, error_message, &calibration_needed, 
+            &calibration_in_progress, motor_names, motor_types, temperatures, voltages, hw_errors);
+
+    if (connection_up && !last_connection_up_flag) {
+        learning_mode_on = true;
+        comm->activateLearningMode(learning_mode_on);
     }
+    last_connection_up_flag = connection_up;
+
+    bool changed = (hardware_status_msg.connection_up != connection_up)
+        || (hardware_status_msg.error_message != error_message)
+        || (hardware_status_msg.calibration_needed != calibration_needed)
+        || (hardware_status_msg.calibration_in_progress != calibration_in_progress)
+        || (hardware_status_msg.hardware_errors != hw_errors)
+        || (hardware_status_msg.motor_names != motor_names)
+        || (hardware_status_msg.motor_types != motor_types);
+
+    if (changed) {
+        hardware_status_msg.connection_up = connection_up;
+        hardware_status_msg.error_message = error_message;
+        hardware_status_msg.calibration_needed = calibration_needed;
+        hardware_status_msg.calibration_in_progress = calibration_in_progress;
+        hardware_status_msg.hardware_errors = hw_errors;
+        hardware_status_msg.motor_names = motor_names;
+        hardware_status_msg.motor_types = motor_types;
+    }
+    hardware_status_msg.temperatures = temperatures;
+    hardware_status_msg.voltages = voltages;
+
+    return changed;
 }
 
-void RosInterface::publishSoftwareVersion()
+bool RosInterface::updateSoftwareVersion()
 {
-    double publish_software_version_frequency;
-    ros::param::get("~publish_software_version_frequency", publish_software_version_frequency);
-    ros::Rate publish_software_version_rate = ros::Rate(publish_software_version_frequency);
-
-    while (ros::ok()) {
-        std::vector<std::string> motor_names;
-        std::vector<std::string> firmware_versions;
-        comm->getFirmwareVersions(motor_names, firmware_versions);
-
-        niryo_one_msgs::SoftwareVersion msg;
-        msg.motor_names = motor_names;
-        msg.stepper_firmware_versions = firmware_versions;
-        msg.rpi_image_version = rpi_image_version;
-        msg.ros_niryo_one_version = ros_niryo_one_version;
-       
-        software_version_publisher.publish(msg);
-        publish_software_version_rate.sleep();
+    comm->getFirmwareVersions(firmware_motor_names, firmware_versions);
+
+    bool changed = (software_version_msg.motor_names != firmware_motor_names)
+        || (software_version_msg.stepper_firmware_versions != firmware_versions);
+
+    if (changed) {
+        software_version_msg.motor_names = firmware_motor_names;
+        software_version_msg.stepper_firmware_versions = firmware_versions;
     }
+    return changed;
 }
 
-void RosInterface::publishLearningMode()
+/*
+ * Single thread for hardware status, software version and learning mode topics
+ * - state is checked at check_hw_status_frequency, or right away when notified (service callbacks)
+ * - a message is published as soon as its content changes (connection lost, motor error, ...),
+ *   else at its keep-alive rate (publish_xxx_frequency params)
+ */
+void RosInterface::publishStatusLoop()
 {
+    double check_hw_status_frequency = 10.0;
+    double publish_hw_status_frequency;
+    double publish_software_version_frequency;
     double publish_learning_mode_frequency;
+    ros::param::get("~check_hw_status_frequency", check_hw_status_frequency);
+    ros::param::get("~publish_hw_status_frequency", publish_hw_status_frequency);
+    ros::param::get("~publish_software_version_frequency", publish_software_version_frequency);
     ros::param::get("~publish_learning_mode_frequency", publish_learning_mode_frequency);
-    ros::Rate publish_learning_mode_rate = ros::Rate(publish_learning_mode_frequency);
 
-    while (ros::ok()) {
-        std_msgs::Bool msg;
-        msg.data = learning_mode_on;
-        learning_mode_publisher.publish(msg);
-        publish_learning_mode_rate.sleep();
+    // static data
+    hardware_status_msg.hardware_version = hardware_version;
+    software_version_msg.rpi_image_version = rpi_image_version;
+    software_version_msg.ros_niryo_one_version = ros_niryo_one_version;
+
+    ros::Time time_last_hw_status_publish(0);
+    ros::Time time_last_software_version_publish(0);
+    ros::Time time_last_learning_mode_publish(0);
+
+    while (ros::ok() && publish_status_loop_running) {
+        ros::Time time_now = ros::Time::now();
+
+        // 1. Hardware status
+        bool hw_status_changed = updateHardwareStatus();
+        if (hw_status_changed || (time_now - time_last_hw_status_publish).toSec() >= 1.0/publish_hw_status_frequency) {
+            hardware_status_msg.header.stamp = time_now;
+            hardware_status_msg.rpi_temperature = rpi_diagnostics->getRpiCpuTemperature();
+            hardware_status_publisher.publish(hardware_status_msg);
+            time_last_hw_status_publish = time_now;
+        }
+
+        // 2. Software version (firmware versions are only updated after a (re)connection)
+        bool software_version_keep_alive = (time_now - time_last_software_version_publish).toSec() >= 1.0/publish_software_version_frequency;
+        if (hw_status_changed || software_version_keep_alive) {
+            if (updateSoftwareVersion() || software_version_keep_alive) {
+                software_version_publisher.publish(software_version_msg);
+                time_last_software_version_publish = time_now;
+            }
+        }
+
+        // 3. Learning mode
+        bool learning_mode = learning_mode_on;
+        if (learning_mode != learning_mode_published 
+                || (time_now - time_last_learning_mode_publish).toSec() >= 1.0/publish_learning_mode_frequency) {
+            std_msgs::Bool msg;
+            msg.data = learning_mode;
+            learning_mode_publisher.publish(msg);
+            learning_mode_published = learning_mode;
+            time_last_learning_mode_publish = time_now;
+        }
+
+        // wait for next check, or for a notification
+        std::unique_lock<std::mutex> lock(status_mutex);
+        status_condition.wait_for(lock, std::chrono::duration<double>(1.0/check_hw_status_frequency),
+                [this] { return status_changed; });
+        status_changed = false;
     }
 }
 
 void RosInterface::startPublishers()
 {
-    hardware_status_publisher = nh_.advertise<niryo_one_msgs::HardwareStatus>("niryo_one/hardware_status", 10);
-    publish_hardware_status_thread.reset(new std::thread(boost::bind(&RosInterface::publishHardwareStatus, this))); 
-
-    software_version_publisher = nh_.advertise<niryo_one_msgs::SoftwareVersion>("niryo_one/software_version", 10);
-    publish_software_version_thread.reset(new std::thread(boost::bind(&RosInterface::publishSoftwareVersion, this)));
+    // latched : messages are not published at a fixed rate anymore, new subscribers get the last one
+    hardware_status_publisher = nh_.advertise<niryo_one_msgs::HardwareStatus>("niryo_one/hardware_status", 10, true);
+    software_version_publisher = nh_.advertise<niryo_one_msgs::SoftwareVersion>("niryo_one/software_version", 10, true);
+    learning_mode_publisher = nh_.advertise<std_msgs::Bool>("niryo_one/learning_mode", 10, true);
 
-    learning_mode_publisher = nh_.advertise<std_msgs::Bool>("niryo_one/learning_mode", 10);
-    publish_learning_mode_thread.reset(new std::thread(boost::bind(&RosInterface::publishLearningMode, this)));
+    publish_status_loop_running = true;
+    publish_status_thread.reset(new std::thread(boost::bind(&RosInterface::publishStatusLoop, this)));
 }
 
 
@@ -0,0 +1,226 @@
+/*
+    streaming_joint_position_controller.cpp
+    Copyright (C) 2018 Niryo
+    All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "niryo_one_driver/streaming_joint_position_controller.h"
+
+#include <pluginlib/class_list_macros.h>
+#include <algorithm>
+
+namespace niryo_one_driver {
+
+void SetpointQueue::init(int capacity, int joint_number)
+{
+    stamps.assign(capacity, ros::Time(0));
+    positions.assign(capacity, std::vector<double>(joint_number, 0.0));
+    head = 0;
+    count = 0;
+}
+
+bool SetpointQueue::push(const ros::Time &stamp, const std::vector<double> &position)
+{
+    bool overwritten = full();
+    if (overwritten) {
+        pop();
+    }
+    int index = (head + count) % stamps.size();
+    stamps[index] = stamp;
+    std::copy(position.begin(), position.end(), positions[index].begin());
+    count++;
+    return !overwritten;
+}
+
+void SetpointQueue::pop()
+{
+    head = (head + 1) % stamps.size();
+    count--;
+}
+
+bool StreamingJointPositionController::init(hardware_interface::PositionJointInterface *hw, ros::NodeHandle &nh)
+{
+    if (!nh.getParam("joints", joint_names) || joint_names.empty()) {
+        ROS_ERROR("Streaming controller : no joints given (namespace : %s)", nh.getNamespace().c_str());
+        return false;
+    }
+    joint_number = joint_names.size();
+    for (int i = 0; i < joint_number; i++) {
+        try {
+            joints.push_back(hw->getHandle(joint_names.at(i)));
+        }
+        catch (const hardware_interface::HardwareInterfaceException &e) {
+            ROS_ERROR("Streaming controller : %s", e.what());
+            return false;
+        }
+    }
+
+    int queue_size;
+    double status_publish_rate;
+    nh.param("queue_size", queue_size, 32);
+    nh.param("interpolation_delay", interpolation_delay, 0.0);
+    nh.param("stream_timeout", stream_timeout, 0.5);
+    nh.param("status_publish_rate", status_publish_rate, 1.0);
+    status_publish_period = (status_publish_rate > 0.0) ? 1.0 / status_publish_rate : 0.0;
+
+    incoming.init(std::max(queue_size, 1), joint_number);
+    setpoints.init(std::max(queue_size, 1), joint_number);
+    incoming_buffer.resize(joint_number);
+    previous_position.resize(joint_number);
+    dropped_incoming_samples = 0;
+    received_samples = 0;
+    late_samples = 0;
+    dropped_samples = 0;
+    underruns = 0;
+
+    status_publisher.reset(
+            new realtime_tools::RealtimePublisher<niryo_one_msgs::JointStreamingStatus>(nh, "status", 1));
+    command_subscriber = nh.subscribe("command", queue_size, &StreamingJointPositionController::callbackCommand, this,
+            ros::TransportHints().tcpNoDelay());
+
+    ROS_INFO("Streaming controller : %d joints, queue size : %d, interpolation delay : %.3lf s",
+            joint_number, queue_size, interpolation_delay);
+    return true;
+}
+
+void StreamingJointPositionController::starting(const ros::Time &time)
+{
+    // hold current position until the first setpoint
+    for (int i = 0; i < joint_number; i++) {
+        previous_position[i] = joints[i].getPosition();
+        joints[i].setCommand(previous_position[i]);
+    }
+    previous_stamp = time - ros::Duration(interpolation_delay);
+    last_sample_time = ros::Time(0);
+    last_status_time = time;
+    setpoints.clear();
+
+    std::lock_guard<std::mutex> lock(incoming_mutex);
+    incoming.clear();
+}
+
+void StreamingJointPositionController::update(const ros::Time &time, const ros::Duration &period)
+{
+    ros::Time target = time - ros::Duration(interpolation_delay);
+
+    // take the new setpoints, without ever waiting for the subscriber thread
+    std::unique_lock<std::mutex> lock(incoming_mutex, std::try_to_lock);
+    if (lock.owns_lock()) {
+        dropped_samples += dropped_incoming_samples;
+        dropped_incoming_samples = 0;
+        if (!incoming.empty() && setpoints.empty() && previous_stamp < target
+                && (time - last_sample_time).toSec() < stream_timeout) {
+            // the stream resumes after the last setpoint was reached and held
+            underruns++;
+        }
+        while (!incoming.empty()) {
+            ros::Time stamp = incoming.frontStamp();
+            ros::Time last_stamp = setpoints.empty() ? previous_stamp : setpoints.backStamp();
+            received_samples++;
+            last_sample_time = time;
+
+            bool superseded = false;
+            if (stamp < target) {
+                late_samples++;
+                // the most recent position is still the best goal : reach it within a period
+                superseded = (incoming.size() > 1);
+                stamp = target + period;
+            }
+            if (superseded || stamp <= last_stamp || !setpoints.push(stamp, incoming.frontPositions())) {
+                // late and superseded by a newer setpoint, out of order, or overwritten in a full queue
+                dropped_samples++;
+            }
+            incoming.pop();
+        }
+        lock.unlock();
+    }
+
+    // setpoints already reached
+    while (!setpoints.empty() && setpoints.frontStamp() <= target) {
+        std::copy(setpoints.frontPositions().begin(), setpoints.frontPositions().end(), previous_position.begin());
+        previous_stamp = setpoints.frontStamp();
+        setpoints.pop();
+    }
+
+    if (!setpoints.empty()) {
+        const std::vector<double> &next_position = setpoints.frontPositions();
+        double span = (setpoints.frontStamp() - previous_stamp).toSec();
+        double ratio = (span > 0.0) ? (target - previous_stamp).toSec() / span : 1.0;
+        ratio = std::min(std::max(ratio, 0.0), 1.0);
+        for (int i = 0; i < joint_number; i++) {
+            joints[i].setCommand(previous_position[i] + ratio * (next_position[i] - previous_position[i]));
+        }
+    }
+    else {
+        // hold : the next setpoint will be interpolated from here
+        previous_stamp = std::max(previous_stamp, target);
+        for (int i = 0; i < joint_number; i++) {
+            joints[i].setCommand(previous_position[i]);
+        }
+    }
+
+    if (status_publish_period > 0.0 && (time - last_status_time).toSec() >= status_publish_period) {
+        publishStatus(time);
+    }
+}
+
+void StreamingJointPositionController::publishStatus(const ros::Time &time)
+{
+    if (!status_publisher->trylock()) {
+        return; // retried at next update
+    }
+    status_publisher->msg_.header.stamp = time;
+    status_publisher->msg_.queue_depth = setpoints.size();
+    status_publisher->msg_.received_samples = received_samples;
+    status_publisher->msg_.late_samples = late_samples;
+    status_publisher->msg_.dropped_samples = dropped_samples;
+    status_publisher->msg_.underruns = underruns;
+    status_publisher->unlockAndPublish();
+    last_status_time = time;
+}
+
+void StreamingJointPositionController::callbackCommand(const sensor_msgs::JointStateConstPtr &msg)
+{
+    if ((int)msg->position.size() != joint_number) {
+        ROS_WARN_THROTTLE(1.0, "Streaming controller : setpoint with %d positions ignored (%d joints)",
+                (int)msg->position.size(), joint_number);
+        return;
+    }
+
+    if (msg->name.empty()) {
+        std::copy(msg->position.begin(), msg->position.end(), incoming_buffer.begin());
+    }
+    else {
+        for (int i = 0; i < joint_number; i++) {
+            std::vector<std::string>::const_iterator it =
+                std::find(msg->name.begin(), msg->name.end(), joint_names[i]);
+            if (it == msg->name.end()) {
+                ROS_WARN_THROTTLE(1.0, "Streaming controller : setpoint without %s ignored", joint_names[i].c_str());
+                return;
+            }
+            incoming_buffer[i] = msg->position[it - msg->name.begin()];
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(incoming_mutex);
+    if (!incoming.push(msg->header.stamp, incoming_buffer)) {
+        dropped_incoming_samples++;
+    }
+}
+
+} // namespace niryo_one_driver
+
+PLUGINLIB_EXPORT_CLASS(niryo_one_driver::StreamingJointPositionController, controller_interface::ControllerBase)
@@ -1,5 +1,5 @@
 /*
-    motor_offset_file_handler.h
+    motor_offset_file_handler.cpp
     Copyright (C) 2018 Niryo
     All rights reserved.
 
@@ -18,83 +18,97 @@
 */
 
 #include "niryo_one_driver/motor_offset_file_handler.h"
+#include "niryo_one_driver/persistent_store.h"
 
-#include "boost/filesystem.hpp"
 #include <iostream>
 #include <fstream>
 #include <exception>
 
-bool get_motors_calibration_offsets(std::vector<int> &motor_id_list,  std::vector<int> &steps_list)
+#define DEFAULT_CALIBRATION_OFFSETS_FILE "/home/niryo/niryo_one_saved_values/stepper_motor_calibration_offsets.bin"
+#define LEGACY_CALIBRATION_OFFSETS_FILE  "/home/niryo/niryo_one_saved_values/stepper_motor_calibration_offsets.txt"
+
+static std::string get_calibration_offsets_file_name()
+{
+    std::string file_name = DEFAULT_CALIBRATION_OFFSETS_FILE;
+    ros::param::get("~calibration_offsets_file", file_name);
+    return file_name;
+}
+
+/*
+ * Offsets saved by previous versions (one "id:steps" line per motor)
+ * Only used if no binary store is available, to avoid a new calibration after an update
+ */
+static bool read_legacy_calibration_offsets(std::vector<int> &motor_id_list,  std::vector<int> &steps_list)
 {
-    std::string file_name = "/home/niryo/niryo_one_saved_values/stepper_motor_calibration_offsets.txt"; // Todo rosparam
-    std::vector<std::string> lines;
+    std::string file_name = LEGACY_CALIBRATION_OFFSETS_FILE;
     std::string current_line;
-    
+    int line_number = 0;
+
     std::ifstream offset_file(file_name.c_str());
-    if (offset_file.is_open()) {
-        while (std::getline(offset_file, current_line)) {
-            try {
-                size_t index = current_line.find(":");
-                motor_id_list.push_back(stoi(current_line.substr(0, index)));
-                steps_list.push_back(stoi(current_line.erase(0, index + 1)));
-            }
-            catch (std::exception& e) {
-            
-            }
-        }
-        offset_file.close();
-    }
-    else {
-        ROS_WARN("Unable to open file : %s", file_name.c_str());
+    if (!offset_file.is_open()) {
         return false;
     }
-   
+
+    while (std::getline(offset_file, current_line)) {
+        line_number++;
+        size_t index = current_line.find(":");
+        if (index == std::string::npos) {
+            ROS_ERROR("Invalid line %d in %s : '%s'", line_number, file_name.c_str(), current_line.c_str());
+            return false;
+        }
+        try {
+            int motor_id = std::stoi(current_line.substr(0, index));
+            int steps = std::stoi(current_line.substr(index + 1));
+            motor_id_list.push_back(motor_id);
+            steps_list.push_back(steps);
+        }
+        catch (std::exception& e) {
+            ROS_ERROR("Invalid line %d in %s : '%s' (%s)", line_number, file_name.c_str(), current_line.c_str(), e.what());
+            motor_id_list.clear();
+            steps_list.clear();
+            return false;
+        }
+    }
+    offset_file.close();
     return true;
 }
 
-bool set_motors_calibration_offsets(std::vector<int> &motor_id_list, std::vector<int> &steps_list)
+bool get_motors_calibration_offsets(std::vector<int> &motor_id_list,  std::vector<int> &steps_list)
 {
-    if (motor_id_list.size() != steps_list.size()) {
-        return false;
+    PersistentStore store(get_calibration_offsets_file_name());
+
+    if (store.load()) {
+        store.getSection(PERSISTENT_STORE_SECTION_STEPPER_CALIBRATION_OFFSET, motor_id_list, steps_list);
+        return true;
     }
 
-    std::string file_name = "/home/niryo/niryo_one_saved_values/stepper_motor_calibration_offsets.txt"; // Todo rosparam
-    size_t found = file_name.find_last_of("/");
-    std::string folder_name = file_name.substr(0, found);
+    if (read_legacy_calibration_offsets(motor_id_list, steps_list)) {
+        ROS_INFO("Calibration offsets read from legacy file, converting to %s", store.getFileName().c_str());
+        set_motors_calibration_offsets(motor_id_list, steps_list);
+        return true;
+    }
 
-    boost::filesystem::path filepath(file_name);
-    boost::filesystem::path directory(folder_name);
+    ROS_WARN("Unable to read calibration offsets from : %s", store.getFileName().c_str());
+    return false;
+}
 
-    // Create dir if not exist
-    boost::system::error_code returned_error;
-    boost::filesystem::create_directories(directory, returned_error);
-    if (returned_error) {
-        ROS_WARN("Could not create directory : %s", folder_name.c_str()); 
+bool set_motors_calibration_offsets(std::vector<int> &motor_id_list, std::vector<int> &steps_list)
+{
+    if (motor_id_list.size() != steps_list.size()) {
         return false;
     }
 
-    // Create text to write
+    // keep other values saved in the store
+    PersistentStore store(get_calibration_offsets_file_name());
+    store.load();
+    store.clearSection(PERSISTENT_STORE_SECTION_STEPPER_CALIBRATION_OFFSET);
+
     std::string text_to_write = "";
     for (int i = 0; i < motor_id_list.size(); i++) {
-        text_to_write += std::to_string(motor_id_list.at(i));
-        text_to_write += ":"; 
-        text_to_write += std::to_string(steps_list.at(i));
-        if (i < motor_id_list.size() - 1) {
-            text_to_write += "\n";
-        }
+        store.setValue(PERSISTENT_STORE_SECTION_STEPPER_CALIBRATION_OFFSET, motor_id_list.at(i), steps_list.at(i));
+        text_to_write += "\n" + std::to_string(motor_id_list.at(i)) + ":" + std::to_string(steps_list.at(i));
     }
 
-    // Write to file
-    std::ofstream offset_file(file_name.c_str()); 
-    if (offset_file.is_open()) {
-        ROS_INFO("Writing calibration offsets to file : \n%s", text_to_write.c_str());
-        offset_file << text_to_write.c_str();
-        offset_file.close();
-    }
-    else {
-        ROS_WARN("Unable to open file : %s", file_name.c_str());
-        return false;
-    }
-
-    return true;
+    ROS_INFO("Writing calibration offsets to file : %s%s", store.getFileName().c_str(), text_to_write.c_str());
+    return store.save();
 }
@@ -0,0 +1,264 @@
+/*
+    persistent_store.cpp
+    Copyright (C) 2018 Niryo
+    All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "niryo_one_driver/persistent_store.h"
+
+#include <ros/ros.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "boost/filesystem.hpp"
+
+PersistentStore::PersistentStore(const std::string &file_name)
+{
+    this->file_name = file_name;
+}
+
+const std::string& PersistentStore::getFileName() const
+{
+    return file_name;
+}
+
+/*
+ * Load main file, or backup file if the main one is missing or corrupted
+ */
+bool PersistentStore::load()
+{
+    if (loadFile(file_name)) {
+        return true;
+    }
+
+    std::string backup_file_name = file_name + ".bak";
+    if (loadFile(backup_file_name)) {
+        ROS_WARN("Persistent store : using backup file %s", backup_file_name.c_str());
+        return true;
+    }
+
+    entries.clear();
+    return false;
+}
+
+bool PersistentStore::loadFile(const std::string &path)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || file_stat.st_size < (off_t)sizeof(Header)) {
+        ROS_WARN("Persistent store : file %s is too small", path.c_str());
+        close(fd);
+        return false;
+    }
+
+    size_t file_size = file_stat.st_size;
+    void *mapped = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        ROS_WARN("Persistent store : unable to map file %s", path.c_str());
+        return false;
+    }
+
+    const unsigned char *data = (const unsigned char*)mapped;
+    Header header;
+    memcpy(&header, data, sizeof(Header));
+
+    bool is_valid = true;
+    if (header.magic != PERSISTENT_STORE_MAGIC) {
+        ROS_WARN("Persistent store : bad magic number in %s", path.c_str());
+        is_valid = false;
+    }
+    else if (header.version != PERSISTENT_STORE_VERSION) {
+        ROS_WARN("Persistent store : unsupported version %d in %s", header.version, path.c_str());
+        is_valid = false;
+    }
+    else if (file_size != sizeof(Header) + header.entry_count * sizeof(Entry)) {
+        ROS_WARN("Persistent store : size mismatch in %s", path.c_str());
+        is_valid = false;
+    }
+    else if (computeCrc32(data + sizeof(Header), header.entry_count * sizeof(Entry)) != header.crc) {
+        ROS_WARN("Persistent store : checksum mismatch in %s", path.c_str());
+        is_valid = false;
+    }
+
+    if (is_valid) {
+        entries.resize(header.entry_count);
+        if (header.entry_count > 0) {
+            memcpy(&entries[0], data + sizeof(Header), header.entry_count * sizeof(Entry));
+        }
+    }
+
+    munmap(mapped, file_size);
+    return is_valid;
+}
+
+/*
+ * Write to <file>.tmp, then keep previous file as <file>.bak and rename tmp file
+ */
+bool PersistentStore::save()
+{
+    boost::filesystem::path directory = boost::filesystem::path(file_name).parent_path();
+
+    // Create dir if not exist
+    boost::system::error_code returned_error;
+    boost::filesystem::create_directories(directory, returned_error);
+    if (returned_error) {
+        ROS_WARN("Could not create directory : %s", directory.string().c_str());
+        return false;
+    }
+
+    std::string tmp_file_name = file_name + ".tmp";
+    if (!writeFile(tmp_file_name)) {
+        unlink(tmp_file_name.c_str());
+        return false;
+    }
+
+    std::string backup_file_name = file_name + ".bak";
+    if (access(file_name.c_str(), F_OK) == 0) {
+        if (rename(file_name.c_str(), backup_file_name.c_str()) != 0) {
+            ROS_WARN("Persistent store : unable to backup %s", file_name.c_str());
+        }
+    }
+
+    if (rename(tmp_file_name.c_str(), file_name.c_str()) != 0) {
+        ROS_WARN("Persistent store : unable to rename %s", tmp_file_name.c_str());
+        return false;
+    }
+
+    // make the renames durable
+    int dir_fd = open(directory.string().c_str(), O_RDONLY);
+    if (dir_fd >= 0) {
+        fsync(dir_fd);
+        close(dir_fd);
+    }
+    return true;
+}
+
+bool PersistentStore::writeFile(const std::string &path)
+{
+    Header header;
+    header.magic = PERSISTENT_STORE_MAGIC;
+    header.version = PERSISTENT_STORE_VERSION;
+    header.entry_count = entries.size();
+    header.crc = entries.empty() ? computeCrc32(NULL, 0) :
+        computeCrc32((const unsigned char*)&entries[0], entries.size() * sizeof(Entry));
+
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        ROS_WARN("Unable to open file : %s", path.c_str());
+        return false;
+    }
+
+    bool success = (write(fd, &header, sizeof(Header)) == (ssize_t)sizeof(Header));
+    if (success && !entries.empty()) {
+        ssize_t entries_size = entries.size() * sizeof(Entry);
+        success = (write(fd, &entries[0], entries_size) == entries_size);
+    }
+    if (success) {
+        success = (fsync(fd) == 0);
+    }
+    close(fd);
+
+    if (!success) {
+        ROS_WARN("Unable to write file : %s", path.c_str());
+    }
+    return success;
+}
+
+bool PersistentStore::getValue(uint16_t section, uint16_t id, int32_t &value) const
+{
+    for (int i = 0; i < entries.size(); i++) {
+        if (entries.at(i).section == section && entries.at(i).id == id) {
+            value = entries.at(i).value;
+            return true;
+        }
+    }
+    return false;
+}
+
+void PersistentStore::setValue(uint16_t section, uint16_t id, int32_t value)
+{
+    for (int i = 0; i < entries.size(); i++) {
+        if (entries.at(i).section == section && entries.at(i).id == id) {
+            entries.at(i).value = value;
+            return;
+        }
+    }
+
+    Entry entry;
+    entry.section = section;
+    entry.id = id;
+    entry.value = value;
+    entries.push_back(entry);
+}
+
+void PersistentStore::clearSection(uint16_t section)
+{
+    std::vector<Entry> kept_entries;
+    for (int i = 0; i < entries.size(); i++) {
+        if (entries.at(i).section != section) {
+            kept_entries.push_back(entries.at(i));
+        }
+    }
+    entries = kept_entries;
+}
+
+void PersistentStore::getSection(uint16_t section, std::vector<int> &id_list, std::vector<int> &value_list) const
+{
+    for (int i = 0; i < entries.size(); i++) {
+        if (entries.at(i).section == section) {
+            id_list.push_back(entries.at(i).id);
+            value_list.push_back(entries.at(i).value);
+        }
+    }
+}
+
+/*
+ * Standard CRC-32 (IEEE 802.3, reflected, polynomial 0xEDB88320)
+ */
+struct Crc32Table {
+    uint32_t values[256];
+
+    Crc32Table()
+    {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? (0xEDB88320 ^ (c >> 1)) : (c >> 1);
+            }
+            values[i] = c;
+        }
+    }
+};
+
+uint32_t PersistentStore::computeCrc32(const unsigned char *data, size_t length)
+{
+    static const Crc32Table table; // thread-safe initialization (C++11)
+
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc = table.values[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFF;
+}
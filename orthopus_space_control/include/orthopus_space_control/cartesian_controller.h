@@ -27,6 +27,7 @@
 #include "std_msgs/Int32.h"
 
 #include "orthopus_space_control/inverse_kinematic.h"
+#include "orthopus_space_control/kinematic_cache.h"
 #include "orthopus_space_control/joint_pose_manager.h"
 #include "orthopus_space_control/trajectory_controller.h"
 
@@ -43,6 +44,8 @@ namespace space_control
 class CartesianController
 {
 public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
   enum InputSelector
   {
     INPUT_TRAJECTORY = 0,
@@ -50,7 +53,18 @@ public:
   };
   typedef InputSelector InputSelectorType;
 
-  CartesianController(const int joint_number);
+  /**
+  * \brief Duration of the stages of the last run call (s)
+  */
+  struct StageDurations
+  {
+    double fk;
+    double trajectory; /*!< Trajectory controller, or copy of the user input when it is selected */
+    double ik;
+    double integrate;
+  };
+
+  CartesianController(const int joint_number, const ros::NodeHandle& nh_private);
   void init(double sampling_period, JointPoseManager& joint_pose_manager);
   void reset();
   void run(const JointPosition& q_current, JointPosition& q_command);
@@ -63,6 +77,14 @@ public:
 
   TrajectoryController* getTrajectoryController();
   InverseKinematic* getInverseKinematic();
+  InputSelectorType getInputSelector() const;
+  const SpacePosition& getXCurrent() const;
+  const SpaceVelocity& getDxDesiredSelected() const;
+  const StageDurations& getStageDurations() const;
+  /**
+  * \brief Number of reset calls since construction (see RunRecorder)
+  */
+  unsigned int getResetCount() const;
 
 protected:
 private:
@@ -76,6 +98,7 @@ private:
   ros::Publisher dx_desired_debug_pub_;
   ros::Publisher control_feedback_pub_;
 
+  KinematicCache kc_; /*!< Kinematic computed once per cycle and shared by fk_ and ik_ */
   TrajectoryController tc_;
   InverseKinematic ik_;
   ForwardKinematic fk_;
@@ -97,6 +120,8 @@ private:
   SpaceVelocity dx_desired_selected_;
 
   InputSelectorType input_selector_;
+  StageDurations stage_durations_;
+  unsigned int reset_count_;
 
   void publishDebugTopic_();
   void publishControlFeedbackTopic_();
@@ -0,0 +1,136 @@
+/*
+ *  collision_model.h
+ *  Copyright (C) 2019 Orthopus
+ *  All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CARTESIAN_CONTROLLER_COLLISION_MODEL_H
+#define CARTESIAN_CONTROLLER_COLLISION_MODEL_H
+
+#include <vector>
+
+// Eigen
+#include "Eigen/Dense"
+
+#include "orthopus_space_control/niryo_one_kinematic.h"
+
+namespace space_control
+{
+/**
+* \brief Segment swept by a sphere (a sphere if both ends are equal)
+*/
+struct CollisionCapsule
+{
+  Eigen::Vector3d a; /*!< First end of the segment */
+  Eigen::Vector3d b; /*!< Second end of the segment */
+  double radius;
+};
+
+/**
+* \brief Distance between two bodies of the collision model, expressed in base_link frame
+*/
+struct CollisionDistance
+{
+  int link_a;              /*!< Link of the first body (0 : base_link, i : child link of joint i) */
+  int link_b;              /*!< Link of the second body, -1 for the environment (table or obstacle) */
+  double distance;         /*!< Distance between the body surfaces (m), negative if they overlap */
+  Eigen::Vector3d point_a; /*!< Closest point on the segment of the first body */
+  Eigen::Vector3d point_b; /*!< Closest point on the segment (or plane) of the second body */
+  Eigen::Vector3d normal;  /*!< Unit vector from point_b to point_a */
+};
+
+/**
+* \brief Capsule distance engine of the Niryo One links
+*
+* Each link (base_link to hand_link) is enclosed in a capsule fitted offline on its collision mesh
+* (niryo_one_description/meshes/v1 and v2). The checked pairs are :
+*   - the self-collision pairs enabled in niryo_one_moveit_config/config/niryo_one.srdf (base_link and shoulder_link
+*     against forearm_link, wrist_link and hand_link),
+*   - every moving link against the sphere obstacles,
+*   - the links from arm_link against the table plane (z = table height).
+* The tool mounted on hand_link is not modeled.
+*
+* All capsule pairs are computed in one pass on fixed-size Eigen arrays (one coefficient per pair), so the segment
+* distance is evaluated without branches on SIMD packets of pairs. A cycle (update) costs about a microsecond, whatever
+* the robot configuration (see collision_benchmark).
+*
+* Capsules enclose the meshes : they are conservative, and overlap when the arm is folded on the shoulder (ex : rest
+* position).
+*/
+class NiryoOneCollisionModel
+{
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  static constexpr int LINK_NUMBER = 7;          /*!< base_link + child links of the 6 joints */
+  static constexpr int MAX_OBSTACLE_NUMBER = 4;  /*!< Sphere obstacles */
+  static constexpr int MAX_PAIR_NUMBER = 32;     /*!< Capsule pairs computed in one pass (multiple of SIMD width) */
+  static constexpr int TABLE_FIRST_LINK = 2;     /*!< First link checked against the table (arm_link) */
+
+  NiryoOneCollisionModel();
+  /**
+  * \brief Load the capsules of hardware_version (1 or 2) and set the environment
+  *
+  * obstacles holds the spheres as (x, y, z, radius) in base_link frame. Return false if the hardware version is
+  * unknown : no distance is computed then.
+  */
+  bool init(const int hardware_version, const double table_height, const std::vector<double>& obstacles);
+  bool isValid() const;
+  /**
+  * \brief Move the capsules to the link frames of state and compute the distance of all pairs
+  */
+  void update(const NiryoOneKinematicState& state);
+  /**
+  * \brief Get the count nearest pairs closer than activation_distance, sorted by increasing distance
+  * \return number of pairs written in nearest
+  */
+  int selectNearest(const int count, const double activation_distance, CollisionDistance* nearest) const;
+  double getMinimumDistance() const;
+  /**
+  * \brief Compute the distance jacobian of a pair (d distance / dt = jacobian * dq) at the configuration of state
+  */
+  void computeDistanceJacobian(const CollisionDistance& distance, const NiryoOneKinematicState& state,
+                               Eigen::Matrix<double, 1, 6>& jacobian) const;
+
+private:
+  typedef Eigen::Array<double, MAX_PAIR_NUMBER, 1> PairArray;
+
+  bool valid_;
+  double table_height_;
+  int pair_number_;                         /*!< Capsule pairs (self-collision, then obstacles) */
+  int pair_link_a_[MAX_PAIR_NUMBER];        /*!< First link of each pair */
+  int pair_link_b_[MAX_PAIR_NUMBER];        /*!< Second link of each pair, -1 for an obstacle */
+  CollisionCapsule capsule_[LINK_NUMBER];   /*!< Link capsules, in link frame */
+  CollisionCapsule world_[LINK_NUMBER];     /*!< Link capsules, in base_link frame */
+
+  /* Pair segments and results, one coefficient per pair (structure of arrays) */
+  PairArray ax0_, ay0_, az0_, ax1_, ay1_, az1_, radius_a_;
+  PairArray bx0_, by0_, bz0_, bx1_, by1_, bz1_, radius_b_;
+  PairArray s_;        /*!< Closest point parameter on segment a */
+  PairArray t_;        /*!< Closest point parameter on segment b */
+  PairArray distance_; /*!< Pair distance */
+  double table_distance_[LINK_NUMBER]; /*!< Link distance to the table (from TABLE_FIRST_LINK) */
+
+  void setPairSegment_(const int pair, const CollisionCapsule& capsule, const bool first);
+  void computePairDistances_();
+  /**
+  * \brief Fill distance with candidate i (pairs, then table distances)
+  */
+  void getDistance_(const int candidate, CollisionDistance& distance) const;
+  void addPointJacobian_(const int link, const Eigen::Vector3d& point, const Eigen::Vector3d& direction,
+                         const NiryoOneKinematicState& state, Eigen::Matrix<double, 1, 6>& jacobian) const;
+};
+}
+#endif
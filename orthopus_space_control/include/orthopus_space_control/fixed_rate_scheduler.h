@@ -0,0 +1,76 @@
+/*
+ *  fixed_rate_scheduler.h
+ *  Copyright (C) 2019 Orthopus
+ *  All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CARTESIAN_CONTROLLER_FIXED_RATE_SCHEDULER_H
+#define CARTESIAN_CONTROLLER_FIXED_RATE_SCHEDULER_H
+
+#include <chrono>
+#include <cstdint>
+
+namespace space_control
+{
+/**
+* \brief Periodic cycle timing with absolute deadlines
+*
+* Deadlines are start + k * period on the monotonic clock, so the computation time and the wake up latency of a cycle
+* do not shift the following ones (unlike sleeping for the remaining time). When a cycle overruns its deadline, the
+* deadlines already passed are skipped (no burst of late cycles) and counted.
+*/
+class FixedRateScheduler
+{
+public:
+  /**
+  * \brief Timing statistics (durations in seconds)
+  */
+  struct Statistics
+  {
+    uint64_t cycles;
+    uint64_t overruns;          /*!< Cycles whose computation ended after their deadline */
+    uint64_t missed_deadlines;  /*!< Deadlines skipped because of overruns */
+    double compute_time_mean;   /*!< From the wake up to the sleep() call */
+    double compute_time_max;
+    double wakeup_latency_mean; /*!< From the deadline to the actual wake up */
+    double wakeup_latency_max;
+  };
+
+  FixedRateScheduler();
+  /**
+  * \brief Start the first cycle now, with the given period (s)
+  */
+  void start(const double period);
+  /**
+  * \brief End the current cycle and sleep until the next deadline. Return false if the cycle overran.
+  */
+  bool sleep();
+  double getPeriod() const;
+  /**
+  * \brief Statistics since the last resetStatistics() call
+  */
+  const Statistics& getStatistics() const;
+  void resetStatistics();
+
+private:
+  typedef std::chrono::steady_clock Clock;
+
+  Clock::duration period_;
+  Clock::time_point deadline_;    /*!< End of the current cycle */
+  Clock::time_point cycle_start_; /*!< Wake up time of the current cycle */
+  Statistics statistics_;
+};
+}
+#endif
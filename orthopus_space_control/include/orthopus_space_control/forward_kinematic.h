@@ -21,14 +21,10 @@
 
 #include "ros/ros.h"
 
-// MoveIt!
-#include "moveit/robot_model/robot_model.h"
-#include "moveit/robot_model_loader/robot_model_loader.h"
-#include "moveit/robot_state/robot_state.h"
-
 #include "geometry_msgs/Pose.h"
 #include "sensor_msgs/JointState.h"
 
+#include "orthopus_space_control/kinematic_cache.h"
 #include "orthopus_space_control/types/joint_position.h"
 #include "orthopus_space_control/types/space_position.h"
 
@@ -37,25 +33,21 @@ namespace space_control
 class ForwardKinematic
 {
 public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
   ForwardKinematic(const int joint_number);
-  void init(const std::string end_effector_link);
-  void reset();
+  void init(KinematicCache& kinematic_cache);
   void resolveForwardKinematic();
   void setQCurrent(const JointPosition& q_current);
   void getXCurrent(SpacePosition& x_current);
 
 protected:
 private:
-  ros::NodeHandle n_;
-
-  bool init_flag_;
   int joint_number_;
 
-  std::string end_effector_link_;
   JointPosition q_current_;
   SpacePosition x_current_;
-  robot_model::RobotModelPtr kinematic_model_;
-  robot_state::RobotStatePtr kinematic_state_;
+  KinematicCache* kinematic_cache_; /*!< Kinematic shared with InverseKinematic */
 };
 }
 #endif
@@ -23,6 +23,7 @@
 
 #include "orthopus_space_control/fsm/state.h"
 #include "orthopus_space_control/fsm/transition.h"
+#include "orthopus_space_control/trace.h"
 
 namespace space_control
 {
@@ -34,7 +35,7 @@ public:
   {
     ROS_DEBUG("Construct FSM engine");
     obj_ = obj;
-    current_state_ == nullptr;
+    current_state_ = nullptr;
     if (obj_ == nullptr)
     {
       ROS_ERROR("Bad state machine context object !");
@@ -62,7 +63,6 @@ public:
       return;
     }
     bool found = false;
-    ROS_DEBUG("Looking for transition for the current state '%s'", current_state_->getName().c_str());
 
     for (int i = 0; i < transitions_.size(); i++)
     {
@@ -70,16 +70,17 @@ public:
       {
         break;
       }
-      std::vector<State<T>*> init_state = transitions_[i]->getInitialStates();
+      const std::vector<State<T>*>& init_state = transitions_[i]->getInitialStates();
       for (int j = 0; j < init_state.size(); j++)
       {
         if (init_state[j] == current_state_)
         {
-          ROS_DEBUG("Found transition to go from '%s' to '%s' state...", current_state_->getName().c_str(),
-                    transitions_[i]->getFinalState()->getName().c_str());
           if (transitions_[i]->isConditionFulfilled())
           {
-            ROS_ERROR("=> Condition is fulfil ! Go to '%s'", transitions_[i]->getFinalState()->getName().c_str());
+            /* Transitions are rare : they are still logged */
+            SPACE_CONTROL_TRACE(trace::Event::FsmTransition, i, 0.0);
+            ROS_INFO("FSM : go from '%s' to '%s' state", current_state_->getName().c_str(),
+                     transitions_[i]->getFinalState()->getName().c_str());
             current_state_->exit();
             current_state_ = transitions_[i]->getFinalState();
             current_state_->enter();
@@ -102,6 +103,21 @@ public:
     return current_state_;
   };
 
+  /**
+  * \brief Registration index of the current state, -1 if it is not registered
+  */
+  int getCurrentStateIndex() const
+  {
+    for (int i = 0; i < states_.size(); i++)
+    {
+      if (states_[i] == current_state_)
+      {
+        return i;
+      }
+    }
+    return -1;
+  };
+
 private:
   T* obj_;
   State<T>* current_state_;
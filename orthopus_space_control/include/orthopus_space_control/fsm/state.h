@@ -73,7 +73,7 @@ public:
       //       ROS_DEBUG("No UPDATE function for the state %s !", name_.c_str());
       return;
     }
-    ROS_DEBUG("Run update function of state '%s'...", name_.c_str());
+    /* Called at each control cycle : no logging here */
     (obj_->*update_ptr_)();
   };
 
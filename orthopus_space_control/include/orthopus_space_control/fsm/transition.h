@@ -69,7 +69,7 @@ public:
     return ((obj_->*condition_ptr_)());
   };
 
-  std::vector<State<T>*> getInitialStates()
+  const std::vector<State<T>*>& getInitialStates() const
   {
     return initial_states_;
   };
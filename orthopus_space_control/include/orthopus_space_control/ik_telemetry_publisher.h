@@ -0,0 +1,64 @@
+/*
+ *  ik_telemetry_publisher.h
+ *  Copyright (C) 2019 Orthopus
+ *  All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CARTESIAN_CONTROLLER_IK_TELEMETRY_PUBLISHER_H
+#define CARTESIAN_CONTROLLER_IK_TELEMETRY_PUBLISHER_H
+
+#include <atomic>
+#include <thread>
+
+#include "ros/ros.h"
+
+#include "orthopus_space_control/IkSolveStats.h"
+#include "orthopus_space_control/inverse_kinematic.h"
+
+namespace space_control
+{
+/**
+* \brief Publish IK solve statistics out of the control loop
+*
+* A dedicated thread reads the InverseKinematic telemetry ring at a low rate, aggregates the records read and
+* publishes them as an IkSolveStats message. The control loop only pays for a copy in the ring.
+*/
+class IkTelemetryPublisher
+{
+public:
+  IkTelemetryPublisher();
+  ~IkTelemetryPublisher();
+  /**
+  * \brief Start the publisher thread. Nothing is started if rate is lower or equal to zero.
+  */
+  void start(const ros::Publisher& publisher, IkTelemetryRing& ring, const double rate);
+  void stop();
+
+protected:
+private:
+  ros::Publisher publisher_;
+  IkTelemetryRing* ring_;
+  double rate_;
+  std::atomic<bool> running_;
+  std::thread thread_;
+
+  void run_();
+  /**
+  * \brief Read all available records into msg. Return false if there was none.
+  */
+  bool aggregate_(orthopus_space_control::IkSolveStats& msg);
+};
+}
+#endif
@@ -19,17 +19,21 @@
 #ifndef CARTESIAN_CONTROLLER_INVERSE_KINEMATIC_H
 #define CARTESIAN_CONTROLLER_INVERSE_KINEMATIC_H
 
+#include <array>
+
 #include "ros/ros.h"
 
+#include "orthopus_space_control/collision_model.h"
+#include "orthopus_space_control/kinematic_cache.h"
+#include "orthopus_space_control/mpc_qp_solver.h"
+#include "orthopus_space_control/qp_sequence_recorder.h"
+#include "orthopus_space_control/small_qp_solver.h"
+#include "orthopus_space_control/telemetry_ring.h"
 #include "orthopus_space_control/types/joint_position.h"
 #include "orthopus_space_control/types/joint_velocity.h"
 #include "orthopus_space_control/types/space_position.h"
 #include "orthopus_space_control/types/space_velocity.h"
-
-// MoveIt!
-#include "moveit/robot_model/robot_model.h"
-#include "moveit/robot_model_loader/robot_model_loader.h"
-#include "moveit/robot_state/robot_state.h"
+#include "orthopus_space_control/velocity_integrator.h"
 
 // QPOASES
 #include "qpOASES.hpp"
@@ -42,27 +46,121 @@ typedef Eigen::MatrixXd MatrixXd;
 
 namespace space_control
 {
+/* Dimensions of the IK problem, known at compile time so that no matrix is allocated during a solve */
+static constexpr int IK_JOINT_NUMBER = 6;       /*!< Niryo One joints */
+static constexpr int IK_SPACE_DIMENSION = 7;    /*!< position + quaternion */
+static constexpr int IK_COLLISION_CONSTRAINT_NUMBER = 4; /*!< Nearest collision pairs constrained at each solve */
+/* Constraints : joint position (6) + space position (3) + orientation (3) + collision */
+static constexpr int IK_CONSTRAINT_NUMBER = 12 + IK_COLLISION_CONSTRAINT_NUMBER;
+/* Constraint patterns : one bit per locked space axis (position xyz, orientation xyz) */
+static constexpr int IK_CONSTRAINT_PATTERN_NUMBER = 1 << 6;
+
+/* qpOASES expects row major matrices */
+typedef Eigen::Matrix<double, IK_SPACE_DIMENSION, IK_JOINT_NUMBER> IkJacobian;
+typedef Eigen::Matrix<double, IK_JOINT_NUMBER, IK_JOINT_NUMBER, Eigen::RowMajor> IkHessian;
+typedef Eigen::Matrix<double, IK_JOINT_NUMBER, 1> IkGradient;
+typedef Eigen::Matrix<double, IK_CONSTRAINT_NUMBER, IK_JOINT_NUMBER, Eigen::RowMajor> IkConstraintMatrix;
+typedef Eigen::Matrix<double, IK_CONSTRAINT_NUMBER, 1> IkConstraintVector;
+typedef SmallQpSolver<IK_JOINT_NUMBER, IK_CONSTRAINT_NUMBER> IkSmallQpSolver;
+typedef MpcQpSolver<IK_JOINT_NUMBER, IK_CONSTRAINT_NUMBER> IkMpcQpSolver;
+typedef QpSequenceRecorder<IK_JOINT_NUMBER, IK_CONSTRAINT_NUMBER> IkQpSequenceRecorder;
+
+/**
+* \brief qpOASES working set (active bounds and constraints) saved for a constraint pattern
+*/
+struct IkWorkingSet
+{
+  IkWorkingSet() : valid(false)
+  {
+    /* Sized once, so that saving a working set reuses this memory */
+    bounds.init(IK_JOINT_NUMBER);
+    constraints.init(IK_CONSTRAINT_NUMBER);
+  }
+
+  bool valid; /*!< A working set was saved for this pattern */
+  qpOASES::Bounds bounds;
+  qpOASES::Constraints constraints;
+};
+
+/**
+* \brief Telemetry record of one IK solve
+*/
+struct IkSolveReport
+{
+  double stamp;           /*!< Wall time of the solve (s) */
+  bool qpoases;           /*!< True if solved by qpOASES, false if solved by the small QP solver */
+  bool success;           /*!< True if the QP solution is used */
+  int status;             /*!< Solver return code (qpOASES returnValue or IkSmallQpSolver::Status) */
+  int iterations;         /*!< Active set changes (small_qp) or working set recalculations (qpOASES) */
+  int active_constraints; /*!< Active bounds and constraints of the solution */
+  double cpu_time;        /*!< Solve duration (s) */
+  double objective;       /*!< 1/2*x'Hx + x'g of the applied solution */
+  double primal_residual; /*!< Largest bound or constraint violation of the solution */
+  double dual_residual;   /*!< Largest KKT stationarity residual (small_qp only) */
+  bool budget_exceeded;   /*!< True if the solve was stopped by the CPU time budget */
+  bool fallback_used;     /*!< True if the previous solution was applied instead (see ik_qp_budget_fallback) */
+};
+
+static constexpr std::size_t IK_TELEMETRY_RING_SIZE = 512; /*!< Solves kept until the telemetry consumer reads them */
+typedef TelemetryRing<IkSolveReport, IK_TELEMETRY_RING_SIZE> IkTelemetryRing;
+
 /**
 * \brief Compute inverse kinematic
 *
-* This class computes inverse kinematic based on quadratic programming (QP). It relies on MoveIt RobotState and
-* RobotModel to compute jacobian and qpOASES project (https://projects.coin-or.org/qpOASES/) to solve the QP
+* This class computes inverse kinematic based on quadratic programming (QP). It relies on the KinematicCache shared
+* with ForwardKinematic to get the jacobian and qpOASES project (https://projects.coin-or.org/qpOASES/) to solve the QP
 * optimization problem of the following form :
 *     min   1/2*x'Hx + x'g
 *     s.t.  lb  <=  x <= ub
 *           lbA <= Ax <= ubA
+*
+* The QP is solved either by qpOASES (default) or by SmallQpSolver (bounded worst-case solve time), depending on the
+* ik_qp_solver parameter.
+*
+* With ik_mpc_horizon > 1, the QP is extended to a horizon of several sampling periods (see MpcQpSolver, solved by
+* qpOASES whatever ik_qp_solver) : joint and space limits are then respected at every step of the horizon, and joint
+* accelerations are bounded by ik_mpc_joint_max_acc, so the robot slows down before reaching a limit. Only the first
+* step is applied.
+*
+* Each solve can be bounded by a CPU time budget (ik_qp_cpu_time_budget, qpOASES cputime argument). When the budget is
+* exceeded, the robot is either stopped for the cycle or keeps the previous solution if it still satisfies the current
+* bounds and constraints (ik_qp_budget_fallback). A telemetry record of every solve is pushed in a lock-free ring, read
+* by IkTelemetryPublisher.
+*
+* The IK_COLLISION_CONSTRAINT_NUMBER nearest collision pairs of NiryoOneCollisionModel (self-collision, table and
+* obstacles) closer than ik_collision_activation_distance are added as linearized distance constraints (see
+* setCollisionConstraints_).
+*
+* In the single-step QP, the joint velocity bounds lb and ub are tightened at each cycle around the joint velocity
+* applied at the previous cycle, so that joint accelerations and jerks stay below ik_joint_max_acc and
+* ik_joint_max_jerk (see setJointDynamicBounds_) : input steps of the devices are ramped instead of being sent as
+* velocity steps to the steppers.
+*
+* Problem dimensions are fixed (see IK_JOINT_NUMBER, IK_SPACE_DIMENSION and IK_CONSTRAINT_NUMBER) : all QP
+* matrices are members, so a solve does not allocate memory on the heap (except inside qpOASES).
+*
+* The QP of every single-step solve can be recorded in a QP sequence file (ik_qp_dump_file), to be replayed offline by
+* the qp_sequence_benchmark of qpoases_ros.
 */
 class InverseKinematic
 {
 public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
   enum class ControlFrame
   {
     World,
     Tool
   };
 
-  InverseKinematic(const int joint_number);
-  void init(const std::string end_effector_link, const double sampling_period);
+  enum class BudgetFallback
+  {
+    Stop,        /*!< Zero joint velocity */
+    HoldPrevious /*!< Previous solution if it is still feasible, zero joint velocity otherwise */
+  };
+
+  InverseKinematic(const int joint_number, const ros::NodeHandle& nh_private);
+  void init(KinematicCache& kinematic_cache, const double sampling_period);
   void reset();
   void resolveInverseKinematic(JointVelocity& dq_computed, const SpaceVelocity& dx_desired);
   void setQCurrent(const JointPosition& q_current);
@@ -71,6 +169,12 @@ public:
   void setOrientationControlFrame(const ControlFrame frame);
   const ControlFrame& getPositionControlFrame() const;
   const ControlFrame& getOrientationControlFrame() const;
+  const IkSolveReport& getLastSolveReport() const;
+  IkTelemetryRing& getTelemetryRing();
+  /**
+  * \brief Number of reset calls since construction (see RunRecorder)
+  */
+  unsigned int getResetCount() const;
 
 protected:
 private:
@@ -78,23 +182,23 @@ private:
   int joint_number_;
   int space_dimension_;
   double sampling_period_;
-  bool qp_init_required_; /*!< Flag to track the first iteration of QP solver */
-  bool jacobian_init_flag_;
+  bool qp_init_required_;         /*!< Flag to init space constraints snapshots at the first iteration */
+  bool qp_revalidation_required_; /*!< Flag to check the qpOASES working set again after a reset */
+  unsigned int constraint_pattern_;    /*!< Bit mask of the locked space axes (position xyz, orientation xyz) */
+  unsigned int qp_constraint_pattern_; /*!< Constraint pattern of the last qpOASES solve */
+  unsigned int reset_count_;           /*!< Number of reset calls */
 
   ControlFrame position_ctrl_frame_;
   ControlFrame orientation_ctrl_frame_;
 
-  Eigen::Quaterniond jacobian_quat_prev_;  // TODO used
   std::vector<double> gamma_weight_vec;
 
   JointPosition q_current_;  /*!< Current joint position */
   SpacePosition x_current_;  /*!< Current space position */
-  VectorXd x_current_eigen_; /*!< Copy of x_current in eigen format (use in matrix computation) */
-  VectorXd x_des;            /*!< TODO */
+  Vector7d x_current_eigen_; /*!< Copy of x_current in eigen format (use in matrix computation) */
 
   bool reset_axis[7];
   bool reset_axis2[7];
-  std::string end_effector_link_;
 
   Eigen::Vector3d pos_snap;
   double eps_inf_pos[3];
@@ -110,17 +214,55 @@ private:
   double x_min_limit[7]; /*!< Space min limit used in lower constraints bound vector lbA */
   double x_max_limit[7]; /*!< Space max limit used in upper constraints bound vector ubA */
 
-  MatrixXd alpha_weight_;   /*!< Diagonal matrix which contains weight for space velocity minimization */
-  MatrixXd beta_weight_;    /*!< Diagonal matrix which contains weight for joint velocity minimization */
-  MatrixXd gamma_weight_;   /*!< Diagonal matrix which contains weight for space position minimization */
-  MatrixXd delta_weight_;   /*!< TODO */
-  MatrixXd epsilon_weight_; /*!< TODO */
+  Eigen::Matrix<double, IK_SPACE_DIMENSION, IK_SPACE_DIMENSION>
+      alpha_weight_; /*!< Diagonal matrix which contains weight for space velocity minimization */
+  IkHessian beta_weight_; /*!< Diagonal matrix which contains weight for joint velocity minimization */
 
-  qpOASES::SQProblem* QP_; /*!< QP solver instance pointer */
+  /* QP data, preallocated and updated at each solve */
+  IkJacobian jacobian_;       /*!< Jacobian in quaternion representation */
+  IkHessian hessian_;         /*!< Hessian matrix H */
+  IkGradient g_;              /*!< Gradient vector g */
+  IkConstraintMatrix A_;      /*!< Constraint matrix A */
+  IkConstraintVector lbA_;    /*!< Lower constraints bound vector */
+  IkConstraintVector ubA_;    /*!< Upper constraints bound vector */
+  IkGradient x_opt_;          /*!< Solution of the QP */
+  IkGradient x_prev_;         /*!< Last solution applied, used by BudgetFallback::HoldPrevious */
+  bool x_prev_valid_;         /*!< False until a solution is applied after a reset */
+  IkGradient dq_applied_;     /*!< Joint velocity applied at the last cycle (solution or zero) */
+  bool dq_applied_valid_;     /*!< False until a joint velocity is applied after a reset */
+  IkGradient ddq_applied_;    /*!< Joint acceleration of the last cycle (zero after a reset) */
 
-  robot_model::RobotModelPtr kinematic_model_;      /*!< MoveIt RobotModel pointer */
-  robot_state::RobotStatePtr kinematic_state_;      /*!< MoveIt RobotState pointer */
-  robot_state::JointModelGroup* joint_model_group_; /*!< MoveIt JointModelGroup pointer */
+  IkGradient dq_max_;           /*!< Joint velocity limit */
+  double joint_max_acc_;        /*!< Joint acceleration limit (rad/s^2), 0 if disabled */
+  double joint_max_jerk_;       /*!< Joint jerk limit (rad/s^3), 0 if disabled */
+  bool dq_bounds_tightened_;    /*!< lb and ub of the last QP are tighter than the joint velocity limit */
+  VelocityIntegrator::Mode integration_mode_; /*!< Integration of the joint velocity into the joint command */
+
+  bool use_qpoases_;           /*!< Use qpOASES instead of the small QP solver */
+  qpOASES::SQProblem QP_;      /*!< qpOASES solver instance, kept (with its working set) across resets */
+  std::array<IkWorkingSet, IK_CONSTRAINT_PATTERN_NUMBER> working_set_cache_; /*!< Working sets by constraint pattern */
+  IkSmallQpSolver small_qp_;   /*!< Small QP solver instance */
+  int mpc_horizon_;            /*!< Number of steps of the MPC horizon, 1 for the single-step QP */
+  double mpc_max_acc_;         /*!< Joint acceleration limit of the MPC (rad/s^2), 0 if disabled */
+  double mpc_smoothing_;       /*!< Weight of the joint velocity changes in the MPC objective */
+  int mpc_max_iterations_;     /*!< Working set recalculations per MPC solve */
+  IkMpcQpSolver mpc_qp_;       /*!< MPC solver instance, allocated by init */
+  IkSolveReport solve_report_; /*!< Statistics of the last solve */
+  IkTelemetryRing telemetry_;  /*!< Records of all solves, read by the telemetry publisher thread */
+  double cpu_time_budget_;     /*!< Solve time budget (s), 0 if disabled */
+  BudgetFallback budget_fallback_;
+
+  KinematicCache* kinematic_cache_; /*!< Kinematic shared with ForwardKinematic */
+
+  bool collision_avoidance_;                /*!< Add the collision constraints to the QP */
+  double collision_activation_distance_;    /*!< Pairs farther than this distance (m) are not constrained */
+  double collision_safety_distance_;        /*!< Distance (m) kept between the bodies */
+  double collision_gain_;                   /*!< Fraction of the remaining margin which may be covered in one period */
+  double collision_table_height_;           /*!< Table plane height in base_link frame (m) */
+  std::vector<double> collision_obstacles_; /*!< Sphere obstacles (x, y, z, radius) in base_link frame */
+  NiryoOneCollisionModel collision_model_;
+  CollisionDistance collision_nearest_[IK_COLLISION_CONSTRAINT_NUMBER]; /*!< Constrained pairs of the last solve */
+  IkQpSequenceRecorder qp_recorder_; /*!< Writes the solved QPs in the ik_qp_dump_file, if enabled */
 
   Eigen::Quaterniond quat_des;
   bool flag_save[3];
@@ -133,22 +275,35 @@ private:
   void setAlphaWeight_(const std::vector<double>& alpha_weight);
   void setBetaWeight_(const std::vector<double>& beta_weight);
   void setDqBounds_(const JointVelocity& dq_bound);
+  /**
+  * \brief Fill the collision rows of A_, lbA_ and ubA_ at the current configuration
+  */
+  void setCollisionConstraints_();
+  /**
+  * \brief Fill lb and ub from the joint velocity, acceleration and jerk limits, and adapt the constraints to the
+  * integration mode (the QP rows are written for an euler integration)
+  */
+  void setJointDynamicBounds_();
+  bool solveQp_();
+  bool solveSmallQp_();
+  bool solveQpOases_();
+  bool solveMpcQp_();
+  /**
+  * \brief Apply budget_fallback_ after a solve stopped by the CPU time budget. Return true if x_opt_ can be used.
+  */
+  bool applyBudgetFallback_();
 
   /**
-  * \brief Compute jacobian
-  *
-  * This is an updated version of MoveIt (RobotState class) implementation with quaternion discontinuity handling.
+  * \brief Convert the angular part of a geometric jacobian (rows 3 to 5) into quaternion representation (rows 3 to 6)
   */
-  bool getJacobian_(const robot_state::RobotStatePtr kinematic_state, const robot_state::JointModelGroup* group,
-                    const robot_state::LinkModel* link, const Eigen::Vector3d& reference_point_position,
-                    Eigen::MatrixXd& jacobian, bool use_quaternion_representation);
+  void setQuaternionJacobian_(const Eigen::Quaterniond& orientation, IkJacobian& jacobian);
 
   Eigen::Matrix4d xR(Eigen::Quaterniond& quat);
   Eigen::Matrix4d Rx(Eigen::Quaterniond& quat);
 
   Eigen::Quaterniond r_snap;
   Eigen::Quaterniond r_snap_cong;
-  Eigen::MatrixXd Rs_cong;
+  Eigen::Matrix4d Rs_cong;
 };
 }
 #endif
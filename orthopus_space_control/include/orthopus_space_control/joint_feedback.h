@@ -0,0 +1,111 @@
+/*
+ *  joint_feedback.h
+ *  Copyright (C) 2019 Orthopus
+ *  All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CARTESIAN_CONTROLLER_JOINT_FEEDBACK_H
+#define CARTESIAN_CONTROLLER_JOINT_FEEDBACK_H
+
+#include <vector>
+
+#include "ros/ros.h"
+
+#include "orthopus_space_control/types/joint_position.h"
+
+namespace space_control
+{
+/**
+* \brief Joint position measured by the driver, with the time of the measurement
+*/
+struct MeasuredJointPosition
+{
+  explicit MeasuredJointPosition(const int joint_number) : position(joint_number)
+  {
+  }
+
+  JointPosition position;
+  ros::Time stamp;
+};
+
+/**
+* \brief Select the joint position used as the starting point of each space control cycle
+*
+* In open loop mode (default), the last command is used : the robot is assumed to follow it exactly.
+*
+* In closed loop mode, the command is corrected with the measured joint position :
+*     q_current = q_command + gain * (q_meas(t) - q_command(t))
+* where t is the joint state timestamp. Comparing the measure with the command sent at the same time compensates the
+* measurement latency : the motion commanded since t is not seen as an error. Commands are kept in a short history to
+* find q_command(t).
+*
+* When the error of a joint exceeds the resynchronization threshold (missed steps, collision...), the measured
+* position is used as is and the caller must restart from it.
+*/
+class JointFeedback
+{
+public:
+  enum class Mode
+  {
+    OpenLoop,
+    ClosedLoop
+  };
+
+  enum class Result
+  {
+    Command,   /*!< q_current is the command (open loop, or no usable measure) */
+    Corrected, /*!< q_current is the command corrected with the measure */
+    Resync     /*!< Drift bound exceeded : q_current is the measure */
+  };
+
+  JointFeedback(const int joint_number, const ros::NodeHandle& nh_private);
+  /**
+  * \brief Forget the command history (ex : when the command restarts from the measured position)
+  */
+  void reset();
+  /**
+  * \brief Record the command sent at stamp
+  */
+  void addCommand(const JointPosition& q_command, const ros::Time& stamp);
+  Result update(const JointPosition& q_command, const MeasuredJointPosition& q_meas, const ros::Time& now,
+                JointPosition& q_current);
+
+  Mode getMode() const;
+  unsigned int getResyncCount() const;
+
+protected:
+private:
+  static constexpr int HISTORY_SIZE = 64; /*!< Commands kept to compensate the measurement latency */
+
+  int joint_number_;
+  Mode mode_;
+  double gain_;             /*!< Weight of the measure (0 : open loop, 1 : measure only) */
+  double max_latency_;      /*!< Older measures are ignored (s) */
+  double resync_threshold_; /*!< Joint error which triggers a resynchronization (rad) */
+  unsigned int resync_count_;
+
+  std::vector<JointPosition> history_; /*!< Ring of the last commands */
+  std::vector<ros::Time> history_stamp_;
+  int history_next_;  /*!< Next slot written */
+  int history_count_; /*!< Valid commands in the ring */
+  JointPosition q_command_at_meas_;
+
+  /**
+  * \brief Command at stamp, linearly interpolated in the history. Return false if stamp is not covered.
+  */
+  bool commandAt_(const ros::Time& stamp, JointPosition& q_command) const;
+};
+}
+#endif
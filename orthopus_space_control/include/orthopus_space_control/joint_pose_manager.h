@@ -33,7 +33,7 @@ namespace space_control
 class JointPoseManager
 {
 public:
-  JointPoseManager(const int joint_number);
+  JointPoseManager(const int joint_number, const ros::NodeHandle& nh_private);
   const JointPosition getJointPosition(const std::string position_name);
   bool setJointPosition(const std::string position_name, const JointPosition q_pose_to_record);
   bool updateJointPosition(const std::string position_name, const JointPosition q_pose_to_record);
@@ -0,0 +1,96 @@
+/*
+ *  kinematic_cache.h
+ *  Copyright (C) 2019 Orthopus
+ *  All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CARTESIAN_CONTROLLER_KINEMATIC_CACHE_H
+#define CARTESIAN_CONTROLLER_KINEMATIC_CACHE_H
+
+#include "ros/ros.h"
+
+// MoveIt!
+#include "moveit/robot_model/robot_model.h"
+#include "moveit/robot_model_loader/robot_model_loader.h"
+#include "moveit/robot_state/robot_state.h"
+
+// Eigen
+#include "Eigen/Dense"
+
+#include "orthopus_space_control/niryo_one_kinematic.h"
+#include "orthopus_space_control/types/joint_position.h"
+
+namespace space_control
+{
+/**
+* \brief End effector kinematic shared by ForwardKinematic and InverseKinematic
+*
+* Pose and geometric jacobian of the end effector are computed once for a given joint position (closed-form Niryo One
+* kinematic when validated, MoveIt otherwise) and served to both FK and IK. They are only recomputed when the joint
+* position changes.
+*
+* The quaternion sign continuity (q and -q are the same rotation) is also handled here, so that FK and IK see the same
+* quaternion.
+*/
+class KinematicCache
+{
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  KinematicCache(const int joint_number);
+  void init(const std::string end_effector_link);
+  /**
+  * \brief Invalidate the cache and restart quaternion continuity tracking
+  */
+  void reset();
+  /**
+  * \brief Compute pose and jacobian for q, unless q is the joint position of the last computation
+  */
+  void update(const JointPosition& q);
+
+  const Eigen::Vector3d& getPosition() const;
+  const Eigen::Matrix3d& getRotation() const;
+  const Eigen::Quaterniond& getOrientation() const;
+  const Eigen::Matrix<double, 6, 6>& getJacobian() const;
+  /**
+  * \brief Full kinematic state (link frames included), without quaternion sign continuity
+  */
+  const NiryoOneKinematicState& getState() const;
+  int getHardwareVersion() const;
+
+protected:
+private:
+  int joint_number_;
+  std::string end_effector_link_;
+
+  bool cache_valid_;           /*!< False if the cached values does not match q_cached_ */
+  bool continuity_init_flag_;  /*!< True until the first quaternion is computed */
+  JointPosition q_cached_;     /*!< Joint position of the cached values */
+
+  NiryoOneKinematicState state_; /*!< Cached pose and geometric jacobian */
+  Eigen::Quaterniond orientation_; /*!< Cached orientation, with sign continuity */
+
+  NiryoOneKinematic niryo_one_kinematic_;           /*!< Closed-form kinematic, used instead of MoveIt once validated */
+  robot_model::RobotModelPtr kinematic_model_;      /*!< MoveIt RobotModel pointer */
+  robot_state::RobotStatePtr kinematic_state_;      /*!< MoveIt RobotState pointer */
+  const robot_state::JointModelGroup* joint_model_group_; /*!< MoveIt JointModelGroup pointer */
+  const robot_state::LinkModel* end_effector_link_model_;
+  std::vector<const robot_state::LinkModel*> joint_child_link_models_; /*!< Child link of each joint of the arm */
+  Eigen::MatrixXd moveit_jacobian_;
+
+  void computeMoveIt_();
+};
+}
+#endif
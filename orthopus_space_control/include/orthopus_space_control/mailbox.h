@@ -0,0 +1,79 @@
+/*
+ *  mailbox.h
+ *  Copyright (C) 2019 Orthopus
+ *  All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CARTESIAN_CONTROLLER_MAILBOX_H
+#define CARTESIAN_CONTROLLER_MAILBOX_H
+
+#include <mutex>
+
+namespace space_control
+{
+/**
+* \brief Latest-value mailbox between a callback thread and the control loop
+*
+* The writer replaces the value, the reader copies the latest one : older values are never queued. The lock is only
+* held during a copy, so neither side waits for the other's processing.
+*/
+template <class T>
+class Mailbox
+{
+public:
+  explicit Mailbox(const T& initial_value) : value_(initial_value), written_(false), fresh_(false)
+  {
+  }
+
+  void write(const T& value)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    value_ = value;
+    written_ = true;
+    fresh_ = true;
+  }
+
+  /**
+  * \brief Copy the latest value. Return false (value is unchanged) if nothing was written yet.
+  */
+  bool read(T& value)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!written_)
+    {
+      return false;
+    }
+    value = value_;
+    fresh_ = false;
+    return true;
+  }
+
+  /**
+  * \brief True if a value was written since the last read
+  */
+  bool isFresh()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return fresh_;
+  }
+
+private:
+  std::mutex mutex_;
+  T value_;
+  bool written_;
+  bool fresh_;
+};
+}
+#endif
@@ -0,0 +1,432 @@
+/*
+ *  mpc_qp_solver.h
+ *  Copyright (C) 2019 Orthopus
+ *  All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CARTESIAN_CONTROLLER_MPC_QP_SOLVER_H
+#define CARTESIAN_CONTROLLER_MPC_QP_SOLVER_H
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+// QPOASES
+#include "qpOASES.hpp"
+
+// Eigen
+#include "Eigen/Dense"
+
+namespace space_control
+{
+/**
+* \brief Multi-step (model predictive) version of a single-step velocity QP
+*
+* Extends a QP on the N joint velocities of one sampling period T :
+*     min   1/2*dq'H dq + dq'g
+*     s.t.  lb  <=  dq <= ub
+*           lbA <= A dq <= ubA
+* where A maps a joint velocity applied during T to a displacement (lbA and ubA being the remaining distances to the
+* position limits), to a horizon of K steps. H, g and A are frozen over the horizon. The QP is condensed : the
+* variables are the joint velocities of all steps z = [dq_0; ...; dq_K-1], positions are sums of velocities :
+*     min   sum_k ( 1/2*dq_k'H dq_k + dq_k'g + 1/2*rho*||dq_k - dq_k-1||^2 )
+*     s.t.  lb  <=  dq_k <= ub
+*           -acc_max*T <= dq_k - dq_k-1 <= acc_max*T
+*           lbA <= A (dq_0 + ... + dq_k) <= ubA
+* with dq_-1 the joint velocity applied at the previous cycle (if known). Every step of the horizon stays inside the
+* position limits, so with bounded accelerations the robot slows down before reaching a limit instead of stopping
+* on it.
+*
+* Rows declared with setDamperRow are velocity dampers instead of position limits : lbA = -gain*margin bounds the
+* change of a distance over one period. Each step may then cover the same fraction of the margin left by the steps
+* before, so at step k the cumulative change is bounded by (1 - (1 - gain)^(k+1))*margin. The first step keeps the
+* single-step meaning of the row.
+*
+* With setTrapezoidalIntegration, the joint command follows the mean of two consecutive velocities. The single-step
+* rows are then expected for this integration (A/2, bounds shifted by A/2*dq_-1, see InverseKinematic) : the position
+* of step k becomes A/2 (2*dq_0 + ... + 2*dq_k-1 + dq_k).
+*
+* If the acceleration limit of the first step makes the QP infeasible, it is solved again without it.
+*
+* Only dq_0 is applied. The next solve starts from the previous solution and working set shifted by one step (qpOASES
+* init with a guessed working set), and from scratch if this warm start fails.
+*
+* The QP has K*N variables and K*(N+M) constraints, allocated once by configure. A solve costs about K^3 times a
+* single-step solve : the horizon and the working set recalculation limit set the anticipation/latency trade-off.
+*/
+template <int N, int M>
+class MpcQpSolver
+{
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  typedef Eigen::Matrix<double, N, 1> VectorN;
+  typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMajorMatrixX;
+  typedef Eigen::Matrix<double, Eigen::Dynamic, 1> VectorX;
+
+  static constexpr int STAGE_CONSTRAINT_NUMBER = N + M; /*!< Acceleration (N) and position (M) constraints per step */
+
+  /**
+  * \brief Statistics of the last solve
+  */
+  struct Report
+  {
+    int status;             /*!< qpOASES returnValue */
+    int iterations;         /*!< Working set recalculations (warm start and cold start) */
+    int active_constraints; /*!< Active bounds and constraints of the horizon solution */
+    double cpu_time;        /*!< Solve duration (s) */
+    double primal_residual; /*!< Largest constraint violation of the horizon solution */
+    bool warm_started;      /*!< True if the solution was found from the shifted previous solution */
+    bool relaxed;           /*!< True if the acceleration limit of the first step was dropped to find a solution */
+    bool budget_exceeded;   /*!< True if the solve was stopped by the CPU time budget */
+  };
+
+  MpcQpSolver()
+    : horizon_(0)
+    , period_(0.0)
+    , acceleration_max_(0.0)
+    , smoothing_weight_(0.0)
+    , max_working_set_recalculations_(0)
+    , trapezoidal_(false)
+    , plan_valid_(false)
+  {
+    report_ = Report();
+    damper_gain_.setZero();
+  }
+
+  /**
+  * \brief Allocate the QP of a horizon of horizon steps of period seconds
+  *
+  * acceleration_max (rad/s^2) bounds the joint velocity change between two steps (0 to disable), smoothing_weight
+  * (rho) penalizes it. max_working_set_recalculations bounds the qpOASES iterations of each solve.
+  */
+  void configure(const int horizon, const double period, const double acceleration_max,
+                 const double smoothing_weight, const int max_working_set_recalculations)
+  {
+    horizon_ = std::max(horizon, 1);
+    period_ = period;
+    acceleration_max_ = acceleration_max;
+    smoothing_weight_ = smoothing_weight;
+    max_working_set_recalculations_ = std::max(max_working_set_recalculations, 1);
+
+    const int nv = N * horizon_;
+    const int nc = STAGE_CONSTRAINT_NUMBER * horizon_;
+    H_.setZero(nv, nv);
+    g_.setZero(nv);
+    A_.setZero(nc, nv);
+    lb_.setZero(nv);
+    ub_.setZero(nv);
+    lbA_.setZero(nc);
+    ubA_.setZero(nc);
+    z_.setZero(nv);
+    z_guess_.setZero(nv);
+
+    /* Acceleration rows of step k : dq_k - dq_k-1 */
+    for (int k = 0; k < horizon_; k++)
+    {
+      for (int i = 0; i < N; i++)
+      {
+        A_(k * STAGE_CONSTRAINT_NUMBER + i, k * N + i) = 1.0;
+        if (k > 0)
+        {
+          A_(k * STAGE_CONSTRAINT_NUMBER + i, (k - 1) * N + i) = -1.0;
+        }
+      }
+    }
+
+    qp_.reset(new qpOASES::QProblem(nv, nc));
+    qpOASES::Options options;
+    options.setToMPC();
+    options.printLevel = qpOASES::PL_NONE;
+    qp_->setOptions(options);
+    plan_valid_ = false;
+  }
+
+  /**
+  * \brief Declare the constraint row as a velocity damper of gain (in ]0, 1]), or as a position row if gain is 0
+  */
+  void setDamperRow(const int row, const double gain)
+  {
+    damper_gain_(row) = gain;
+  }
+
+  /**
+  * \brief Expect the rows of a trapezoidal velocity integration (see VelocityIntegrator)
+  */
+  void setTrapezoidalIntegration(const bool trapezoidal)
+  {
+    trapezoidal_ = trapezoidal;
+  }
+
+  int getHorizon() const
+  {
+    return horizon_;
+  }
+
+  /**
+  * \brief Forget the previous solution (the next solve is a cold start)
+  */
+  void reset()
+  {
+    plan_valid_ = false;
+  }
+
+  const Report& getReport() const
+  {
+    return report_;
+  }
+
+  /**
+  * \brief Get the second step of the last solution, i.e. the velocity planned for the current cycle. Return false if
+  * there is no solution since the last reset.
+  */
+  bool getNextPlannedStep(VectorN& dq) const
+  {
+    if (!plan_valid_)
+    {
+      return false;
+    }
+    dq = z_.template segment<N>(horizon_ > 1 ? N : 0);
+    return true;
+  }
+
+  /**
+  * \brief Solve the horizon QP and return its first step in dq
+  *
+  * dq_previous is the joint velocity applied at the previous cycle (nullptr if unknown : the first step is then not
+  * constrained by the acceleration limit). cpu_time_budget (s) stops the solve when it is exceeded (0 to disable).
+  * Return true if dq is the solution.
+  */
+  template <class DerivedH, class DerivedA>
+  bool solve(const Eigen::MatrixBase<DerivedH>& H, const VectorN& g, const Eigen::MatrixBase<DerivedA>& A,
+             const double* lb, const double* ub, const double* lbA, const double* ubA, const VectorN* dq_previous,
+             const double cpu_time_budget, VectorN& dq)
+  {
+    setupQp_(H, g, A, lb, ub, lbA, ubA, dq_previous, dq_previous);
+
+    const double budget = (cpu_time_budget > 0.0) ? cpu_time_budget : qpOASES::INFTY;
+    qpOASES::int_t nwsr = max_working_set_recalculations_;
+    qpOASES::real_t cputime = budget;
+    qpOASES::returnValue qp_return = qpOASES::RET_INIT_FAILED;
+    int iterations = 0;
+    double cpu_time = 0.0;
+
+    report_.warm_started = plan_valid_;
+    if (plan_valid_)
+    {
+      /* The shifted working set is only factorized, the homotopy then starts close to the solution */
+      shiftPlan_();
+      qp_return = qp_->init(H_.data(), g_.data(), A_.data(), lb_.data(), ub_.data(), lbA_.data(), ubA_.data(), nwsr,
+                            &cputime, z_guess_.data(), 0, &guess_bounds_, &guess_constraints_);
+      iterations += nwsr;
+      cpu_time += cputime;
+    }
+    if (!plan_valid_ || (qp_return != qpOASES::SUCCESSFUL_RETURN && qp_return != qpOASES::RET_MAX_NWSR_REACHED))
+    {
+      /* First solve, or the shifted working set is not valid anymore : cold start within the remaining budget */
+      report_.warm_started = false;
+      nwsr = max_working_set_recalculations_;
+      cputime = std::max(budget - cpu_time, 0.0);
+      qp_return = qp_->init(H_.data(), g_.data(), A_.data(), lb_.data(), ub_.data(), lbA_.data(), ubA_.data(), nwsr,
+                            &cputime);
+      iterations += nwsr;
+      cpu_time += cputime;
+    }
+    report_.relaxed = false;
+    if (qp_return == qpOASES::RET_INIT_FAILED_INFEASIBILITY && dq_previous != nullptr && acceleration_max_ > 0.0)
+    {
+      /* The limits can not be reached without exceeding the acceleration limit (ex : they moved) : braking harder is
+       * safer than stopping the robot at once */
+      report_.relaxed = true;
+      setupQp_(H, g, A, lb, ub, lbA, ubA, nullptr, dq_previous);
+      nwsr = max_working_set_recalculations_;
+      cputime = std::max(budget - cpu_time, 0.0);
+      qp_return = qp_->init(H_.data(), g_.data(), A_.data(), lb_.data(), ub_.data(), lbA_.data(), ubA_.data(), nwsr,
+                            &cputime);
+      iterations += nwsr;
+      cpu_time += cputime;
+    }
+
+    report_.status = qp_return;
+    report_.iterations = iterations;
+    report_.cpu_time = cpu_time;
+    report_.primal_residual = 0.0;
+    report_.active_constraints = qp_->getNFX() + qp_->getNAC();
+    /* When the time limit stops qpOASES, it returns RET_MAX_NWSR_REACHED before using all its recalculations */
+    report_.budget_exceeded = (qp_return == qpOASES::RET_MAX_NWSR_REACHED && cpu_time_budget > 0.0 &&
+                               nwsr < max_working_set_recalculations_);
+
+    if (qp_return != qpOASES::SUCCESSFUL_RETURN)
+    {
+      /* The previous solution is kept for getNextPlannedStep, unless the QP could not be solved at all */
+      plan_valid_ = plan_valid_ && report_.budget_exceeded;
+      return false;
+    }
+
+    qp_->getPrimalSolution(z_.data());
+    qp_->getBounds(bounds_);
+    qp_->getConstraints(constraints_);
+    plan_valid_ = true;
+
+    VectorX az = A_ * z_;
+    for (int i = 0; i < A_.rows(); i++)
+    {
+      report_.primal_residual = std::max(report_.primal_residual, std::max(lbA_(i) - az(i), az(i) - ubA_(i)));
+    }
+
+    dq = z_.template head<N>();
+    return true;
+  }
+
+private:
+  int horizon_;
+  double period_;
+  double acceleration_max_;
+  double smoothing_weight_;
+  int max_working_set_recalculations_;
+  Eigen::Matrix<double, M, 1> damper_gain_; /*!< Gain of the velocity damper rows, 0 for position rows */
+  bool trapezoidal_;                        /*!< Rows are written for a trapezoidal velocity integration */
+
+  /* Horizon QP data (row major, as expected by qpOASES) */
+  RowMajorMatrixX H_;
+  VectorX g_;
+  RowMajorMatrixX A_;
+  VectorX lb_;
+  VectorX ub_;
+  VectorX lbA_;
+  VectorX ubA_;
+
+  VectorX z_;       /*!< Last solution */
+  VectorX z_guess_; /*!< Last solution shifted by one step */
+  bool plan_valid_; /*!< True if z_, bounds_ and constraints_ hold a solution */
+
+  std::unique_ptr<qpOASES::QProblem> qp_;
+  qpOASES::Bounds bounds_;                 /*!< Working set of the last solution */
+  qpOASES::Constraints constraints_;       /*!< Working set of the last solution */
+  qpOASES::Bounds guess_bounds_;           /*!< Shifted working set */
+  qpOASES::Constraints guess_constraints_; /*!< Shifted working set */
+
+  Report report_;
+
+  /**
+  * \brief Fill the horizon QP. The acceleration of the first step is limited around dq_previous (if not nullptr),
+  * dq_integrated is the previous joint velocity used by the trapezoidal integration (zero if nullptr).
+  */
+  template <class DerivedH, class DerivedA>
+  void setupQp_(const Eigen::MatrixBase<DerivedH>& H, const VectorN& g, const Eigen::MatrixBase<DerivedA>& A,
+                const double* lb, const double* ub, const double* lbA, const double* ubA, const VectorN* dq_previous,
+                const VectorN* dq_integrated)
+  {
+    const double rho = smoothing_weight_;
+    const double dq_step = acceleration_max_ * period_;
+    /* Part of the row bounds due to the previous joint velocity (trapezoidal integration), not damped */
+    Eigen::Matrix<double, M, 1> previous_motion = Eigen::Matrix<double, M, 1>::Zero();
+    if (trapezoidal_ && dq_integrated != nullptr)
+    {
+      previous_motion.noalias() = A * (*dq_integrated);
+    }
+
+    for (int k = 0; k < horizon_; k++)
+    {
+      /* Stage cost, plus the velocity change terms (k-1, k) and (k, k+1) which involve dq_k */
+      const int change_terms = ((k > 0 || dq_previous != nullptr) ? 1 : 0) + ((k < horizon_ - 1) ? 1 : 0);
+      H_.template block<N, N>(k * N, k * N) = H;
+      H_.template block<N, N>(k * N, k * N).diagonal().array() += rho * change_terms;
+      if (k > 0)
+      {
+        H_.template block<N, N>(k * N, (k - 1) * N).diagonal().setConstant(-rho);
+        H_.template block<N, N>((k - 1) * N, k * N).diagonal().setConstant(-rho);
+      }
+      g_.template segment<N>(k * N) = g;
+
+      const int row = k * STAGE_CONSTRAINT_NUMBER;
+      for (int i = 0; i < N; i++)
+      {
+        lb_(k * N + i) = lb[i];
+        ub_(k * N + i) = ub[i];
+
+        if (acceleration_max_ <= 0.0 || (k == 0 && dq_previous == nullptr))
+        {
+          lbA_(row + i) = -qpOASES::INFTY;
+          ubA_(row + i) = qpOASES::INFTY;
+        }
+        else
+        {
+          const double dq_reference = (k == 0) ? (*dq_previous)(i) : 0.0;
+          lbA_(row + i) = dq_reference - dq_step;
+          ubA_(row + i) = dq_reference + dq_step;
+        }
+      }
+
+      /* Position of step k : A (dq_0 + ... + dq_k), or A (2*dq_0 + ... + 2*dq_k-1 + dq_k) if trapezoidal */
+      for (int l = 0; l <= k; l++)
+      {
+        A_.template block<M, N>(row + N, l * N) = (trapezoidal_ && l < k) ? (2.0 * A).eval() : A.eval();
+      }
+      for (int j = 0; j < M; j++)
+      {
+        /* Fraction of the one period bound a damper row allows over k + 1 steps */
+        const double gain = damper_gain_(j);
+        const double scale = (gain > 0.0) ? (1.0 - std::pow(1.0 - gain, k + 1)) / gain : 1.0;
+        lbA_(row + N + j) =
+            (lbA[j] > -qpOASES::INFTY) ? scale * (lbA[j] + previous_motion(j)) - previous_motion(j) : lbA[j];
+        ubA_(row + N + j) =
+            (ubA[j] < qpOASES::INFTY) ? scale * (ubA[j] + previous_motion(j)) - previous_motion(j) : ubA[j];
+      }
+    }
+
+    if (dq_previous != nullptr)
+    {
+      g_.template head<N>() -= rho * (*dq_previous);
+    }
+  }
+
+  /**
+  * \brief Shift the last solution and its working set by one step (the last step is repeated, without its active
+  * constraints)
+  */
+  void shiftPlan_()
+  {
+    const int nv = N * horizon_;
+    const int nc = STAGE_CONSTRAINT_NUMBER * horizon_;
+    guess_bounds_.init(nv);
+    guess_constraints_.init(nc);
+
+    for (int k = 0; k < horizon_; k++)
+    {
+      const int from = std::min(k + 1, horizon_ - 1);
+      z_guess_.template segment<N>(k * N) = z_.template segment<N>(from * N);
+      for (int i = 0; i < N; i++)
+      {
+        guess_bounds_.setupBound(k * N + i, bounds_.getStatus(from * N + i));
+      }
+      for (int i = 0; i < STAGE_CONSTRAINT_NUMBER; i++)
+      {
+        const int row = k * STAGE_CONSTRAINT_NUMBER + i;
+        qpOASES::SubjectToStatus status = constraints_.getStatus(from * STAGE_CONSTRAINT_NUMBER + i);
+        /* Rows of the repeated last step would duplicate those of the step before, and unbounded rows (acceleration
+         * of the first step when the previous velocity is unknown) can not be active */
+        if (k == from || (status == qpOASES::ST_LOWER && lbA_(row) <= -qpOASES::INFTY) ||
+            (status == qpOASES::ST_UPPER && ubA_(row) >= qpOASES::INFTY))
+        {
+          status = qpOASES::ST_INACTIVE;
+        }
+        guess_constraints_.setupConstraint(row, status);
+      }
+    }
+  }
+};
+}
+#endif
@@ -0,0 +1,195 @@
+/*
+ *  niryo_one_kinematic.h
+ *  Copyright (C) 2019 Orthopus
+ *  All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CARTESIAN_CONTROLLER_NIRYO_ONE_KINEMATIC_H
+#define CARTESIAN_CONTROLLER_NIRYO_ONE_KINEMATIC_H
+
+#include "ros/ros.h"
+
+// MoveIt!
+#include "moveit/robot_model/robot_model.h"
+
+// Eigen
+#include "Eigen/Dense"
+#include "Eigen/Geometry"
+
+namespace space_control
+{
+/**
+* \brief Niryo One V1 geometry (niryo_one_description/urdf/v1/niryo_one.urdf.xacro)
+*/
+struct NiryoOneGeometryV1
+{
+  static constexpr double distance_origin_shoulder_z = 0.103;
+  static constexpr double distance_shoulder_arm_z = 0.08;
+  static constexpr double distance_arm_elbow_x = 0.21004;
+  static constexpr double distance_arm_elbow_y = 0.0;
+  static constexpr double distance_elbow_forearm_x = 0.037;
+  static constexpr double distance_elbow_forearm_y = 0.032;
+  static constexpr double distance_forearm_wrist_z = 0.180;
+  static constexpr double distance_wrist_hand_x = 0.018;
+  static constexpr double distance_wrist_hand_y = 0.0;
+  static constexpr double distance_hand_tool = 0.0;
+};
+
+/**
+* \brief Niryo One V2 geometry (niryo_one_description/urdf/v2/niryo_one.urdf.xacro)
+*/
+struct NiryoOneGeometryV2
+{
+  static constexpr double distance_origin_shoulder_z = 0.103;
+  static constexpr double distance_shoulder_arm_z = 0.080;
+  static constexpr double distance_arm_elbow_x = 0.210;
+  static constexpr double distance_arm_elbow_y = 0.0;
+  static constexpr double distance_elbow_forearm_x = 0.0415;
+  static constexpr double distance_elbow_forearm_y = 0.030;
+  static constexpr double distance_forearm_wrist_z = 0.180;
+  static constexpr double distance_wrist_hand_x = 0.0164;
+  static constexpr double distance_wrist_hand_y = -0.0055;
+  static constexpr double distance_hand_tool = 0.0073;
+};
+
+/**
+* \brief Result of the Niryo One kinematic kernel, expressed in base_link frame
+*/
+struct NiryoOneKinematicState
+{
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  Eigen::Vector3d position;                /*!< tool_link position */
+  Eigen::Matrix3d rotation;                /*!< tool_link orientation */
+  Eigen::Quaterniond orientation;          /*!< tool_link orientation (no sign continuity handling) */
+  Eigen::Matrix<double, 6, 6> jacobian;    /*!< Geometric jacobian : linear velocity (rows 0-2), angular (rows 3-5) */
+  Eigen::Vector3d link_position[6];        /*!< Child link origin of each joint (shoulder_link to hand_link) */
+  Eigen::Matrix3d link_rotation[6];        /*!< Child link orientation of each joint (shoulder_link to hand_link) */
+};
+
+/**
+* \brief Closed-form forward kinematic and jacobian of the Niryo One chain (base_link -> tool_link)
+*
+* Every joint of the Niryo One is a revolute joint around its local z axis, and fixed origins only use rotations of
+* +/- PI/2. The chain is thus unrolled here with the URDF constants of the Geometry parameter, and the pose, the
+* quaternion and the jacobian are all computed in one pass, without walking the generic MoveIt link tree.
+*/
+template <class Geometry>
+class NiryoOneKinematicKernel
+{
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  NiryoOneKinematicKernel()
+  {
+    /* PI value used by the URDF xacro files, kept to match the MoveIt model bit for bit */
+    const double pi = 3.14159265359;
+    origin_rotation_[0] = rpy(0.0, 0.0, 0.0);
+    origin_rotation_[1] = rpy(pi / 2, -pi / 2, 0.0);
+    origin_rotation_[2] = rpy(0.0, 0.0, -pi / 2);
+    origin_rotation_[3] = rpy(0.0, pi / 2, 0.0);
+    origin_rotation_[4] = rpy(0.0, -pi / 2, 0.0);
+    origin_rotation_[5] = rpy(0.0, pi / 2, 0.0);
+    tool_rotation_ = rpy(-pi / 2, -pi / 2, 0.0);
+
+    origin_translation_[0] = Eigen::Vector3d(0.0, 0.0, Geometry::distance_origin_shoulder_z);
+    origin_translation_[1] = Eigen::Vector3d(0.0, 0.0, Geometry::distance_shoulder_arm_z);
+    origin_translation_[2] = Eigen::Vector3d(Geometry::distance_arm_elbow_x, Geometry::distance_arm_elbow_y, 0.0);
+    origin_translation_[3] =
+        Eigen::Vector3d(Geometry::distance_elbow_forearm_x, Geometry::distance_elbow_forearm_y, 0.0);
+    origin_translation_[4] = Eigen::Vector3d(0.0, 0.0, Geometry::distance_forearm_wrist_z);
+    origin_translation_[5] = Eigen::Vector3d(Geometry::distance_wrist_hand_x, Geometry::distance_wrist_hand_y, 0.0);
+    tool_translation_ = Eigen::Vector3d(0.0, 0.0, Geometry::distance_hand_tool);
+  }
+
+  void compute(const double* q, NiryoOneKinematicState& state) const
+  {
+    Eigen::Matrix3d rotation = Eigen::Matrix3d::Identity();
+    Eigen::Vector3d position = Eigen::Vector3d::Zero();
+
+    for (int i = 0; i < 6; i++)
+    {
+      /* Fixed origin of the joint */
+      position += rotation * origin_translation_[i];
+      rotation = rotation * origin_rotation_[i];
+      state.link_position[i] = position;
+      /* Joint axis is the local z axis, which is not modified by the joint rotation */
+      state.jacobian.block<3, 1>(3, i) = rotation.col(2);
+      /* Joint rotation around z : only the x and y columns change */
+      const double c = cos(q[i]), s = sin(q[i]);
+      const Eigen::Vector3d x_axis = rotation.col(0);
+      rotation.col(0) = c * x_axis + s * rotation.col(1);
+      rotation.col(1) = c * rotation.col(1) - s * x_axis;
+      state.link_rotation[i] = rotation;
+    }
+    /* Fixed tool frame */
+    state.position = position + rotation * tool_translation_;
+    state.rotation = rotation * tool_rotation_;
+    state.orientation = Eigen::Quaterniond(state.rotation);
+
+    for (int i = 0; i < 6; i++)
+    {
+      state.jacobian.block<3, 1>(0, i) =
+          state.jacobian.block<3, 1>(3, i).cross(state.position - state.link_position[i]);
+    }
+  }
+
+private:
+  Eigen::Matrix3d origin_rotation_[6];
+  Eigen::Vector3d origin_translation_[6];
+  Eigen::Matrix3d tool_rotation_;
+  Eigen::Vector3d tool_translation_;
+
+  /* Same convention as URDF : R = Rz(yaw) * Ry(pitch) * Rx(roll) */
+  static Eigen::Matrix3d rpy(const double roll, const double pitch, const double yaw)
+  {
+    return (Eigen::AngleAxisd(yaw, Eigen::Vector3d::UnitZ()) * Eigen::AngleAxisd(pitch, Eigen::Vector3d::UnitY()) *
+            Eigen::AngleAxisd(roll, Eigen::Vector3d::UnitX()))
+        .toRotationMatrix();
+  }
+};
+
+/**
+* \brief Niryo One kinematic, selecting the V1 or V2 kernel
+*
+* The kernel matching /niryo_one/hardware_version is checked against the MoveIt robot model loaded from
+* robot_description (see validate()). If the loaded URDF does not match the built-in geometry, isValid() returns false
+* and callers must keep using MoveIt.
+*/
+class NiryoOneKinematic
+{
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  static constexpr double VALIDATION_TOLERANCE = 1e-9;
+
+  NiryoOneKinematic();
+  /**
+  * \brief Compare the kernel with MoveIt on the joint limits and random configurations
+  * \return true if pose, quaternion, link frames and jacobian errors are below VALIDATION_TOLERANCE
+  */
+  bool validate(const robot_model::RobotModelConstPtr& kinematic_model, const std::string& end_effector_link);
+  bool isValid() const;
+  int getHardwareVersion() const;
+  void compute(const std::vector<double>& q, NiryoOneKinematicState& state) const;
+
+private:
+  int hardware_version_;
+  bool valid_;
+  NiryoOneKinematicKernel<NiryoOneGeometryV1> kernel_v1_;
+  NiryoOneKinematicKernel<NiryoOneGeometryV2> kernel_v2_;
+};
+}
+#endif
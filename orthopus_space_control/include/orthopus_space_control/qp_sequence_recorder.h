@@ -0,0 +1,188 @@
+/*
+ *  qp_sequence_recorder.h
+ *  Copyright (C) 2019 Orthopus
+ *  All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CARTESIAN_CONTROLLER_QP_SEQUENCE_RECORDER_H
+#define CARTESIAN_CONTROLLER_QP_SEQUENCE_RECORDER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "ros/ros.h"
+
+// QPOASES
+#include "qpOASES.hpp"
+
+#include "orthopus_space_control/telemetry_ring.h"
+
+namespace space_control
+{
+/**
+* \brief Write the QPs of a solver in a QP sequence file (see qpOASES/extras/QPSequence.hpp) out of the control loop
+*
+* Like RunRecorder, the control loop only copies the QP data in a lock-free ring (QPs are dropped when it is full), a
+* writer thread appends the QPs read to the file. Matrices are row major, as given to qpOASES.
+*/
+template <int N, int M>
+class QpSequenceRecorder
+{
+public:
+  static constexpr std::size_t RING_SIZE = 256; /*!< QPs kept until the writer thread reads them */
+
+  QpSequenceRecorder() : file_(nullptr), running_(false)
+  {
+  }
+
+  ~QpSequenceRecorder()
+  {
+    close();
+  }
+
+  /**
+  * \brief Create the file, write its header and start the writer thread. Return false if the file is not written.
+  */
+  bool open(const std::string& file_name)
+  {
+    close();
+    file_ = std::fopen(file_name.c_str(), "wb");
+    if (file_ == nullptr)
+    {
+      return false;
+    }
+    if (qpOASES::writeQPSequenceHeader(file_, N, M) != qpOASES::SUCCESSFUL_RETURN)
+    {
+      std::fclose(file_);
+      file_ = nullptr;
+      return false;
+    }
+    ring_.reset(new Ring());
+    running_ = true;
+    thread_ = std::thread(&QpSequenceRecorder::run_, this);
+    return true;
+  }
+
+  /**
+  * \brief Stop the writer thread, write the remaining QPs and close the file
+  */
+  void close()
+  {
+    running_ = false;
+    if (thread_.joinable())
+    {
+      thread_.join();
+    }
+    if (file_ != nullptr)
+    {
+      if (!flush_())
+      {
+        ROS_ERROR("Could not write the last QPs of the QP sequence file");
+      }
+      std::fclose(file_);
+      file_ = nullptr;
+    }
+  }
+
+  bool isOpen() const
+  {
+    return file_ != nullptr;
+  }
+
+  /**
+  * \brief Record a QP (control loop side)
+  */
+  void push(const double* H, const double* g, const double* A, const double* lb, const double* ub, const double* lbA,
+            const double* ubA)
+  {
+    if (file_ == nullptr)
+    {
+      return;
+    }
+    std::copy(H, H + N * N, record_.H);
+    std::copy(g, g + N, record_.g);
+    std::copy(A, A + M * N, record_.A);
+    std::copy(lb, lb + N, record_.lb);
+    std::copy(ub, ub + N, record_.ub);
+    std::copy(lbA, lbA + M, record_.lbA);
+    std::copy(ubA, ubA + M, record_.ubA);
+    ring_->push(record_);
+  }
+
+  std::size_t getDropped() const
+  {
+    return ring_ ? ring_->getDropped() : 0;
+  }
+
+private:
+  struct Record
+  {
+    double H[N * N];
+    double g[N];
+    double A[M * N];
+    double lb[N];
+    double ub[N];
+    double lbA[M];
+    double ubA[M];
+  };
+  typedef TelemetryRing<Record, RING_SIZE> Ring;
+
+  FILE* file_;
+  std::unique_ptr<Ring> ring_;
+  Record record_; /*!< Control loop side copy, kept as member to stay off the stack */
+  Record written_; /*!< Writer thread side copy */
+  std::atomic<bool> running_;
+  std::thread thread_;
+
+  void run_()
+  {
+    /* QPs are written by blocks, the ring holds the QPs of a period at the highest control rate */
+    const std::chrono::milliseconds write_period(100);
+    while (running_)
+    {
+      std::this_thread::sleep_for(write_period);
+      if (!flush_())
+      {
+        /* QPs are dropped from now on, the ring is no more read */
+        ROS_ERROR("Could not write the QP sequence file, QPs are not recorded anymore");
+        return;
+      }
+    }
+  }
+
+  /**
+  * \brief Write all available QPs. Return false on write error.
+  */
+  bool flush_()
+  {
+    while (ring_->pop(written_))
+    {
+      if (qpOASES::writeQPSequenceRecord(file_, N, M, written_.H, written_.g, written_.A, written_.lb, written_.ub,
+                                         written_.lbA, written_.ubA) != qpOASES::SUCCESSFUL_RETURN)
+      {
+        return false;
+      }
+    }
+    return std::fflush(file_) == 0;
+  }
+};
+}
+#endif
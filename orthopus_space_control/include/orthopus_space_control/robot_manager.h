@@ -19,16 +19,25 @@
 #ifndef CARTESIAN_CONTROLLER_ROBOT_MANAGER_H
 #define CARTESIAN_CONTROLLER_ROBOT_MANAGER_H
 
+#include "ros/callback_queue.h"
 #include "ros/ros.h"
 
+#include <atomic>
+
 #include "orthopus_space_control/SetRobotAction.h"
 #include "orthopus_space_control/SetUInt16.h"
 #include "sensor_msgs/JointState.h"
 #include "std_msgs/UInt16.h"
 
+#include "orthopus_space_control/ControlLoopStats.h"
 #include "orthopus_space_control/cartesian_controller.h"
+#include "orthopus_space_control/fixed_rate_scheduler.h"
+#include "orthopus_space_control/ik_telemetry_publisher.h"
+#include "orthopus_space_control/joint_feedback.h"
 #include "orthopus_space_control/joint_pose_manager.h"
+#include "orthopus_space_control/mailbox.h"
 #include "orthopus_space_control/robot_manager_fsm.h"
+#include "orthopus_space_control/run_recorder.h"
 
 #include "orthopus_space_control/types/joint_position.h"
 #include "orthopus_space_control/types/space_velocity.h"
@@ -42,18 +51,38 @@ namespace space_control
 class RobotManager
 {
 public:
-  RobotManager(const int joint_number = 6, const bool debug = false);
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  RobotManager(const ros::NodeHandle& nh, const ros::NodeHandle& nh_private, const int joint_number = 6,
+               const bool debug = false);
   void init();
+  /**
+  * \brief Wait for the first joint state, then run the control loop until ROS shutdown or stop() call.
+  */
+  void run();
+  void stop();
 
 protected:
 private:
   ros::NodeHandle n_;
+  ros::NodeHandle n_private_;
+  ros::NodeHandle n_intake_;
+  /* Service callbacks are processed from the control loop thread only, either in a standalone node or in a nodelet */
+  ros::CallbackQueue callback_queue_;
+  /* Topic callbacks are processed by their own thread, and only write the latest values in mailboxes */
+  ros::CallbackQueue intake_queue_;
+  ros::AsyncSpinner intake_spinner_;
+  std::atomic<bool> running_;
+  FixedRateScheduler scheduler_; /*!< Control loop timing (absolute deadlines) */
   ros::Publisher command_pub_;
+  ros::Publisher streaming_command_pub_;
   ros::Publisher joystick_enabled_pub_;
   ros::Publisher q_current_debug_pub_;
   ros::Publisher x_current_debug_pub_;
   ros::Publisher dx_desired_debug_pub_;
   ros::Publisher control_feedback_pub_;
+  ros::Publisher ik_solve_stats_pub_;
+  ros::Publisher control_loop_stats_pub_;
   ros::Subscriber joints_sub_;
   ros::Subscriber dx_input_device_sub_;
   ros::Subscriber learning_mode_sub_;
@@ -61,16 +90,28 @@ private:
   ros::ServiceServer manage_position_service_;
   ros::ServiceServer get_position_list_service_;
   ros::ServiceServer set_control_frame_service_;
+  ros::ServiceClient switch_controller_client_;
 
   JointPoseManager joint_pose_manager_;
   CartesianController cartesian_controller_;
+  IkTelemetryPublisher ik_telemetry_publisher_;
+  RunRecorder run_recorder_;
 
   int sampling_freq_;
-  int learning_mode_;
+  std::atomic<int> learning_mode_; /*!< Written by the intake thread */
   int joint_number_;
   bool debug_;
   double sampling_period_;
+  bool streaming_command_; /*!< Space control commands are streamed instead of sent as trajectories */
+  std::atomic<bool> streaming_controller_requested_; /*!< Driver controller wanted by the FSM (control loop) */
+  std::atomic<bool> streaming_controller_active_; /*!< Driver controller switch acknowledged (intake thread) */
+  bool joint_position_sent_; /*!< The joint position trajectory of the JOINT POSITION state was sent */
   double joint_max_vel_;
+  double ik_telemetry_rate_; /*!< IK solve statistics publication rate (Hz), 0 to disable */
+  std::string trace_file_;   /*!< Control loop trace file, written at exit if tracing is compiled in */
+  std::string run_record_file_; /*!< CartesianController run recording (see RunRecorder), empty to disable */
+  double control_loop_stats_rate_; /*!< Control loop timing statistics publication rate (Hz), 0 to disable */
+  uint64_t overruns_total_;
   double space_position_max_vel_;
   double space_orientation_max_vel_;
   double goal_joint_tolerance_;
@@ -80,12 +121,17 @@ private:
   JointPosition q_command_;
   JointPosition q_current_;
   JointPosition q_meas_;
+  MeasuredJointPosition q_meas_intake_; /*!< Joint state conversion buffer of the intake thread */
+  MeasuredJointPosition q_meas_stamped_; /*!< Last joint state read by the control loop */
+  Mailbox<MeasuredJointPosition> q_meas_mailbox_;
+  JointFeedback joint_feedback_;
 
   SpacePosition x_drink_pose_;
   SpacePosition x_stand_pose_;
 
   SpaceVelocity dx_desired_;
   SpaceVelocity dx_desired_prev_;
+  Mailbox<SpaceVelocity> dx_desired_mailbox_;
 
   /* FSM engine */
   Engine<RobotManager>* engine_;
@@ -113,12 +159,15 @@ private:
   bool trSpacePositionToSpaceControl_();
 
   /* FSM functions */
+  void disableEnter_();
   void disableUpdate_();
+  void idleEnter_();
   void idleUpdate_();
   void spaceControlUpdate_();
   void spaceControlEnter_();
   void jointPositionExit_();
   void jointPositionEnter_();
+  void jointPositionUpdate_();
   void spacePositionUpdate_();
   void spacePositionEnter_();
 
@@ -128,6 +177,11 @@ private:
   void initializeServices_();
   void retrieveParameters_();
   void initializeStateMachine_();
+  void publishControlLoopStats_();
+  /**
+  * \brief Record the last CartesianController run if the run recorder is open
+  */
+  void recordRun_();
 
   /* FSM input event (what is allowed to do from user point of view) */
   FsmInputEvent input_event_requested_;
@@ -150,6 +204,25 @@ private:
   bool isPositionCompleted_(const JointPosition position) const;
   double computeDuration_(const JointPosition position) const;
   void sendJointsCommand_() const;
+  /**
+  * \brief Request the streaming controller (space control) or the trajectory controller (joint position, driver
+  * clients) in the driver. Does nothing in trajectory command mode.
+  *
+  * The switch is done by the intake thread (see switchControllers_), commands are streamed once it is acknowledged.
+  */
+  void selectStreamingController_(const bool streaming);
+  /**
+  * \brief Switch the driver controllers to the last requested one (intake thread, blocks for a driver cycle)
+  */
+  void switchControllers_();
+  /**
+  * \brief Read the latest joint state of the intake thread. Return false if none was received yet.
+  */
+  bool readJointState_();
+  /**
+  * \brief Compute q_current_ from the command and the measured joint state (see JointFeedback)
+  */
+  void updateJointFeedback_();
   bool isUserVelocityReceive() const;
 };
 }
@@ -0,0 +1,215 @@
+/*
+ *  run_recorder.h
+ *  Copyright (C) 2019 Orthopus
+ *  All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CARTESIAN_CONTROLLER_RUN_RECORDER_H
+#define CARTESIAN_CONTROLLER_RUN_RECORDER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "ros/ros.h"
+
+#include "orthopus_space_control/cartesian_controller.h"
+#include "orthopus_space_control/telemetry_ring.h"
+#include "orthopus_space_control/types/joint_position.h"
+#include "orthopus_space_control/types/space_velocity.h"
+
+/*
+ * CartesianController run recording
+ *
+ * Each CartesianController::run call of the control loop is recorded with its inputs (joint position, desired
+ * velocity, control frames, input selector, FSM state and the controller events since the previous call) and its
+ * outputs (command, forward kinematic, IK solve result, stage durations). Recordings are replayed offline by
+ * run_replay, which drives a CartesianController without ROS master and diffs its outputs against a recording.
+ *
+ * File layout (native byte order) :
+ *  - FileHeader
+ *  - parameter snapshot (XML-RPC value, see snapshotParameters), zero padded up to FileHeader::records_offset
+ *  - fixed-size Record array up to the end of the file
+ * records_offset is a multiple of RECORDS_ALIGNMENT : the record array can be used in place from a mapped file.
+ */
+namespace space_control
+{
+namespace run_record
+{
+static constexpr char FILE_MAGIC[8] = { 'O', 'S', 'C', 'R', 'U', 'N', 'R', 'C' };
+static constexpr uint32_t FILE_VERSION = 1;
+static constexpr std::size_t RECORDS_ALIGNMENT = 64;
+static constexpr int MAX_JOINT_NUMBER = 6; /*!< Joint arrays size of a record (Niryo One) */
+static constexpr int SPACE_DIMENSION = 7;  /*!< position + quaternion */
+static constexpr std::size_t RING_SIZE = 1024; /*!< Records kept until the writer thread reads them */
+
+/* Record::control_frame bits */
+static constexpr uint32_t POSITION_TOOL_FRAME = 0x01;
+static constexpr uint32_t ORIENTATION_TOOL_FRAME = 0x02;
+
+/* Record::ik_flags bits */
+static constexpr uint32_t IK_SUCCESS = 0x01;
+static constexpr uint32_t IK_FALLBACK_USED = 0x02;
+static constexpr uint32_t IK_BUDGET_EXCEEDED = 0x04;
+static constexpr uint32_t IK_QPOASES = 0x08;
+
+struct FileHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t record_size;      /*!< sizeof(Record) */
+  uint32_t records_offset;   /*!< Offset of the first record in the file */
+  uint32_t parameters_size;  /*!< Size of the parameter snapshot, following the header */
+  uint32_t joint_number;
+  uint32_t reserved;
+  double sampling_period;    /*!< Control loop period (s) */
+};
+
+/**
+* \brief One CartesianController::run call, written as is in run recordings
+*
+* Controller events are counted since the controller construction. Events since the previous record happened before
+* the run call, in this order : CartesianController::reset, InverseKinematic::reset, TrajectoryController::setXGoal.
+*/
+struct Record
+{
+  uint64_t cycle;               /*!< Record sequence number, a gap means records were dropped */
+  double stamp;                 /*!< Monotonic clock (s) */
+  int32_t fsm_state;            /*!< RobotManager FSM state index */
+  int32_t input_selector;       /*!< CartesianController::InputSelector */
+  uint32_t control_frame;       /*!< POSITION_TOOL_FRAME and ORIENTATION_TOOL_FRAME bits */
+  uint32_t reset_count;         /*!< CartesianController::reset calls */
+  uint32_t ik_reset_count;      /*!< InverseKinematic::reset calls, CartesianController::reset ones included */
+  uint32_t goal_count;          /*!< TrajectoryController::setXGoal calls */
+  double q_current[MAX_JOINT_NUMBER];
+  double dx_desired[SPACE_DIMENSION];
+  double x_goal[SPACE_DIMENSION]; /*!< Trajectory goal of the last setXGoal call */
+
+  /* Outputs */
+  double q_command[MAX_JOINT_NUMBER];
+  double x_current[SPACE_DIMENSION];
+  double dx_selected[SPACE_DIMENSION]; /*!< Space velocity given to the IK */
+  uint32_t ik_flags;            /*!< IK_SUCCESS, IK_FALLBACK_USED, IK_BUDGET_EXCEEDED and IK_QPOASES bits */
+  int32_t ik_status;
+  int32_t ik_iterations;
+  int32_t ik_active_constraints;
+  double ik_objective;
+
+  /* Stage durations (s) */
+  double fk_time;
+  double trajectory_time;
+  double ik_time;
+  double integrate_time;
+};
+static_assert(sizeof(Record) % 8 == 0, "Records must keep their alignment in a record array");
+
+typedef TelemetryRing<Record, RING_SIZE> RecordRing;
+
+/* Global parameters read by the controller components, saved with the private namespace of the node */
+static const char* const SNAPSHOT_PARAMETERS[] = { "/robot_description", "/robot_description_semantic",
+                                                   "/robot_description_kinematics", "/robot_description_planning",
+                                                   "/niryo_one/robot_command_validation" };
+static constexpr const char* PRIVATE_NAMESPACE_KEY = "~"; /*!< Key of the private namespace in a snapshot */
+
+/**
+* \brief Snapshot of the parameters read by CartesianController, as an XML-RPC struct value
+*
+* The private namespace is saved under PRIVATE_NAMESPACE_KEY, SNAPSHOT_PARAMETERS under their name.
+*/
+std::string snapshotParameters(const ros::NodeHandle& nh_private);
+
+/**
+* \brief Fill a record with the inputs and outputs of the last run call of controller
+*
+* cycle, stamp and fsm_state are set to zero, they are not known by the controller.
+*/
+void capture(CartesianController& controller, const JointPosition& q_current, const SpaceVelocity& dx_desired,
+             const JointPosition& q_command, Record& record);
+}
+
+/**
+* \brief Write run records in a file out of the control loop
+*
+* The control loop only copies a record in a lock-free ring (records are dropped when it is full), a writer thread
+* appends the records read to the file.
+*/
+class RunRecorder
+{
+public:
+  RunRecorder();
+  ~RunRecorder();
+  /**
+  * \brief Create the file, write its header and start the writer thread. Return false if the file is not written.
+  */
+  bool open(const std::string& file_name, const int joint_number, const double sampling_period,
+            const std::string& parameters);
+  /**
+  * \brief Stop the writer thread, write the remaining records and close the file
+  */
+  void close();
+  bool isOpen() const;
+  /**
+  * \brief Record a run (control loop side). cycle is set by the recorder.
+  */
+  void push(run_record::Record& record);
+  std::size_t getDropped() const;
+
+protected:
+private:
+  FILE* file_;
+  std::unique_ptr<run_record::RecordRing> ring_;
+  uint64_t cycle_;
+  std::atomic<bool> running_;
+  std::thread thread_;
+
+  void run_();
+  /**
+  * \brief Write all available records. Return false on write error.
+  */
+  bool flush_();
+};
+
+/**
+* \brief Read-only mapping of a run recording
+*/
+class RunRecordReader
+{
+public:
+  RunRecordReader();
+  ~RunRecordReader();
+  /**
+  * \brief Map a recording and check its header. Return false and set error if it could not be read.
+  */
+  bool open(const std::string& file_name, std::string& error);
+  void close();
+  const run_record::FileHeader& getHeader() const;
+  std::string getParameters() const;
+  std::size_t size() const;
+  const run_record::Record& operator[](const std::size_t i) const;
+
+protected:
+private:
+  void* data_;
+  std::size_t data_size_;
+  const run_record::FileHeader* header_;
+  const run_record::Record* records_;
+  std::size_t record_number_;
+};
+}
+#endif
@@ -0,0 +1,507 @@
+/*
+ *  small_qp_solver.h
+ *  Copyright (C) 2019 Orthopus
+ *  All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CARTESIAN_CONTROLLER_SMALL_QP_SOLVER_H
+#define CARTESIAN_CONTROLLER_SMALL_QP_SOLVER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+// Eigen
+#include "Eigen/Dense"
+
+namespace space_control
+{
+/**
+* \brief Dense QP solver for small problems whose dimensions are known at compile time
+*
+* Solves the same problem form as qpOASES :
+*     min   1/2*x'Hx + x'g
+*     s.t.  lb  <=  x <= ub
+*           lbA <= Ax <= ubA
+* with H positive definite, using the dual active set method of Goldfarb and Idnani ("A numerically stable dual method
+* for solving strictly convex quadratic programs", 1983). The method starts from the unconstrained minimum, so no
+* feasible starting point is required, and adds the most violated constraint at each iteration. The factorization of
+* the active set is updated with Givens rotations on fixed-size matrices : a solve does not allocate memory.
+*
+* Each iteration (one constraint added or dropped) costs O(N*(N+M)). The number of iterations is bounded by
+* max_iterations, which bounds the worst-case solve time. An optional CPU time budget (max_cpu_time) stops the solve
+* when it is exceeded, whatever the number of iterations.
+*
+* Bounds lower than -INFTY or greater than INFTY are ignored.
+*/
+template <int N, int M>
+class SmallQpSolver
+{
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  typedef Eigen::Matrix<double, N, N> MatrixN;
+  typedef Eigen::Matrix<double, N, 1> VectorN;
+
+  static constexpr int CONSTRAINT_NUMBER = 2 * (N + M); /*!< Each bound gives one one-sided constraint */
+  static constexpr double INFTY = 1.0e20;
+
+  enum class Status
+  {
+    Success,
+    MaxIterationsReached,
+    MaxCpuTimeReached,
+    Infeasible,
+    NotConvex
+  };
+
+  /**
+  * \brief Statistics of the last solve
+  */
+  struct Report
+  {
+    Status status;
+    int iterations;         /*!< Number of constraints added or dropped */
+    int active_constraints; /*!< Size of the final active set */
+    double primal_residual; /*!< Largest constraint violation */
+    double dual_residual;   /*!< Largest component of the KKT stationarity residual (Hx + g - C'u) */
+    double cpu_time;        /*!< Solve duration in seconds */
+  };
+
+  SmallQpSolver(const int max_iterations = 2 * CONSTRAINT_NUMBER)
+    : max_iterations_(max_iterations), max_cpu_time_(0.0), feasibility_tolerance_(1e-10)
+  {
+    report_.status = Status::Success;
+    report_.iterations = 0;
+    report_.active_constraints = 0;
+    report_.primal_residual = 0.0;
+    report_.dual_residual = 0.0;
+    report_.cpu_time = 0.0;
+    std::fill(active_, active_ + N + 1, -1);
+  }
+
+  void setMaxIterations(const int max_iterations)
+  {
+    max_iterations_ = max_iterations;
+  }
+
+  /**
+  * \brief Set the solve time budget in seconds (0 to disable)
+  */
+  void setMaxCpuTime(const double max_cpu_time)
+  {
+    max_cpu_time_ = max_cpu_time;
+  }
+
+  const Report& getReport() const
+  {
+    return report_;
+  }
+
+  template <class DerivedH, class DerivedA>
+  Status solve(const Eigen::MatrixBase<DerivedH>& H, const VectorN& g, const Eigen::MatrixBase<DerivedA>& A,
+               const double* lb, const double* ub, const double* lbA, const double* ubA, VectorN& x)
+  {
+    start_time_ = Clock::now();
+
+    /* One-sided constraints C.row(k) * x >= b(k) : lower bound (k even), upper bound (k odd) */
+    for (int i = 0; i < N + M; i++)
+    {
+      VectorN a;
+      double lower, upper;
+      if (i < N)
+      {
+        a.setZero();
+        a(i) = 1.0;
+        lower = lb[i];
+        upper = ub[i];
+      }
+      else
+      {
+        a = A.row(i - N).transpose();
+        lower = lbA[i - N];
+        upper = ubA[i - N];
+      }
+      C_.row(2 * i) = a.transpose();
+      b_(2 * i) = lower;
+      enabled_[2 * i] = (lower > -INFTY);
+      C_.row(2 * i + 1) = -a.transpose();
+      b_(2 * i + 1) = -upper;
+      enabled_[2 * i + 1] = (upper < INFTY);
+    }
+
+    H_ = H;
+    llt_.compute(H_);
+    if (llt_.info() != Eigen::Success)
+    {
+      x.setZero();
+      return finish_(Status::NotConvex, 0, 0, g, x);
+    }
+
+    /* Unconstrained minimum, and J = L^-T where H = L.L' */
+    x = -llt_.solve(g);
+    resetFactorization_();
+    u_.setZero();
+
+    int iq = 0;
+    int iterations = 0;
+    for (int k = 0; k < CONSTRAINT_NUMBER; k++)
+    {
+      is_active_[k] = false;
+    }
+
+    const double inf = std::numeric_limits<double>::infinity();
+    const double eps = std::numeric_limits<double>::epsilon();
+
+    /* Step 1 : compute constraint slacks and save the current state */
+    while (true)
+    {
+      s_.noalias() = C_ * x - b_;
+      for (int k = 0; k < CONSTRAINT_NUMBER; k++)
+      {
+        excluded_[k] = !enabled_[k];
+      }
+      const int iq_old = iq;
+      const VectorN x_old = x;
+      const Eigen::Matrix<double, N + 1, 1> u_old = u_;
+      int active_old[N + 1];
+      std::copy(active_, active_ + N + 1, active_old);
+
+      bool constraint_added = false;
+      while (!constraint_added)
+      {
+        /* Step 2 : choose the most violated constraint */
+        int ip = -1;
+        double s_min = -feasibility_tolerance_;
+        for (int k = 0; k < CONSTRAINT_NUMBER; k++)
+        {
+          if (!is_active_[k] && !excluded_[k] && s_(k) < s_min)
+          {
+            s_min = s_(k);
+            ip = k;
+          }
+        }
+        if (ip < 0)
+        {
+          return finish_(Status::Success, iterations, iq, g, x);
+        }
+
+        const VectorN np = C_.row(ip).transpose();
+        u_(iq) = 0.0;
+        active_[iq] = ip;
+
+        while (true)
+        {
+          if (iterations >= max_iterations_)
+          {
+            return finish_(Status::MaxIterationsReached, iterations, iq, g, x);
+          }
+          if (max_cpu_time_ > 0.0 && elapsed_() > max_cpu_time_)
+          {
+            return finish_(Status::MaxCpuTimeReached, iterations, iq, g, x);
+          }
+          iterations++;
+
+          /* Step 2a : primal (z) and dual (r) step directions */
+          d_.noalias() = J_.transpose() * np;
+          z_.noalias() = J_.rightCols(N - iq) * d_.tail(N - iq);
+          for (int i = iq - 1; i >= 0; i--)
+          {
+            double sum = d_(i);
+            for (int j = i + 1; j < iq; j++)
+            {
+              sum -= R_(i, j) * r_(j);
+            }
+            r_(i) = sum / R_(i, i);
+          }
+
+          /* Step 2b : step lengths, t1 keeps dual feasibility, t2 satisfies the constraint */
+          double t1 = inf;
+          int l = -1;
+          for (int k = 0; k < iq; k++)
+          {
+            if (r_(k) > 0.0 && u_(k) / r_(k) < t1)
+            {
+              t1 = u_(k) / r_(k);
+              l = active_[k];
+            }
+          }
+          double t2 = inf;
+          if (z_.squaredNorm() > eps)
+          {
+            t2 = -s_(ip) / z_.dot(np);
+            if (t2 < 0.0)
+            {
+              t2 = inf;
+            }
+          }
+          const double t = std::min(t1, t2);
+
+          /* Step 2c */
+          if (t >= inf)
+          {
+            return finish_(Status::Infeasible, iterations, iq, g, x);
+          }
+
+          if (t2 >= inf)
+          {
+            /* Step in dual space only, then drop the blocking constraint */
+            u_.head(iq) -= t * r_.head(iq);
+            u_(iq) += t;
+            is_active_[l] = false;
+            deleteConstraint_(l, iq);
+            continue;
+          }
+
+          /* Step in primal and dual space */
+          x += t * z_;
+          u_.head(iq) -= t * r_.head(iq);
+          u_(iq) += t;
+
+          if (t2 <= t1)
+          {
+            /* Full step : the constraint is satisfied, add it to the active set */
+            if (addConstraint_(iq))
+            {
+              is_active_[ip] = true;
+              constraint_added = true;
+            }
+            else
+            {
+              /* Linearly dependent constraint : restore the previous state and choose another one */
+              excluded_[ip] = true;
+              x = x_old;
+              u_ = u_old;
+              std::copy(active_old, active_old + N + 1, active_);
+              iq = 0;
+              resetFactorization_();
+              for (int k = 0; k < CONSTRAINT_NUMBER; k++)
+              {
+                is_active_[k] = false;
+              }
+              for (int k = 0; k < iq_old; k++)
+              {
+                d_.noalias() = J_.transpose() * C_.row(active_[k]).transpose();
+                addConstraint_(iq);
+                is_active_[active_[k]] = true;
+              }
+            }
+            break;
+          }
+
+          /* Partial step : drop the blocking constraint and continue with the same violated constraint */
+          is_active_[l] = false;
+          deleteConstraint_(l, iq);
+          s_(ip) = np.dot(x) - b_(ip);
+        }
+      }
+    }
+  }
+
+private:
+  typedef std::chrono::steady_clock Clock;
+
+  int max_iterations_;
+  double max_cpu_time_;
+  double feasibility_tolerance_;
+  Clock::time_point start_time_;
+  Report report_;
+
+  Eigen::Matrix<double, CONSTRAINT_NUMBER, N> C_;
+  Eigen::Matrix<double, CONSTRAINT_NUMBER, 1> b_;
+  Eigen::Matrix<double, CONSTRAINT_NUMBER, 1> s_;
+  bool enabled_[CONSTRAINT_NUMBER];
+  bool is_active_[CONSTRAINT_NUMBER];
+  bool excluded_[CONSTRAINT_NUMBER];
+
+  MatrixN H_;
+  Eigen::LLT<MatrixN> llt_;
+  MatrixN J_;
+  MatrixN R_;
+  double R_norm_;
+  VectorN d_;
+  VectorN z_;
+  VectorN r_;
+  Eigen::Matrix<double, N + 1, 1> u_;
+  int active_[N + 1];
+
+  /* J = L^-T where H = L.L', empty active set */
+  void resetFactorization_()
+  {
+    J_.setIdentity();
+    llt_.matrixU().solveInPlace(J_);
+    R_.setZero();
+    R_norm_ = 1.0;
+  }
+
+  double elapsed_() const
+  {
+    return std::chrono::duration<double>(Clock::now() - start_time_).count();
+  }
+
+  Status finish_(const Status status, const int iterations, const int iq, const VectorN& g, const VectorN& x)
+  {
+    report_.status = status;
+    report_.iterations = iterations;
+    report_.active_constraints = iq;
+
+    report_.primal_residual = 0.0;
+    for (int k = 0; k < CONSTRAINT_NUMBER; k++)
+    {
+      if (enabled_[k])
+      {
+        report_.primal_residual = std::max(report_.primal_residual, b_(k) - C_.row(k).dot(x));
+      }
+    }
+
+    VectorN stationarity = H_ * x + g;
+    for (int k = 0; k < iq; k++)
+    {
+      stationarity -= u_(k) * C_.row(active_[k]).transpose();
+    }
+    report_.dual_residual = stationarity.cwiseAbs().maxCoeff();
+    report_.cpu_time = elapsed_();
+    return status;
+  }
+
+  /* Update J and R (J' * [active normals] = [R 0]') for the new constraint, whose d = J' * n is in d_ */
+  bool addConstraint_(int& iq)
+  {
+    for (int j = N - 1; j >= iq + 1; j--)
+    {
+      double cc = d_(j - 1);
+      double ss = d_(j);
+      const double h = std::hypot(cc, ss);
+      if (h == 0.0)
+      {
+        continue;
+      }
+      d_(j) = 0.0;
+      ss = ss / h;
+      cc = cc / h;
+      if (cc < 0.0)
+      {
+        cc = -cc;
+        ss = -ss;
+        d_(j - 1) = -h;
+      }
+      else
+      {
+        d_(j - 1) = h;
+      }
+      const double xny = ss / (1.0 + cc);
+      for (int k = 0; k < N; k++)
+      {
+        const double t1 = J_(k, j - 1);
+        const double t2 = J_(k, j);
+        J_(k, j - 1) = t1 * cc + t2 * ss;
+        J_(k, j) = xny * (t1 + J_(k, j - 1)) - t2;
+      }
+    }
+    iq++;
+    for (int i = 0; i < iq; i++)
+    {
+      R_(i, iq - 1) = d_(i);
+    }
+    if (std::abs(d_(iq - 1)) <= std::numeric_limits<double>::epsilon() * R_norm_)
+    {
+      return false;
+    }
+    R_norm_ = std::max(R_norm_, std::abs(d_(iq - 1)));
+    return true;
+  }
+
+  /* Remove constraint l from the active set (the pending constraint in active_[iq] is shifted as well) */
+  void deleteConstraint_(const int l, int& iq)
+  {
+    int qq = -1;
+    for (int i = 0; i < iq; i++)
+    {
+      if (active_[i] == l)
+      {
+        qq = i;
+        break;
+      }
+    }
+    if (qq < 0)
+    {
+      return;
+    }
+
+    for (int i = qq; i < iq - 1; i++)
+    {
+      active_[i] = active_[i + 1];
+      u_(i) = u_(i + 1);
+      R_.col(i) = R_.col(i + 1);
+    }
+    active_[iq - 1] = active_[iq];
+    u_(iq - 1) = u_(iq);
+    active_[iq] = -1;
+    u_(iq) = 0.0;
+    for (int j = 0; j < iq; j++)
+    {
+      R_(j, iq - 1) = 0.0;
+    }
+    iq--;
+
+    /* Restore the triangular form of R with Givens rotations */
+    for (int j = qq; j < iq; j++)
+    {
+      double cc = R_(j, j);
+      double ss = R_(j + 1, j);
+      const double h = std::hypot(cc, ss);
+      if (h == 0.0)
+      {
+        continue;
+      }
+      cc = cc / h;
+      ss = ss / h;
+      R_(j + 1, j) = 0.0;
+      if (cc < 0.0)
+      {
+        R_(j, j) = -h;
+        cc = -cc;
+        ss = -ss;
+      }
+      else
+      {
+        R_(j, j) = h;
+      }
+      const double xny = ss / (1.0 + cc);
+      for (int k = j + 1; k < iq; k++)
+      {
+        const double t1 = R_(j, k);
+        const double t2 = R_(j + 1, k);
+        R_(j, k) = t1 * cc + t2 * ss;
+        R_(j + 1, k) = xny * (t1 + R_(j, k)) - t2;
+      }
+      for (int k = 0; k < N; k++)
+      {
+        const double t1 = J_(k, j);
+        const double t2 = J_(k, j + 1);
+        J_(k, j) = t1 * cc + t2 * ss;
+        J_(k, j + 1) = xny * (J_(k, j) + t1) - t2;
+      }
+    }
+  }
+};
+
+template <int N, int M>
+constexpr int SmallQpSolver<N, M>::CONSTRAINT_NUMBER;
+template <int N, int M>
+constexpr double SmallQpSolver<N, M>::INFTY;
+}
+#endif
@@ -0,0 +1,89 @@
+/*
+ *  telemetry_ring.h
+ *  Copyright (C) 2019 Orthopus
+ *  All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CARTESIAN_CONTROLLER_TELEMETRY_RING_H
+#define CARTESIAN_CONTROLLER_TELEMETRY_RING_H
+
+#include <atomic>
+#include <cstddef>
+
+namespace space_control
+{
+/**
+* \brief Lock-free single producer / single consumer ring of telemetry records
+*
+* The producer (control loop) never blocks and never allocates : when the ring is full, the record is dropped and
+* counted instead of overwriting records the consumer may be reading. Size must be a power of two.
+*/
+template <class T, std::size_t Size>
+class TelemetryRing
+{
+  static_assert(Size > 0 && (Size & (Size - 1)) == 0, "TelemetryRing size must be a power of two");
+
+public:
+  TelemetryRing() : head_(0), tail_(0), dropped_(0)
+  {
+  }
+
+  /**
+  * \brief Add a record (producer side). Return false if the ring is full.
+  */
+  bool push(const T& record)
+  {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) >= Size)
+    {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    buffer_[head & (Size - 1)] = record;
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+  * \brief Remove the oldest record (consumer side). Return false if the ring is empty.
+  */
+  bool pop(T& record)
+  {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_acquire))
+    {
+      return false;
+    }
+    record = buffer_[tail & (Size - 1)];
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+  * \brief Number of records dropped because the ring was full
+  */
+  std::size_t getDropped() const
+  {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+private:
+  T buffer_[Size];
+  std::atomic<std::size_t> head_; /*!< Next slot written by the producer */
+  std::atomic<std::size_t> tail_; /*!< Next slot read by the consumer */
+  std::atomic<std::size_t> dropped_;
+};
+}
+#endif
@@ -0,0 +1,112 @@
+/*
+ *  trace.h
+ *  Copyright (C) 2019 Orthopus
+ *  All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CARTESIAN_CONTROLLER_TRACE_H
+#define CARTESIAN_CONTROLLER_TRACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/*
+ * Control loop tracing
+ *
+ * The control loop records binary events (no string formatting) with SPACE_CONTROL_TRACE. Tracing is compiled in only
+ * when ORTHOPUS_SPACE_CONTROL_TRACE is defined (cmake -DORTHOPUS_SPACE_CONTROL_TRACE=ON), otherwise the macro and its
+ * arguments are removed by the preprocessor.
+ *
+ * Each thread records in its own ring (the oldest events are overwritten), so recording does not lock nor allocate
+ * after the first event of a thread. Rings are written to a file with trace::dump and decoded offline with
+ * trace_decoder.
+ */
+#ifdef ORTHOPUS_SPACE_CONTROL_TRACE
+#define SPACE_CONTROL_TRACE(event, arg, value) ::space_control::trace::record(event, arg, value)
+#else
+#define SPACE_CONTROL_TRACE(event, arg, value)                                                                         \
+  do                                                                                                                   \
+  {                                                                                                                    \
+  } while (0)
+#endif
+
+namespace space_control
+{
+namespace trace
+{
+/* Events are stored as their value in trace files : only append new events at the end (before Count) */
+enum class Event : uint16_t
+{
+  CycleBegin,      /*!< arg : FSM state index */
+  CycleEnd,        /*!< arg : FSM state index */
+  FsmTransition,   /*!< arg : transition index */
+  FkBegin,
+  FkEnd,
+  TrajectoryBegin,
+  TrajectoryEnd,   /*!< value : desired linear velocity norm */
+  IkBegin,         /*!< value : desired linear velocity norm */
+  IkEnd,           /*!< arg : 1 if a QP solution is applied, value : QP objective */
+  IntegrateBegin,
+  IntegrateEnd,
+  CommandSent,
+  Count
+};
+
+static constexpr char FILE_MAGIC[8] = { 'O', 'S', 'C', 'T', 'R', 'A', 'C', 'E' };
+static constexpr uint32_t FILE_VERSION = 1;
+static constexpr std::size_t THREAD_RING_SIZE = 8192; /*!< Events kept per thread, power of two */
+
+/**
+* \brief Binary trace event, written as is in trace files
+*/
+struct Record
+{
+  uint64_t stamp;  /*!< Monotonic clock (ns) */
+  uint16_t event;  /*!< Event value */
+  uint16_t thread; /*!< Index of the recording thread */
+  int32_t arg;
+  double value;
+};
+
+/**
+* \brief Name of an event, for the decoder
+*/
+inline const char* eventName(const uint16_t event)
+{
+  static const char* const names[] = {
+    "cycle_begin",    "cycle_end", "fsm_transition", "fk_begin",        "fk_end",        "trajectory_begin",
+    "trajectory_end", "ik_begin",  "ik_end",         "integrate_begin", "integrate_end", "command_sent"
+  };
+  static_assert(sizeof(names) / sizeof(names[0]) == static_cast<std::size_t>(Event::Count),
+                "A name is required for each trace event");
+  return (event < static_cast<uint16_t>(Event::Count)) ? names[event] : "unknown";
+}
+
+/**
+* \brief Record an event in the ring of the calling thread
+*/
+void record(const Event event, const int32_t arg = 0, const double value = 0.0);
+
+/**
+* \brief Write the rings of all threads in a trace file
+*
+* Rings are read while other threads may still record : call it when the traced threads are stopped to get a
+* consistent trace. Return false if the file could not be written or if tracing is not compiled in.
+*/
+bool dump(const std::string& file_name);
+}
+}
+#endif
@@ -33,13 +33,18 @@ namespace space_control
 class TrajectoryController
 {
 public:
-  TrajectoryController(const int joint_number);
+  TrajectoryController(const int joint_number, const ros::NodeHandle& nh_private);
   void init(double sampling_period);
   void reset();
   void computeTrajectory(SpaceVelocity& dx_output);
   bool isTrajectoryCompleted();
   void setXCurrent(const SpacePosition& x_current);
   void setXGoal(const SpacePosition& x_pose);
+  const SpacePosition& getXGoal() const;
+  /**
+  * \brief Number of setXGoal calls since construction (see RunRecorder)
+  */
+  unsigned int getGoalCount() const;
 
 protected:
 private:
@@ -56,6 +61,7 @@ private:
   bool is_completed_;         /*!< Completion state of the trajectory */
   bool is_comp_completed_[7]; /*!< Completion state of the trajectory on each component (position and orientation) */
   const int pi_number_;       /*!< Number of PI controller to handle */
+  unsigned int goal_count_;   /*!< Number of setXGoal calls */
 
   void updateTrajectoryCompletion_();
   void processPi_(SpaceVelocity& dx_output);
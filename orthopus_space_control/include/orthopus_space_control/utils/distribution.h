@@ -0,0 +1,132 @@
+/*
+ *  distribution.h
+ *  Copyright (C) 2019 Orthopus
+ *  All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CARTESIAN_CONTROLLER_DISTRIBUTION_H
+#define CARTESIAN_CONTROLLER_DISTRIBUTION_H
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace space_control
+{
+/**
+* \brief Distribution of measured values (durations, periods...) printed by the benchmarks and the offline tools
+*
+* Values are stored as they come and sorted on the first statistic asked after an add(). Statistics of an empty
+* distribution are 0.
+*/
+class Distribution
+{
+public:
+  Distribution() : sorted_(true){};
+
+  void reserve(const std::size_t size)
+  {
+    values_.reserve(size);
+  };
+
+  void add(const double value)
+  {
+    values_.push_back(value);
+    sorted_ = false;
+  };
+
+  std::size_t size() const
+  {
+    return values_.size();
+  };
+
+  bool empty() const
+  {
+    return values_.empty();
+  };
+
+  /**
+  * \brief Value below which the given fraction of the values lies (0.5 for the median)
+  */
+  double percentile(const double fraction)
+  {
+    if (values_.empty())
+    {
+      return 0.0;
+    }
+    sort_();
+    const std::size_t index = static_cast<std::size_t>(fraction * static_cast<double>(values_.size()));
+    return values_[std::min(index, values_.size() - 1)];
+  };
+
+  double min()
+  {
+    return percentile(0.0);
+  };
+
+  double max()
+  {
+    return percentile(1.0);
+  };
+
+  double mean() const
+  {
+    double mean = 0.0;
+    for (const double v : values_)
+    {
+      mean += v / static_cast<double>(values_.size());
+    }
+    return mean;
+  };
+
+  /**
+  * \brief "min | mean | p50 | p90 | p99 | max" summary, with the given number of decimals
+  */
+  std::string format(const int precision = 1)
+  {
+    char line[256];
+    std::snprintf(line, sizeof(line), "min %.*f | mean %.*f | p50 %.*f | p90 %.*f | p99 %.*f | max %.*f", precision,
+                  min(), precision, mean(), precision, percentile(0.5), precision, percentile(0.9), precision,
+                  percentile(0.99), precision, max());
+    return line;
+  };
+
+  /**
+  * \brief Print the distribution as a table row on the standard output, nothing if it is empty
+  */
+  void print(const char* name, const char* unit)
+  {
+    if (!values_.empty())
+    {
+      std::printf("%-20s %8zu  %s %s\n", name, values_.size(), format().c_str(), unit);
+    }
+  };
+
+private:
+  std::vector<double> values_; /*!< Measured values, sorted when sorted_ is true */
+  bool sorted_;
+
+  void sort_()
+  {
+    if (!sorted_)
+    {
+      std::sort(values_.begin(), values_.end());
+      sorted_ = true;
+    }
+  };
+};
+}
+#endif
@@ -19,6 +19,8 @@
 #ifndef CARTESIAN_CONTROLLER_INTEGRATOR_H
 #define CARTESIAN_CONTROLLER_INTEGRATOR_H
 
+#include <string>
+
 #include "ros/ros.h"
 
 #include "sensor_msgs/JointState.h"
@@ -28,20 +30,43 @@
 
 namespace space_control
 {
+/**
+* \brief Integrate the joint velocity computed by the IK into the joint position command
+*
+* The integration mode is set by the velocity_integration parameter :
+*   - euler : q = q_current + dq*T, the joint velocity changes in one step at each cycle,
+*   - trapezoidal : q = q_current + (dq_prev + dq)/2*T, the joint velocity ramps from the previous cycle velocity to
+*     the new one. InverseKinematic reads the same parameter to constrain the resulting position.
+*/
 class VelocityIntegrator
 {
 public:
-  VelocityIntegrator(const int joint_number);
+  enum class Mode
+  {
+    Euler,
+    Trapezoidal
+  };
+
+  VelocityIntegrator(const int joint_number, const ros::NodeHandle& nh_private);
   void init(const double sampling_period);
+  void reset();
   void integrate(const JointVelocity& dq_input, JointPosition& q_output);
   void setQCurrent(const JointPosition& q_current);
+  Mode getMode() const;
+  /**
+  * \brief Convert the velocity_integration parameter into a mode
+  * \return false if name is unknown (mode is then left unchanged)
+  */
+  static bool parseMode(const std::string& name, Mode& mode);
 
 protected:
 private:
   ros::NodeHandle n_;
   int joint_number_;
   double sampling_period_;
+  Mode mode_;
   JointPosition q_current_;
+  JointVelocity dq_previous_; /*!< Joint velocity integrated at the last cycle, zero after a reset */
 };
 }
 #endif
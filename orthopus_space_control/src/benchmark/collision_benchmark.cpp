@@ -0,0 +1,132 @@
+/*
+ *  collision_benchmark.cpp
+ *  Copyright (C) 2019 Orthopus
+ *  All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "ros/ros.h"
+
+#include "orthopus_space_control/collision_model.h"
+#include "orthopus_space_control/inverse_kinematic.h"
+#include "orthopus_space_control/niryo_one_kinematic.h"
+#include "orthopus_space_control/utils/distribution.h"
+
+using namespace space_control;
+
+/*
+ * Measure the per-cycle cost of the IK collision constraints.
+ *
+ * The joints sweep their whole range (sinusoids of different periods, from the niryo_one joint limits), so that the
+ * arm goes through folded configurations and close to the table. At each cycle, the time of the distance computation
+ * of all pairs (NiryoOneCollisionModel::update) and of the constraint rows of the nearest pairs (selection and
+ * distance jacobians) is measured. The kinematic itself is shared with the IK and is not measured.
+ */
+int main(int argc, char** argv)
+{
+  ros::init(argc, argv, "collision_benchmark");
+  ros::NodeHandle nh_private("~");
+
+  int iterations = 100000;
+  int sampling_freq = 10;
+  double activation_distance = 0.1;
+  double table_height = 0.0;
+  std::vector<double> obstacles;
+  nh_private.getParam("iterations", iterations);
+  nh_private.getParam("sampling_frequency", sampling_freq);
+  nh_private.getParam("ik_collision_activation_distance", activation_distance);
+  nh_private.getParam("ik_collision_table_height", table_height);
+  nh_private.getParam("ik_collision_obstacles", obstacles);
+  if (sampling_freq <= 0 || iterations <= 0)
+  {
+    ROS_ERROR("sampling_frequency and iterations must be greater than zero");
+    return 1;
+  }
+  const double sampling_period = 1.0 / sampling_freq;
+
+  std::vector<double> q_min(IK_JOINT_NUMBER), q_max(IK_JOINT_NUMBER);
+  for (int j = 0; j < IK_JOINT_NUMBER; j++)
+  {
+    const std::string limit = "/niryo_one/robot_command_validation/joint_limits/j" + std::to_string(j + 1);
+    if (!nh_private.getParam(limit + "/min", q_min[j]) || !nh_private.getParam(limit + "/max", q_max[j]))
+    {
+      ROS_ERROR("Could not get joint limits from %s", limit.c_str());
+      return 1;
+    }
+  }
+
+  NiryoOneKinematic kinematic;
+  NiryoOneCollisionModel collision_model;
+  if (!collision_model.init(kinematic.getHardwareVersion(), table_height, obstacles))
+  {
+    return 1;
+  }
+
+  std::vector<double> q(IK_JOINT_NUMBER);
+  NiryoOneKinematicState state;
+  CollisionDistance nearest[IK_COLLISION_CONSTRAINT_NUMBER];
+  Eigen::Matrix<double, 1, IK_JOINT_NUMBER> distance_jacobian;
+  Distribution update_time_us, rows_time_us, cycle_time_us;
+  update_time_us.reserve(iterations);
+  rows_time_us.reserve(iterations);
+  cycle_time_us.reserve(iterations);
+  int active_cycles = 0;
+  int active_pairs = 0;
+  double minimum_distance = std::numeric_limits<double>::infinity();
+
+  for (int i = 0; i < iterations && ros::ok(); i++)
+  {
+    const double t = i * sampling_period;
+    for (int j = 0; j < IK_JOINT_NUMBER; j++)
+    {
+      const double period = 20.0 + 7.0 * j;
+      q[j] = 0.5 * (q_min[j] + q_max[j]) + 0.5 * (q_max[j] - q_min[j]) * std::sin(2.0 * M_PI * t / period + j);
+    }
+    kinematic.compute(q, state);
+
+    ros::WallTime start = ros::WallTime::now();
+    collision_model.update(state);
+    ros::WallTime updated = ros::WallTime::now();
+    const int pair_number =
+        collision_model.selectNearest(IK_COLLISION_CONSTRAINT_NUMBER, activation_distance, nearest);
+    for (int k = 0; k < pair_number; k++)
+    {
+      collision_model.computeDistanceJacobian(nearest[k], state, distance_jacobian);
+    }
+    ros::WallTime end = ros::WallTime::now();
+
+    update_time_us.add((updated - start).toSec() * 1e6);
+    rows_time_us.add((end - updated).toSec() * 1e6);
+    cycle_time_us.add((end - start).toSec() * 1e6);
+    active_cycles += (pair_number > 0) ? 1 : 0;
+    active_pairs += pair_number;
+    minimum_distance = std::min(minimum_distance, collision_model.getMinimumDistance());
+  }
+
+  ROS_INFO("Collision constraints over %d configurations (V%d, at most %d pairs closer than %g m)", iterations,
+           kinematic.getHardwareVersion(), IK_COLLISION_CONSTRAINT_NUMBER, activation_distance);
+  ROS_INFO("%-22s (us) : %s", "Distances (all pairs)", update_time_us.format(3).c_str());
+  ROS_INFO("%-22s (us) : %s", "Nearest pair rows", rows_time_us.format(3).c_str());
+  ROS_INFO("%-22s (us) : %s", "Cycle", cycle_time_us.format(3).c_str());
+  ROS_INFO("%.1f %% of the cycles with constraints (%.2f pairs on average), minimum distance %.4f m",
+           100.0 * active_cycles / iterations, static_cast<double>(active_pairs) / iterations, minimum_distance);
+
+  return 0;
+}
@@ -0,0 +1,149 @@
+/*
+ *  control_loop_benchmark.cpp
+ *  Copyright (C) 2019 Orthopus
+ *  All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <time.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "ros/ros.h"
+
+#include "geometry_msgs/Pose.h"
+#include "sensor_msgs/JointState.h"
+#include "std_msgs/UInt16.h"
+
+#include "orthopus_space_control/cartesian_controller.h"
+#include "orthopus_space_control/joint_pose_manager.h"
+#include "orthopus_space_control/trace.h"
+#include "orthopus_space_control/utils/distribution.h"
+
+using namespace space_control;
+
+namespace
+{
+double threadCpuTime()
+{
+  timespec t;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t);
+  return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+/* Per-cycle logging of the control loop before tracing was introduced, to measure its cost on the same build */
+void legacyLogging()
+{
+  ROS_INFO("=== Update joint position (Open loop)...");
+  ROS_INFO("---- Execute cartesian control loop ----");
+  ROS_INFO("=== Start FK computation...");
+  ROS_INFO("=== Retrieve user space velocity...");
+  ROS_INFO("=== Start IK computation...");
+  ROS_INFO("=== Integrate joint velocity...");
+  ROS_INFO("----------------------------------------");
+  ROS_INFO("=== Send Niryo One joints command...");
+}
+}
+
+/*
+ * Measure the CPU share of the cartesian control loop (CartesianController::run).
+ *
+ * The loop is run back to back in user input mode with a smooth synthetic space velocity, and the thread CPU time of
+ * each cycle is compared to the sampling period. Run it on the robot (Raspberry Pi) to get meaningful numbers :
+ *   - legacy_logging:=true adds the per-cycle ROS_INFO lines the loop used to print,
+ *   - a build with -DORTHOPUS_SPACE_CONTROL_TRACE=ON includes the trace events, and writes them in trace_file.
+ */
+int main(int argc, char** argv)
+{
+  ros::init(argc, argv, "control_loop_benchmark");
+  ros::NodeHandle nh_private("~");
+
+  int joint_number = 6;
+  int sampling_freq = 10;
+  int iterations = 2000;
+  bool legacy_logging = false;
+  std::string trace_file = "control_loop_benchmark.trace";
+  nh_private.getParam("joint_number", joint_number);
+  nh_private.getParam("sampling_frequency", sampling_freq);
+  nh_private.getParam("iterations", iterations);
+  nh_private.getParam("legacy_logging", legacy_logging);
+  nh_private.getParam("trace_file", trace_file);
+  if (sampling_freq <= 0 || iterations <= 0)
+  {
+    ROS_ERROR("sampling_frequency and iterations must be greater than zero");
+    return 1;
+  }
+  const double sampling_period = 1.0 / sampling_freq;
+
+  /* Topics of the controller are published in the benchmark namespace */
+  ros::Publisher q_current_pub = nh_private.advertise<sensor_msgs::JointState>("q_current", 1);
+  ros::Publisher x_current_pub = nh_private.advertise<geometry_msgs::Pose>("x_current", 1);
+  ros::Publisher dx_desired_pub = nh_private.advertise<geometry_msgs::Pose>("dx_desired", 1);
+  ros::Publisher control_feedback_pub = nh_private.advertise<std_msgs::UInt16>("control_feedback", 1);
+
+  JointPoseManager joint_pose_manager(joint_number, nh_private);
+  CartesianController controller(joint_number, nh_private);
+  controller.init(sampling_period, joint_pose_manager);
+  controller.setDebugPublishers(q_current_pub, x_current_pub, dx_desired_pub);
+  controller.setControlFeedbackPublisher(control_feedback_pub);
+  controller.setInputSelector(CartesianController::INPUT_USER);
+
+  JointPosition q_current(joint_number);
+  JointPosition q_command(joint_number);
+  std::vector<double> rest_position;
+  if (nh_private.getParam("rest_position", rest_position) && rest_position.size() == joint_number)
+  {
+    std::copy(rest_position.begin(), rest_position.end(), q_current.begin());
+  }
+
+  SpaceVelocity dx_desired;
+  Distribution cpu_time_us;
+  cpu_time_us.reserve(iterations);
+  for (int i = 0; i < iterations && ros::ok(); i++)
+  {
+    /* Slow circle in the YZ plane */
+    const double t = i * sampling_period;
+    dx_desired.position.x() = 0.0;
+    dx_desired.position.y() = 0.02 * std::cos(0.5 * t);
+    dx_desired.position.z() = 0.02 * std::sin(0.5 * t);
+
+    const double start = threadCpuTime();
+    SPACE_CONTROL_TRACE(trace::Event::CycleBegin, 0, 0.0);
+    if (legacy_logging)
+    {
+      legacyLogging();
+    }
+    controller.setDxDesired(dx_desired);
+    controller.run(q_current, q_command);
+    SPACE_CONTROL_TRACE(trace::Event::CycleEnd, 0, 0.0);
+    cpu_time_us.add((threadCpuTime() - start) * 1e6);
+
+    /* Open loop, as in RobotManager */
+    q_current = q_command;
+  }
+
+#ifdef ORTHOPUS_SPACE_CONTROL_TRACE
+  const char* tracing = "on";
+  trace::dump(trace_file);
+#else
+  const char* tracing = "off";
+#endif
+  ROS_INFO("Control loop CPU time over %zu cycles (us), tracing %s, legacy logging %s : %s", cpu_time_us.size(),
+           tracing, legacy_logging ? "on" : "off", cpu_time_us.format().c_str());
+  ROS_INFO("CPU share at %d Hz : mean %.3f %% | max %.3f %%", sampling_freq, cpu_time_us.mean() * 1e-4 * sampling_freq,
+           cpu_time_us.max() * 1e-4 * sampling_freq);
+
+  return 0;
+}
@@ -0,0 +1,267 @@
+/*
+ *  ik_benchmark.cpp
+ *  Copyright (C) 2019 Orthopus
+ *  All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ros/ros.h"
+
+#include "orthopus_space_control/forward_kinematic.h"
+#include "orthopus_space_control/inverse_kinematic.h"
+#include "orthopus_space_control/kinematic_cache.h"
+#include "orthopus_space_control/utils/distribution.h"
+
+using namespace space_control;
+
+namespace
+{
+/*
+ * IK solve with the dynamic-size data path used before the IK problem dimensions were fixed : jacobian, hessian,
+ * gradient and constraint matrix are Eigen temporaries allocated at each solve, and the SQProblem is allocated on the
+ * heap at the first solve. The QP is the one of that time (joint velocity bounds, joint position limits, space
+ * position and orientation rows), with free space axes and the space velocity in world frame. It has no collision
+ * rows and no joint acceleration nor jerk bounds.
+ */
+class DynamicSizeIk
+{
+public:
+  DynamicSizeIk(const ros::NodeHandle& nh_private, const double sampling_period) : sampling_period_(sampling_period)
+  {
+    std::vector<double> alpha_weight(IK_SPACE_DIMENSION, 1.0);
+    std::vector<double> beta_weight(IK_JOINT_NUMBER, 1.0);
+    nh_private.getParam("alpha_weight", alpha_weight);
+    nh_private.getParam("beta_weight", beta_weight);
+    alpha_weight.resize(IK_SPACE_DIMENSION, 1.0);
+    beta_weight.resize(IK_JOINT_NUMBER, 1.0);
+    alpha_weight_ = MatrixXd::Identity(IK_SPACE_DIMENSION, IK_SPACE_DIMENSION);
+    beta_weight_ = MatrixXd::Identity(IK_JOINT_NUMBER, IK_JOINT_NUMBER);
+    for (int i = 0; i < IK_SPACE_DIMENSION; i++)
+    {
+      alpha_weight_(i, i) = alpha_weight[i];
+    }
+    for (int i = 0; i < IK_JOINT_NUMBER; i++)
+    {
+      beta_weight_(i, i) = beta_weight[i];
+    }
+
+    double dq_max = 0.6;
+    nh_private.getParam("joint_max_vel", dq_max);
+    q_lower_limit_.assign(IK_JOINT_NUMBER, -M_PI);
+    q_upper_limit_.assign(IK_JOINT_NUMBER, M_PI);
+    for (int j = 0; j < IK_JOINT_NUMBER; j++)
+    {
+      dq_lower_limit_[j] = -dq_max;
+      dq_upper_limit_[j] = dq_max;
+      const std::string limit = "/niryo_one/robot_command_validation/joint_limits/j" + std::to_string(j + 1);
+      nh_private.getParam(limit + "/min", q_lower_limit_[j]);
+      nh_private.getParam(limit + "/max", q_upper_limit_[j]);
+    }
+  }
+
+  /* Return false if qpOASES fails, dq_computed is then zero */
+  bool resolveInverseKinematic(const KinematicCache& kc, const JointPosition& q_current,
+                               const SpaceVelocity& dx_desired, JointVelocity& dq_computed)
+  {
+    const Eigen::Quaterniond& orientation = kc.getOrientation();
+    const double w = orientation.w(), x = orientation.x(), y = orientation.y(), z = orientation.z();
+    MatrixXd quaternion_update_matrix(4, 3);
+    quaternion_update_matrix << -x, -y, -z, w, z, -y, -z, w, x, y, -x, w;
+
+    MatrixXd jacobian = MatrixXd::Zero(IK_SPACE_DIMENSION, IK_JOINT_NUMBER);
+    jacobian.topRows(3) = kc.getJacobian().topRows(3);
+    jacobian.bottomRows(4) = 0.5 * quaternion_update_matrix * kc.getJacobian().bottomRows(3);
+
+    MatrixXd hessian = (jacobian.transpose() * alpha_weight_ * jacobian) + beta_weight_;
+    VectorXd dx = dx_desired.getRawVector();
+    VectorXd g = (-jacobian.transpose() * alpha_weight_ * dx);
+
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> A =
+        MatrixXd::Zero(IK_CONSTRAINT_NUMBER - IK_COLLISION_CONSTRAINT_NUMBER, IK_JOINT_NUMBER);
+    A.topLeftCorner(6, 6) = MatrixXd::Identity(6, 6) * sampling_period_;
+    A.block(6, 0, 3, 6) = jacobian.topLeftCorner(3, 6) * sampling_period_;
+    A.bottomLeftCorner(3, 6) = jacobian.bottomLeftCorner(3, 6) * sampling_period_;
+
+    /* Free space axes : the IK uses +/- 10 around the current position for the axes which move */
+    const double inf = 10.0;
+    double lbA[12], ubA[12];
+    for (int i = 0; i < 6; i++)
+    {
+      lbA[i] = q_lower_limit_[i] - q_current[i];
+      ubA[i] = q_upper_limit_[i] - q_current[i];
+      lbA[6 + i] = -inf;
+      ubA[6 + i] = inf;
+    }
+
+    qpOASES::real_t xOpt[6];
+    qpOASES::int_t nWSR = 10;
+    int qp_return = 0;
+    if (!QP_)
+    {
+      QP_.reset(new qpOASES::SQProblem(6, 12));
+      qpOASES::Options options;
+      options.setToReliable();
+      options.printLevel = qpOASES::PL_NONE;
+      QP_->setOptions(options);
+      nWSR = 5 * (6 + 12);
+      qp_return = QP_->init(hessian.data(), g.data(), A.data(), dq_lower_limit_, dq_upper_limit_, lbA, ubA, nWSR, 0);
+    }
+    else
+    {
+      qp_return =
+          QP_->hotstart(hessian.data(), g.data(), A.data(), dq_lower_limit_, dq_upper_limit_, lbA, ubA, nWSR, 0);
+    }
+
+    if (qp_return != qpOASES::SUCCESSFUL_RETURN)
+    {
+      for (int i = 0; i < 6; i++)
+      {
+        dq_computed[i] = 0.0;
+      }
+      return false;
+    }
+    QP_->getPrimalSolution(xOpt);
+    for (int i = 0; i < 6; i++)
+    {
+      dq_computed[i] = xOpt[i];
+    }
+    return true;
+  }
+
+private:
+  double sampling_period_;
+  MatrixXd alpha_weight_;
+  MatrixXd beta_weight_;
+  double dq_lower_limit_[IK_JOINT_NUMBER];
+  double dq_upper_limit_[IK_JOINT_NUMBER];
+  std::vector<double> q_lower_limit_;
+  std::vector<double> q_upper_limit_;
+  std::unique_ptr<qpOASES::SQProblem> QP_;
+};
+}
+
+/*
+ * Measure InverseKinematic::resolveInverseKinematic solve time.
+ *
+ * The IK loop is run offline (no driver needed, only robot_description and the settings.yaml parameters) with a
+ * smooth synthetic space velocity, at the configured sampling_frequency. Joint positions are integrated from the
+ * computed velocities so that the QP follows a realistic trajectory. Solve time distribution is printed at the end.
+ *
+ * With dynamic_size:=true, the solve of the dynamic-size data path (see DynamicSizeIk) is measured instead, on the
+ * same trajectory. It solves a smaller QP than the current IK : compare it to a run with
+ * ik_collision_avoidance:=false, ik_joint_max_acc:=0 and ik_joint_max_jerk:=0.
+ */
+int main(int argc, char** argv)
+{
+  ros::init(argc, argv, "ik_benchmark");
+  ros::NodeHandle nh_private("~");
+
+  int joint_number = 6;
+  int sampling_freq = 10;
+  int iterations = 2000;
+  nh_private.getParam("joint_number", joint_number);
+  nh_private.getParam("sampling_frequency", sampling_freq);
+  nh_private.getParam("iterations", iterations);
+  bool dynamic_size = false;
+  nh_private.getParam("dynamic_size", dynamic_size);
+  if (sampling_freq <= 0 || iterations <= 0)
+  {
+    ROS_ERROR("sampling_frequency and iterations must be greater than zero");
+    return 1;
+  }
+  const double sampling_period = 1.0 / sampling_freq;
+
+  JointPosition q_current(joint_number);
+  std::vector<double> rest_position;
+  if (nh_private.getParam("rest_position", rest_position) && rest_position.size() == joint_number)
+  {
+    std::copy(rest_position.begin(), rest_position.end(), q_current.begin());
+  }
+
+  KinematicCache kc(joint_number);
+  ForwardKinematic fk(joint_number);
+  InverseKinematic ik(joint_number, nh_private);
+  kc.init("tool_link");
+  fk.init(kc);
+  ik.init(kc, sampling_period);
+  DynamicSizeIk dynamic_size_ik(nh_private, sampling_period);
+
+  SpacePosition x_current;
+  SpaceVelocity dx_desired;
+  JointVelocity dq_computed(joint_number);
+  Distribution solve_time_us;
+  solve_time_us.reserve(iterations);
+  int qp_iterations_max = 0;
+  int qp_failures = 0;
+  int qp_budget_exceeded = 0;
+  double qp_cpu_time_max = 0.0;
+
+  for (int i = 0; i < iterations && ros::ok(); i++)
+  {
+    /* Slow circle in the YZ plane, with a small rotation around X */
+    const double t = i * sampling_period;
+    dx_desired[0] = 0.0;
+    dx_desired[1] = 0.02 * std::cos(0.5 * t);
+    dx_desired[2] = 0.02 * std::sin(0.5 * t);
+    dx_desired[3] = 0.0;
+    dx_desired[4] = 0.0;
+    dx_desired[5] = 0.0;
+    dx_desired[6] = 0.0;
+
+    fk.setQCurrent(q_current);
+    fk.resolveForwardKinematic();
+    fk.getXCurrent(x_current);
+
+    if (dynamic_size)
+    {
+      ros::WallTime start = ros::WallTime::now();
+      const bool success = dynamic_size_ik.resolveInverseKinematic(kc, q_current, dx_desired, dq_computed);
+      solve_time_us.add((ros::WallTime::now() - start).toSec() * 1e6);
+      qp_failures += success ? 0 : 1;
+      for (int j = 0; j < joint_number; j++)
+      {
+        q_current[j] += dq_computed[j] * sampling_period;
+      }
+      continue;
+    }
+
+    ros::WallTime start = ros::WallTime::now();
+    ik.setQCurrent(q_current);
+    ik.setXCurrent(x_current);
+    ik.resolveInverseKinematic(dq_computed, dx_desired);
+    solve_time_us.add((ros::WallTime::now() - start).toSec() * 1e6);
+    qp_iterations_max = std::max(qp_iterations_max, ik.getLastSolveReport().iterations);
+    qp_failures += ik.getLastSolveReport().success ? 0 : 1;
+    qp_budget_exceeded += ik.getLastSolveReport().budget_exceeded ? 1 : 0;
+    qp_cpu_time_max = std::max(qp_cpu_time_max, ik.getLastSolveReport().cpu_time);
+
+    for (int j = 0; j < joint_number; j++)
+    {
+      q_current[j] += dq_computed[j] * sampling_period;
+    }
+  }
+
+  ROS_INFO("IK solve time over %zu iterations at %d Hz, %s matrices (us) : %s", solve_time_us.size(), sampling_freq,
+           dynamic_size ? "dynamic-size" : "fixed-size", solve_time_us.format().c_str());
+  ROS_INFO("QP : max iterations %d, max solver time %.1f us, failures %d (budget exceeded %d)", qp_iterations_max,
+           qp_cpu_time_max * 1e6, qp_failures, qp_budget_exceeded);
+
+  return 0;
+}
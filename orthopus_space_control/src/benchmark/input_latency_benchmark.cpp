@@ -0,0 +1,142 @@
+/*
+ *  input_latency_benchmark.cpp
+ *  Copyright (C) 2019 Orthopus
+ *  All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <atomic>
+
+#include "ros/ros.h"
+
+#include "geometry_msgs/TwistStamped.h"
+#include "std_msgs/Time.h"
+
+#include "orthopus_space_control/utils/distribution.h"
+
+using namespace space_control;
+
+namespace
+{
+std::atomic<double> last_bus_write(0.0); /*!< Time (s) of the last bus write of a new position command */
+
+void callbackBusWrite(const std_msgs::TimeConstPtr& msg)
+{
+  last_bus_write = msg->data.toSec();
+}
+
+void publishInput(ros::Publisher& input_pub, const double linear_y)
+{
+  geometry_msgs::TwistStamped input;
+  input.header.stamp = ros::Time::now();
+  input.twist.linear.y = linear_y;
+  input_pub.publish(input);
+}
+}
+
+/*
+ * Measure the end-to-end latency from the input device to the bus write.
+ *
+ * The benchmark takes the place of the input device : it sends velocity steps on the input device topic, and waits
+ * for the first bus write of a new position command, published by niryo_one_driver (publish_bus_writes). Between two
+ * steps, the input is set back to zero until no new command is written for rest_duration. Steps alternate between
+ * +y and -y, so that the arm stays around its start pose.
+ *
+ * The whole chain is measured : intake of the input, control cycle (up to one sampling period of wait), command
+ * publication, driver controller, ros_control loop and bus write loop (can_hw_write_frequency). The latter runs at
+ * fixed rates whatever the transport : run the benchmark with use_nodelets:=true and use_nodelets:=false (driver and
+ * cartesian controller) to compare the two. The cartesian controller must be in space control (select a position in
+ * the web app), and no input device node must run.
+ */
+int main(int argc, char** argv)
+{
+  ros::init(argc, argv, "input_latency_benchmark");
+  ros::NodeHandle nh;
+  ros::NodeHandle nh_private("~");
+
+  int steps = 50;
+  double step_input = 0.5;
+  double step_duration = 0.3;
+  double rest_duration = 0.5;
+  double timeout = 1.0;
+  nh_private.getParam("steps", steps);
+  nh_private.getParam("step_input", step_input);
+  nh_private.getParam("step_duration", step_duration);
+  nh_private.getParam("rest_duration", rest_duration);
+  nh_private.getParam("timeout", timeout);
+  if (steps <= 0 || step_input <= 0.0 || timeout <= 0.0)
+  {
+    ROS_ERROR("steps, step_input and timeout must be greater than zero");
+    return 1;
+  }
+
+  ros::Publisher input_pub =
+      nh.advertise<geometry_msgs::TwistStamped>("/orthopus_space_control/input_device_velocity", 1);
+  ros::Subscriber bus_write_sub = nh.subscribe("/niryo_one/bus_write", 10, callbackBusWrite);
+  ros::AsyncSpinner spinner(1);
+  spinner.start();
+
+  ros::WallTime connection_timeout = ros::WallTime::now() + ros::WallDuration(10.0);
+  while ((input_pub.getNumSubscribers() == 0 || bus_write_sub.getNumPublishers() == 0) && ros::ok())
+  {
+    if (ros::WallTime::now() > connection_timeout)
+    {
+      ROS_ERROR("No cartesian controller or no bus write publisher (start niryo_one_driver with "
+                "publish_bus_writes:=true)");
+      return 1;
+    }
+    ros::WallDuration(0.01).sleep();
+  }
+
+  Distribution latency_ms;
+  latency_ms.reserve(steps);
+  int missed_steps = 0;
+  ros::Rate poll_rate(1000);
+  for (int k = 0; k < steps && ros::ok(); k++)
+  {
+    /* Rest : the arm stops (acceleration limits) and the bus is written with the same command again */
+    publishInput(input_pub, 0.0);
+    while (ros::Time::now().toSec() - last_bus_write < rest_duration && ros::ok())
+    {
+      poll_rate.sleep();
+    }
+
+    /* Step : wait for the first new command on the bus */
+    const double step_time = ros::Time::now().toSec();
+    publishInput(input_pub, (k % 2 == 0) ? step_input : -step_input);
+    while (last_bus_write <= step_time && ros::Time::now().toSec() - step_time < timeout && ros::ok())
+    {
+      poll_rate.sleep();
+    }
+    if (last_bus_write > step_time)
+    {
+      latency_ms.add((last_bus_write - step_time) * 1e3);
+    }
+    else
+    {
+      missed_steps++;
+    }
+    ros::Duration(step_duration).sleep();
+  }
+  publishInput(input_pub, 0.0);
+
+  ROS_INFO("Input to bus write latency over %zu steps (ms) : %s", latency_ms.size(), latency_ms.format().c_str());
+  if (missed_steps > 0)
+  {
+    ROS_WARN("%d steps without bus write within %g s (is the cartesian controller in space control ?)", missed_steps,
+             timeout);
+  }
+
+  return 0;
+}
@@ -16,6 +16,8 @@
  *  You should have received a copy of the GNU General Public License
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <chrono>
+
 #include "ros/ros.h"
 
 #include "tf2/LinearMath/Quaternion.h"
@@ -25,17 +27,30 @@
 #include "std_msgs/UInt16.h"
 
 #include "orthopus_space_control/cartesian_controller.h"
+#include "orthopus_space_control/trace.h"
 
 #define INIT_TIME 2
 
 namespace space_control
 {
-CartesianController::CartesianController(const int joint_number)
-  : tc_(joint_number)
-  , ik_(joint_number)
+namespace
+{
+double elapsed(std::chrono::steady_clock::time_point& since)
+{
+  const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  const double duration = std::chrono::duration<double>(now - since).count();
+  since = now;
+  return duration;
+}
+}
+
+CartesianController::CartesianController(const int joint_number, const ros::NodeHandle& nh_private)
+  : kc_(joint_number)
+  , tc_(joint_number, nh_private)
+  , ik_(joint_number, nh_private)
   , fk_(joint_number)
-  , vi_(joint_number)
-  , jpm_(joint_number)
+  , vi_(joint_number, nh_private)
+  , jpm_(joint_number, nh_private)
   , joint_number_(joint_number)
   , x_current_()
   , x_orientation_constraint_()
@@ -49,6 +64,9 @@ CartesianController::CartesianController(const int joint_number)
   , q_current_(joint_number)
   , dq_desired_(joint_number)
   , sampling_period_(0.0)
+  , input_selector_(INPUT_TRAJECTORY)
+  , stage_durations_()
+  , reset_count_(0)
 {
   ROS_DEBUG_STREAM("CartesianController constructor");
 }
@@ -59,12 +77,10 @@ void CartesianController::init(double sampling_period, JointPoseManager& joint_p
   jpm_ = joint_pose_manager;
   sampling_period_ = sampling_period;
 
-  /* This is use to update joint state before running anything */
-  ros::spinOnce();
-
   tc_.init(sampling_period_);
-  ik_.init("tool_link", sampling_period_);
-  fk_.init("tool_link");
+  kc_.init("tool_link");
+  ik_.init(kc_, sampling_period_);
+  fk_.init(kc_);
   vi_.init(sampling_period_);
 }
 
@@ -84,8 +100,10 @@ void CartesianController::setControlFeedbackPublisher(ros::Publisher& control_fe
 void CartesianController::reset()
 {
   tc_.reset();
-  fk_.reset();
+  kc_.reset();
   ik_.reset();
+  vi_.reset();
+  reset_count_++;
 }
 
 void CartesianController::setDxDesired(const SpaceVelocity& dx_desired)
@@ -100,51 +118,47 @@ void CartesianController::setInputSelector(const InputSelectorType input_selecto
 
 void CartesianController::run(const JointPosition& q_current, JointPosition& q_command)
 {
-  ROS_INFO("---- Execute cartesian control loop ----");
+  /* Hot path : no logging here, events are recorded with SPACE_CONTROL_TRACE (see trace.h) */
   q_current_ = q_current;
+  std::chrono::steady_clock::time_point stage_begin = std::chrono::steady_clock::now();
 
-  ROS_INFO("=== Start FK computation...");
-  ROS_DEBUG_STREAM("Input joint position :");
-  ROS_DEBUG_STREAM("q_current_           : " << q_current_);
+  SPACE_CONTROL_TRACE(trace::Event::FkBegin, 0, 0.0);
   fk_.setQCurrent(q_current_);
   fk_.resolveForwardKinematic();
   fk_.getXCurrent(x_current_);
-  ROS_DEBUG_STREAM("Forward kinematic computes space position : ");
-  ROS_DEBUG_STREAM("x_current_           : " << x_current_);
+  SPACE_CONTROL_TRACE(trace::Event::FkEnd, 0, 0.0);
+  stage_durations_.fk = elapsed(stage_begin);
 
   if (input_selector_ == INPUT_TRAJECTORY)
   {
     /* If input trajectory is selected, user input is ignore */
-    ROS_INFO("=== Perform trajectory control...");
+    SPACE_CONTROL_TRACE(trace::Event::TrajectoryBegin, 0, 0.0);
     tc_.setXCurrent(x_current_);
     tc_.computeTrajectory(dx_desired_selected_);
-    ROS_DEBUG_STREAM("Trajectory controller generates space velocity :");
-    ROS_DEBUG_STREAM("dx_desired_selected_ : " << dx_desired_selected_);
+    SPACE_CONTROL_TRACE(trace::Event::TrajectoryEnd, 0, dx_desired_selected_.getPosition().norm());
   }
   else
   {
-    ROS_INFO("=== Retrieve user space velocity...");
-    ROS_DEBUG_STREAM("User sent space velocity : ");
-    ROS_DEBUG_STREAM("dx_desired_ : " << dx_desired_);
     dx_desired_selected_ = dx_desired_;
   }
+  stage_durations_.trajectory = elapsed(stage_begin);
 
-  ROS_INFO("=== Start IK computation...");
+  SPACE_CONTROL_TRACE(trace::Event::IkBegin, 0, dx_desired_selected_.getPosition().norm());
   ik_.setQCurrent(q_current_);
   ik_.setXCurrent(x_current_);
   ik_.resolveInverseKinematic(dq_desired_, dx_desired_selected_);
-  ROS_DEBUG_STREAM("Inverse kinematic computes joint velocity :");
-  ROS_DEBUG_STREAM("dq_desired_          : " << dq_desired_);
+  SPACE_CONTROL_TRACE(trace::Event::IkEnd, ik_.getLastSolveReport().success || ik_.getLastSolveReport().fallback_used,
+                      ik_.getLastSolveReport().objective);
+  stage_durations_.ik = elapsed(stage_begin);
 
-  ROS_INFO("=== Integrate joint velocity...");
+  SPACE_CONTROL_TRACE(trace::Event::IntegrateBegin, 0, 0.0);
   vi_.setQCurrent(q_current_);
   vi_.integrate(dq_desired_, q_command_);
-  ROS_DEBUG_STREAM("Velocity integrator computes joint position :");
-  ROS_DEBUG_STREAM("q_command_           : " << q_command_);
+  SPACE_CONTROL_TRACE(trace::Event::IntegrateEnd, 0, 0.0);
+  stage_durations_.integrate = elapsed(stage_begin);
 
   /* Write joint command output */
   q_command = q_command_;
-  ROS_INFO("----------------------------------------");
   publishControlFeedbackTopic_();
   publishDebugTopic_();
 }
@@ -159,8 +173,38 @@ InverseKinematic* CartesianController::getInverseKinematic()
   return &ik_;
 }
 
+CartesianController::InputSelectorType CartesianController::getInputSelector() const
+{
+  return input_selector_;
+}
+
+const SpacePosition& CartesianController::getXCurrent() const
+{
+  return x_current_;
+}
+
+const SpaceVelocity& CartesianController::getDxDesiredSelected() const
+{
+  return dx_desired_selected_;
+}
+
+const CartesianController::StageDurations& CartesianController::getStageDurations() const
+{
+  return stage_durations_;
+}
+
+unsigned int CartesianController::getResetCount() const
+{
+  return reset_count_;
+}
+
 void CartesianController::publishControlFeedbackTopic_()
 {
+  /* Publishers are not set when the controller runs offline (see run_replay) */
+  if (!control_feedback_pub_)
+  {
+    return;
+  }
   std_msgs::UInt16 feedback;
   feedback.data = 0;
   if (ik_.getPositionControlFrame() == InverseKinematic::ControlFrame::Tool)
@@ -176,6 +220,11 @@ void CartesianController::publishControlFeedbackTopic_()
 
 void CartesianController::publishDebugTopic_()
 {
+  if (!q_current_debug_pub_ || !x_current_debug_pub_ || !dx_desired_debug_pub_)
+  {
+    return;
+  }
+
   /* debug current joint position */
   sensor_msgs::JointState q_current_state;
   q_current_state.position.resize(joint_number_);
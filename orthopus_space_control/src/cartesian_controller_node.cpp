@@ -0,0 +1,39 @@
+/*
+ *  cartesian_controller_node.cpp
+ *  Copyright (C) 2019 Orthopus
+ *  All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ros/ros.h"
+
+#include "orthopus_space_control/robot_manager.h"
+
+using namespace space_control;
+int main(int argc, char** argv)
+{
+  ros::init(argc, argv, "robot_manager");
+  ros::NodeHandle nh;
+  ros::NodeHandle nh_private("~");
+  int joint_number = 6;
+  bool debug = false;
+
+  nh_private.getParam("joint_number", joint_number);
+  nh_private.getParam("debug", debug);
+
+  RobotManager robot_manager(nh, nh_private, joint_number, debug);
+  robot_manager.run();
+
+  return 0;
+}
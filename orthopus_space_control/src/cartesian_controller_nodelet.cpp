@@ -0,0 +1,70 @@
+/*
+ *  cartesian_controller_nodelet.cpp
+ *  Copyright (C) 2019 Orthopus
+ *  All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ros/ros.h"
+
+#include "boost/shared_ptr.hpp"
+#include "boost/thread.hpp"
+#include "nodelet/nodelet.h"
+#include "pluginlib/class_list_macros.h"
+
+#include "orthopus_space_control/robot_manager.h"
+
+namespace space_control
+{
+/**
+* \brief Nodelet version of the cartesian controller
+*
+* Loaded in the same manager than niryo_one_driver nodelet, joint states and joint commands are exchanged through
+* shared pointers without serialization. Parameters are read from the nodelet private namespace.
+*/
+class CartesianControllerNodelet : public nodelet::Nodelet
+{
+public:
+  virtual ~CartesianControllerNodelet()
+  {
+    if (robot_manager_)
+    {
+      robot_manager_->stop();
+    }
+    if (control_thread_.joinable())
+    {
+      control_thread_.join();
+    }
+  }
+
+  virtual void onInit()
+  {
+    int joint_number = 6;
+    bool debug = false;
+
+    getPrivateNodeHandle().getParam("joint_number", joint_number);
+    getPrivateNodeHandle().getParam("debug", debug);
+
+    robot_manager_.reset(new RobotManager(getNodeHandle(), getPrivateNodeHandle(), joint_number, debug));
+    /* onInit must return : the control loop (which waits for the first joint state) runs in its own thread */
+    control_thread_ = boost::thread(&RobotManager::run, robot_manager_.get());
+  }
+
+private:
+  boost::shared_ptr<RobotManager> robot_manager_;
+  boost::thread control_thread_;
+};
+}
+
+PLUGINLIB_EXPORT_CLASS(space_control::CartesianControllerNodelet, nodelet::Nodelet)
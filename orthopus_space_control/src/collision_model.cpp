@@ -0,0 +1,362 @@
+/*
+ *  collision_model.cpp
+ *  Copyright (C) 2019 Orthopus
+ *  All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <cmath>
+
+#include "ros/ros.h"
+
+#include "orthopus_space_control/collision_model.h"
+
+namespace space_control
+{
+constexpr int NiryoOneCollisionModel::LINK_NUMBER;
+constexpr int NiryoOneCollisionModel::MAX_OBSTACLE_NUMBER;
+constexpr int NiryoOneCollisionModel::MAX_PAIR_NUMBER;
+constexpr int NiryoOneCollisionModel::TABLE_FIRST_LINK;
+
+namespace
+{
+/*
+ * Link capsules (a, b, radius) in link frame, from base_link to hand_link. The segment follows the principal axis of
+ * the STL collision mesh (niryo_one_description/meshes/v1 and v2), the radius is the largest distance of a mesh vertex
+ * to this axis, and the ends are pulled in as much as possible while keeping every vertex inside the capsule.
+ */
+const double CAPSULES_V1[NiryoOneCollisionModel::LINK_NUMBER][7] = {
+  { -0.0051, -0.0517, 0.0464, -0.0051, 0.0517, 0.0464, 0.0883 },  /* base_link */
+  { -0.0122, -0.0425, 0.0392, -0.0122, 0.0561, 0.0392, 0.0853 },  /* shoulder_link */
+  { -0.0158, -0.0007, 0.0050, 0.2200, -0.0007, 0.0050, 0.0651 },  /* arm_link */
+  { -0.0749, 0.0064, -0.0036, 0.0316, 0.0060, -0.0077, 0.0512 },  /* elbow_link */
+  { 0.0, 0.0, 0.0074, 0.0, 0.0, 0.1890, 0.0495 },                 /* forearm_link */
+  { -0.0459, 0.0045, -0.0001, 0.0114, 0.0045, -0.0001, 0.0250 },  /* wrist_link */
+  { 0.0, -0.0138, 0.0050, 0.0, 0.0080, 0.0050, 0.0182 }           /* hand_link */
+};
+
+const double CAPSULES_V2[NiryoOneCollisionModel::LINK_NUMBER][7] = {
+  { -0.0059, -0.0861, 0.0437, -0.0059, 0.0837, 0.0437, 0.0896 },  /* base_link */
+  { 0.0171, -0.0111, 0.0604, -0.0432, 0.0371, 0.0308, 0.0856 },   /* shoulder_link */
+  { -0.0136, -0.0001, 0.0040, 0.2285, -0.0001, 0.0040, 0.0661 },  /* arm_link */
+  { -0.0021, 0.0416, -0.0001, 0.0050, -0.0106, -0.0139, 0.0499 }, /* elbow_link */
+  { -0.0102, 0.0, 0.0123, -0.0102, 0.0, 0.1897, 0.0523 },         /* forearm_link */
+  { -0.0011, -0.0116, 0.0004, -0.0495, 0.0026, 0.0, 0.0262 },     /* wrist_link */
+  { 0.0, -0.0237, 0.0067, 0.0, 0.0180, 0.0067, 0.0188 }           /* hand_link */
+};
+
+/* Self-collision pairs enabled in niryo_one.srdf (all the other pairs are adjacent or never in collision) */
+const int SELF_COLLISION_PAIR_NUMBER = 6;
+const int SELF_COLLISION_PAIRS[SELF_COLLISION_PAIR_NUMBER][2] = { { 4, 0 }, { 5, 0 }, { 6, 0 },
+                                                                  { 4, 1 }, { 5, 1 }, { 6, 1 } };
+}
+
+NiryoOneCollisionModel::NiryoOneCollisionModel() : valid_(false), table_height_(0.0), pair_number_(0)
+{
+  /* Unused pairs are two points far apart, so that the whole arrays always hold finite values */
+  ax0_.setZero();
+  ay0_.setZero();
+  az0_.setZero();
+  ax1_.setZero();
+  ay1_.setZero();
+  az1_.setZero();
+  radius_a_.setZero();
+  bx0_.setConstant(1000.0);
+  by0_.setZero();
+  bz0_.setZero();
+  bx1_.setConstant(1000.0);
+  by1_.setZero();
+  bz1_.setZero();
+  radius_b_.setZero();
+  s_.setZero();
+  t_.setZero();
+  distance_.setConstant(1000.0);
+  std::fill(table_distance_, table_distance_ + LINK_NUMBER, 1000.0);
+}
+
+bool NiryoOneCollisionModel::init(const int hardware_version, const double table_height,
+                                  const std::vector<double>& obstacles)
+{
+  valid_ = false;
+  pair_number_ = 0;
+  if (hardware_version != 1 && hardware_version != 2)
+  {
+    ROS_ERROR("NiryoOneCollisionModel : incorrect hardware version %d, collisions are not checked", hardware_version);
+    return false;
+  }
+
+  const double(*capsules)[7] = (hardware_version == 1) ? CAPSULES_V1 : CAPSULES_V2;
+  for (int i = 0; i < LINK_NUMBER; i++)
+  {
+    capsule_[i].a = Eigen::Vector3d(capsules[i][0], capsules[i][1], capsules[i][2]);
+    capsule_[i].b = Eigen::Vector3d(capsules[i][3], capsules[i][4], capsules[i][5]);
+    capsule_[i].radius = capsules[i][6];
+  }
+  /* base_link does not move */
+  world_[0] = capsule_[0];
+  table_height_ = table_height;
+
+  for (int i = 0; i < SELF_COLLISION_PAIR_NUMBER; i++)
+  {
+    pair_link_a_[pair_number_] = SELF_COLLISION_PAIRS[i][0];
+    pair_link_b_[pair_number_] = SELF_COLLISION_PAIRS[i][1];
+    pair_number_++;
+  }
+
+  /* Obstacles are static : they are written once in the b side of their pairs */
+  const int obstacle_number = static_cast<int>(obstacles.size() / 4);
+  if (obstacles.size() % 4 != 0 || obstacle_number > MAX_OBSTACLE_NUMBER)
+  {
+    ROS_WARN("NiryoOneCollisionModel : obstacles should be at most %d spheres (x, y, z, radius), the first %d are used",
+             MAX_OBSTACLE_NUMBER, std::min(obstacle_number, MAX_OBSTACLE_NUMBER));
+  }
+  for (int k = 0; k < std::min(obstacle_number, MAX_OBSTACLE_NUMBER); k++)
+  {
+    CollisionCapsule sphere;
+    sphere.a = Eigen::Vector3d(obstacles[4 * k], obstacles[4 * k + 1], obstacles[4 * k + 2]);
+    sphere.b = sphere.a;
+    sphere.radius = obstacles[4 * k + 3];
+    for (int link = 1; link < LINK_NUMBER; link++)
+    {
+      pair_link_a_[pair_number_] = link;
+      pair_link_b_[pair_number_] = -1;
+      setPairSegment_(pair_number_, sphere, false);
+      pair_number_++;
+    }
+  }
+
+  for (int p = 0; p < pair_number_; p++)
+  {
+    if (pair_link_b_[p] == 0)
+    {
+      setPairSegment_(p, world_[0], false);
+    }
+  }
+
+  valid_ = true;
+  ROS_INFO("NiryoOneCollisionModel : V%d capsules, %d pairs checked (%d obstacles), table at z = %g m",
+           hardware_version, pair_number_, std::min(obstacle_number, MAX_OBSTACLE_NUMBER), table_height_);
+  return true;
+}
+
+bool NiryoOneCollisionModel::isValid() const
+{
+  return valid_;
+}
+
+void NiryoOneCollisionModel::update(const NiryoOneKinematicState& state)
+{
+  if (!valid_)
+  {
+    return;
+  }
+
+  for (int i = 1; i < LINK_NUMBER; i++)
+  {
+    world_[i].a.noalias() = state.link_position[i - 1] + state.link_rotation[i - 1] * capsule_[i].a;
+    world_[i].b.noalias() = state.link_position[i - 1] + state.link_rotation[i - 1] * capsule_[i].b;
+    world_[i].radius = capsule_[i].radius;
+  }
+
+  for (int p = 0; p < pair_number_; p++)
+  {
+    setPairSegment_(p, world_[pair_link_a_[p]], true);
+    if (pair_link_b_[p] > 0)
+    {
+      setPairSegment_(p, world_[pair_link_b_[p]], false);
+    }
+  }
+  computePairDistances_();
+
+  for (int i = TABLE_FIRST_LINK; i < LINK_NUMBER; i++)
+  {
+    table_distance_[i] = std::min(world_[i].a.z(), world_[i].b.z()) - world_[i].radius - table_height_;
+  }
+}
+
+void NiryoOneCollisionModel::setPairSegment_(const int pair, const CollisionCapsule& capsule, const bool first)
+{
+  if (first)
+  {
+    ax0_(pair) = capsule.a.x();
+    ay0_(pair) = capsule.a.y();
+    az0_(pair) = capsule.a.z();
+    ax1_(pair) = capsule.b.x();
+    ay1_(pair) = capsule.b.y();
+    az1_(pair) = capsule.b.z();
+    radius_a_(pair) = capsule.radius;
+  }
+  else
+  {
+    bx0_(pair) = capsule.a.x();
+    by0_(pair) = capsule.a.y();
+    bz0_(pair) = capsule.a.z();
+    bx1_(pair) = capsule.b.x();
+    by1_(pair) = capsule.b.y();
+    bz1_(pair) = capsule.b.z();
+    radius_b_(pair) = capsule.radius;
+  }
+}
+
+void NiryoOneCollisionModel::computePairDistances_()
+{
+  /*
+   * Closest points of segments a0 + s*d1 and b0 + t*d2 with s, t in [0, 1] (C. Ericson, Real-Time Collision
+   * Detection, 5.1.9), written without branches :
+   *        s = clamp((b*f - c*e) / (a*e - b^2))   (0 if the segments are parallel)
+   *        t = clamp((b*s + f) / e)
+   *        s = clamp((b*t - c) / a)
+   * with a = d1.d1, b = d1.d2, c = d1.r, e = d2.d2, f = d2.r and r = a0 - b0. Degenerated segments (spheres) give
+   * s = 0 or t = 0.
+   */
+  const double eps = 1e-12;
+  const PairArray d1x = ax1_ - ax0_, d1y = ay1_ - ay0_, d1z = az1_ - az0_;
+  const PairArray d2x = bx1_ - bx0_, d2y = by1_ - by0_, d2z = bz1_ - bz0_;
+  const PairArray rx = ax0_ - bx0_, ry = ay0_ - by0_, rz = az0_ - bz0_;
+
+  const PairArray a = d1x * d1x + d1y * d1y + d1z * d1z;
+  const PairArray b = d1x * d2x + d1y * d2y + d1z * d2z;
+  const PairArray c = d1x * rx + d1y * ry + d1z * rz;
+  const PairArray e = d2x * d2x + d2y * d2y + d2z * d2z;
+  const PairArray f = d2x * rx + d2y * ry + d2z * rz;
+  const PairArray denominator = a * e - b * b;
+
+  s_ = (denominator > eps).select(((b * f - c * e) / denominator.max(eps)).max(0.0).min(1.0), 0.0);
+  t_ = ((b * s_ + f) / e.max(eps)).max(0.0).min(1.0);
+  s_ = ((b * t_ - c) / a.max(eps)).max(0.0).min(1.0);
+
+  const PairArray dx = rx + d1x * s_ - d2x * t_;
+  const PairArray dy = ry + d1y * s_ - d2y * t_;
+  const PairArray dz = rz + d1z * s_ - d2z * t_;
+  distance_ = (dx * dx + dy * dy + dz * dz).sqrt() - radius_a_ - radius_b_;
+}
+
+int NiryoOneCollisionModel::selectNearest(const int count, const double activation_distance,
+                                          CollisionDistance* nearest) const
+{
+  if (!valid_ || count <= 0)
+  {
+    return 0;
+  }
+
+  /* Insertion in a sorted list of at most count candidates (pairs, then table distances) */
+  int selected[MAX_PAIR_NUMBER + LINK_NUMBER];
+  double selected_distance[MAX_PAIR_NUMBER + LINK_NUMBER];
+  const int max_count = std::min(count, MAX_PAIR_NUMBER + LINK_NUMBER);
+  int selected_number = 0;
+  const int candidate_number = pair_number_ + LINK_NUMBER - TABLE_FIRST_LINK;
+  for (int i = 0; i < candidate_number; i++)
+  {
+    const double d = (i < pair_number_) ? distance_(i) : table_distance_[TABLE_FIRST_LINK + i - pair_number_];
+    if (d >= activation_distance || (selected_number == max_count && d >= selected_distance[max_count - 1]))
+    {
+      continue;
+    }
+    int j = std::min(selected_number, max_count - 1);
+    while (j > 0 && selected_distance[j - 1] > d)
+    {
+      selected[j] = selected[j - 1];
+      selected_distance[j] = selected_distance[j - 1];
+      j--;
+    }
+    selected[j] = i;
+    selected_distance[j] = d;
+    selected_number = std::min(selected_number + 1, max_count);
+  }
+
+  for (int k = 0; k < selected_number; k++)
+  {
+    getDistance_(selected[k], nearest[k]);
+  }
+  return selected_number;
+}
+
+double NiryoOneCollisionModel::getMinimumDistance() const
+{
+  if (!valid_)
+  {
+    return distance_(0);
+  }
+  double minimum = distance_.head(pair_number_).minCoeff();
+  for (int i = TABLE_FIRST_LINK; i < LINK_NUMBER; i++)
+  {
+    minimum = std::min(minimum, table_distance_[i]);
+  }
+  return minimum;
+}
+
+void NiryoOneCollisionModel::getDistance_(const int candidate, CollisionDistance& distance) const
+{
+  if (candidate < pair_number_)
+  {
+    const int p = candidate;
+    distance.link_a = pair_link_a_[p];
+    distance.link_b = pair_link_b_[p];
+    distance.distance = distance_(p);
+    distance.point_a = Eigen::Vector3d(ax0_(p), ay0_(p), az0_(p)) +
+                       s_(p) * Eigen::Vector3d(ax1_(p) - ax0_(p), ay1_(p) - ay0_(p), az1_(p) - az0_(p));
+    distance.point_b = Eigen::Vector3d(bx0_(p), by0_(p), bz0_(p)) +
+                       t_(p) * Eigen::Vector3d(bx1_(p) - bx0_(p), by1_(p) - by0_(p), bz1_(p) - bz0_(p));
+    distance.normal = distance.point_a - distance.point_b;
+    const double norm = distance.normal.norm();
+    /* Crossing segments : any direction separates them, the one between the capsule centers is used */
+    if (norm < 1e-9)
+    {
+      distance.normal = (distance.point_a - 0.5 * (world_[distance.link_a].a + world_[distance.link_a].b)) -
+                        (distance.point_b - 0.5 * Eigen::Vector3d(bx0_(p) + bx1_(p), by0_(p) + by1_(p),
+                                                                  bz0_(p) + bz1_(p)));
+      distance.normal = (distance.normal.norm() < 1e-9) ? Eigen::Vector3d::UnitZ() : distance.normal.normalized();
+    }
+    else
+    {
+      distance.normal /= norm;
+    }
+  }
+  else
+  {
+    /* Table : the lowest end of the segment, above its projection on the plane */
+    const int link = TABLE_FIRST_LINK + candidate - pair_number_;
+    const CollisionCapsule& capsule = world_[link];
+    distance.link_a = link;
+    distance.link_b = -1;
+    distance.distance = table_distance_[link];
+    distance.point_a = (capsule.a.z() <= capsule.b.z()) ? capsule.a : capsule.b;
+    distance.point_b = Eigen::Vector3d(distance.point_a.x(), distance.point_a.y(), table_height_);
+    distance.normal = Eigen::Vector3d::UnitZ();
+  }
+}
+
+void NiryoOneCollisionModel::computeDistanceJacobian(const CollisionDistance& distance,
+                                                     const NiryoOneKinematicState& state,
+                                                     Eigen::Matrix<double, 1, 6>& jacobian) const
+{
+  /* d distance / dt = normal.(v_a - v_b), v being the velocity of the closest points */
+  jacobian.setZero();
+  addPointJacobian_(distance.link_a, distance.point_a, distance.normal, state, jacobian);
+  addPointJacobian_(distance.link_b, distance.point_b, -distance.normal, state, jacobian);
+}
+
+void NiryoOneCollisionModel::addPointJacobian_(const int link, const Eigen::Vector3d& point,
+                                               const Eigen::Vector3d& direction, const NiryoOneKinematicState& state,
+                                               Eigen::Matrix<double, 1, 6>& jacobian) const
+{
+  /* A point of link i only moves with joints 0 to i-1 (base_link and the environment do not move) */
+  for (int j = 0; j < link; j++)
+  {
+    const Eigen::Vector3d axis = state.jacobian.block<3, 1>(3, j);
+    jacobian(j) += direction.dot(axis.cross(point - state.link_position[j]));
+  }
+}
+}
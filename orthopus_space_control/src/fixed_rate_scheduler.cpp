@@ -0,0 +1,88 @@
+/*
+ *  fixed_rate_scheduler.cpp
+ *  Copyright (C) 2019 Orthopus
+ *  All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <thread>
+
+#include "orthopus_space_control/fixed_rate_scheduler.h"
+
+namespace space_control
+{
+FixedRateScheduler::FixedRateScheduler() : period_(Clock::duration::zero())
+{
+  resetStatistics();
+}
+
+void FixedRateScheduler::start(const double period)
+{
+  period_ = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(period));
+  cycle_start_ = Clock::now();
+  deadline_ = cycle_start_ + period_;
+}
+
+bool FixedRateScheduler::sleep()
+{
+  const Clock::time_point end = Clock::now();
+  const double compute_time = std::chrono::duration<double>(end - cycle_start_).count();
+  const uint64_t n = statistics_.cycles;
+  statistics_.cycles++;
+  statistics_.compute_time_mean += (compute_time - statistics_.compute_time_mean) / statistics_.cycles;
+  statistics_.compute_time_max = std::max(statistics_.compute_time_max, compute_time);
+
+  const bool overrun = (end > deadline_);
+  if (overrun)
+  {
+    statistics_.overruns++;
+    /* Keep the phase : wake up at the first deadline still ahead */
+    while (deadline_ <= end)
+    {
+      deadline_ += period_;
+      statistics_.missed_deadlines++;
+    }
+  }
+
+  std::this_thread::sleep_until(deadline_);
+  cycle_start_ = Clock::now();
+  const double latency = std::chrono::duration<double>(cycle_start_ - deadline_).count();
+  statistics_.wakeup_latency_mean += (latency - statistics_.wakeup_latency_mean) / (n + 1);
+  statistics_.wakeup_latency_max = std::max(statistics_.wakeup_latency_max, latency);
+  deadline_ += period_;
+  return !overrun;
+}
+
+double FixedRateScheduler::getPeriod() const
+{
+  return std::chrono::duration<double>(period_).count();
+}
+
+const FixedRateScheduler::Statistics& FixedRateScheduler::getStatistics() const
+{
+  return statistics_;
+}
+
+void FixedRateScheduler::resetStatistics()
+{
+  statistics_.cycles = 0;
+  statistics_.overruns = 0;
+  statistics_.missed_deadlines = 0;
+  statistics_.compute_time_mean = 0.0;
+  statistics_.compute_time_max = 0.0;
+  statistics_.wakeup_latency_mean = 0.0;
+  statistics_.wakeup_latency_max = 0.0;
+}
+}
@@ -23,80 +23,32 @@
 // Eigen
 #include "Eigen/Dense"
 
-// TF
-#include "tf/tf.h"
-
 namespace space_control
 {
 ForwardKinematic::ForwardKinematic(const int joint_number)
-  : joint_number_(joint_number), x_current_(), q_current_(joint_number)
-{
-  robot_model_loader::RobotModelLoader robot_model_loader("robot_description");
-  kinematic_model_ = robot_model_loader.getModel();
-  kinematic_state_ = std::make_shared<robot_state::RobotState>(kinematic_model_);
-  kinematic_state_->setToDefaultValues();
-  end_effector_link_ = "";
-}
-
-void ForwardKinematic::init(const std::string end_effector_link)
+  : joint_number_(joint_number), q_current_(joint_number), x_current_(), kinematic_cache_(nullptr)
 {
-  end_effector_link_ = end_effector_link;
-  init_flag_ = true;
 }
 
-void ForwardKinematic::reset()
+void ForwardKinematic::init(KinematicCache& kinematic_cache)
 {
-  init_flag_ = true;
+  kinematic_cache_ = &kinematic_cache;
 }
 
 void ForwardKinematic::resolveForwardKinematic()
 {
-  /* Set kinemtic state of the robot to the previous joint positions computed */
-  kinematic_state_->setVariablePositions(q_current_);
-  kinematic_state_->updateLinkTransforms();
-
-  /* Get the cartesian state of the tool_link frame */
-  const Eigen::Affine3d& end_effector_state =
-      kinematic_state_->getGlobalLinkTransform(kinematic_state_->getLinkModel(end_effector_link_));
-
-  /* Convert rotation matrix to quaternion */
-  Eigen::Quaterniond conv_quat(end_effector_state.linear());
-  /* Warning : During the convertion in quaternion, sign could change as there are tow quaternion definitions possible
-   * (q and -q) for the same rotation. The following code ensure quaternion continuity between to occurence of this
-   * method call
-   */
-  if (init_flag_)
-  {
-    init_flag_ = false;
-  }
-  else
-  {
-    /* Detect if a discontinuity happened between new quaternion and the previous one */
-    double diff_norm =
-        sqrt(pow(conv_quat.w() - x_current_.orientation.w(), 2) + pow(conv_quat.x() - x_current_.orientation.x(), 2) +
-             pow(conv_quat.y() - x_current_.orientation.y(), 2) + pow(conv_quat.z() - x_current_.orientation.z(), 2));
-    if (diff_norm > 1)
-    {
-      ROS_DEBUG_NAMED("ForwardKinematic", "A discontinuity has been detected during quaternion conversion.");
-      /* If discontinuity happened, change sign of the quaternion */
-      conv_quat.w() = -conv_quat.w();
-      conv_quat.x() = -conv_quat.x();
-      conv_quat.y() = -conv_quat.y();
-      conv_quat.z() = -conv_quat.z();
-    }
-    else
-    {
-      /* Else, do nothing and keep quaternion sign */
-    }
-  }
-
-  x_current_.position.x() = end_effector_state.translation()[0];
-  x_current_.position.y() = end_effector_state.translation()[1];
-  x_current_.position.z() = end_effector_state.translation()[2];
-  x_current_.orientation.w() = conv_quat.w();
-  x_current_.orientation.x() = conv_quat.x();
-  x_current_.orientation.y() = conv_quat.y();
-  x_current_.orientation.z() = conv_quat.z();
+  /* Pose is computed (or reused) by the shared kinematic cache, which also ensures quaternion sign continuity */
+  kinematic_cache_->update(q_current_);
+  const Eigen::Vector3d& position = kinematic_cache_->getPosition();
+  const Eigen::Quaterniond& orientation = kinematic_cache_->getOrientation();
+
+  x_current_.position.x() = position[0];
+  x_current_.position.y() = position[1];
+  x_current_.position.z() = position[2];
+  x_current_.orientation.w() = orientation.w();
+  x_current_.orientation.x() = orientation.x();
+  x_current_.orientation.y() = orientation.y();
+  x_current_.orientation.z() = orientation.z();
 }
 
 void ForwardKinematic::setQCurrent(const JointPosition& q_current)
@@ -0,0 +1,120 @@
+/*
+ *  ik_telemetry_publisher.cpp
+ *  Copyright (C) 2019 Orthopus
+ *  All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+
+#include "ros/ros.h"
+
+#include "orthopus_space_control/ik_telemetry_publisher.h"
+
+namespace space_control
+{
+IkTelemetryPublisher::IkTelemetryPublisher() : ring_(nullptr), rate_(0.0), running_(false)
+{
+}
+
+IkTelemetryPublisher::~IkTelemetryPublisher()
+{
+  stop();
+}
+
+void IkTelemetryPublisher::start(const ros::Publisher& publisher, IkTelemetryRing& ring, const double rate)
+{
+  stop();
+  if (rate <= 0.0)
+  {
+    ROS_INFO("IK telemetry publication is disabled");
+    return;
+  }
+  publisher_ = publisher;
+  ring_ = &ring;
+  rate_ = rate;
+  running_ = true;
+  thread_ = std::thread(&IkTelemetryPublisher::run_, this);
+}
+
+void IkTelemetryPublisher::stop()
+{
+  running_ = false;
+  if (thread_.joinable())
+  {
+    thread_.join();
+  }
+}
+
+void IkTelemetryPublisher::run_()
+{
+  ros::WallRate loop_rate(rate_);
+  orthopus_space_control::IkSolveStats msg;
+  while (ros::ok() && running_)
+  {
+    loop_rate.sleep();
+    if (aggregate_(msg))
+    {
+      publisher_.publish(msg);
+    }
+  }
+}
+
+bool IkTelemetryPublisher::aggregate_(orthopus_space_control::IkSolveStats& msg)
+{
+  msg.solve_count = 0;
+  msg.failure_count = 0;
+  msg.budget_exceeded_count = 0;
+  msg.fallback_count = 0;
+  msg.cpu_time_mean = 0.0;
+  msg.cpu_time_max = 0.0;
+  msg.iterations_max = 0;
+  msg.objective_mean = 0.0;
+  msg.primal_residual_max = 0.0;
+
+  IkSolveReport report;
+  while (ring_->pop(report))
+  {
+    msg.solve_count++;
+    msg.failure_count += report.success ? 0 : 1;
+    msg.budget_exceeded_count += report.budget_exceeded ? 1 : 0;
+    msg.fallback_count += report.fallback_used ? 1 : 0;
+    msg.cpu_time_mean += report.cpu_time;
+    msg.cpu_time_max = std::max(msg.cpu_time_max, report.cpu_time);
+    msg.iterations_max = std::max(msg.iterations_max, static_cast<uint32_t>(report.iterations));
+    msg.objective_mean += report.objective;
+    msg.primal_residual_max = std::max(msg.primal_residual_max, report.primal_residual);
+  }
+  if (msg.solve_count == 0)
+  {
+    return false;
+  }
+
+  msg.cpu_time_mean /= msg.solve_count;
+  msg.objective_mean /= msg.solve_count;
+  msg.dropped_count = ring_->getDropped();
+
+  msg.header.stamp.fromSec(report.stamp);
+  msg.solver = report.qpoases ? "qpoases" : "small_qp";
+  msg.last_success = report.success;
+  msg.last_status = report.status;
+  msg.last_iterations = report.iterations;
+  msg.last_active_constraints = report.active_constraints;
+  msg.last_cpu_time = report.cpu_time;
+  msg.last_objective = report.objective;
+  msg.last_primal_residual = report.primal_residual;
+  msg.last_dual_residual = report.dual_residual;
+  return true;
+}
+}
@@ -25,8 +25,9 @@
 
 namespace space_control
 {
-InverseKinematic::InverseKinematic(const int joint_number)
-  : joint_number_(joint_number)
+InverseKinematic::InverseKinematic(const int joint_number, const ros::NodeHandle& nh_private)
+  : n_(nh_private)
+  , joint_number_(joint_number)
   , q_current_(joint_number)
   , q_upper_limit_(joint_number)
   , q_lower_limit_(joint_number)
@@ -37,20 +38,46 @@ InverseKinematic::InverseKinematic(const int joint_number)
   // , x_max_limit_()
   , sampling_period_(0)
   , qp_init_required_(true)
-  , jacobian_init_flag_(true)
+  , qp_revalidation_required_(true)
+  , constraint_pattern_(0)
+  , qp_constraint_pattern_(0)
+  , reset_count_(0)
   , position_ctrl_frame_(ControlFrame::World)
   , orientation_ctrl_frame_(ControlFrame::Tool)
+  , x_prev_valid_(false)
+  , dq_applied_valid_(false)
+  , joint_max_acc_(0.0)
+  , joint_max_jerk_(0.0)
+  , dq_bounds_tightened_(false)
+  , integration_mode_(VelocityIntegrator::Mode::Euler)
+  , use_qpoases_(false)
+  , QP_(IK_JOINT_NUMBER, IK_CONSTRAINT_NUMBER)
+  , mpc_horizon_(1)
+  , mpc_max_acc_(0.0)
+  , mpc_smoothing_(0.0)
+  , mpc_max_iterations_(100)
+  , cpu_time_budget_(0.0)
+  , budget_fallback_(BudgetFallback::HoldPrevious)
+  , kinematic_cache_(nullptr)
+  , collision_avoidance_(true)
+  , collision_activation_distance_(0.1)
+  , collision_safety_distance_(0.01)
+  , collision_gain_(0.5)
+  , collision_table_height_(0.0)
 {
   ROS_DEBUG_STREAM("InverseKinematic constructor");
 
-  // TODO QUAT improve that !
-  space_dimension_ = 7;
+  if (joint_number_ != IK_JOINT_NUMBER)
+  {
+    ROS_ERROR("InverseKinematic only handles %d joints (%d requested)", IK_JOINT_NUMBER, joint_number_);
+  }
+  space_dimension_ = IK_SPACE_DIMENSION;
 
   std::vector<double> alpha_weight_vec;
   std::vector<double> beta_weight_vec;
 
-  ros::param::get("~alpha_weight", alpha_weight_vec);
-  ros::param::get("~beta_weight", beta_weight_vec);
+  n_.getParam("alpha_weight", alpha_weight_vec);
+  n_.getParam("beta_weight", beta_weight_vec);
 
   setAlphaWeight_(alpha_weight_vec);
   setBetaWeight_(beta_weight_vec);
@@ -81,7 +108,7 @@ InverseKinematic::InverseKinematic(const int joint_number)
    */
   ROS_DEBUG("Setting up bounds on joint velocity (dq) of the QP");
   double dq_max;
-  ros::param::get("~joint_max_vel", dq_max);
+  n_.getParam("joint_max_vel", dq_max);
   JointVelocity limit = JointVelocity(joint_number_);
   for (int i = 0; i < joint_number_; i++)
   {
@@ -89,23 +116,145 @@ InverseKinematic::InverseKinematic(const int joint_number)
   }
   setDqBounds_(limit);
 
-  robot_model_loader::RobotModelLoader robot_model_loader("robot_description");
-  kinematic_model_ = robot_model_loader.getModel();
-  kinematic_state_ = std::make_shared<robot_state::RobotState>(kinematic_model_);
-  kinematic_state_->setToDefaultValues();
-  joint_model_group_ = kinematic_model_->getJointModelGroup("arm");
+  /* Joint acceleration and jerk limits, applied around the joint velocity of the previous cycle */
+  n_.getParam("ik_joint_max_acc", joint_max_acc_);
+  n_.getParam("ik_joint_max_jerk", joint_max_jerk_);
+  if (joint_max_acc_ < 0.0 || joint_max_jerk_ < 0.0)
+  {
+    ROS_WARN("IK joint acceleration and jerk limits could not be negative (%g, %g), they are disabled", joint_max_acc_,
+             joint_max_jerk_);
+    joint_max_acc_ = std::max(joint_max_acc_, 0.0);
+    joint_max_jerk_ = std::max(joint_max_jerk_, 0.0);
+  }
+  /* Unknown modes are reported by VelocityIntegrator */
+  std::string integration_mode = "euler";
+  n_.getParam("velocity_integration", integration_mode);
+  VelocityIntegrator::parseMode(integration_mode, integration_mode_);
+
+  std::string qp_solver = "qpoases";
+  int qp_max_iterations = 2 * IkSmallQpSolver::CONSTRAINT_NUMBER;
+  n_.getParam("ik_qp_solver", qp_solver);
+  n_.getParam("ik_qp_max_iterations", qp_max_iterations);
+  use_qpoases_ = (qp_solver != "small_qp");
+  if (use_qpoases_ && qp_solver != "qpoases")
+  {
+    ROS_WARN("Unknown IK QP solver \"%s\", qpoases is used", qp_solver.c_str());
+  }
+  small_qp_.setMaxIterations(qp_max_iterations);
+
+  /* Multi-step QP : the horizon and the iteration limit set the anticipation/latency trade-off */
+  n_.getParam("ik_mpc_horizon", mpc_horizon_);
+  n_.getParam("ik_mpc_joint_max_acc", mpc_max_acc_);
+  n_.getParam("ik_mpc_smoothing_weight", mpc_smoothing_);
+  n_.getParam("ik_mpc_max_iterations", mpc_max_iterations_);
+  if (mpc_horizon_ < 1)
+  {
+    ROS_WARN("IK MPC horizon could not be lower than 1 (%d), the single-step QP is used", mpc_horizon_);
+    mpc_horizon_ = 1;
+  }
+  if (mpc_horizon_ > 1)
+  {
+    ROS_INFO("IK is solved over a %d step horizon (joint acceleration limit %g rad/s^2)", mpc_horizon_, mpc_max_acc_);
+  }
+
+  /* Collision avoidance : the nearest pairs are constrained at each solve */
+  n_.getParam("ik_collision_avoidance", collision_avoidance_);
+  n_.getParam("ik_collision_activation_distance", collision_activation_distance_);
+  n_.getParam("ik_collision_safety_distance", collision_safety_distance_);
+  n_.getParam("ik_collision_gain", collision_gain_);
+  n_.getParam("ik_collision_table_height", collision_table_height_);
+  n_.getParam("ik_collision_obstacles", collision_obstacles_);
+  if (collision_gain_ <= 0.0 || collision_gain_ > 1.0)
+  {
+    ROS_WARN("IK collision gain should be in ]0, 1] (%g), 0.5 is used", collision_gain_);
+    collision_gain_ = 0.5;
+  }
+
+  std::string budget_fallback = "previous";
+  n_.getParam("ik_qp_cpu_time_budget", cpu_time_budget_);
+  n_.getParam("ik_qp_budget_fallback", budget_fallback);
+  if (cpu_time_budget_ < 0.0)
+  {
+    ROS_WARN("IK QP CPU time budget could not be negative (%g), budget is disabled", cpu_time_budget_);
+    cpu_time_budget_ = 0.0;
+  }
+  if (budget_fallback == "stop")
+  {
+    budget_fallback_ = BudgetFallback::Stop;
+  }
+  else if (budget_fallback != "previous")
+  {
+    ROS_WARN("Unknown IK QP budget fallback \"%s\", previous is used", budget_fallback.c_str());
+  }
+  small_qp_.setMaxCpuTime(cpu_time_budget_);
+
+  /* Record the QP of each solve for offline replay (relative paths are relative to ROS_HOME) */
+  std::string qp_dump_file;
+  n_.getParam("ik_qp_dump_file", qp_dump_file);
+  if (!qp_dump_file.empty() && mpc_horizon_ > 1)
+  {
+    /* The single-step QP is not the one solved, replays would measure the wrong problem */
+    ROS_WARN("IK QPs are not recorded in %s : the horizon QP of the MPC can not be recorded", qp_dump_file.c_str());
+  }
+  else if (!qp_dump_file.empty())
+  {
+    if (!qp_recorder_.open(qp_dump_file))
+    {
+      ROS_ERROR("Could not write IK QP dump file %s, QPs are not recorded", qp_dump_file.c_str());
+    }
+    else
+    {
+      ROS_INFO("IK QPs are recorded in %s", qp_dump_file.c_str());
+    }
+  }
+
+  solve_report_ = IkSolveReport();
+  solve_report_.qpoases = use_qpoases_ || mpc_horizon_ > 1;
+  x_prev_.setZero();
+  dq_applied_.setZero();
+  ddq_applied_.setZero();
+
+  /* QP solver is allocated once, it is only re-initialized (init) after a reset */
+  qpOASES::Options options;
+  options.setToReliable();
+  options.printLevel = qpOASES::PL_NONE;
+  QP_.setOptions(options);
+
+  A_.setZero();
+  Rs_cong.setIdentity();
 }
 
-void InverseKinematic::init(const std::string end_effector_link, const double sampling_period)
+void InverseKinematic::init(KinematicCache& kinematic_cache, const double sampling_period)
 {
-  end_effector_link_ = end_effector_link;
+  kinematic_cache_ = &kinematic_cache;
   sampling_period_ = sampling_period;
+  if (collision_avoidance_ &&
+      !collision_model_.init(kinematic_cache.getHardwareVersion(), collision_table_height_, collision_obstacles_))
+  {
+    ROS_WARN("IK collision avoidance is disabled");
+    collision_avoidance_ = false;
+  }
+  if (mpc_horizon_ > 1)
+  {
+    /* MPC matrices depend on the sampling period, they are allocated here once */
+    mpc_qp_.configure(mpc_horizon_, sampling_period_, mpc_max_acc_, mpc_smoothing_, mpc_max_iterations_);
+    mpc_qp_.setTrapezoidalIntegration(integration_mode_ == VelocityIntegrator::Mode::Trapezoidal);
+    if (collision_avoidance_)
+    {
+      /* Collision rows are velocity dampers (see setCollisionConstraints_) */
+      const int first_row = IK_CONSTRAINT_NUMBER - IK_COLLISION_CONSTRAINT_NUMBER;
+      for (int k = 0; k < IK_COLLISION_CONSTRAINT_NUMBER; k++)
+      {
+        mpc_qp_.setDamperRow(first_row + k, collision_gain_);
+      }
+    }
+  }
 }
 
 void InverseKinematic::setAlphaWeight_(const std::vector<double>& alpha_weight)
 {
   // Minimize cartesian velocity (dx) weight
-  alpha_weight_ = MatrixXd::Identity(space_dimension_, space_dimension_);
+  alpha_weight_.setIdentity();
   for (int i = 0; i < space_dimension_; i++)
   {
     alpha_weight_(i, i) = alpha_weight[i];
@@ -116,7 +265,7 @@ void InverseKinematic::setAlphaWeight_(const std::vector<double>& alpha_weight)
 void InverseKinematic::setBetaWeight_(const std::vector<double>& beta_weight)
 {
   // Minimize joint velocity (dq) weight
-  beta_weight_ = MatrixXd::Identity(joint_number_, joint_number_);
+  beta_weight_.setIdentity();
   for (int i = 0; i < joint_number_; i++)
   {
     beta_weight_(i, i) = beta_weight[i];
@@ -134,7 +283,6 @@ void InverseKinematic::setXCurrent(const SpacePosition& x_current)
   x_current_ = x_current;
   /* As most of computation in this class are eigen matrix operation,
   the current state is also copied in an eigen vector */
-  x_current_eigen_ = VectorXd(space_dimension_);
   for (int i = 0; i < space_dimension_; i++)
   {
     x_current_eigen_(i) = x_current[i];
@@ -167,14 +315,24 @@ void InverseKinematic::setDqBounds_(const JointVelocity& dq_bound)
   {
     dq_lower_limit_[i] = -dq_bound[i];
     dq_upper_limit_[i] = dq_bound[i];
+    dq_max_(i) = dq_bound[i];
   }
 }
 
 void InverseKinematic::reset()
 {
-  /* Initialize a flag used to init QP if required */
+  /* Initialize a flag used to init space constraints snapshots if required */
   qp_init_required_ = true;
-  jacobian_init_flag_ = true;
+  /* The previous solution belongs to an other motion */
+  x_prev_valid_ = false;
+  dq_applied_valid_ = false;
+  /* The robot starts from rest (see VelocityIntegrator::reset) */
+  dq_applied_.setZero();
+  ddq_applied_.setZero();
+  mpc_qp_.reset();
+  /* The QP working set is kept, it is only checked again at the next solve */
+  qp_revalidation_required_ = true;
+  reset_count_++;
 }
 
 void InverseKinematic::resolveInverseKinematic(JointVelocity& dq_computed, const SpaceVelocity& dx_desired)
@@ -253,15 +411,10 @@ void InverseKinematic::resolveInverseKinematic(JointVelocity& dq_computed, const
 
   /*********************************************************/
 
-  /* Set kinemtic state of the robot to the current joint positions */
-  kinematic_state_->setVariablePositions(q_current_);
-  kinematic_state_->updateLinkTransforms();
-
-  /* Get jacobian */
-  Eigen::Vector3d reference_point_position(0.0, 0.0, 0.0);
-  Eigen::MatrixXd jacobian;
-  getJacobian_(kinematic_state_, joint_model_group_, kinematic_state_->getLinkModel(end_effector_link_),
-               reference_point_position, jacobian, true);
+  /* Get jacobian (already computed by the forward kinematic if q_current_ did not change) */
+  kinematic_cache_->update(q_current_);
+  jacobian_.topRows<6>() = kinematic_cache_->getJacobian();
+  setQuaternionJacobian_(kinematic_cache_->getOrientation(), jacobian_);
 
   /*
    * qpOASES solves QPs of the following form :
@@ -319,10 +472,11 @@ void InverseKinematic::resolveInverseKinematic(JointVelocity& dq_computed, const
    */
 
   /* Hessian computation */
-  MatrixXd hessian = (jacobian.transpose() * alpha_weight_ * jacobian) + beta_weight_;
+  hessian_.noalias() = jacobian_.transpose() * alpha_weight_ * jacobian_;
+  hessian_ += beta_weight_;
 
   /* Gradient vector computation */
-  VectorXd g = (-jacobian.transpose() * alpha_weight_ * dx_desired_in_frame.getRawVector());
+  g_.noalias() = -jacobian_.transpose() * alpha_weight_ * dx_desired_in_frame.getRawVector();
 
   /* In order to limit the joint position, we define a inequality constraint for the QP optimisation.
    * Taylor developpement of joint position is :
@@ -342,9 +496,10 @@ void InverseKinematic::resolveInverseKinematic(JointVelocity& dq_computed, const
    * where :
    *      - I is the identity matrix
    */
-  Eigen::Matrix<double, 12, 6, Eigen::RowMajor> A;
-  A.topLeftCorner(6, 6) = Eigen::MatrixXd::Identity(6, 6) * sampling_period_;
-  A.block(6, 0, 3, 6) = R_0to1_transpose * jacobian.topLeftCorner(3, 6) * sampling_period_;
+  A_.topLeftCorner<IK_JOINT_NUMBER, IK_JOINT_NUMBER>() =
+      Eigen::Matrix<double, IK_JOINT_NUMBER, IK_JOINT_NUMBER>::Identity() * sampling_period_;
+  A_.block<3, IK_JOINT_NUMBER>(6, 0).noalias() =
+      R_0to1_transpose * jacobian_.topRows<3>() * sampling_period_;
 
   const double eps_pos = 0.001;
   const double eps_orientation = 0.001;
@@ -363,6 +518,7 @@ void InverseKinematic::resolveInverseKinematic(JointVelocity& dq_computed, const
     pos_snap = x_current_.getPosition();
     r_snap = x_current_.getOrientation();
     r_snap_cong = r_snap.conjugate();
+    qp_init_required_ = false;
   }
 
   for (int i = 0; i < 3; i++)
@@ -387,6 +543,20 @@ void InverseKinematic::resolveInverseKinematic(JointVelocity& dq_computed, const
     }
   }
 
+  /* Locked space axes define the constraint pattern used to select a cached QP working set */
+  constraint_pattern_ = 0;
+  for (int i = 0; i < 3; i++)
+  {
+    if (eps_inf_pos[i] != inf)
+    {
+      constraint_pattern_ |= (1 << i);
+    }
+    if (dx_desired[4 + i] == 0.0)
+    {
+      constraint_pattern_ |= (1 << (3 + i));
+    }
+  }
+
   Eigen::Vector3d lim_pos_vec = R_0to1_transpose * (pos_snap - x_current_.getPosition());
   for (int i = 0; i < 3; i++)
   {
@@ -438,77 +608,54 @@ void InverseKinematic::resolveInverseKinematic(JointVelocity& dq_computed, const
   }
 
   /* constraint of quaternion part */
-  A.bottomLeftCorner(3, 6) = (Rs_cong * jacobian.bottomLeftCorner(4, 6) * sampling_period_).bottomLeftCorner(3, 6);
-
-  // TODO add function to handle constaints beautifuly
-  double lbA[] = { /* Joints min hard limits constraints */
-                   (q_lower_limit_[0] - q_current_[0]),
-                   (q_lower_limit_[1] - q_current_[1]),
-                   (q_lower_limit_[2] - q_current_[2]),
-                   (q_lower_limit_[3] - q_current_[3]),
-                   (q_lower_limit_[4] - q_current_[4]),
-                   (q_lower_limit_[5] - q_current_[5]),
-                   x_min_limit[0],
-                   x_min_limit[1],
-                   x_min_limit[2],
-                   x_min_limit[4],
-                   x_min_limit[5],
-                   x_min_limit[6]
-  };
-
-  double ubA[] = { /* Joints max hard limits constraints */
-                   (q_upper_limit_[0] - q_current_[0]),
-                   (q_upper_limit_[1] - q_current_[1]),
-                   (q_upper_limit_[2] - q_current_[2]),
-                   (q_upper_limit_[3] - q_current_[3]),
-                   (q_upper_limit_[4] - q_current_[4]),
-                   (q_upper_limit_[5] - q_current_[5]),
-                   x_max_limit[0],
-                   x_max_limit[1],
-                   x_max_limit[2],
-                   x_max_limit[4],
-                   x_max_limit[5],
-                   x_max_limit[6]
-  };
+  A_.block<3, IK_JOINT_NUMBER>(9, 0).noalias() =
+      Rs_cong.bottomRows<3>() * jacobian_.bottomRows<4>() * sampling_period_;
 
-  /* Solve QP */
-  qpOASES::real_t xOpt[6];
-  qpOASES::int_t nWSR = 10;
-  int qp_return = 0;
-  if (qp_init_required_)
+  /* Joints hard limits constraints */
+  for (int i = 0; i < IK_JOINT_NUMBER; i++)
   {
-    /* Initialize QP solver */
-    QP_ = new qpOASES::SQProblem(6, 12);  // HACK : ONLY JOINT VELOCITY LIMIT
-    qpOASES::Options options;
-    options.setToReliable();
-    // options.enableInertiaCorrection = qpOASES::BT_TRUE;
-    options.printLevel = qpOASES::PL_NONE;
-    QP_->setOptions(options);
-
-    qp_return = QP_->init(hessian.data(), g.data(), A.data(), dq_lower_limit_.data(), dq_upper_limit_.data(), lbA, ubA,
-                          nWSR, 0);
-    qp_init_required_ = false;
+    lbA_(i) = q_lower_limit_[i] - q_current_[i];
+    ubA_(i) = q_upper_limit_[i] - q_current_[i];
   }
-  else
+  /* Space position and orientation constraints (quaternion scalar part is not constrained) */
+  for (int i = 0; i < 3; i++)
   {
-    qp_return = QP_->hotstart(hessian.data(), g.data(), A.data(), dq_lower_limit_.data(), dq_upper_limit_.data(), lbA,
-                              ubA, nWSR, 0);
+    lbA_(IK_JOINT_NUMBER + i) = x_min_limit[i];
+    ubA_(IK_JOINT_NUMBER + i) = x_max_limit[i];
+    lbA_(IK_JOINT_NUMBER + 3 + i) = x_min_limit[4 + i];
+    ubA_(IK_JOINT_NUMBER + 3 + i) = x_max_limit[4 + i];
   }
+  setCollisionConstraints_();
+  setJointDynamicBounds_();
 
-  // enableInertiaCorrection ? ?
-
-  if (qp_return == qpOASES::SUCCESSFUL_RETURN)
+  /* Solve QP */
+  bool solved = solveQp_();
+  if (!solved && dq_bounds_tightened_ && !solve_report_.budget_exceeded)
+  {
+    /* The acceleration limits may conflict with the space or collision constraints : only the velocity limit is kept
+     * for this cycle */
+    ROS_WARN_THROTTLE(1.0, "IK QP : joint acceleration limits are released to satisfy the constraints");
+    for (int i = 0; i < IK_JOINT_NUMBER; i++)
+    {
+      dq_lower_limit_[i] = -dq_max_(i);
+      dq_upper_limit_[i] = dq_max_(i);
+    }
+    dq_bounds_tightened_ = false;
+    solved = solveQp_();
+  }
+  /* Only the last QP solved in the cycle is published and recorded (file I/O is done by the recorder thread) */
+  telemetry_.push(solve_report_);
+  qp_recorder_.push(hessian_.data(), g_.data(), A_.data(), dq_lower_limit_.data(), dq_upper_limit_.data(),
+                    lbA_.data(), ubA_.data());
+  if (solved)
   {
-    ROS_DEBUG_STREAM("qpOASES : succesfully return");
-
     /* Get solution of the QP */
-    QP_->getPrimalSolution(xOpt);
-    dq_computed[0] = xOpt[0];
-    dq_computed[1] = xOpt[1];
-    dq_computed[2] = xOpt[2];
-    dq_computed[3] = xOpt[3];
-    dq_computed[4] = xOpt[4];
-    dq_computed[5] = xOpt[5];
+    for (int i = 0; i < IK_JOINT_NUMBER; i++)
+    {
+      dq_computed[i] = x_opt_(i);
+    }
+    ddq_applied_ = (x_opt_ - dq_applied_) / sampling_period_;
+    dq_applied_ = x_opt_;
 
     // /*********** DEBUG **************/
     // Eigen::Matrix<double, 6, 1> dq_eigen;
@@ -536,7 +683,6 @@ void InverseKinematic::resolveInverseKinematic(JointVelocity& dq_computed, const
   }
   else
   {
-    ROS_ERROR("qpOASES : Failed with code : %d !", qp_return);
     // /*********** DEBUG **************/
     // Eigen::Matrix<double, 6, 1> dq_eigen;
     // Eigen::Matrix<double, 4, 1> min_l;
@@ -567,144 +713,390 @@ void InverseKinematic::resolveInverseKinematic(JointVelocity& dq_computed, const
     dq_computed[3] = 0.0;
     dq_computed[4] = 0.0;
     dq_computed[5] = 0.0;
+    ddq_applied_ = -dq_applied_ / sampling_period_;
+    dq_applied_.setZero();
   }
-
-  if (qp_return != qpOASES::SUCCESSFUL_RETURN && qp_return != qpOASES::RET_MAX_NWSR_REACHED)
-  {
-    reset();
-    exit(0);  // TODO improve error handling. Crash of the application is neither safe nor beautiful
-  }
+  dq_applied_valid_ = true;
 }
 
-bool InverseKinematic::getJacobian_(const robot_state::RobotStatePtr kinematic_state,
-                                    const robot_state::JointModelGroup* group, const robot_state::LinkModel* link,
-                                    const Eigen::Vector3d& reference_point_position, Eigen::MatrixXd& jacobian,
-                                    bool use_quaternion_representation)
+void InverseKinematic::setCollisionConstraints_()
 {
-  if (!group->isChain())
+  int pair_number = 0;
+  if (collision_avoidance_)
   {
-    ROS_ERROR("The group '%s' is not a chain. Cannot compute Jacobian.", group->getName().c_str());
-    return false;
+    collision_model_.update(kinematic_cache_->getState());
+    pair_number = collision_model_.selectNearest(IK_COLLISION_CONSTRAINT_NUMBER, collision_activation_distance_,
+                                                 collision_nearest_);
   }
 
-  if (!group->isLinkUpdated(link->getName()))
+  /*
+   * The distance d of a pair is linearized at the current configuration :
+   *        d(q0 + dq*T) = d + J_d.dq*T
+   * with J_d the distance jacobian (normal projection of the relative velocity of the closest points). Approaching
+   * velocity is then damped so that the safety distance d_s is never crossed :
+   *        J_d.dq*T >= -gain*(d - d_s)
+   * so :
+   *        A = J_d.T
+   *        lbA = -gain*(d - d_s)
+   *        ubA = +inf
+   * Below the safety distance (ex : conservative capsules when the arm is folded), lbA is 0 : the distance may only
+   * increase, and dq = 0 always satisfies the constraint. Unused rows are left unbounded. Over the MPC horizon, these
+   * rows are damped at each step (see MpcQpSolver::setDamperRow).
+   */
+  const int first_row = IK_CONSTRAINT_NUMBER - IK_COLLISION_CONSTRAINT_NUMBER;
+  Eigen::Matrix<double, 1, IK_JOINT_NUMBER> distance_jacobian;
+  for (int k = 0; k < IK_COLLISION_CONSTRAINT_NUMBER; k++)
   {
-    ROS_ERROR("Link name '%s' does not exist in the chain '%s' or is not a child for this chain",
-              link->getName().c_str(), group->getName().c_str());
-    return false;
+    if (k < pair_number)
+    {
+      const CollisionDistance& pair = collision_nearest_[k];
+      collision_model_.computeDistanceJacobian(pair, kinematic_cache_->getState(), distance_jacobian);
+      A_.row(first_row + k) = distance_jacobian * sampling_period_;
+      lbA_(first_row + k) = -collision_gain_ * std::max(pair.distance - collision_safety_distance_, 0.0);
+      ubA_(first_row + k) = qpOASES::INFTY;
+    }
+    else
+    {
+      A_.row(first_row + k).setZero();
+      lbA_(first_row + k) = -qpOASES::INFTY;
+      ubA_(first_row + k) = qpOASES::INFTY;
+    }
   }
+}
 
-  const robot_model::JointModel* root_joint_model = group->getJointModels()[0];
-  const robot_model::LinkModel* root_link_model = root_joint_model->getParentLinkModel();
-  Eigen::Affine3d reference_transform = root_link_model ?
-                                            kinematic_state->getGlobalLinkTransform(root_link_model).inverse() :
-                                            Eigen::Affine3d::Identity();
-  int rows = use_quaternion_representation ? 7 : 6;
-  int columns = group->getVariableCount();
-  jacobian = Eigen::MatrixXd::Zero(rows, columns);
-
-  Eigen::Affine3d link_transform = reference_transform * kinematic_state->getGlobalLinkTransform(link);
-  Eigen::Vector3d point_transform = link_transform * reference_point_position;
-
-  Eigen::Vector3d joint_axis;
-  Eigen::Affine3d joint_transform;
+void InverseKinematic::setJointDynamicBounds_()
+{
+  /* The MPC bounds the joint accelerations over its whole horizon (ik_mpc_joint_max_acc) */
+  const bool single_step = (mpc_horizon_ == 1);
 
-  const robot_state::LinkModel* tool_link = kinematic_state_->getLinkModel("tool_link");
-  Eigen::Affine3d reference_transform_2 =
-      tool_link ? kinematic_state->getGlobalLinkTransform(tool_link).inverse() : Eigen::Affine3d::Identity();
-  Eigen::Affine3d link_transform_2 = reference_transform_2 * kinematic_state->getGlobalLinkTransform(tool_link);
+  /*
+   * The QP rows are written for an euler integration of the joint velocity (q = q0 + dq*T). With the trapezoidal
+   * integration (see VelocityIntegrator), the joint command follows :
+   *        q = q0 + (dq_prev + dq)/2*T
+   * with dq_prev the joint velocity applied at the previous cycle. Each row, A.dq being a motion over the period,
+   * becomes :
+   *        lbA - A.dq_prev/2 <= A/2.dq <= ubA - A.dq_prev/2
+   * Unbounded sides are left unbounded. The MPC extends these rows to its horizon (see
+   * MpcQpSolver::setTrapezoidalIntegration).
+   */
+  if (integration_mode_ == VelocityIntegrator::Mode::Trapezoidal)
+  {
+    IkConstraintVector previous_motion;
+    previous_motion.noalias() = 0.5 * A_ * dq_applied_;
+    for (int i = 0; i < IK_CONSTRAINT_NUMBER; i++)
+    {
+      if (lbA_(i) > -qpOASES::INFTY)
+      {
+        lbA_(i) -= previous_motion(i);
+      }
+      if (ubA_(i) < qpOASES::INFTY)
+      {
+        ubA_(i) -= previous_motion(i);
+      }
+    }
+    A_ *= 0.5;
+  }
 
-  while (link)
+  /*
+   * Joint velocity bounds are the velocity limit, tightened around the joint velocity dq_prev and acceleration
+   * ddq_prev of the previous cycle :
+   *        max(-dq_max, dq_prev + ddq_min*T) <= dq <= min(dq_max, dq_prev + ddq_max*T)
+   * with :
+   *        ddq_min = max(-ddq_limit, ddq_prev - dddq_limit*T)
+   *        ddq_max = min(ddq_limit, ddq_prev + dddq_limit*T)
+   * Close to the velocity limit, the jerk limit may leave no admissible velocity (the acceleration can not decrease
+   * fast enough) : it is then ignored for this joint. Joint position limits have priority : the bounds are widened
+   * when the joint could not stop before its limit.
+   */
+  dq_bounds_tightened_ = false;
+  for (int i = 0; i < IK_JOINT_NUMBER; i++)
   {
-    const robot_model::JointModel* pjm = link->getParentJointModel();
-    if (pjm->getVariableCount() > 0)
+    double lower = -dq_max_(i);
+    double upper = dq_max_(i);
+    if (single_step && (joint_max_acc_ > 0.0 || joint_max_jerk_ > 0.0))
     {
-      unsigned int joint_index = group->getVariableGroupIndex(pjm->getName());
-      if (pjm->getType() == robot_model::JointModel::REVOLUTE)
+      const double acc_limit = (joint_max_acc_ > 0.0) ? joint_max_acc_ : qpOASES::INFTY;
+      double acc_lower = -acc_limit;
+      double acc_upper = acc_limit;
+      if (joint_max_jerk_ > 0.0)
       {
-        joint_transform = reference_transform * kinematic_state->getGlobalLinkTransform(link);
-        joint_axis = joint_transform.rotation() * static_cast<const robot_model::RevoluteJointModel*>(pjm)->getAxis();
-        jacobian.block<3, 1>(0, joint_index) =
-            jacobian.block<3, 1>(0, joint_index) + joint_axis.cross(point_transform - joint_transform.translation());
-        jacobian.block<3, 1>(3, joint_index) = jacobian.block<3, 1>(3, joint_index) + joint_axis;
+        acc_lower = std::max(acc_lower, ddq_applied_(i) - joint_max_jerk_ * sampling_period_);
+        acc_upper = std::min(acc_upper, ddq_applied_(i) + joint_max_jerk_ * sampling_period_);
       }
-      else if (pjm->getType() == robot_model::JointModel::PRISMATIC)
+      lower = std::max(-dq_max_(i), dq_applied_(i) + acc_lower * sampling_period_);
+      upper = std::min(dq_max_(i), dq_applied_(i) + acc_upper * sampling_period_);
+      if (lower > upper)
       {
-        joint_transform = reference_transform * kinematic_state->getGlobalLinkTransform(link);
-        joint_axis = joint_transform * static_cast<const robot_model::PrismaticJointModel*>(pjm)->getAxis();
-        jacobian.block<3, 1>(0, joint_index) = jacobian.block<3, 1>(0, joint_index) + joint_axis;
+        lower = std::max(-dq_max_(i), dq_applied_(i) - acc_limit * sampling_period_);
+        upper = std::min(dq_max_(i), dq_applied_(i) + acc_limit * sampling_period_);
       }
-      else if (pjm->getType() == robot_model::JointModel::PLANAR)
+
+      /* Joint position row : lbA <= A(i, i).dq <= ubA */
+      const double row_lower = lbA_(i) / A_(i, i);
+      const double row_upper = ubA_(i) / A_(i, i);
+      if (lower > row_upper)
       {
-        joint_transform = reference_transform * kinematic_state->getGlobalLinkTransform(link);
-        joint_axis = joint_transform * Eigen::Vector3d(1.0, 0.0, 0.0);
-        jacobian.block<3, 1>(0, joint_index) = jacobian.block<3, 1>(0, joint_index) + joint_axis;
-        joint_axis = joint_transform * Eigen::Vector3d(0.0, 1.0, 0.0);
-        jacobian.block<3, 1>(0, joint_index + 1) = jacobian.block<3, 1>(0, joint_index + 1) + joint_axis;
-        joint_axis = joint_transform * Eigen::Vector3d(0.0, 0.0, 1.0);
-        jacobian.block<3, 1>(0, joint_index + 2) = jacobian.block<3, 1>(0, joint_index + 2) +
-                                                   joint_axis.cross(point_transform - joint_transform.translation());
-        jacobian.block<3, 1>(3, joint_index + 2) = jacobian.block<3, 1>(3, joint_index + 2) + joint_axis;
+        lower = std::max(-dq_max_(i), row_upper);
       }
-      else
-        ROS_ERROR("Unknown type of joint in Jacobian computation");
+      if (upper < row_lower)
+      {
+        upper = std::min(dq_max_(i), row_lower);
+      }
+      dq_bounds_tightened_ = dq_bounds_tightened_ || lower > -dq_max_(i) || upper < dq_max_(i);
     }
-    if (pjm == root_joint_model)
-      break;
-    link = pjm->getParentLinkModel();
+    dq_lower_limit_[i] = lower;
+    dq_upper_limit_[i] = upper;
   }
+}
 
-  if (use_quaternion_representation)
+bool InverseKinematic::solveQp_()
+{
+  solve_report_.stamp = ros::WallTime::now().toSec();
+  solve_report_.qpoases = use_qpoases_ || mpc_horizon_ > 1;
+  solve_report_.budget_exceeded = false;
+  solve_report_.fallback_used = false;
+  solve_report_.objective = 0.0;
+
+  bool solution_available = (mpc_horizon_ > 1) ? solveMpcQp_() : (use_qpoases_ ? solveQpOases_() : solveSmallQp_());
+  if (!solution_available && solve_report_.budget_exceeded)
   {
-    /* Convert rotation matrix to quaternion */
-    Eigen::Quaterniond conv_quat(link_transform.rotation());
+    solution_available = applyBudgetFallback_();
+  }
 
-    /* Warning : During the convertion in quaternion, sign could change as there are tow quaternion definitions possible
-     * (q and -q) for the same rotation. The following code ensure quaternion continuity between to occurence of this
-     * method call
-     */
-    if (jacobian_init_flag_)
+  if (solution_available)
+  {
+    solve_report_.objective = 0.5 * x_opt_.dot(hessian_ * x_opt_) + g_.dot(x_opt_);
+    x_prev_ = x_opt_;
+    x_prev_valid_ = true;
+  }
+  return solution_available;
+}
+
+bool InverseKinematic::solveSmallQp_()
+{
+  IkSmallQpSolver::Status status = small_qp_.solve(hessian_, g_, A_, dq_lower_limit_.data(), dq_upper_limit_.data(),
+                                                   lbA_.data(), ubA_.data(), x_opt_);
+  const IkSmallQpSolver::Report& report = small_qp_.getReport();
+  solve_report_.success = (status == IkSmallQpSolver::Status::Success);
+  solve_report_.status = static_cast<int>(status);
+  solve_report_.iterations = report.iterations;
+  solve_report_.active_constraints = report.active_constraints;
+  solve_report_.cpu_time = report.cpu_time;
+  solve_report_.primal_residual = report.primal_residual;
+  solve_report_.dual_residual = report.dual_residual;
+  solve_report_.budget_exceeded = (status == IkSmallQpSolver::Status::MaxCpuTimeReached);
+  ROS_DEBUG("Small QP : %d iterations, %d active constraints, residuals : primal %g, dual %g", report.iterations,
+            report.active_constraints, report.primal_residual, report.dual_residual);
+  if (!solve_report_.success && !solve_report_.budget_exceeded)
+  {
+    /* Iteration limit or infeasible problem : the robot is stopped for this cycle */
+    ROS_ERROR("Small QP : Failed with status %d after %d iterations (primal residual %g)", static_cast<int>(status),
+              report.iterations, report.primal_residual);
+  }
+  return solve_report_.success;
+}
+
+bool InverseKinematic::solveQpOases_()
+{
+  /* A cold init needs much more working set recalculations than a hotstart */
+  const qpOASES::int_t nwsr_hotstart = 10;
+  const qpOASES::int_t nwsr_init = 5 * (IK_JOINT_NUMBER + IK_CONSTRAINT_NUMBER);
+  qpOASES::int_t nWSR = nwsr_hotstart;
+  qpOASES::int_t nwsr_limit = nwsr_hotstart;
+  /* qpOASES stops when cputime is exceeded, and returns the time used in it */
+  const double cpu_time_budget = (cpu_time_budget_ > 0.0) ? cpu_time_budget_ : qpOASES::INFTY;
+  qpOASES::real_t cputime = cpu_time_budget;
+  int qp_return = 0;
+  bool cold_start = false;
+  if (QP_.isInitialised() == qpOASES::BT_FALSE)
+  {
+    /* First solve : initialize QP solver */
+    cold_start = true;
+    nWSR = nwsr_limit = nwsr_init;
+    qp_return = QP_.init(hessian_.data(), g_.data(), A_.data(), dq_lower_limit_.data(), dq_upper_limit_.data(),
+                         lbA_.data(), ubA_.data(), nWSR, &cputime);
+  }
+  else if (qp_revalidation_required_ || constraint_pattern_ != qp_constraint_pattern_)
+  {
+    /* After a reset or when locked axes change, the working set of the previous solve may be far from the new one.
+     * Save it, then start from the working set last used with the new constraint pattern if there is one (init with
+     * a guessed working set only factorizes it), or keep the current one (hotstart). */
+    IkWorkingSet& previous_working_set = working_set_cache_[qp_constraint_pattern_];
+    QP_.getBounds(previous_working_set.bounds);
+    QP_.getConstraints(previous_working_set.constraints);
+    previous_working_set.valid = true;
+
+    const IkWorkingSet& cached = working_set_cache_[constraint_pattern_];
+    if (cached.valid && constraint_pattern_ != qp_constraint_pattern_)
     {
-      jacobian_init_flag_ = false;
+      qp_return = QP_.init(hessian_.data(), g_.data(), A_.data(), dq_lower_limit_.data(), dq_upper_limit_.data(),
+                           lbA_.data(), ubA_.data(), nWSR, &cputime, 0, 0, &cached.bounds, &cached.constraints);
     }
     else
     {
-      /* Detect if a discontinuity happened between new quaternion and the previous one */
-      double diff_norm =
-          sqrt(pow(conv_quat.w() - jacobian_quat_prev_.w(), 2) + pow(conv_quat.x() - jacobian_quat_prev_.x(), 2) +
-               pow(conv_quat.y() - jacobian_quat_prev_.y(), 2) + pow(conv_quat.z() - jacobian_quat_prev_.z(), 2));
-      if (diff_norm > 1)
-      {
-        ROS_DEBUG_NAMED("InverseKinematic", "A discontinuity has been detected during quaternion conversion.");
-        /* If discontinuity happened, change sign of the quaternion */
-        conv_quat.w() = -conv_quat.w();
-        conv_quat.x() = -conv_quat.x();
-        conv_quat.y() = -conv_quat.y();
-        conv_quat.z() = -conv_quat.z();
-      }
-      else
-      {
-        /* Else, do nothing and keep quaternion sign */
-      }
+      qp_return = QP_.hotstart(hessian_.data(), g_.data(), A_.data(), dq_lower_limit_.data(),
+                               dq_upper_limit_.data(), lbA_.data(), ubA_.data(), nWSR, &cputime);
     }
-    jacobian_quat_prev_ = conv_quat;
+  }
+  else
+  {
+    qp_return = QP_.hotstart(hessian_.data(), g_.data(), A_.data(), dq_lower_limit_.data(), dq_upper_limit_.data(),
+                             lbA_.data(), ubA_.data(), nWSR, &cputime);
+  }
+  double cpu_time = cputime;
 
-    double w = conv_quat.w(), x = conv_quat.x(), y = conv_quat.y(), z = conv_quat.z();
-    // Eigen::MatrixXd quaternion_update_matrix(4, 3);
+  if (!cold_start && qp_return != qpOASES::SUCCESSFUL_RETURN && qp_return != qpOASES::RET_MAX_NWSR_REACHED)
+  {
+    /* Reused working set is not valid anymore : fall back to a cold start, within the remaining budget */
+    ROS_WARN("qpOASES : warm start failed with code %d, QP is initialized again", qp_return);
+    nWSR = nwsr_limit = nwsr_init;
+    cputime = std::max(cpu_time_budget - cpu_time, 0.0);
+    qp_return = QP_.init(hessian_.data(), g_.data(), A_.data(), dq_lower_limit_.data(), dq_upper_limit_.data(),
+                         lbA_.data(), ubA_.data(), nWSR, &cputime);
+    cpu_time += cputime;
+  }
+  if (qp_return == qpOASES::SUCCESSFUL_RETURN)
+  {
+    qp_revalidation_required_ = false;
+    qp_constraint_pattern_ = constraint_pattern_;
+  }
 
-    /* d/dt ( [w] ) = 1/2 * [ -x -y -z ]  * [ omega_1 ]
-     *        [x]           [  w  z -y ]    [ omega_2 ]
-     *        [y]           [ -z  w  x ]    [ omega_3 ]
-     *        [z]           [  y -x  w ]
-     */
-    // quaternion_update_matrix << -x, -y, -z, w, z, -y, -z, w, x, y, -x, w;
+  solve_report_.success = (qp_return == qpOASES::SUCCESSFUL_RETURN);
+  solve_report_.status = qp_return;
+  solve_report_.iterations = nWSR;
+  solve_report_.active_constraints = QP_.getNFX() + QP_.getNAC();
+  solve_report_.cpu_time = cpu_time;
+  solve_report_.dual_residual = 0.0;
+  solve_report_.primal_residual = 0.0;
+  /* When the time limit stops qpOASES, it returns RET_MAX_NWSR_REACHED before using all its recalculations */
+  solve_report_.budget_exceeded =
+      (qp_return == qpOASES::RET_MAX_NWSR_REACHED && cpu_time_budget_ > 0.0 && nWSR < nwsr_limit);
+  if (solve_report_.success)
+  {
+    QP_.getPrimalSolution(x_opt_.data());
+    IkConstraintVector ax = A_ * x_opt_;
+    for (int i = 0; i < IK_CONSTRAINT_NUMBER; i++)
+    {
+      solve_report_.primal_residual =
+          std::max(solve_report_.primal_residual, std::max(lbA_(i) - ax(i), ax(i) - ubA_(i)));
+    }
+    return true;
+  }
+
+  if (solve_report_.budget_exceeded)
+  {
+    /* Handled by applyBudgetFallback_ */
+  }
+  else if (qp_return == qpOASES::RET_MAX_NWSR_REACHED)
+  {
+    ROS_ERROR("qpOASES : working set recalculation limit (%d) reached, the robot is stopped for this cycle",
+              static_cast<int>(nWSR));
+  }
+  else
+  {
+    ROS_ERROR("qpOASES : Failed with code : %d !", qp_return);
+    reset();
+    exit(0);  // TODO improve error handling. Crash of the application is neither safe nor beautiful
+  }
+  return false;
+}
 
-    // Eigen::Vector4d omega;
-    // omega(0) = 0.0;
-    // omega.bottomLeftCorner(3, 1) =
-    jacobian.block(3, 0, 4, columns) = 0.5 * xR(conv_quat).block(0, 1, 4, 3) * jacobian.block(3, 0, 3, columns);
+bool InverseKinematic::solveMpcQp_()
+{
+  bool success = mpc_qp_.solve(hessian_, g_, A_, dq_lower_limit_.data(), dq_upper_limit_.data(), lbA_.data(),
+                               ubA_.data(), dq_applied_valid_ ? &dq_applied_ : nullptr, cpu_time_budget_, x_opt_);
+  const IkMpcQpSolver::Report& report = mpc_qp_.getReport();
+  solve_report_.success = success;
+  solve_report_.status = report.status;
+  solve_report_.iterations = report.iterations;
+  solve_report_.active_constraints = report.active_constraints;
+  solve_report_.cpu_time = report.cpu_time;
+  solve_report_.primal_residual = report.primal_residual;
+  solve_report_.dual_residual = 0.0;
+  solve_report_.budget_exceeded = report.budget_exceeded;
+  ROS_DEBUG("IK MPC : %d iterations (%s start), %d active constraints, primal residual %g", report.iterations,
+            report.warm_started ? "warm" : "cold", report.active_constraints, report.primal_residual);
+  if (report.relaxed)
+  {
+    ROS_WARN_THROTTLE(1.0, "IK MPC : joint acceleration limit exceeded to respect the position limits");
+  }
+  if (!success && !report.budget_exceeded)
+  {
+    /* Iteration limit or infeasible problem : the robot is stopped for this cycle */
+    ROS_ERROR("IK MPC : Failed with code %d after %d iterations", report.status, report.iterations);
+  }
+  return success;
+}
+
+bool InverseKinematic::applyBudgetFallback_()
+{
+  /* In MPC mode, the velocity planned for this cycle by the last solve is held instead of the previous solution */
+  IkGradient previous = x_prev_;
+  bool previous_valid = (mpc_horizon_ > 1) ? mpc_qp_.getNextPlannedStep(previous) : x_prev_valid_;
+  if (budget_fallback_ == BudgetFallback::HoldPrevious && previous_valid)
+  {
+    /* The previous solution is only applied if it satisfies the bounds and constraints of this cycle */
+    const double tolerance = 1e-9;
+    bool feasible = true;
+    for (int i = 0; i < IK_JOINT_NUMBER; i++)
+    {
+      feasible =
+          feasible && previous(i) >= dq_lower_limit_[i] - tolerance && previous(i) <= dq_upper_limit_[i] + tolerance;
+    }
+    IkConstraintVector ax = A_ * previous;
+    for (int i = 0; i < IK_CONSTRAINT_NUMBER; i++)
+    {
+      feasible = feasible && ax(i) >= lbA_(i) - tolerance && ax(i) <= ubA_(i) + tolerance;
+    }
+    if (feasible)
+    {
+      x_opt_ = previous;
+      solve_report_.fallback_used = true;
+      ROS_WARN_THROTTLE(1.0, "IK QP : CPU time budget (%g s) exceeded, previous solution is kept", cpu_time_budget_);
+      return true;
+    }
   }
-  return true;
+  ROS_WARN_THROTTLE(1.0, "IK QP : CPU time budget (%g s) exceeded, the robot is stopped for this cycle",
+                    cpu_time_budget_);
+  return false;
+}
+
+const IkSolveReport& InverseKinematic::getLastSolveReport() const
+{
+  return solve_report_;
+}
+
+IkTelemetryRing& InverseKinematic::getTelemetryRing()
+{
+  return telemetry_;
+}
+
+unsigned int InverseKinematic::getResetCount() const
+{
+  return reset_count_;
+}
+
+void InverseKinematic::setQuaternionJacobian_(const Eigen::Quaterniond& orientation, IkJacobian& jacobian)
+{
+  /* Quaternion sign continuity is ensured by the kinematic cache */
+  Eigen::Quaterniond conv_quat = orientation;
+
+  double w = conv_quat.w(), x = conv_quat.x(), y = conv_quat.y(), z = conv_quat.z();
+  // Eigen::MatrixXd quaternion_update_matrix(4, 3);
+
+  /* d/dt ( [w] ) = 1/2 * [ -x -y -z ]  * [ omega_1 ]
+   *        [x]           [  w  z -y ]    [ omega_2 ]
+   *        [y]           [ -z  w  x ]    [ omega_3 ]
+   *        [z]           [  y -x  w ]
+   */
+  // quaternion_update_matrix << -x, -y, -z, w, z, -y, -z, w, x, y, -x, w;
+
+  // Eigen::Vector4d omega;
+  // omega(0) = 0.0;
+  // omega.bottomLeftCorner(3, 1) =
+  /* the angular part is copied first, as rows 3 to 5 are overwritten */
+  Eigen::Matrix<double, 3, IK_JOINT_NUMBER> angular_jacobian = jacobian.block<3, IK_JOINT_NUMBER>(3, 0);
+  jacobian.bottomRows<4>().noalias() = 0.5 * xR(conv_quat).block<4, 3>(0, 1) * angular_jacobian;
 }
 
 /* Quaternion post-product matrix */
@@ -0,0 +1,143 @@
+/*
+ *  joint_feedback.cpp
+ *  Copyright (C) 2019 Orthopus
+ *  All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <cmath>
+
+#include "ros/ros.h"
+
+#include "orthopus_space_control/joint_feedback.h"
+
+namespace space_control
+{
+constexpr int JointFeedback::HISTORY_SIZE;
+
+JointFeedback::JointFeedback(const int joint_number, const ros::NodeHandle& nh_private)
+  : joint_number_(joint_number)
+  , mode_(Mode::OpenLoop)
+  , gain_(0.5)
+  , max_latency_(0.5)
+  , resync_threshold_(0.2)
+  , resync_count_(0)
+  , history_(HISTORY_SIZE, JointPosition(joint_number))
+  , history_stamp_(HISTORY_SIZE)
+  , history_next_(0)
+  , history_count_(0)
+  , q_command_at_meas_(joint_number)
+{
+  std::string mode = "open_loop";
+  nh_private.getParam("joint_feedback_mode", mode);
+  nh_private.getParam("joint_feedback_gain", gain_);
+  nh_private.getParam("joint_feedback_max_latency", max_latency_);
+  nh_private.getParam("joint_feedback_resync_threshold", resync_threshold_);
+  if (mode == "closed_loop")
+  {
+    mode_ = Mode::ClosedLoop;
+  }
+  else if (mode != "open_loop")
+  {
+    ROS_WARN("Unknown joint feedback mode \"%s\", open_loop is used", mode.c_str());
+  }
+  if (gain_ < 0.0 || gain_ > 1.0)
+  {
+    ROS_WARN("Joint feedback gain should be in [0, 1] (%g), it is saturated", gain_);
+    gain_ = std::min(std::max(gain_, 0.0), 1.0);
+  }
+}
+
+void JointFeedback::reset()
+{
+  history_next_ = 0;
+  history_count_ = 0;
+}
+
+void JointFeedback::addCommand(const JointPosition& q_command, const ros::Time& stamp)
+{
+  std::copy(q_command.begin(), q_command.end(), history_[history_next_].begin());
+  history_stamp_[history_next_] = stamp;
+  history_next_ = (history_next_ + 1) % HISTORY_SIZE;
+  history_count_ = std::min(history_count_ + 1, HISTORY_SIZE);
+}
+
+JointFeedback::Result JointFeedback::update(const JointPosition& q_command, const MeasuredJointPosition& q_meas,
+                                            const ros::Time& now, JointPosition& q_current)
+{
+  std::copy(q_command.begin(), q_command.end(), q_current.begin());
+  if (mode_ == Mode::OpenLoop || (now - q_meas.stamp).toSec() > max_latency_ ||
+      !commandAt_(q_meas.stamp, q_command_at_meas_))
+  {
+    return Result::Command;
+  }
+
+  for (int i = 0; i < joint_number_; i++)
+  {
+    if (std::abs(q_meas.position[i] - q_command_at_meas_[i]) > resync_threshold_)
+    {
+      ROS_WARN("Joint feedback : joint %d is %g rad away from its command, command is resynchronized", i + 1,
+               q_meas.position[i] - q_command_at_meas_[i]);
+      std::copy(q_meas.position.begin(), q_meas.position.end(), q_current.begin());
+      resync_count_++;
+      reset();
+      return Result::Resync;
+    }
+  }
+  for (int i = 0; i < joint_number_; i++)
+  {
+    q_current[i] += gain_ * (q_meas.position[i] - q_command_at_meas_[i]);
+  }
+  return Result::Corrected;
+}
+
+bool JointFeedback::commandAt_(const ros::Time& stamp, JointPosition& q_command) const
+{
+  /* Walk the history from the newest command to the oldest one */
+  for (int k = 0; k < history_count_; k++)
+  {
+    const int i = (history_next_ - 1 - k + HISTORY_SIZE) % HISTORY_SIZE;
+    if (history_stamp_[i] <= stamp)
+    {
+      if (k == 0)
+      {
+        /* Measure is newer than the last command : the robot is going to (or stays at) the last command */
+        std::copy(history_[i].begin(), history_[i].end(), q_command.begin());
+        return true;
+      }
+      /* Interpolate between the command sent before the measure and the next one */
+      const int j = (i + 1) % HISTORY_SIZE;
+      const double span = (history_stamp_[j] - history_stamp_[i]).toSec();
+      const double ratio = (span > 0.0) ? (stamp - history_stamp_[i]).toSec() / span : 1.0;
+      for (int n = 0; n < joint_number_; n++)
+      {
+        q_command[n] = history_[i][n] + ratio * (history_[j][n] - history_[i][n]);
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+JointFeedback::Mode JointFeedback::getMode() const
+{
+  return mode_;
+}
+
+unsigned int JointFeedback::getResyncCount() const
+{
+  return resync_count_;
+}
+}
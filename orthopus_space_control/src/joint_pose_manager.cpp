@@ -25,13 +25,14 @@
 
 namespace space_control
 {
-JointPoseManager::JointPoseManager(const int joint_number) : joint_number_(joint_number), csv_m_("joint_pose_db.csv")
+JointPoseManager::JointPoseManager(const int joint_number, const ros::NodeHandle& nh_private)
+  : n_(nh_private), joint_number_(joint_number), csv_m_("joint_pose_db.csv")
 {
   ROS_DEBUG_STREAM("JointPoseManager constructor");
   JointPosition q(joint_number);
-  ros::param::get("~home_position", q);
+  n_.getParam("home_position", q);
   q_saved_pose_.emplace("Home", q);
-  ros::param::get("~rest_position", q);
+  n_.getParam("rest_position", q);
   q_saved_pose_.emplace("Rest", q);
 
   loadJointPoseFromCSV();
@@ -0,0 +1,163 @@
+/*
+ *  kinematic_cache.cpp
+ *  Copyright (C) 2019 Orthopus
+ *  All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+
+#include "ros/ros.h"
+
+#include "orthopus_space_control/kinematic_cache.h"
+
+namespace space_control
+{
+KinematicCache::KinematicCache(const int joint_number)
+  : joint_number_(joint_number)
+  , cache_valid_(false)
+  , continuity_init_flag_(true)
+  , q_cached_(joint_number)
+  , joint_model_group_(nullptr)
+  , end_effector_link_model_(nullptr)
+{
+  robot_model_loader::RobotModelLoader robot_model_loader("robot_description");
+  kinematic_model_ = robot_model_loader.getModel();
+  kinematic_state_ = std::make_shared<robot_state::RobotState>(kinematic_model_);
+  kinematic_state_->setToDefaultValues();
+  joint_model_group_ = kinematic_model_->getJointModelGroup("arm");
+  for (const robot_state::JointModel* joint_model : joint_model_group_->getActiveJointModels())
+  {
+    joint_child_link_models_.push_back(joint_model->getChildLinkModel());
+  }
+
+  state_.position.setZero();
+  state_.rotation.setIdentity();
+  state_.orientation.setIdentity();
+  state_.jacobian.setZero();
+  for (int i = 0; i < 6; i++)
+  {
+    state_.link_position[i].setZero();
+    state_.link_rotation[i].setIdentity();
+  }
+  orientation_.setIdentity();
+}
+
+void KinematicCache::init(const std::string end_effector_link)
+{
+  end_effector_link_ = end_effector_link;
+  end_effector_link_model_ = kinematic_model_->getLinkModel(end_effector_link_);
+  niryo_one_kinematic_.validate(kinematic_model_, end_effector_link_);
+  reset();
+}
+
+void KinematicCache::reset()
+{
+  cache_valid_ = false;
+  continuity_init_flag_ = true;
+}
+
+void KinematicCache::update(const JointPosition& q)
+{
+  if (cache_valid_ && std::equal(q_cached_.begin(), q_cached_.end(), q.begin()))
+  {
+    return;
+  }
+
+  if (niryo_one_kinematic_.isValid())
+  {
+    niryo_one_kinematic_.compute(q, state_);
+  }
+  else
+  {
+    kinematic_state_->setVariablePositions(q);
+    computeMoveIt_();
+  }
+
+  /* Warning : During the convertion in quaternion, sign could change as there are tow quaternion definitions possible
+   * (q and -q) for the same rotation. The following code ensure quaternion continuity between to computations.
+   */
+  Eigen::Quaterniond conv_quat = state_.orientation;
+  if (continuity_init_flag_)
+  {
+    continuity_init_flag_ = false;
+  }
+  else
+  {
+    /* Detect if a discontinuity happened between new quaternion and the previous one */
+    if ((conv_quat.coeffs() - orientation_.coeffs()).norm() > 1)
+    {
+      ROS_DEBUG_NAMED("KinematicCache", "A discontinuity has been detected during quaternion conversion.");
+      /* If discontinuity happened, change sign of the quaternion */
+      conv_quat.coeffs() = -conv_quat.coeffs();
+    }
+  }
+  orientation_ = conv_quat;
+
+  std::copy(q.begin(), q.end(), q_cached_.begin());
+  cache_valid_ = true;
+}
+
+void KinematicCache::computeMoveIt_()
+{
+  kinematic_state_->updateLinkTransforms();
+
+  const Eigen::Affine3d& end_effector_state = kinematic_state_->getGlobalLinkTransform(end_effector_link_model_);
+  state_.position = end_effector_state.translation();
+  state_.rotation = end_effector_state.linear();
+  state_.orientation = Eigen::Quaterniond(state_.rotation);
+
+  /* Geometric jacobian expressed in the root link of the group (base_link) */
+  kinematic_state_->getJacobian(joint_model_group_, end_effector_link_model_, Eigen::Vector3d::Zero(),
+                                moveit_jacobian_, false);
+  state_.jacobian = moveit_jacobian_;
+
+  for (std::size_t i = 0; i < joint_child_link_models_.size() && i < 6; i++)
+  {
+    const Eigen::Affine3d& link_state = kinematic_state_->getGlobalLinkTransform(joint_child_link_models_[i]);
+    state_.link_position[i] = link_state.translation();
+    state_.link_rotation[i] = link_state.linear();
+  }
+}
+
+const Eigen::Vector3d& KinematicCache::getPosition() const
+{
+  return state_.position;
+}
+
+const Eigen::Matrix3d& KinematicCache::getRotation() const
+{
+  return state_.rotation;
+}
+
+const Eigen::Quaterniond& KinematicCache::getOrientation() const
+{
+  return orientation_;
+}
+
+const Eigen::Matrix<double, 6, 6>& KinematicCache::getJacobian() const
+{
+  return state_.jacobian;
+}
+
+const NiryoOneKinematicState& KinematicCache::getState() const
+{
+  return state_;
+}
+
+int KinematicCache::getHardwareVersion() const
+{
+  return niryo_one_kinematic_.getHardwareVersion();
+}
+}
@@ -0,0 +1,138 @@
+/*
+ *  niryo_one_kinematic.cpp
+ *  Copyright (C) 2019 Orthopus
+ *  All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+
+#include "ros/ros.h"
+
+#include "orthopus_space_control/niryo_one_kinematic.h"
+
+#include "moveit/robot_state/robot_state.h"
+
+namespace space_control
+{
+constexpr double NiryoOneKinematic::VALIDATION_TOLERANCE;
+
+NiryoOneKinematic::NiryoOneKinematic() : hardware_version_(2), valid_(false)
+{
+  ros::param::get("/niryo_one/hardware_version", hardware_version_);
+  if (hardware_version_ != 1 && hardware_version_ != 2)
+  {
+    ROS_ERROR("NiryoOneKinematic : incorrect hardware version %d, should be 1 or 2", hardware_version_);
+  }
+}
+
+bool NiryoOneKinematic::validate(const robot_model::RobotModelConstPtr& kinematic_model,
+                                 const std::string& end_effector_link)
+{
+  valid_ = false;
+  if (hardware_version_ != 1 && hardware_version_ != 2)
+  {
+    return false;
+  }
+
+  const robot_state::JointModelGroup* group = kinematic_model->getJointModelGroup("arm");
+  const robot_state::LinkModel* link = kinematic_model->getLinkModel(end_effector_link);
+  if (group == nullptr || link == nullptr || group->getVariableCount() != 6 || end_effector_link != "tool_link")
+  {
+    ROS_WARN("NiryoOneKinematic : robot model does not match the Niryo One chain, MoveIt kinematic is used");
+    return false;
+  }
+
+  robot_state::RobotState kinematic_state(kinematic_model);
+  kinematic_state.setToDefaultValues();
+
+  std::vector<double> q(6);
+  NiryoOneKinematicState state;
+  Eigen::MatrixXd moveit_jacobian;
+  double max_position_error = 0.0, max_orientation_error = 0.0, max_jacobian_error = 0.0;
+
+  /* Default configuration, then random configurations within joint limits */
+  const int configuration_number = 200;
+  for (int i = 0; i < configuration_number; i++)
+  {
+    if (i > 0)
+    {
+      kinematic_state.setToRandomPositions(group);
+    }
+    kinematic_state.copyJointGroupPositions(group, q);
+    kinematic_state.updateLinkTransforms();
+
+    const Eigen::Affine3d& moveit_pose = kinematic_state.getGlobalLinkTransform(link);
+    Eigen::Quaterniond moveit_quat(moveit_pose.linear());
+    kinematic_state.getJacobian(group, link, Eigen::Vector3d::Zero(), moveit_jacobian, false);
+
+    compute(q, state);
+
+    max_position_error = std::max(max_position_error, (state.position - moveit_pose.translation()).norm());
+    /* Link frames are used by the collision model */
+    for (int j = 0; j < 6; j++)
+    {
+      const Eigen::Affine3d& moveit_link_pose =
+          kinematic_state.getGlobalLinkTransform(group->getActiveJointModels()[j]->getChildLinkModel());
+      max_position_error =
+          std::max(max_position_error, (state.link_position[j] - moveit_link_pose.translation()).norm());
+      max_orientation_error = std::max(
+          max_orientation_error, (state.link_rotation[j] - moveit_link_pose.linear()).cwiseAbs().maxCoeff());
+    }
+    /* q and -q are the same rotation */
+    const double quat_error = std::min((state.orientation.coeffs() - moveit_quat.coeffs()).norm(),
+                                       (state.orientation.coeffs() + moveit_quat.coeffs()).norm());
+    max_orientation_error = std::max(max_orientation_error, quat_error);
+    max_jacobian_error = std::max(max_jacobian_error, (state.jacobian - moveit_jacobian).cwiseAbs().maxCoeff());
+  }
+
+  valid_ = (max_position_error < VALIDATION_TOLERANCE && max_orientation_error < VALIDATION_TOLERANCE &&
+            max_jacobian_error < VALIDATION_TOLERANCE);
+  if (valid_)
+  {
+    ROS_INFO("NiryoOneKinematic : V%d analytical kinematic validated against MoveIt (max error : position %g, "
+             "quaternion %g, jacobian %g)",
+             hardware_version_, max_position_error, max_orientation_error, max_jacobian_error);
+  }
+  else
+  {
+    ROS_WARN("NiryoOneKinematic : V%d analytical kinematic does not match robot_description (max error : position %g, "
+             "quaternion %g, jacobian %g), MoveIt kinematic is used",
+             hardware_version_, max_position_error, max_orientation_error, max_jacobian_error);
+  }
+  return valid_;
+}
+
+bool NiryoOneKinematic::isValid() const
+{
+  return valid_;
+}
+
+int NiryoOneKinematic::getHardwareVersion() const
+{
+  return hardware_version_;
+}
+
+void NiryoOneKinematic::compute(const std::vector<double>& q, NiryoOneKinematicState& state) const
+{
+  if (hardware_version_ == 1)
+  {
+    kernel_v1_.compute(q.data(), state);
+  }
+  else
+  {
+    kernel_v2_.compute(q.data(), state);
+  }
+}
+}
@@ -16,10 +16,15 @@
  *  You should have received a copy of the GNU General Public License
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <chrono>
+#include <functional>
+
 #include "ros/ros.h"
 
+#include "controller_manager_msgs/SwitchController.h"
 #include "niryo_one_msgs/SetInt.h"
 #include "orthopus_space_control/robot_manager.h"
+#include "orthopus_space_control/trace.h"
 
 // Eigen
 #include "eigen_conversions/eigen_msg.h"
@@ -29,30 +34,77 @@
 
 namespace space_control
 {
-RobotManager::RobotManager(const int joint_number, const bool debug)
-  : cartesian_controller_(joint_number)
-  , joint_pose_manager_(joint_number)
+namespace
+{
+/* Runs a function from a ROS callback queue */
+class FunctionCallback : public ros::CallbackInterface
+{
+public:
+  explicit FunctionCallback(const std::function<void()>& function) : function_(function)
+  {
+  }
+  virtual CallResult call()
+  {
+    function_();
+    return Success;
+  }
+
+private:
+  std::function<void()> function_;
+};
+}
+
+RobotManager::RobotManager(const ros::NodeHandle& nh, const ros::NodeHandle& nh_private, const int joint_number,
+                           const bool debug)
+  : n_(nh)
+  , n_private_(nh_private)
+  , n_intake_(nh)
+  , intake_spinner_(1, &intake_queue_)
+  , running_(false)
+  , learning_mode_(1)
+  , cartesian_controller_(joint_number, nh_private)
+  , joint_pose_manager_(joint_number, nh_private)
   , joint_number_(joint_number)
   , debug_(debug)
+  , streaming_command_(false)
+  , streaming_controller_requested_(false)
+  , streaming_controller_active_(false)
+  , joint_position_sent_(false)
+  , ik_telemetry_rate_(1.0)
+  , trace_file_("orthopus_space_control.trace")
+  , control_loop_stats_rate_(1.0)
+  , overruns_total_(0)
   , q_command_(joint_number)
   , q_current_(joint_number)
   , q_meas_(joint_number)
+  , q_meas_intake_(joint_number)
+  , q_meas_stamped_(joint_number)
+  , q_meas_mailbox_(MeasuredJointPosition(joint_number))
+  , joint_feedback_(joint_number, nh_private)
   , x_drink_pose_()
   , x_stand_pose_()
   , dx_desired_()
   , dx_desired_prev_()
+  , dx_desired_mailbox_(SpaceVelocity())
 {
   ROS_DEBUG_STREAM("RobotManager constructor");
+  n_.setCallbackQueue(&callback_queue_);
+  n_intake_.setCallbackQueue(&intake_queue_);
   retrieveParameters_();
   initializeSubscribers_();
   initializePublishers_();
   initializeServices_();
   initializeStateMachine_();
-  ros::Rate loop_rate = ros::Rate(sampling_freq_);
   set_control_frame_requested_ = 0;
+}
+
+void RobotManager::run()
+{
+  running_ = true;
+  intake_spinner_.start();
   // Wait for initial messages
   ROS_INFO("Waiting for first joint msg.");
-  ros::topic::waitForMessage<sensor_msgs::JointState>("joint_states");
+  ros::topic::waitForMessage<sensor_msgs::JointState>("joint_states", n_);
   ROS_INFO("Received first joint msg.");
   joint_position_timer_ = ros::Time::now();
 
@@ -68,11 +120,17 @@ RobotManager::RobotManager(const int joint_number, const bool debug)
 
   init();
 
-  while (ros::ok())
+  /* Timing statistics are published every stats_cycles cycles */
+  const uint64_t stats_cycles =
+      (control_loop_stats_rate_ > 0.0) ? std::max(1, int(sampling_freq_ / control_loop_stats_rate_)) : 0;
+  scheduler_.start(sampling_period_);
+  while (ros::ok() && running_)
   {
-    ros::spinOnce();
-    ROS_DEBUG("Current state is '%s' and input event is '%s'", engine_->getCurrentState()->getName().c_str(),
-              input_event_requested_.toString().c_str());
+    /* Services, then the latest topic values received by the intake thread */
+    callback_queue_.callAvailable();
+    readJointState_();
+    dx_desired_mailbox_.read(dx_desired_);
+    SPACE_CONTROL_TRACE(trace::Event::CycleBegin, engine_->getCurrentStateIndex(), 0.0);
 
     engine_->process();
     input_event_requested_ = FsmInputEvent::None;
@@ -81,27 +139,116 @@ RobotManager::RobotManager(const int joint_number, const bool debug)
     joystick_enable_msg.data = true;
     joystick_enabled_pub_.publish(joystick_enable_msg);
 
-    loop_rate.sleep();
+    SPACE_CONTROL_TRACE(trace::Event::CycleEnd, engine_->getCurrentStateIndex(), 0.0);
+    if (!scheduler_.sleep())
+    {
+      overruns_total_++;
+    }
+    if (stats_cycles > 0 && scheduler_.getStatistics().cycles >= stats_cycles)
+    {
+      publishControlLoopStats_();
+    }
+  }
+  ik_telemetry_publisher_.stop();
+  intake_spinner_.stop();
+  if (run_recorder_.isOpen())
+  {
+    run_recorder_.close();
+    ROS_INFO("CartesianController runs recorded in %s (%zu dropped)", run_record_file_.c_str(),
+             run_recorder_.getDropped());
+  }
+
+#ifdef ORTHOPUS_SPACE_CONTROL_TRACE
+  if (trace::dump(trace_file_))
+  {
+    ROS_INFO("Control loop trace written in %s (decode it with trace_decoder)", trace_file_.c_str());
   }
+  else
+  {
+    ROS_ERROR("Could not write control loop trace in %s", trace_file_.c_str());
+  }
+#endif
+}
+
+void RobotManager::stop()
+{
+  running_ = false;
 }
 
 void RobotManager::init()
 {
+  /* This is use to update joint state before running anything */
+  callback_queue_.callAvailable(ros::WallDuration(0.1));
+  ros::WallTime timeout = ros::WallTime::now() + ros::WallDuration(1.0);
+  while (!readJointState_() && ros::WallTime::now() < timeout)
+  {
+    ros::WallDuration(0.01).sleep();
+  }
+  dx_desired_mailbox_.read(dx_desired_);
+
   cartesian_controller_.init(sampling_period_, joint_pose_manager_);
   cartesian_controller_.setControlFeedbackPublisher(control_feedback_pub_);
   cartesian_controller_.setDebugPublishers(q_current_debug_pub_, x_current_debug_pub_, dx_desired_debug_pub_);
+  ik_telemetry_publisher_.start(ik_solve_stats_pub_, cartesian_controller_.getInverseKinematic()->getTelemetryRing(),
+                                ik_telemetry_rate_);
+  if (!run_record_file_.empty())
+  {
+    if (run_recorder_.open(run_record_file_, joint_number_, sampling_period_,
+                           run_record::snapshotParameters(n_private_)))
+    {
+      ROS_INFO("Recording CartesianController runs in %s (replay it with run_replay)", run_record_file_.c_str());
+    }
+    else
+    {
+      ROS_ERROR("Could not create run recording %s", run_record_file_.c_str());
+    }
+  }
+}
+
+void RobotManager::recordRun_()
+{
+  if (!run_recorder_.isOpen())
+  {
+    return;
+  }
+  run_record::Record record;
+  run_record::capture(cartesian_controller_, q_current_, dx_desired_, q_command_, record);
+  record.stamp = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  record.fsm_state = engine_->getCurrentStateIndex();
+  run_recorder_.push(record);
+}
+
+void RobotManager::publishControlLoopStats_()
+{
+  const FixedRateScheduler::Statistics& statistics = scheduler_.getStatistics();
+  orthopus_space_control::ControlLoopStats msg;
+  msg.header.stamp = ros::Time::now();
+  msg.period = scheduler_.getPeriod();
+  msg.cycles = statistics.cycles;
+  msg.overruns = statistics.overruns;
+  msg.missed_deadlines = statistics.missed_deadlines;
+  msg.overruns_total = overruns_total_;
+  msg.compute_time_mean = statistics.compute_time_mean;
+  msg.compute_time_max = statistics.compute_time_max;
+  msg.wakeup_latency_mean = statistics.wakeup_latency_mean;
+  msg.wakeup_latency_max = statistics.wakeup_latency_max;
+  control_loop_stats_pub_.publish(msg);
+  scheduler_.resetStatistics();
 }
 
 void RobotManager::callbackInputDeviceVelocity_(const geometry_msgs::TwistStampedPtr& msg)
 {
-  dx_desired_.position.x() = (msg->twist.linear.x * space_position_max_vel_);
-  dx_desired_.position.y() = (msg->twist.linear.y * space_position_max_vel_);
-  dx_desired_.position.z() = (msg->twist.linear.z * space_position_max_vel_);
+  /* Intake thread */
+  SpaceVelocity dx_desired;
+  dx_desired.position.x() = (msg->twist.linear.x * space_position_max_vel_);
+  dx_desired.position.y() = (msg->twist.linear.y * space_position_max_vel_);
+  dx_desired.position.z() = (msg->twist.linear.z * space_position_max_vel_);
 
-  dx_desired_.orientation.w() = (0.0);
-  dx_desired_.orientation.x() = (msg->twist.angular.x * space_orientation_max_vel_);
-  dx_desired_.orientation.y() = (msg->twist.angular.y * space_orientation_max_vel_);
-  dx_desired_.orientation.z() = (msg->twist.angular.z * space_orientation_max_vel_);
+  dx_desired.orientation.w() = (0.0);
+  dx_desired.orientation.x() = (msg->twist.angular.x * space_orientation_max_vel_);
+  dx_desired.orientation.y() = (msg->twist.angular.y * space_orientation_max_vel_);
+  dx_desired.orientation.z() = (msg->twist.angular.z * space_orientation_max_vel_);
+  dx_desired_mailbox_.write(dx_desired);
 }
 
 void RobotManager::callbackLearningMode_(const std_msgs::BoolPtr& msg)
@@ -112,10 +259,35 @@ void RobotManager::callbackLearningMode_(const std_msgs::BoolPtr& msg)
 
 void RobotManager::callbackJointState_(const sensor_msgs::JointStateConstPtr& msg)
 {
+  /* Intake thread */
   for (int i = 0; i < joint_number_; i++)
   {
     // TODO check that data exists for all joint
-    q_meas_[i] = msg->position[i];
+    q_meas_intake_.position[i] = msg->position[i];
+  }
+  /* Some drivers do not stamp their joint states : the reception time is the best estimate left */
+  q_meas_intake_.stamp = msg->header.stamp.isZero() ? ros::Time::now() : msg->header.stamp;
+  q_meas_mailbox_.write(q_meas_intake_);
+}
+
+bool RobotManager::readJointState_()
+{
+  if (!q_meas_mailbox_.read(q_meas_stamped_))
+  {
+    return false;
+  }
+  q_meas_ = q_meas_stamped_.position;
+  return true;
+}
+
+void RobotManager::updateJointFeedback_()
+{
+  if (joint_feedback_.update(q_command_, q_meas_stamped_, ros::Time::now(), q_current_) ==
+      JointFeedback::Result::Resync)
+  {
+    /* The robot did not follow the command : restart from the measured position */
+    q_command_ = q_current_;
+    cartesian_controller_.getInverseKinematic()->reset();
   }
 }
 
@@ -194,10 +366,11 @@ bool RobotManager::callbackGetPositionList_(niryo_one_msgs::GetPositionList::Req
 void RobotManager::initializeSubscribers_()
 {
   ROS_DEBUG_STREAM("RobotManager initializeSubscribers");
-  joints_sub_ = n_.subscribe("joint_states", 1, &RobotManager::callbackJointState_, this);
-  dx_input_device_sub_ = n_.subscribe("/orthopus_space_control/input_device_velocity", 1,
-                                      &RobotManager::callbackInputDeviceVelocity_, this);
-  learning_mode_sub_ = n_.subscribe("/niryo_one/learning_mode", 1, &RobotManager::callbackLearningMode_, this);
+  joints_sub_ = n_intake_.subscribe("joint_states", 1, &RobotManager::callbackJointState_, this);
+  dx_input_device_sub_ = n_intake_.subscribe("/orthopus_space_control/input_device_velocity", 1,
+                                             &RobotManager::callbackInputDeviceVelocity_, this);
+  learning_mode_sub_ =
+      n_intake_.subscribe("/niryo_one/learning_mode", 1, &RobotManager::callbackLearningMode_, this);
 }
 
 void RobotManager::initializePublishers_()
@@ -205,11 +378,16 @@ void RobotManager::initializePublishers_()
   ROS_DEBUG_STREAM("RobotManager initializePublishers");
   command_pub_ =
       n_.advertise<trajectory_msgs::JointTrajectory>("/niryo_one_follow_joint_trajectory_controller/command", 1);
+  streaming_command_pub_ = n_.advertise<sensor_msgs::JointState>("/niryo_one_streaming_joint_controller/command", 1);
   joystick_enabled_pub_ = n_.advertise<std_msgs::Bool>("/niryo_one/joystick_interface/is_enabled", 1);
   q_current_debug_pub_ = n_.advertise<sensor_msgs::JointState>("/orthopus_space_control/q_current", 1);
   x_current_debug_pub_ = n_.advertise<geometry_msgs::Pose>("/orthopus_space_control/x_current", 1);
   dx_desired_debug_pub_ = n_.advertise<geometry_msgs::Pose>("/orthopus_space_control/dx_desired", 1);
   control_feedback_pub_ = n_.advertise<std_msgs::UInt16>("/orthopus_space_control/control_feedback", 1);
+  ik_solve_stats_pub_ =
+      n_.advertise<orthopus_space_control::IkSolveStats>("/orthopus_space_control/ik_solve_stats", 10);
+  control_loop_stats_pub_ =
+      n_.advertise<orthopus_space_control::ControlLoopStats>("/orthopus_space_control/control_loop_stats", 10);
 }
 
 void RobotManager::initializeServices_()
@@ -223,6 +401,8 @@ void RobotManager::initializeServices_()
       n_.advertiseService("/orthopus_space_control/get_position_list", &RobotManager::callbackGetPositionList_, this);
   set_control_frame_service_ =
       n_.advertiseService("/orthopus_space_control/set_control_frame", &RobotManager::callbackSetControlFrame_, this);
+  switch_controller_client_ =
+      n_.serviceClient<controller_manager_msgs::SwitchController>("/controller_manager/switch_controller");
 }
 
 void RobotManager::retrieveParameters_()
@@ -230,21 +410,21 @@ void RobotManager::retrieveParameters_()
   geometry_msgs::Pose drink_pose;
   geometry_msgs::Pose stand_pose;
 
-  ros::param::get("~drink_pose/position/x", drink_pose.position.x);
-  ros::param::get("~drink_pose/position/y", drink_pose.position.y);
-  ros::param::get("~drink_pose/position/z", drink_pose.position.z);
-  ros::param::get("~drink_pose/orientation/w", drink_pose.orientation.w);
-  ros::param::get("~drink_pose/orientation/x", drink_pose.orientation.x);
-  ros::param::get("~drink_pose/orientation/y", drink_pose.orientation.y);
-  ros::param::get("~drink_pose/orientation/z", drink_pose.orientation.z);
-
-  ros::param::get("~stand_pose/position/x", stand_pose.position.x);
-  ros::param::get("~stand_pose/position/y", stand_pose.position.y);
-  ros::param::get("~stand_pose/position/z", stand_pose.position.z);
-  ros::param::get("~stand_pose/orientation/w", stand_pose.orientation.w);
-  ros::param::get("~stand_pose/orientation/x", stand_pose.orientation.x);
-  ros::param::get("~stand_pose/orientation/y", stand_pose.orientation.y);
-  ros::param::get("~stand_pose/orientation/z", stand_pose.orientation.z);
+  n_private_.getParam("drink_pose/position/x", drink_pose.position.x);
+  n_private_.getParam("drink_pose/position/y", drink_pose.position.y);
+  n_private_.getParam("drink_pose/position/z", drink_pose.position.z);
+  n_private_.getParam("drink_pose/orientation/w", drink_pose.orientation.w);
+  n_private_.getParam("drink_pose/orientation/x", drink_pose.orientation.x);
+  n_private_.getParam("drink_pose/orientation/y", drink_pose.orientation.y);
+  n_private_.getParam("drink_pose/orientation/z", drink_pose.orientation.z);
+
+  n_private_.getParam("stand_pose/position/x", stand_pose.position.x);
+  n_private_.getParam("stand_pose/position/y", stand_pose.position.y);
+  n_private_.getParam("stand_pose/position/z", stand_pose.position.z);
+  n_private_.getParam("stand_pose/orientation/w", stand_pose.orientation.w);
+  n_private_.getParam("stand_pose/orientation/x", stand_pose.orientation.x);
+  n_private_.getParam("stand_pose/orientation/y", stand_pose.orientation.y);
+  n_private_.getParam("stand_pose/orientation/z", stand_pose.orientation.z);
 
   x_drink_pose_.position.x() = (drink_pose.position.x);
   x_drink_pose_.position.y() = (drink_pose.position.y);
@@ -262,25 +442,40 @@ void RobotManager::retrieveParameters_()
   x_stand_pose_.orientation.y() = (stand_pose.orientation.y);
   x_stand_pose_.orientation.z() = (stand_pose.orientation.z);
 
-  ros::param::get("~goal_joint_tolerance", goal_joint_tolerance_);
-  ros::param::get("~sampling_frequency", sampling_freq_);
-
-  ros::param::get("~joint_max_vel", joint_max_vel_);
-  ros::param::get("~space_position_max_vel", space_position_max_vel_);
-  ros::param::get("~space_orientation_max_vel", space_orientation_max_vel_);
-  ros::param::get("~debug", debug_);
+  n_private_.getParam("goal_joint_tolerance", goal_joint_tolerance_);
+  n_private_.getParam("sampling_frequency", sampling_freq_);
+
+  n_private_.getParam("joint_max_vel", joint_max_vel_);
+  n_private_.getParam("ik_telemetry_rate", ik_telemetry_rate_);
+  n_private_.getParam("trace_file", trace_file_);
+  n_private_.getParam("run_record_file", run_record_file_);
+  n_private_.getParam("control_loop_stats_rate", control_loop_stats_rate_);
+  n_private_.getParam("space_position_max_vel", space_position_max_vel_);
+  n_private_.getParam("space_orientation_max_vel", space_orientation_max_vel_);
+  n_private_.getParam("debug", debug_);
+
+  std::string joint_command_mode = "trajectory";
+  n_private_.getParam("joint_command_mode", joint_command_mode);
+  streaming_command_ = (joint_command_mode == "streaming");
+  if (!streaming_command_ && joint_command_mode != "trajectory")
+  {
+    ROS_WARN("Unknown joint command mode \"%s\", trajectory is used", joint_command_mode.c_str());
+  }
 }
 void RobotManager::initializeStateMachine_()
 {
   /* State definition */
   state_disable_ = new State<RobotManager>(this, "DISABLE");
+  state_disable_->registerEnterFcn(&RobotManager::disableEnter_);
   state_disable_->registerUpdateFcn(&RobotManager::disableUpdate_);
 
   state_idle_ = new State<RobotManager>(this, "IDLE");
+  state_idle_->registerEnterFcn(&RobotManager::idleEnter_);
   state_disable_->registerUpdateFcn(&RobotManager::idleUpdate_);
 
   state_joint_position_ = new State<RobotManager>(this, "JOINT POSITION");
   state_joint_position_->registerEnterFcn(&RobotManager::jointPositionEnter_);
+  state_joint_position_->registerUpdateFcn(&RobotManager::jointPositionUpdate_);
   state_joint_position_->registerExitFcn(&RobotManager::jointPositionExit_);
 
   state_space_position_ = new State<RobotManager>(this, "SPACE POSITION");
@@ -345,8 +540,8 @@ void RobotManager::initializeStateMachine_()
 
 void RobotManager::spaceControlUpdate_()
 {
-  ROS_INFO("=== Update joint position (Open loop)...");
-  q_current_ = q_command_;
+  /* Joint position is updated with the last command, corrected with the measure in closed loop mode */
+  updateJointFeedback_();
 
   cartesian_controller_.setDxDesired(dx_desired_);
   cartesian_controller_.setInputSelector(CartesianController::INPUT_USER);
@@ -374,23 +569,35 @@ void RobotManager::spaceControlUpdate_()
     set_control_frame_requested_ = 0;
   }
   cartesian_controller_.run(q_current_, q_command_);
+  recordRun_();
 
-  ROS_INFO("=== Send Niryo One joints command...");
   sendJointsCommand_();
+  joint_feedback_.addCommand(q_command_, ros::Time::now());
+  SPACE_CONTROL_TRACE(trace::Event::CommandSent, 0, 0.0);
+}
+
+void RobotManager::disableEnter_()
+{
+  /* Give the trajectory controller back to the other driver clients */
+  selectStreamingController_(false);
 }
 
 void RobotManager::disableUpdate_()
 {
-  ROS_INFO("=== Update joint position with measured position...");
+  /* Update joint position with measured position */
   q_current_ = q_meas_;
-  ROS_INFO("    Done.");
+}
+
+void RobotManager::idleEnter_()
+{
+  /* Give the trajectory controller back to the other driver clients */
+  selectStreamingController_(false);
 }
 
 void RobotManager::idleUpdate_()
 {
-  ROS_INFO("=== Update joint position with measured position...");
+  /* Update joint position with measured position */
   q_current_ = q_meas_;
-  ROS_INFO("    Done.");
 }
 
 void RobotManager::spaceControlEnter_()
@@ -398,11 +605,25 @@ void RobotManager::spaceControlEnter_()
   /* Switch to cartesian mode when position is completed */
   // cartesian_controller_.reset();
   q_command_ = q_meas_;
+  joint_feedback_.reset();
+  selectStreamingController_(true);
 }
 
 void RobotManager::jointPositionEnter_()
 {
-  gotoPosition_(joint_pose_manager_.getJointPosition(position_requested_));
+  selectStreamingController_(false);
+  joint_position_sent_ = false;
+  jointPositionUpdate_();
+}
+
+void RobotManager::jointPositionUpdate_()
+{
+  /* The trajectory is sent once the trajectory controller runs again */
+  if (!joint_position_sent_ && !streaming_controller_active_)
+  {
+    gotoPosition_(joint_pose_manager_.getJointPosition(position_requested_));
+    joint_position_sent_ = true;
+  }
 }
 
 void RobotManager::jointPositionExit_()
@@ -412,23 +633,25 @@ void RobotManager::jointPositionExit_()
 
 void RobotManager::spacePositionUpdate_()
 {
-  ROS_INFO("=== Update joint position (Open loop)...");
-  q_current_ = q_command_;
-  ROS_INFO("    Done.");
+  /* Joint position is updated with the last command, corrected with the measure in closed loop mode */
+  updateJointFeedback_();
 
   cartesian_controller_.setDxDesired(dx_desired_);
   cartesian_controller_.setInputSelector(CartesianController::INPUT_TRAJECTORY);
   cartesian_controller_.run(q_current_, q_command_);
+  recordRun_();
 
-  ROS_INFO("=== Send Niryo One commands...");
   sendJointsCommand_();
-  ROS_INFO("    Done.");
+  joint_feedback_.addCommand(q_command_, ros::Time::now());
+  SPACE_CONTROL_TRACE(trace::Event::CommandSent, 0, 0.0);
 }
 
 void RobotManager::spacePositionEnter_()
 {
   // cartesian_controller_.reset();
   q_command_ = q_meas_;
+  joint_feedback_.reset();
+  selectStreamingController_(true);
   cartesian_controller_.getInverseKinematic()->setPositionControlFrame(
       InverseKinematic::ControlFrame::World);  // PENDING: why that ?
   cartesian_controller_.getInverseKinematic()->setOrientationControlFrame(InverseKinematic::ControlFrame::World);
@@ -466,7 +689,7 @@ bool RobotManager::trToSpacePosition_()
 bool RobotManager::trJointPositionToSpaceControl_()
 {
   // First check if the required time to perform trajectory is elapse
-  if (ros::Time::now() < joint_position_timer_)
+  if (!joint_position_sent_ || ros::Time::now() < joint_position_timer_)
   {
     return false;
   }
@@ -485,24 +708,24 @@ bool RobotManager::isUserVelocityReceive() const
 
 void RobotManager::gotoPosition_(const JointPosition q_pose)
 {
-  trajectory_msgs::JointTrajectory new_jt_traj;
+  trajectory_msgs::JointTrajectoryPtr new_jt_traj(new trajectory_msgs::JointTrajectory);
 
-  new_jt_traj.header.stamp = ros::Time::now();
-  new_jt_traj.joint_names.resize(joint_number_);
+  new_jt_traj->header.stamp = ros::Time::now();
+  new_jt_traj->joint_names.resize(joint_number_);
   trajectory_msgs::JointTrajectoryPoint point;
   point.positions = q_pose;
   /* Set velocity ensure a cubic interpolation */
   point.velocities.resize(joint_number_);
   for (int i = 0; i < joint_number_; i++)
   {
-    new_jt_traj.joint_names[i] = "joint_" + std::to_string(i + 1);
+    new_jt_traj->joint_names[i] = "joint_" + std::to_string(i + 1);
     point.velocities[i] = 0.0;
   }
 
   point.time_from_start = ros::Duration(computeDuration_(q_pose));
   joint_position_timer_ = ros::Time::now() + point.time_from_start;
 
-  new_jt_traj.points.push_back(point);
+  new_jt_traj->points.push_back(point);
   command_pub_.publish(new_jt_traj);
 }
 
@@ -537,34 +760,77 @@ double RobotManager::computeDuration_(const JointPosition q_pose) const
 
 void RobotManager::sendJointsCommand_() const
 {
-  trajectory_msgs::JointTrajectory new_jt_traj;
-  new_jt_traj.header.stamp = ros::Time::now();
-  new_jt_traj.joint_names.resize(joint_number_);
+  /* Message is published through a shared pointer (and never modified afterwards), so that it is passed without
+   * serialization when the driver runs in the same nodelet manager */
+  if (streaming_controller_active_)
+  {
+    /* Setpoint is stamped with the time it must be reached : the driver interpolates up to it */
+    sensor_msgs::JointStatePtr setpoint(new sensor_msgs::JointState);
+    setpoint->header.stamp = ros::Time::now() + ros::Duration(1.0 / sampling_freq_);
+    setpoint->name.resize(joint_number_);
+    for (int i = 0; i < joint_number_; i++)
+    {
+      setpoint->name[i] = "joint_" + std::to_string(i + 1);
+    }
+    setpoint->position = q_command_;
+    streaming_command_pub_.publish(setpoint);
+    return;
+  }
+
+  trajectory_msgs::JointTrajectoryPtr new_jt_traj(new trajectory_msgs::JointTrajectory);
+  new_jt_traj->header.stamp = ros::Time::now();
+  new_jt_traj->joint_names.resize(joint_number_);
   trajectory_msgs::JointTrajectoryPoint point;
   point.time_from_start = ros::Duration(1.0 / sampling_freq_);
   for (int i = 0; i < joint_number_; i++)
   {
-    new_jt_traj.joint_names[i] = "joint_" + std::to_string(i + 1);
+    new_jt_traj->joint_names[i] = "joint_" + std::to_string(i + 1);
   }
   point.positions = q_command_;
 
   // Important : do not send velocity else cubic interpolation is done !
-  new_jt_traj.points.push_back(point);
+  new_jt_traj->points.push_back(point);
   command_pub_.publish(new_jt_traj);
 };
-}
 
-using namespace space_control;
-int main(int argc, char** argv)
+void RobotManager::selectStreamingController_(const bool streaming)
 {
-  ros::init(argc, argv, "robot_manager");
-  int joint_number = 6;
-  bool debug = false;
-
-  ros::param::get("~joint_number", joint_number);
-  ros::param::get("~debug", debug);
-
-  RobotManager robot_manager(joint_number, debug);
+  if (!streaming_command_ || streaming == streaming_controller_requested_)
+  {
+    return;
+  }
+  /* The service call blocks until the next driver control cycle : it is made by the intake thread, out of the
+   * control loop deadlines. Until it is acknowledged, commands go to the controller which still runs. */
+  streaming_controller_requested_ = streaming;
+  intake_queue_.addCallback(
+      ros::CallbackInterfacePtr(new FunctionCallback(std::bind(&RobotManager::switchControllers_, this))));
+}
 
-  return 0;
+void RobotManager::switchControllers_()
+{
+  /* Switches are processed in request order : a request may already be cancelled by a later one */
+  const bool streaming = streaming_controller_requested_;
+  if (streaming == streaming_controller_active_)
+  {
+    return;
+  }
+  controller_manager_msgs::SwitchController srv;
+  const std::string streaming_controller = "niryo_one_streaming_joint_controller";
+  const std::string trajectory_controller = "niryo_one_follow_joint_trajectory_controller";
+  srv.request.start_controllers.push_back(streaming ? streaming_controller : trajectory_controller);
+  srv.request.stop_controllers.push_back(streaming ? trajectory_controller : streaming_controller);
+  srv.request.strictness = controller_manager_msgs::SwitchController::Request::STRICT;
+  if (switch_controller_client_.call(srv) && srv.response.ok)
+  {
+    streaming_controller_active_ = streaming;
+    ROS_INFO("Joint commands are sent to %s", srv.request.start_controllers[0].c_str());
+  }
+  else
+  {
+    /* The next request of this controller is issued again */
+    bool requested = streaming;
+    streaming_controller_requested_.compare_exchange_strong(requested, !streaming);
+    ROS_ERROR("Could not switch driver controllers to %s", srv.request.start_controllers[0].c_str());
+  }
+}
 }
@@ -0,0 +1,324 @@
+/*
+ *  run_recorder.cpp
+ *  Copyright (C) 2019 Orthopus
+ *  All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ros/ros.h"
+#include "xmlrpcpp/XmlRpcValue.h"
+
+#include "orthopus_space_control/run_recorder.h"
+
+namespace space_control
+{
+namespace run_record
+{
+std::string snapshotParameters(const ros::NodeHandle& nh_private)
+{
+  XmlRpc::XmlRpcValue snapshot;
+  XmlRpc::XmlRpcValue value;
+  if (nh_private.getParam(nh_private.getNamespace(), value))
+  {
+    snapshot[PRIVATE_NAMESPACE_KEY] = value;
+  }
+  for (const char* name : SNAPSHOT_PARAMETERS)
+  {
+    if (nh_private.getParam(name, value))
+    {
+      snapshot[name] = value;
+    }
+  }
+  return snapshot.valid() ? snapshot.toXml() : std::string();
+}
+
+void capture(CartesianController& controller, const JointPosition& q_current, const SpaceVelocity& dx_desired,
+             const JointPosition& q_command, Record& record)
+{
+  std::memset(&record, 0, sizeof(record));
+  record.input_selector = controller.getInputSelector();
+
+  const InverseKinematic* ik = controller.getInverseKinematic();
+  const TrajectoryController* tc = controller.getTrajectoryController();
+  if (ik->getPositionControlFrame() == InverseKinematic::ControlFrame::Tool)
+  {
+    record.control_frame |= POSITION_TOOL_FRAME;
+  }
+  if (ik->getOrientationControlFrame() == InverseKinematic::ControlFrame::Tool)
+  {
+    record.control_frame |= ORIENTATION_TOOL_FRAME;
+  }
+  record.reset_count = controller.getResetCount();
+  record.ik_reset_count = ik->getResetCount();
+  record.goal_count = tc->getGoalCount();
+
+  std::copy(q_current.begin(), q_current.end(), record.q_current);
+  std::copy(q_command.begin(), q_command.end(), record.q_command);
+  for (int i = 0; i < SPACE_DIMENSION; i++)
+  {
+    record.dx_desired[i] = dx_desired[i];
+    record.x_goal[i] = tc->getXGoal()[i];
+    record.x_current[i] = controller.getXCurrent()[i];
+    record.dx_selected[i] = controller.getDxDesiredSelected()[i];
+  }
+
+  const IkSolveReport& report = ik->getLastSolveReport();
+  record.ik_flags = (report.success ? IK_SUCCESS : 0) | (report.fallback_used ? IK_FALLBACK_USED : 0) |
+                    (report.budget_exceeded ? IK_BUDGET_EXCEEDED : 0) | (report.qpoases ? IK_QPOASES : 0);
+  record.ik_status = report.status;
+  record.ik_iterations = report.iterations;
+  record.ik_active_constraints = report.active_constraints;
+  record.ik_objective = report.objective;
+
+  const CartesianController::StageDurations& durations = controller.getStageDurations();
+  record.fk_time = durations.fk;
+  record.trajectory_time = durations.trajectory;
+  record.ik_time = durations.ik;
+  record.integrate_time = durations.integrate;
+}
+}
+
+namespace
+{
+/* Records are written by blocks : the ring must hold the records of a period at the highest control rate */
+constexpr std::chrono::milliseconds WRITE_PERIOD(100);
+}
+
+RunRecorder::RunRecorder() : file_(nullptr), cycle_(0), running_(false)
+{
+}
+
+RunRecorder::~RunRecorder()
+{
+  close();
+}
+
+bool RunRecorder::open(const std::string& file_name, const int joint_number, const double sampling_period,
+                       const std::string& parameters)
+{
+  close();
+  if (joint_number > run_record::MAX_JOINT_NUMBER)
+  {
+    ROS_ERROR("Run records are limited to %d joints (%d)", run_record::MAX_JOINT_NUMBER, joint_number);
+    return false;
+  }
+  file_ = std::fopen(file_name.c_str(), "wb");
+  if (file_ == nullptr)
+  {
+    return false;
+  }
+
+  run_record::FileHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, run_record::FILE_MAGIC, sizeof(header.magic));
+  header.version = run_record::FILE_VERSION;
+  header.record_size = sizeof(run_record::Record);
+  header.parameters_size = parameters.size();
+  header.records_offset = ((sizeof(header) + parameters.size() + run_record::RECORDS_ALIGNMENT - 1) /
+                           run_record::RECORDS_ALIGNMENT) *
+                          run_record::RECORDS_ALIGNMENT;
+  header.joint_number = joint_number;
+  header.sampling_period = sampling_period;
+
+  const std::vector<char> padding(header.records_offset - sizeof(header) - parameters.size(), 0);
+  bool ok = (std::fwrite(&header, sizeof(header), 1, file_) == 1);
+  ok = ok && (parameters.empty() || std::fwrite(parameters.data(), parameters.size(), 1, file_) == 1);
+  ok = ok && (padding.empty() || std::fwrite(padding.data(), padding.size(), 1, file_) == 1);
+  if (!ok)
+  {
+    std::fclose(file_);
+    file_ = nullptr;
+    return false;
+  }
+
+  ring_.reset(new run_record::RecordRing());
+  cycle_ = 0;
+  running_ = true;
+  thread_ = std::thread(&RunRecorder::run_, this);
+  return true;
+}
+
+void RunRecorder::close()
+{
+  running_ = false;
+  if (thread_.joinable())
+  {
+    thread_.join();
+  }
+  if (file_ != nullptr)
+  {
+    if (!flush_())
+    {
+      ROS_ERROR("Could not write the last run records");
+    }
+    std::fclose(file_);
+    file_ = nullptr;
+  }
+}
+
+bool RunRecorder::isOpen() const
+{
+  return file_ != nullptr;
+}
+
+void RunRecorder::push(run_record::Record& record)
+{
+  if (file_ == nullptr)
+  {
+    return;
+  }
+  record.cycle = cycle_++;
+  ring_->push(record);
+}
+
+std::size_t RunRecorder::getDropped() const
+{
+  return ring_ ? ring_->getDropped() : 0;
+}
+
+void RunRecorder::run_()
+{
+  while (running_)
+  {
+    std::this_thread::sleep_for(WRITE_PERIOD);
+    if (!flush_())
+    {
+      /* Records are dropped from now on, the ring is no more read */
+      ROS_ERROR("Could not write run records, recording is stopped");
+      return;
+    }
+  }
+}
+
+bool RunRecorder::flush_()
+{
+  run_record::Record record;
+  while (ring_->pop(record))
+  {
+    if (std::fwrite(&record, sizeof(record), 1, file_) != 1)
+    {
+      return false;
+    }
+  }
+  return std::fflush(file_) == 0;
+}
+
+RunRecordReader::RunRecordReader()
+  : data_(nullptr), data_size_(0), header_(nullptr), records_(nullptr), record_number_(0)
+{
+}
+
+RunRecordReader::~RunRecordReader()
+{
+  close();
+}
+
+bool RunRecordReader::open(const std::string& file_name, std::string& error)
+{
+  close();
+  error.clear();
+  const int fd = ::open(file_name.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    error = "could not open " + file_name;
+    return false;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || file_stat.st_size < static_cast<off_t>(sizeof(run_record::FileHeader)))
+  {
+    ::close(fd);
+    error = file_name + " is not a run recording";
+    return false;
+  }
+  void* data = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED)
+  {
+    error = "could not map " + file_name;
+    return false;
+  }
+  data_ = data;
+  data_size_ = file_stat.st_size;
+  header_ = static_cast<const run_record::FileHeader*>(data_);
+
+  if (std::memcmp(header_->magic, run_record::FILE_MAGIC, sizeof(header_->magic)) != 0)
+  {
+    error = file_name + " is not a run recording";
+  }
+  else if (header_->version != run_record::FILE_VERSION || header_->record_size != sizeof(run_record::Record))
+  {
+    error = "unsupported run recording version " + std::to_string(header_->version) + " (record size " +
+            std::to_string(header_->record_size) + ")";
+  }
+  else if (header_->records_offset % run_record::RECORDS_ALIGNMENT != 0 || header_->records_offset > data_size_ ||
+           sizeof(run_record::FileHeader) + header_->parameters_size > header_->records_offset ||
+           header_->joint_number > static_cast<uint32_t>(run_record::MAX_JOINT_NUMBER))
+  {
+    error = file_name + " has an invalid header";
+  }
+  if (!error.empty())
+  {
+    close();
+    return false;
+  }
+
+  /* A partial last record (recording interrupted while writing) is ignored */
+  records_ = reinterpret_cast<const run_record::Record*>(static_cast<const char*>(data_) + header_->records_offset);
+  record_number_ = (data_size_ - header_->records_offset) / sizeof(run_record::Record);
+  return true;
+}
+
+void RunRecordReader::close()
+{
+  if (data_ != nullptr)
+  {
+    munmap(data_, data_size_);
+  }
+  data_ = nullptr;
+  data_size_ = 0;
+  header_ = nullptr;
+  records_ = nullptr;
+  record_number_ = 0;
+}
+
+const run_record::FileHeader& RunRecordReader::getHeader() const
+{
+  return *header_;
+}
+
+std::string RunRecordReader::getParameters() const
+{
+  return std::string(static_cast<const char*>(data_) + sizeof(run_record::FileHeader), header_->parameters_size);
+}
+
+std::size_t RunRecordReader::size() const
+{
+  return record_number_;
+}
+
+const run_record::Record& RunRecordReader::operator[](const std::size_t i) const
+{
+  return records_[i];
+}
+}
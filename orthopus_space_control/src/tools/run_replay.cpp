@@ -0,0 +1,685 @@
+/*
+ *  run_replay.cpp
+ *  Copyright (C) 2019 Orthopus
+ *  All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "ros/ros.h"
+#include "xmlrpcpp/XmlRpcServer.h"
+#include "xmlrpcpp/XmlRpcServerMethod.h"
+#include "xmlrpcpp/XmlRpcValue.h"
+
+#include "orthopus_space_control/cartesian_controller.h"
+#include "orthopus_space_control/joint_pose_manager.h"
+#include "orthopus_space_control/run_recorder.h"
+#include "orthopus_space_control/utils/distribution.h"
+
+using namespace space_control;
+
+/*
+ * Replay a CartesianController run recording offline (see run_recorder.h).
+ *
+ *   run_replay <recording> [--reference <recording>] [--output <recording>] [--tolerance <value>]
+ *              [--keep-cpu-budget] [--set <name>=<value>]...
+ *
+ * The recorded inputs and controller events are given to a CartesianController (forward kinematic, trajectory
+ * controller, inverse kinematic, velocity integrator) run by a single thread, as fast as possible. No ROS master is
+ * needed : the recorded parameters are served by a parameter-only master embedded in the tool, on the loopback
+ * interface.
+ *
+ * Outputs are compared with the reference recording (the replayed recording by default), and the stage durations of
+ * the replay are printed next to the recorded ones. The IK CPU time budget is disabled unless --keep-cpu-budget is
+ * given, so that the replay is deterministic. --set overrides a private parameter (ex : --set ik_qp_solver=qpoases)
+ * and --output records the replay, to be used as a reference later.
+ *
+ * Exit code is 0 if the outputs match the reference within the tolerance, 2 if they diverge, 1 on error.
+ */
+namespace
+{
+const char* const NODE_NAME = "run_replay";
+
+/**
+* \brief Parameter tree with the ROS master parameter semantic (namespaces are struct values)
+*/
+class ParameterTree
+{
+public:
+  ParameterTree()
+  {
+  }
+
+  void set(const std::string& key, const XmlRpc::XmlRpcValue& value)
+  {
+    const std::vector<std::string> names = split_(key);
+    if (names.empty())
+    {
+      return;
+    }
+    XmlRpc::XmlRpcValue* node = &root_;
+    for (std::size_t i = 0; i + 1 < names.size(); i++)
+    {
+      XmlRpc::XmlRpcValue& child = (*node)[names[i]];
+      if (child.getType() != XmlRpc::XmlRpcValue::TypeStruct)
+      {
+        /* An invalid value becomes a struct at its first member access */
+        child = XmlRpc::XmlRpcValue();
+      }
+      node = &child;
+    }
+    (*node)[names.back()] = value;
+  }
+
+  bool get(const std::string& key, XmlRpc::XmlRpcValue& value)
+  {
+    XmlRpc::XmlRpcValue* node = find_(key);
+    if (node == nullptr)
+    {
+      return false;
+    }
+    value = *node;
+    return true;
+  }
+
+  bool has(const std::string& key)
+  {
+    return find_(key) != nullptr;
+  }
+
+  /**
+  * \brief rosmaster searchParam : look for the first name of key from ns up to the root namespace
+  */
+  bool search(const std::string& ns, const std::string& key, std::string& found)
+  {
+    if (!key.empty() && key[0] == '/')
+    {
+      found = key;
+      return has(key);
+    }
+    const std::vector<std::string> key_names = split_(key);
+    if (key_names.empty())
+    {
+      return false;
+    }
+    std::vector<std::string> namespaces = split_(ns);
+    while (true)
+    {
+      std::string prefix = "/";
+      for (const std::string& name : namespaces)
+      {
+        prefix += name + "/";
+      }
+      if (has(prefix + key_names[0]))
+      {
+        found = prefix + key;
+        return true;
+      }
+      if (namespaces.empty())
+      {
+        return false;
+      }
+      namespaces.pop_back();
+    }
+  }
+
+  void getNames(std::vector<std::string>& names)
+  {
+    names.clear();
+    appendNames_(root_, "", names);
+  }
+
+protected:
+private:
+  XmlRpc::XmlRpcValue root_;
+
+  static std::vector<std::string> split_(const std::string& key)
+  {
+    std::vector<std::string> names;
+    std::size_t begin = 0;
+    while (begin <= key.size())
+    {
+      std::size_t end = key.find('/', begin);
+      end = (end == std::string::npos) ? key.size() : end;
+      if (end > begin)
+      {
+        names.push_back(key.substr(begin, end - begin));
+      }
+      begin = end + 1;
+    }
+    return names;
+  }
+
+  XmlRpc::XmlRpcValue* find_(const std::string& key)
+  {
+    XmlRpc::XmlRpcValue* node = &root_;
+    for (const std::string& name : split_(key))
+    {
+      if (node->getType() != XmlRpc::XmlRpcValue::TypeStruct || !node->hasMember(name))
+      {
+        return nullptr;
+      }
+      node = &(*node)[name];
+    }
+    return node->valid() ? node : nullptr;
+  }
+
+  static void appendNames_(XmlRpc::XmlRpcValue& node, const std::string& prefix, std::vector<std::string>& names)
+  {
+    if (node.getType() != XmlRpc::XmlRpcValue::TypeStruct)
+    {
+      names.push_back(prefix);
+      return;
+    }
+    for (XmlRpc::XmlRpcValue::iterator it = node.begin(); it != node.end(); ++it)
+    {
+      appendNames_(it->second, prefix + "/" + it->first, names);
+    }
+  }
+};
+
+/**
+* \brief XML-RPC method of the embedded master
+*/
+class MasterMethod : public XmlRpc::XmlRpcServerMethod
+{
+public:
+  typedef std::function<void(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result)> Function;
+
+  MasterMethod(const std::string& name, XmlRpc::XmlRpcServer* server, const Function& function)
+    : XmlRpc::XmlRpcServerMethod(name, server), function_(function)
+  {
+  }
+
+  void execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result)
+  {
+    function_(params, result);
+  }
+
+protected:
+private:
+  Function function_;
+};
+
+/**
+* \brief Minimal ROS master : parameter server, and registrations accepted without any peer lookup
+*/
+class ParameterMaster
+{
+public:
+  ParameterMaster() : running_(false)
+  {
+  }
+
+  ~ParameterMaster()
+  {
+    stop();
+  }
+
+  ParameterTree& getParameters()
+  {
+    return parameters_;
+  }
+
+  bool start()
+  {
+    addMethods_();
+    if (!server_.bindAndListen(0))
+    {
+      return false;
+    }
+    uri_ = "http://127.0.0.1:" + std::to_string(server_.get_port()) + "/";
+    running_ = true;
+    thread_ = std::thread([this]() {
+      while (running_)
+      {
+        server_.work(0.01);
+      }
+    });
+    return true;
+  }
+
+  void stop()
+  {
+    running_ = false;
+    if (thread_.joinable())
+    {
+      thread_.join();
+      server_.shutdown();
+    }
+  }
+
+  const std::string& getUri() const
+  {
+    return uri_;
+  }
+
+protected:
+private:
+  XmlRpc::XmlRpcServer server_;
+  std::vector<std::unique_ptr<MasterMethod>> methods_;
+  ParameterTree parameters_; /*!< Only accessed by the server thread once started */
+  std::string uri_;
+  std::atomic<bool> running_;
+  std::thread thread_;
+
+  static void response_(XmlRpc::XmlRpcValue& result, const int code, const std::string& message,
+                        const XmlRpc::XmlRpcValue& value)
+  {
+    result[0] = code;
+    result[1] = message;
+    result[2] = value;
+  }
+
+  void addMethod_(const std::string& name, const MasterMethod::Function& function)
+  {
+    methods_.emplace_back(new MasterMethod(name, &server_, function));
+  }
+
+  void addMethods_()
+  {
+    addMethod_("getParam", [this](XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+      XmlRpc::XmlRpcValue value;
+      const std::string key = params[1];
+      if (parameters_.get(key, value))
+      {
+        response_(result, 1, "", value);
+      }
+      else
+      {
+        response_(result, -1, "Parameter [" + key + "] is not set", 0);
+      }
+    });
+    addMethod_("hasParam", [this](XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+      const std::string key = params[1];
+      response_(result, 1, "", parameters_.has(key));
+    });
+    addMethod_("setParam", [this](XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+      const std::string key = params[1];
+      parameters_.set(key, params[2]);
+      response_(result, 1, "", 0);
+    });
+    addMethod_("searchParam", [this](XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+      const std::string ns = params[0];
+      const std::string key = params[1];
+      std::string found;
+      if (parameters_.search(ns, key, found))
+      {
+        response_(result, 1, "", found);
+      }
+      else
+      {
+        response_(result, -1, "Cannot find parameter", "");
+      }
+    });
+    addMethod_("getParamNames", [this](XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+      std::vector<std::string> names;
+      parameters_.getNames(names);
+      XmlRpc::XmlRpcValue value;
+      value.setSize(static_cast<int>(names.size()));
+      for (int i = 0; i < static_cast<int>(names.size()); i++)
+      {
+        value[i] = names[i];
+      }
+      response_(result, 1, "", value);
+    });
+    addMethod_("getUri", [this](XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+      response_(result, 1, "", uri_);
+    });
+    addMethod_("getPid", [](XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+      response_(result, 1, "", static_cast<int>(getpid()));
+    });
+
+    /* Nothing is published nor subscribed by the replay : registrations are accepted, there is no peer */
+    XmlRpc::XmlRpcValue no_peer;
+    no_peer.setSize(0);
+    for (const char* name : { "registerPublisher", "registerSubscriber" })
+    {
+      addMethod_(name, [no_peer](XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+        response_(result, 1, "", no_peer);
+      });
+    }
+    for (const char* name : { "registerService", "unregisterService", "unregisterPublisher", "unregisterSubscriber",
+                              "subscribeParam", "unsubscribeParam" })
+    {
+      addMethod_(name, [](XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+        response_(result, 1, "", 1);
+      });
+    }
+    for (const char* name : { "lookupNode", "lookupService" })
+    {
+      addMethod_(name, [](XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+        response_(result, -1, "No node nor service in a replay", "");
+      });
+    }
+  }
+};
+
+/**
+* \brief Parameter value of a --set option : bool, int, double or string
+*/
+XmlRpc::XmlRpcValue parseValue(const std::string& text)
+{
+  if (text == "true" || text == "false")
+  {
+    return XmlRpc::XmlRpcValue(text == "true");
+  }
+  char* end = nullptr;
+  const long integer = std::strtol(text.c_str(), &end, 10);
+  if (!text.empty() && *end == '\0')
+  {
+    return XmlRpc::XmlRpcValue(static_cast<int>(integer));
+  }
+  const double real = std::strtod(text.c_str(), &end);
+  if (!text.empty() && *end == '\0')
+  {
+    return XmlRpc::XmlRpcValue(real);
+  }
+  return XmlRpc::XmlRpcValue(text);
+}
+
+template <class Space>
+Space toSpace(const double (&raw_data)[run_record::SPACE_DIMENSION])
+{
+  Space value;
+  for (int i = 0; i < run_record::SPACE_DIMENSION; i++)
+  {
+    value[i] = raw_data[i];
+  }
+  return value;
+}
+
+double maxDifference(const double* a, const double* b, const int size)
+{
+  double difference = 0.0;
+  for (int i = 0; i < size; i++)
+  {
+    difference = std::max(difference, std::abs(a[i] - b[i]));
+  }
+  return difference;
+}
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 2)
+  {
+    std::fprintf(stderr,
+                 "usage : %s <recording> [--reference <recording>] [--output <recording>] [--tolerance <value>]\n"
+                 "       [--keep-cpu-budget] [--set <name>=<value>]...\n",
+                 argv[0]);
+    return 1;
+  }
+  const std::string input_file = argv[1];
+  std::string reference_file = input_file;
+  std::string output_file;
+  double tolerance = 1e-9;
+  bool keep_cpu_budget = false;
+  std::vector<std::pair<std::string, std::string>> overrides;
+  for (int i = 2; i < argc; i++)
+  {
+    const std::string option = argv[i];
+    const bool has_value = (i + 1 < argc);
+    if (option == "--reference" && has_value)
+    {
+      reference_file = argv[++i];
+    }
+    else if (option == "--output" && has_value)
+    {
+      output_file = argv[++i];
+    }
+    else if (option == "--tolerance" && has_value)
+    {
+      tolerance = std::atof(argv[++i]);
+    }
+    else if (option == "--keep-cpu-budget")
+    {
+      keep_cpu_budget = true;
+    }
+    else if (option == "--set" && has_value && std::strchr(argv[i + 1], '=') != nullptr)
+    {
+      const std::string assignment = argv[++i];
+      const std::size_t equal = assignment.find('=');
+      overrides.push_back(std::make_pair(assignment.substr(0, equal), assignment.substr(equal + 1)));
+    }
+    else
+    {
+      std::fprintf(stderr, "Unknown or incomplete option %s\n", option.c_str());
+      return 1;
+    }
+  }
+
+  std::string error;
+  RunRecordReader input;
+  RunRecordReader reference;
+  if (!input.open(input_file, error) || !reference.open(reference_file, error))
+  {
+    std::fprintf(stderr, "%s\n", error.c_str());
+    return 1;
+  }
+  const run_record::FileHeader& header = input.getHeader();
+  const int joint_number = header.joint_number;
+  if (input.size() == 0)
+  {
+    std::printf("Empty recording\n");
+    return 0;
+  }
+
+  /* Recorded parameters, the private ones moved to the namespace of the replay node */
+  ParameterMaster master;
+  ParameterTree& parameters = master.getParameters();
+  const std::string private_namespace = std::string("/") + NODE_NAME;
+  const std::string snapshot_xml = input.getParameters();
+  if (snapshot_xml.empty())
+  {
+    std::fprintf(stderr, "Warning : %s has no parameter snapshot\n", input_file.c_str());
+  }
+  else
+  {
+    int offset = 0;
+    XmlRpc::XmlRpcValue snapshot(snapshot_xml, &offset);
+    if (snapshot.getType() != XmlRpc::XmlRpcValue::TypeStruct)
+    {
+      std::fprintf(stderr, "%s has an invalid parameter snapshot\n", input_file.c_str());
+      return 1;
+    }
+    for (XmlRpc::XmlRpcValue::iterator it = snapshot.begin(); it != snapshot.end(); ++it)
+    {
+      parameters.set((it->first == run_record::PRIVATE_NAMESPACE_KEY) ? private_namespace : it->first, it->second);
+    }
+  }
+  /* The replay must not overwrite the files of the recorded run */
+  parameters.set(private_namespace + "/run_record_file", std::string());
+  parameters.set(private_namespace + "/ik_qp_dump_file", std::string());
+  if (!keep_cpu_budget)
+  {
+    parameters.set(private_namespace + "/ik_qp_cpu_time_budget", 0.0);
+  }
+  for (const std::pair<std::string, std::string>& assignment : overrides)
+  {
+    parameters.set(private_namespace + "/" + assignment.first, parseValue(assignment.second));
+  }
+
+  if (!master.start())
+  {
+    std::fprintf(stderr, "Could not start the embedded parameter server\n");
+    return 1;
+  }
+  ros::M_string remappings;
+  remappings["__master"] = master.getUri();
+  remappings["__ip"] = "127.0.0.1";
+  ros::init(remappings, NODE_NAME, ros::init_options::NoRosout);
+
+  int result = 0;
+  {
+    ros::NodeHandle nh_private("~");
+    JointPoseManager joint_pose_manager(joint_number, nh_private);
+    CartesianController controller(joint_number, nh_private);
+    controller.init(header.sampling_period, joint_pose_manager);
+
+    RunRecorder output;
+    if (!output_file.empty() &&
+        !output.open(output_file, joint_number, header.sampling_period, run_record::snapshotParameters(nh_private)))
+    {
+      std::fprintf(stderr, "Could not create %s\n", output_file.c_str());
+      ros::shutdown();
+      return 1;
+    }
+
+    JointPosition q_current(joint_number);
+    JointPosition q_command(joint_number);
+    run_record::Record previous;
+    std::memset(&previous, 0, sizeof(previous));
+    std::size_t gaps = 0;
+    std::vector<Distribution> replay_stats(5), recorded_stats(5);
+    const char* const stage_names[] = { "fk", "trajectory", "ik", "integrate", "run" };
+
+    std::size_t compared = 0;
+    std::size_t first_divergence = input.size();
+    std::size_t ik_mismatches = 0;
+    double q_command_difference = 0.0;
+    double x_current_difference = 0.0;
+    double objective_difference = 0.0;
+
+    std::size_t i = 0;
+    for (; i < input.size() && ros::ok(); i++)
+    {
+      const run_record::Record& record = input[i];
+      gaps += (i > 0 && record.cycle != previous.cycle + 1) ? 1 : 0;
+
+      /* Controller events since the previous run, in their recording order */
+      InverseKinematic* ik = controller.getInverseKinematic();
+      const unsigned int resets = record.reset_count - previous.reset_count;
+      if (resets > 0)
+      {
+        controller.reset();
+      }
+      if (record.ik_reset_count - previous.ik_reset_count > resets)
+      {
+        ik->reset();
+      }
+      if (record.goal_count != previous.goal_count)
+      {
+        controller.getTrajectoryController()->setXGoal(toSpace<SpacePosition>(record.x_goal));
+      }
+      ik->setPositionControlFrame((record.control_frame & run_record::POSITION_TOOL_FRAME) != 0 ?
+                                      InverseKinematic::ControlFrame::Tool :
+                                      InverseKinematic::ControlFrame::World);
+      ik->setOrientationControlFrame((record.control_frame & run_record::ORIENTATION_TOOL_FRAME) != 0 ?
+                                         InverseKinematic::ControlFrame::Tool :
+                                         InverseKinematic::ControlFrame::World);
+      controller.setInputSelector(static_cast<CartesianController::InputSelectorType>(record.input_selector));
+      const SpaceVelocity dx_desired = toSpace<SpaceVelocity>(record.dx_desired);
+      controller.setDxDesired(dx_desired);
+      std::copy(record.q_current, record.q_current + joint_number, q_current.begin());
+
+      const std::chrono::steady_clock::time_point run_begin = std::chrono::steady_clock::now();
+      controller.run(q_current, q_command);
+      const double run_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - run_begin).count();
+
+      run_record::Record replayed;
+      run_record::capture(controller, q_current, dx_desired, q_command, replayed);
+      replayed.stamp = record.stamp;
+      replayed.fsm_state = record.fsm_state;
+      output.push(replayed);
+
+      const bool trajectory = (record.input_selector == CartesianController::INPUT_TRAJECTORY);
+      const double replay_times[] = { replayed.fk_time, replayed.trajectory_time, replayed.ik_time,
+                                      replayed.integrate_time, run_time };
+      const double recorded_times[] = { record.fk_time, record.trajectory_time, record.ik_time, record.integrate_time,
+                                        record.fk_time + record.trajectory_time + record.ik_time +
+                                            record.integrate_time };
+      for (std::size_t s = 0; s < replay_stats.size(); s++)
+      {
+        if (s != 1 || trajectory)
+        {
+          replay_stats[s].add(replay_times[s] * 1e6);
+          recorded_stats[s].add(recorded_times[s] * 1e6);
+        }
+      }
+
+      if (i < reference.size())
+      {
+        const run_record::Record& expected = reference[i];
+        const double q_difference = maxDifference(replayed.q_command, expected.q_command, joint_number);
+        const double x_difference =
+            maxDifference(replayed.x_current, expected.x_current, run_record::SPACE_DIMENSION);
+        const bool ik_mismatch = ((replayed.ik_flags & ~run_record::IK_BUDGET_EXCEEDED) !=
+                                  (expected.ik_flags & ~run_record::IK_BUDGET_EXCEEDED));
+        compared++;
+        ik_mismatches += ik_mismatch ? 1 : 0;
+        q_command_difference = std::max(q_command_difference, q_difference);
+        x_current_difference = std::max(x_current_difference, x_difference);
+        objective_difference = std::max(objective_difference, std::abs(replayed.ik_objective - expected.ik_objective));
+        if (first_divergence == input.size() && (q_difference > tolerance || x_difference > tolerance || ik_mismatch))
+        {
+          first_divergence = i;
+        }
+      }
+      previous = record;
+    }
+    output.close();
+
+    std::printf("%zu runs replayed from %s (%d joints, period %.3f s)\n", i, input_file.c_str(), joint_number,
+                header.sampling_period);
+    if (gaps > 0)
+    {
+      std::printf("%zu gaps in the recording (dropped records) : the replay can not be exact\n", gaps);
+    }
+    std::printf("%-20s %8s\n", "stage", "count");
+    for (std::size_t s = 0; s < replay_stats.size(); s++)
+    {
+      replay_stats[s].print(stage_names[s], "us");
+      recorded_stats[s].print((std::string(stage_names[s]) + " (recorded)").c_str(), "us");
+    }
+
+    std::printf("\n%zu runs compared with %s\n", compared, reference_file.c_str());
+    std::printf("q_command max difference   %12.3e rad\n", q_command_difference);
+    std::printf("x_current max difference   %12.3e\n", x_current_difference);
+    std::printf("IK objective max difference %11.3e\n", objective_difference);
+    std::printf("IK result mismatches       %12zu\n", ik_mismatches);
+    if (compared < input.size())
+    {
+      std::printf("%zu runs missing in the reference\n", input.size() - compared);
+    }
+    if (first_divergence < input.size())
+    {
+      std::printf("Outputs diverge from record %zu (cycle %llu), tolerance %g\n", first_divergence,
+                  static_cast<unsigned long long>(input[first_divergence].cycle), tolerance);
+      result = 2;
+    }
+    else
+    {
+      std::printf("Outputs match the reference within %g\n", tolerance);
+    }
+  }
+
+  ros::shutdown();
+  master.stop();
+  return result;
+}
@@ -0,0 +1,157 @@
+/*
+ *  trace_decoder.cpp
+ *  Copyright (C) 2019 Orthopus
+ *  All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <vector>
+
+#include "orthopus_space_control/trace.h"
+#include "orthopus_space_control/utils/distribution.h"
+
+using namespace space_control;
+
+/*
+ * Decode a control loop trace file (see trace.h).
+ *
+ *   trace_decoder <trace file> [--summary]
+ *
+ * Events of all threads are printed in time order, then the duration of each begin/end pair and the control cycle
+ * period are summarized. With --summary, only the summary is printed.
+ */
+namespace
+{
+struct Span
+{
+  trace::Event begin;
+  trace::Event end;
+  const char* name;
+};
+
+const Span SPANS[] = { { trace::Event::CycleBegin, trace::Event::CycleEnd, "cycle" },
+                       { trace::Event::FkBegin, trace::Event::FkEnd, "fk" },
+                       { trace::Event::TrajectoryBegin, trace::Event::TrajectoryEnd, "trajectory" },
+                       { trace::Event::IkBegin, trace::Event::IkEnd, "ik" },
+                       { trace::Event::IntegrateBegin, trace::Event::IntegrateEnd, "integrate" } };
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 2)
+  {
+    std::fprintf(stderr, "usage : %s <trace file> [--summary]\n", argv[0]);
+    return 1;
+  }
+  const bool summary_only = (argc > 2 && std::strcmp(argv[2], "--summary") == 0);
+
+  FILE* file = std::fopen(argv[1], "rb");
+  if (file == nullptr)
+  {
+    std::fprintf(stderr, "Could not open %s\n", argv[1]);
+    return 1;
+  }
+  char magic[sizeof(trace::FILE_MAGIC)];
+  uint32_t version = 0, record_size = 0;
+  if (std::fread(magic, sizeof(magic), 1, file) != 1 || std::memcmp(magic, trace::FILE_MAGIC, sizeof(magic)) != 0 ||
+      std::fread(&version, sizeof(version), 1, file) != 1 || std::fread(&record_size, sizeof(record_size), 1, file) != 1)
+  {
+    std::fprintf(stderr, "%s is not a trace file\n", argv[1]);
+    std::fclose(file);
+    return 1;
+  }
+  if (version != trace::FILE_VERSION || record_size != sizeof(trace::Record))
+  {
+    std::fprintf(stderr, "Unsupported trace file version %u (record size %u)\n", version, record_size);
+    std::fclose(file);
+    return 1;
+  }
+
+  std::vector<trace::Record> records;
+  trace::Record record;
+  while (std::fread(&record, sizeof(record), 1, file) == 1)
+  {
+    records.push_back(record);
+  }
+  std::fclose(file);
+  if (records.empty())
+  {
+    std::printf("Empty trace\n");
+    return 0;
+  }
+  std::stable_sort(records.begin(), records.end(),
+                   [](const trace::Record& a, const trace::Record& b) { return a.stamp < b.stamp; });
+
+  const uint64_t origin = records.front().stamp;
+  if (!summary_only)
+  {
+    std::printf("%14s %6s %-18s %10s %14s\n", "time (us)", "thread", "event", "arg", "value");
+    for (const trace::Record& r : records)
+    {
+      std::printf("%14.1f %6u %-18s %10d %14.6g\n", (r.stamp - origin) * 1e-3, r.thread, trace::eventName(r.event),
+                  r.arg, r.value);
+    }
+    std::printf("\n");
+  }
+
+  /* Begin/end pairs are matched per thread */
+  std::map<uint16_t, std::map<uint16_t, uint64_t>> open_spans;
+  std::map<uint16_t, uint64_t> last_cycle_begin;
+  std::vector<Distribution> span_stats(sizeof(SPANS) / sizeof(SPANS[0]));
+  Distribution period_stats;
+  int transitions = 0;
+  for (const trace::Record& r : records)
+  {
+    for (std::size_t i = 0; i < span_stats.size(); i++)
+    {
+      if (r.event == static_cast<uint16_t>(SPANS[i].begin))
+      {
+        open_spans[r.thread][r.event] = r.stamp;
+      }
+      else if (r.event == static_cast<uint16_t>(SPANS[i].end))
+      {
+        std::map<uint16_t, uint64_t>& thread_spans = open_spans[r.thread];
+        std::map<uint16_t, uint64_t>::iterator begin = thread_spans.find(static_cast<uint16_t>(SPANS[i].begin));
+        if (begin != thread_spans.end())
+        {
+          span_stats[i].add((r.stamp - begin->second) * 1e-3);
+          thread_spans.erase(begin);
+        }
+      }
+    }
+    if (r.event == static_cast<uint16_t>(trace::Event::CycleBegin))
+    {
+      if (last_cycle_begin.count(r.thread) != 0)
+      {
+        period_stats.add((r.stamp - last_cycle_begin[r.thread]) * 1e-3);
+      }
+      last_cycle_begin[r.thread] = r.stamp;
+    }
+    transitions += (r.event == static_cast<uint16_t>(trace::Event::FsmTransition)) ? 1 : 0;
+  }
+
+  std::printf("%zu events over %.3f s, %d FSM transitions\n", records.size(), (records.back().stamp - origin) * 1e-9,
+              transitions);
+  std::printf("%-12s %8s\n", "span", "count");
+  for (std::size_t i = 0; i < span_stats.size(); i++)
+  {
+    span_stats[i].print(SPANS[i].name, "us");
+  }
+  period_stats.print("period", "us");
+  return 0;
+}
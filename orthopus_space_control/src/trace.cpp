@@ -0,0 +1,108 @@
+/*
+ *  trace.cpp
+ *  Copyright (C) 2019 Orthopus
+ *  All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "orthopus_space_control/trace.h"
+
+namespace space_control
+{
+namespace trace
+{
+namespace
+{
+static_assert((THREAD_RING_SIZE & (THREAD_RING_SIZE - 1)) == 0, "THREAD_RING_SIZE must be a power of two");
+
+struct ThreadRing
+{
+  Record records[THREAD_RING_SIZE];
+  std::atomic<uint64_t> count; /*!< Events recorded since the thread start (the ring keeps the last ones) */
+};
+
+/* Rings are never freed : a thread may exit before the trace is dumped */
+std::mutex registry_mutex;
+std::vector<std::unique_ptr<ThreadRing>> registry;
+
+ThreadRing* registerThread(uint16_t& thread_index)
+{
+  std::unique_ptr<ThreadRing> ring(new ThreadRing());
+  ring->count = 0;
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  thread_index = static_cast<uint16_t>(registry.size());
+  registry.push_back(std::move(ring));
+  return registry.back().get();
+}
+}
+
+void record(const Event event, const int32_t arg, const double value)
+{
+  static thread_local ThreadRing* ring = nullptr;
+  static thread_local uint16_t thread_index = 0;
+  if (ring == nullptr)
+  {
+    ring = registerThread(thread_index);
+  }
+
+  const uint64_t count = ring->count.load(std::memory_order_relaxed);
+  Record& r = ring->records[count & (THREAD_RING_SIZE - 1)];
+  r.stamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+  r.event = static_cast<uint16_t>(event);
+  r.thread = thread_index;
+  r.arg = arg;
+  r.value = value;
+  ring->count.store(count + 1, std::memory_order_release);
+}
+
+bool dump(const std::string& file_name)
+{
+#ifdef ORTHOPUS_SPACE_CONTROL_TRACE
+  FILE* file = std::fopen(file_name.c_str(), "wb");
+  if (file == nullptr)
+  {
+    return false;
+  }
+
+  /* File : magic, version, record size, then the records of each thread, oldest first */
+  const uint32_t record_size = sizeof(Record);
+  bool ok = (std::fwrite(FILE_MAGIC, sizeof(FILE_MAGIC), 1, file) == 1);
+  ok = ok && (std::fwrite(&FILE_VERSION, sizeof(FILE_VERSION), 1, file) == 1);
+  ok = ok && (std::fwrite(&record_size, sizeof(record_size), 1, file) == 1);
+
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  for (const std::unique_ptr<ThreadRing>& ring : registry)
+  {
+    const uint64_t count = ring->count.load(std::memory_order_acquire);
+    const uint64_t first = (count > THREAD_RING_SIZE) ? count - THREAD_RING_SIZE : 0;
+    for (uint64_t i = first; i < count && ok; i++)
+    {
+      ok = (std::fwrite(&ring->records[i & (THREAD_RING_SIZE - 1)], sizeof(Record), 1, file) == 1);
+    }
+  }
+  return (std::fclose(file) == 0) && ok;
+#else
+  return false;
+#endif
+}
+}
+}
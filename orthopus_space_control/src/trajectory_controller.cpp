@@ -22,14 +22,16 @@
 
 namespace space_control
 {
-TrajectoryController::TrajectoryController(const int joint_number)
-  : pi_number_(7)
+TrajectoryController::TrajectoryController(const int joint_number, const ros::NodeHandle& nh_private)
+  : n_(nh_private)
+  , pi_number_(7)
   , joint_number_(joint_number)
   , x_goal_()
   , x_current_()
   , x_error_()
   , x_traj_tolerance_()
   , sampling_period_(0.0)
+  , goal_count_(0)
 {
   pi_ctrl_.resize(pi_number_);
 }
@@ -40,14 +42,14 @@ void TrajectoryController::init(double sampling_period)
   is_completed_ = true;
   double pos_p_gain, pos_i_gain, orient_p_gain, orient_i_gain, space_position_max_vel, space_orientation_max_vel,
       goal_position_tolerance, goal_orientation_tolerance;
-  ros::param::get("~traj_ctrl_position_p_gain", pos_p_gain);
-  ros::param::get("~traj_ctrl_position_i_gain", pos_i_gain);
-  ros::param::get("~traj_ctrl_orientation_p_gain", orient_p_gain);
-  ros::param::get("~traj_ctrl_orientation_i_gain", orient_i_gain);
-  ros::param::get("~space_position_max_vel", space_position_max_vel);
-  ros::param::get("~space_orientation_max_vel", space_orientation_max_vel);
-  ros::param::get("~goal_position_tolerance", goal_position_tolerance);
-  ros::param::get("~goal_orientation_tolerance", goal_orientation_tolerance);
+  n_.getParam("traj_ctrl_position_p_gain", pos_p_gain);
+  n_.getParam("traj_ctrl_position_i_gain", pos_i_gain);
+  n_.getParam("traj_ctrl_orientation_p_gain", orient_p_gain);
+  n_.getParam("traj_ctrl_orientation_i_gain", orient_i_gain);
+  n_.getParam("space_position_max_vel", space_position_max_vel);
+  n_.getParam("space_orientation_max_vel", space_orientation_max_vel);
+  n_.getParam("goal_position_tolerance", goal_position_tolerance);
+  n_.getParam("goal_orientation_tolerance", goal_orientation_tolerance);
 
   for (int i = 0; i < pi_number_; i++)
   {
@@ -88,6 +90,17 @@ void TrajectoryController::setXGoal(const SpacePosition& x_goal)
 {
   is_completed_ = false;
   x_goal_ = x_goal;
+  goal_count_++;
+}
+
+const SpacePosition& TrajectoryController::getXGoal() const
+{
+  return x_goal_;
+}
+
+unsigned int TrajectoryController::getGoalCount() const
+{
+  return goal_count_;
 }
 
 void TrajectoryController::computeTrajectory(SpaceVelocity& dx_output)
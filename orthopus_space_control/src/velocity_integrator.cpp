@@ -22,10 +22,23 @@
 
 namespace space_control
 {
-VelocityIntegrator::VelocityIntegrator(const int joint_number) : joint_number_(joint_number), q_current_(joint_number)
+VelocityIntegrator::VelocityIntegrator(const int joint_number, const ros::NodeHandle& nh_private)
+  : n_(nh_private)
+  , joint_number_(joint_number)
+  , sampling_period_(0.0)
+  , mode_(Mode::Euler)
+  , q_current_(joint_number)
+  , dq_previous_(joint_number)
 {
   ROS_DEBUG_STREAM("VelocityIntegrator constructor");
-  sampling_period_ = 0.0;
+
+  std::string mode = "euler";
+  n_.getParam("velocity_integration", mode);
+  if (!parseMode(mode, mode_))
+  {
+    ROS_WARN("Unknown velocity integration \"%s\", euler is used", mode.c_str());
+  }
+  reset();
 }
 
 void VelocityIntegrator::init(const double sampling_period)
@@ -33,11 +46,32 @@ void VelocityIntegrator::init(const double sampling_period)
   sampling_period_ = sampling_period;
 }
 
-void VelocityIntegrator::integrate(const JointVelocity& dq_input, JointPosition& q_output)
+void VelocityIntegrator::reset()
 {
+  /* The robot starts from rest */
   for (int i = 0; i < joint_number_; i++)
   {
-    q_output[i] = q_current_[i] + dq_input[i] * sampling_period_;
+    dq_previous_[i] = 0.0;
+  }
+}
+
+void VelocityIntegrator::integrate(const JointVelocity& dq_input, JointPosition& q_output)
+{
+  if (mode_ == Mode::Trapezoidal)
+  {
+    for (int i = 0; i < joint_number_; i++)
+    {
+      q_output[i] = q_current_[i] + 0.5 * (dq_previous_[i] + dq_input[i]) * sampling_period_;
+      dq_previous_[i] = dq_input[i];
+    }
+  }
+  else
+  {
+    for (int i = 0; i < joint_number_; i++)
+    {
+      q_output[i] = q_current_[i] + dq_input[i] * sampling_period_;
+      dq_previous_[i] = dq_input[i];
+    }
   }
 }
 
@@ -45,4 +79,24 @@ void VelocityIntegrator::setQCurrent(const JointPosition& q_current)
 {
   q_current_ = q_current;
 }
+
+VelocityIntegrator::Mode VelocityIntegrator::getMode() const
+{
+  return mode_;
+}
+
+bool VelocityIntegrator::parseMode(const std::string& name, Mode& mode)
+{
+  if (name == "euler")
+  {
+    mode = Mode::Euler;
+    return true;
+  }
+  if (name == "trapezoidal")
+  {
+    mode = Mode::Trapezoidal;
+    return true;
+  }
+  return false;
+}
 }
@@ -51,13 +51,14 @@
 #include <QProblem.cpp>
 #include <SQProblem.cpp>
 
-#if defined(SOLVER_MA27) || defined(SOLVER_MA57)
+#if defined(SOLVER_MA27) || defined(SOLVER_MA57) || defined(SOLVER_LDL)
 #include <SparseSolver.cpp>
 #include <SQProblemSchur.cpp>
 #endif
 
 #if !defined(__C_WRAPPER__) && !defined(__MATLAB__)
 #include <OQPinterface.cpp>
+#include <QPSequence.cpp>
 #include <SolutionAnalysis.cpp>
 #endif
 
@@ -67,7 +68,10 @@
 #include <qpOASES/QProblem.hpp>
 #include <qpOASES/SQProblem.hpp>
 #include <qpOASES/SQProblemSchur.hpp>
+#include <qpOASES/QProblemFixed.hpp>
+#include <qpOASES/BatchSolver.hpp>
 #include <qpOASES/extras/OQPinterface.hpp>
+#include <qpOASES/extras/QPSequence.hpp>
 #include <qpOASES/extras/SolutionAnalysis.hpp>
 
 #endif
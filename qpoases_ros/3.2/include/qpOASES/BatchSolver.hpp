@@ -0,0 +1,185 @@
+/*
+ *	This file is part of qpOASES.
+ *
+ *	qpOASES -- An Implementation of the Online Active Set Strategy.
+ *	Copyright (C) 2007-2017 by Hans Joachim Ferreau, Andreas Potschka,
+ *	Christian Kirches et al. All rights reserved.
+ *
+ *	qpOASES is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU Lesser General Public
+ *	License as published by the Free Software Foundation; either
+ *	version 2.1 of the License, or (at your option) any later version.
+ *
+ *	qpOASES is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *	See the GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public
+ *	License along with qpOASES; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/**
+ *	\file include/qpOASES/BatchSolver.hpp
+ *	\author Hans Joachim Ferreau, Andreas Potschka, Christian Kirches
+ *	\version 3.2
+ *	\date 2007-2017
+ *
+ *	Declaration of the BatchSolver class which solves batches of independent
+ *	QPs in parallel.
+ */
+
+
+
+#ifndef QPOASES_BATCHSOLVER_HPP
+#define QPOASES_BATCHSOLVER_HPP
+
+
+#include <qpOASES/SQProblem.hpp>
+
+
+/* worker threads need C++11, otherwise batches are solved sequentially */
+#if !defined(__NO_THREADS__) && ( ( __cplusplus >= 201103L ) || ( defined(_MSVC_LANG) && ( _MSVC_LANG >= 201103L ) ) )
+	#define __USE_THREADS__
+#endif
+
+
+BEGIN_NAMESPACE_QPOASES
+
+
+/**
+ *	\brief Stores the data and results of one QP of a batch.
+ *
+ *	The QP object holds the warm-start state of the QP sequence. The QP is
+ *	initialised if its status is QPS_NOTINITIALISED, otherwise it is
+ *	hotstarted: with new matrices if H or A is given (as for
+ *	SQProblem::hotstart(), shallow copies are made and both matrices are
+ *	replaced), with new vectors only otherwise.
+ *
+ *	\author Hans Joachim Ferreau
+ *	\version 3.2
+ *	\date 2007-2017
+ */
+struct BatchQP {
+	SQProblem* problem;		/**< QP object (must not be shared between QPs of a batch). */
+	const real_t* H;		/**< Hessian matrix (NULL: trivial Hessian, or unchanged if A is NULL too). */
+	const real_t* g;		/**< Gradient vector. */
+	const real_t* A;		/**< Constraint matrix (NULL: no constraints, or unchanged if H is NULL too). */
+	const real_t* lb;		/**< Lower bound vector (NULL: no lower bounds). */
+	const real_t* ub;		/**< Upper bound vector (NULL: no upper bounds). */
+	const real_t* lbA;		/**< Lower constraints' bound vector (NULL: no lower constraints' bounds). */
+	const real_t* ubA;		/**< Upper constraints' bound vector (NULL: no upper constraints' bounds). */
+	int_t nWSR;				/**< Input: Maximum number of working set recalculations; \n
+								 Output: Number of performed working set recalculations. */
+	real_t cputime;			/**< Input: Maximum CPU time allowed for QP solution (unlimited if not positive); \n
+								 Output: CPU time spent for QP solution. */
+	real_t* xOpt;			/**< Output: Primal solution if the QP was solved (NULL: not copied). */
+	real_t* yOpt;			/**< Output: Dual solution if the QP was solved (NULL: not copied). */
+	returnValue status;		/**< Output: Return value of init() or hotstart(). */
+};
+
+
+struct BatchSolverPool;
+
+
+/**
+ *	\brief Solves batches of independent QPs in parallel.
+ *
+ *	A class for solving N independent QPs per call, e.g. several weightings or
+ *	look-ahead steps of the same problem, or the problems of several robots.
+ *	Each QP keeps its own warm-start state in its own QP object.
+ *
+ *	The QPs are distributed over a pool of worker threads created once by the
+ *	constructor (the calling thread takes part in the solution). Each worker
+ *	solves the QPs of its own share of the batch and then steals QPs from the
+ *	shares of the other workers, which balances QPs of different difficulty.
+ *
+ *	The message handler of qpOASES is global: the print level of the QP objects
+ *	has to be set (preferably to PL_NONE) before calling solve().
+ *
+ *	\author Hans Joachim Ferreau, Andreas Potschka, Christian Kirches
+ *	\version 3.2
+ *	\date 2007-2017
+ */
+class BatchSolver
+{
+	/*
+	 *	PUBLIC MEMBER FUNCTIONS
+	 */
+	public:
+		/** Constructor which takes the number of threads. */
+		BatchSolver(	int_t _nThreads = 0		/**< Number of threads solving a batch, including the calling thread \n
+													 (0: number of hardware threads). */
+						);
+
+		/** Destructor (stops the worker threads). */
+		~BatchSolver( );
+
+
+		/** Solves a batch of independent QPs (see BatchQP).
+		 *	\return SUCCESSFUL_RETURN \n
+					RET_BATCH_SOLVE_FAILED \n
+					RET_INVALID_ARGUMENTS */
+		returnValue solve(	BatchQP* const qps,		/**< Data and results of the QPs. */
+							int_t nQP				/**< Number of QPs. */
+							);
+
+
+		/** Returns the number of threads solving a batch (including the calling thread).
+		 *	\return Number of threads */
+		inline int_t getNThreads( ) const;
+
+
+	/*
+	 *	PROTECTED MEMBER FUNCTIONS
+	 */
+	protected:
+		/** Solves one QP of a batch. */
+		static void solveQP(	BatchQP& qp		/**< Data and results of the QP. */
+								);
+
+		/** Solves QPs of the current batch until none is left, starting with
+		 *	the share of the given worker. */
+		void runWorker(	int_t worker		/**< Index of the worker (0: calling thread). */
+						);
+
+		/** Main loop of a worker thread. */
+		void workerLoop(	int_t worker		/**< Index of the worker. */
+							);
+
+
+	/*
+	 *	PRIVATE MEMBER FUNCTIONS
+	 */
+	private:
+		/** Copy constructor (not implemented, worker threads cannot be copied). */
+		BatchSolver(	const BatchSolver& rhs	/**< Rhs object. */
+						);
+
+		/** Assignment operator (not implemented, worker threads cannot be copied). */
+		BatchSolver& operator=(	const BatchSolver& rhs	/**< Rhs object. */
+								);
+
+
+	/*
+	 *	PROTECTED MEMBER VARIABLES
+	 */
+	protected:
+		int_t nThreads;				/**< Number of threads solving a batch (including the calling thread). */
+		BatchSolverPool* pool;		/**< Worker threads and batch queues (NULL if batches are solved sequentially). */
+};
+
+
+END_NAMESPACE_QPOASES
+
+#include <qpOASES/BatchSolver.ipp>
+
+#endif	/* QPOASES_BATCHSOLVER_HPP */
+
+
+/*
+ *	end of file
+ */
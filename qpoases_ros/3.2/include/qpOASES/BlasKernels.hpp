@@ -0,0 +1,229 @@
+/*
+ *	This file is part of qpOASES.
+ *
+ *	qpOASES -- An Implementation of the Online Active Set Strategy.
+ *	Copyright (C) 2007-2017 by Hans Joachim Ferreau, Andreas Potschka,
+ *	Christian Kirches et al. All rights reserved.
+ *
+ *	qpOASES is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU Lesser General Public
+ *	License as published by the Free Software Foundation; either
+ *	version 2.1 of the License, or (at your option) any later version.
+ *
+ *	qpOASES is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *	See the GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public
+ *	License along with qpOASES; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/**
+ *	\file include/qpOASES/BlasKernels.hpp
+ *	\author Hans Joachim Ferreau, Andreas Potschka, Christian Kirches
+ *	\version 3.2
+ *	\date 2007-2017
+ *
+ *	Vectorised double precision kernels used by the BLAS/LAPACK replacement
+ *	routines (internal header).
+ *
+ *	The instruction set is chosen at compile time from the compiler target:
+ *	AVX (with FMA if available), SSE2, NEON on AArch64, or plain scalar code.
+ *	Compile with -march=native (CMake option QPOASES_NATIVE_ARCH) to enable
+ *	the widest instruction set of the build machine.
+ */
+
+
+#ifndef QPOASES_BLASKERNELS_HPP
+#define QPOASES_BLASKERNELS_HPP
+
+
+#include <qpOASES/Types.hpp>
+
+
+#if defined(__AVX__)
+	#include <immintrin.h>
+	#define QPOASES_SIMD_NAME "AVX"
+	#define QPOASES_SIMD_WIDTH 4
+	typedef __m256d qpoases_vreal_t;
+	#define QPOASES_VLOAD(p)     _mm256_loadu_pd(p)
+	#define QPOASES_VSTORE(p,v)  _mm256_storeu_pd((p),(v))
+	#define QPOASES_VSET1(a)     _mm256_set1_pd(a)
+	#define QPOASES_VZERO()      _mm256_setzero_pd()
+	#define QPOASES_VADD(a,b)    _mm256_add_pd((a),(b))
+	#if defined(__FMA__)
+		#define QPOASES_VFMA(a,b,c) _mm256_fmadd_pd((a),(b),(c))
+	#else
+		#define QPOASES_VFMA(a,b,c) _mm256_add_pd(_mm256_mul_pd((a),(b)),(c))
+	#endif
+	static inline double qpoases_vsum( qpoases_vreal_t v )
+	{
+		__m128d s = _mm_add_pd( _mm256_castpd256_pd128(v),_mm256_extractf128_pd(v,1) );
+		return _mm_cvtsd_f64( _mm_add_sd( s,_mm_unpackhi_pd(s,s) ) );
+	}
+#elif defined(__SSE2__)
+	#include <emmintrin.h>
+	#define QPOASES_SIMD_NAME "SSE2"
+	#define QPOASES_SIMD_WIDTH 2
+	typedef __m128d qpoases_vreal_t;
+	#define QPOASES_VLOAD(p)     _mm_loadu_pd(p)
+	#define QPOASES_VSTORE(p,v)  _mm_storeu_pd((p),(v))
+	#define QPOASES_VSET1(a)     _mm_set1_pd(a)
+	#define QPOASES_VZERO()      _mm_setzero_pd()
+	#define QPOASES_VADD(a,b)    _mm_add_pd((a),(b))
+	#define QPOASES_VFMA(a,b,c)  _mm_add_pd(_mm_mul_pd((a),(b)),(c))
+	static inline double qpoases_vsum( qpoases_vreal_t v )
+	{
+		return _mm_cvtsd_f64( _mm_add_sd( v,_mm_unpackhi_pd(v,v) ) );
+	}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+	#include <arm_neon.h>
+	#define QPOASES_SIMD_NAME "NEON"
+	#define QPOASES_SIMD_WIDTH 2
+	typedef float64x2_t qpoases_vreal_t;
+	#define QPOASES_VLOAD(p)     vld1q_f64(p)
+	#define QPOASES_VSTORE(p,v)  vst1q_f64((p),(v))
+	#define QPOASES_VSET1(a)     vdupq_n_f64(a)
+	#define QPOASES_VZERO()      vdupq_n_f64(0.0)
+	#define QPOASES_VADD(a,b)    vaddq_f64((a),(b))
+	#define QPOASES_VFMA(a,b,c)  vfmaq_f64((c),(a),(b))
+	static inline double qpoases_vsum( qpoases_vreal_t v )
+	{
+		return vaddvq_f64( v );
+	}
+#else
+	#define QPOASES_SIMD_NAME "scalar"
+	#define QPOASES_SIMD_WIDTH 1
+#endif
+
+
+BEGIN_NAMESPACE_QPOASES
+
+
+/** Returns x'*y (n entries, unit stride). */
+static inline double kernelDot(	la_uint_t n, const double* x, const double* y )
+{
+	la_uint_t i = 0;
+	double sum = 0.0;
+
+	#if QPOASES_SIMD_WIDTH > 1
+	qpoases_vreal_t acc0 = QPOASES_VZERO();
+	qpoases_vreal_t acc1 = QPOASES_VZERO();
+	for( ; i+2*QPOASES_SIMD_WIDTH <= n; i+=2*QPOASES_SIMD_WIDTH )
+	{
+		acc0 = QPOASES_VFMA( QPOASES_VLOAD(x+i),QPOASES_VLOAD(y+i),acc0 );
+		acc1 = QPOASES_VFMA( QPOASES_VLOAD(x+i+QPOASES_SIMD_WIDTH),QPOASES_VLOAD(y+i+QPOASES_SIMD_WIDTH),acc1 );
+	}
+	for( ; i+QPOASES_SIMD_WIDTH <= n; i+=QPOASES_SIMD_WIDTH )
+		acc0 = QPOASES_VFMA( QPOASES_VLOAD(x+i),QPOASES_VLOAD(y+i),acc0 );
+	sum = qpoases_vsum( QPOASES_VADD(acc0,acc1) );
+	#endif
+
+	for( ; i<n; ++i )
+		sum += x[i] * y[i];
+	return sum;
+}
+
+
+/** Computes out[c] = a_c'*x for the four columns a_0..a_3 (n entries each, unit stride).
+ *	x is loaded once for the four products. */
+static inline void kernelDot4(	la_uint_t n, const double* a0, const double* a1, const double* a2, const double* a3,
+								const double* x, double* out )
+{
+	la_uint_t i = 0;
+	double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+
+	#if QPOASES_SIMD_WIDTH > 1
+	/* short columns : the four horizontal sums would cost more than they save */
+	if ( n >= 2*QPOASES_SIMD_WIDTH )
+	{
+		qpoases_vreal_t acc0 = QPOASES_VZERO();
+		qpoases_vreal_t acc1 = QPOASES_VZERO();
+		qpoases_vreal_t acc2 = QPOASES_VZERO();
+		qpoases_vreal_t acc3 = QPOASES_VZERO();
+		for( ; i+QPOASES_SIMD_WIDTH <= n; i+=QPOASES_SIMD_WIDTH )
+		{
+			qpoases_vreal_t xv = QPOASES_VLOAD(x+i);
+			acc0 = QPOASES_VFMA( QPOASES_VLOAD(a0+i),xv,acc0 );
+			acc1 = QPOASES_VFMA( QPOASES_VLOAD(a1+i),xv,acc1 );
+			acc2 = QPOASES_VFMA( QPOASES_VLOAD(a2+i),xv,acc2 );
+			acc3 = QPOASES_VFMA( QPOASES_VLOAD(a3+i),xv,acc3 );
+		}
+		s0 = qpoases_vsum( acc0 );
+		s1 = qpoases_vsum( acc1 );
+		s2 = qpoases_vsum( acc2 );
+		s3 = qpoases_vsum( acc3 );
+	}
+	#endif
+
+	for( ; i<n; ++i )
+	{
+		s0 += a0[i] * x[i];
+		s1 += a1[i] * x[i];
+		s2 += a2[i] * x[i];
+		s3 += a3[i] * x[i];
+	}
+	out[0] = s0;
+	out[1] = s1;
+	out[2] = s2;
+	out[3] = s3;
+}
+
+
+/** Computes y += alpha*x (n entries, unit stride). */
+static inline void kernelAxpy(	la_uint_t n, double alpha, const double* x, double* y )
+{
+	la_uint_t i = 0;
+
+	#if QPOASES_SIMD_WIDTH > 1
+	qpoases_vreal_t av = QPOASES_VSET1(alpha);
+	for( ; i+QPOASES_SIMD_WIDTH <= n; i+=QPOASES_SIMD_WIDTH )
+		QPOASES_VSTORE( y+i,QPOASES_VFMA( av,QPOASES_VLOAD(x+i),QPOASES_VLOAD(y+i) ) );
+	#endif
+
+	for( ; i<n; ++i )
+		y[i] += alpha * x[i];
+}
+
+
+/** Computes y += c[0]*a_0 + c[1]*a_1 + c[2]*a_2 + c[3]*a_3 (n entries each, unit stride).
+ *	y is loaded and stored once for the four columns. */
+static inline void kernelAxpy4(	la_uint_t n, const double* c, const double* a0, const double* a1,
+								const double* a2, const double* a3, double* y )
+{
+	la_uint_t i = 0;
+
+	#if QPOASES_SIMD_WIDTH > 1
+	qpoases_vreal_t c0 = QPOASES_VSET1(c[0]);
+	qpoases_vreal_t c1 = QPOASES_VSET1(c[1]);
+	qpoases_vreal_t c2 = QPOASES_VSET1(c[2]);
+	qpoases_vreal_t c3 = QPOASES_VSET1(c[3]);
+	for( ; i+QPOASES_SIMD_WIDTH <= n; i+=QPOASES_SIMD_WIDTH )
+	{
+		qpoases_vreal_t yv = QPOASES_VLOAD(y+i);
+		yv = QPOASES_VFMA( c0,QPOASES_VLOAD(a0+i),yv );
+		yv = QPOASES_VFMA( c1,QPOASES_VLOAD(a1+i),yv );
+		yv = QPOASES_VFMA( c2,QPOASES_VLOAD(a2+i),yv );
+		yv = QPOASES_VFMA( c3,QPOASES_VLOAD(a3+i),yv );
+		QPOASES_VSTORE( y+i,yv );
+	}
+	#endif
+
+	for( ; i<n; ++i )
+		y[i] += c[0]*a0[i] + c[1]*a1[i] + c[2]*a2[i] + c[3]*a3[i];
+}
+
+
+END_NAMESPACE_QPOASES
+
+
+#endif	/* QPOASES_BLASKERNELS_HPP */
+
+
+/*
+ *	end of file
+ */
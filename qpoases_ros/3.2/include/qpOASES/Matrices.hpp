@@ -310,7 +310,9 @@ class SymmetricMatrix : public virtual Matrix
 										const real_t* x,				/**< Input vector to be multiplied (uncompressed). */
 										int_t xLD,						/**< Leading dimension of input x. */
 										real_t* y,						/**< Output vector of results (compressed). */
-										int_t yLD						/**< Leading dimension of output y. */
+										int_t yLD,						/**< Leading dimension of output y. */
+										real_t* workspace = 0			/**< Workspace of at least icols->length*xN entries \n
+																			 (if a NULL pointer is passed, it is allocated internally). */
 										) const = 0;
 
 };
@@ -540,7 +542,9 @@ class SymDenseMat : public DenseMatrix, public SymmetricMatrix
 										const real_t* x,				/**< Input vector to be multiplied (uncompressed). */
 										int_t xLD,						/**< Leading dimension of input x. */
 										real_t* y,						/**< Output vector of results (compressed). */
-										int_t yLD						/**< Leading dimension of output y. */
+										int_t yLD,						/**< Leading dimension of output y. */
+										real_t* workspace = 0			/**< Workspace of at least icols->length*xN entries \n
+																			 (if a NULL pointer is passed, it is allocated internally). */
 										) const;
 };
 
@@ -973,7 +977,9 @@ class SymSparseMat : public SymmetricMatrix, public SparseMatrix
 										const real_t* x,				/**< Input vector to be multiplied (uncompressed). */
 										int_t xLD,						/**< Leading dimension of input x. */
 										real_t* y,						/**< Output vector of results (compressed). */
-										int_t yLD						/**< Leading dimension of output y. */
+										int_t yLD,						/**< Leading dimension of output y. */
+										real_t* workspace = 0			/**< Workspace of at least icols->length*xN entries \n
+																			 (if a NULL pointer is passed, it is allocated internally). */
 										) const;
 };
 
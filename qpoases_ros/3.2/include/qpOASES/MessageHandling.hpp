@@ -227,7 +227,9 @@ RET_SIMPLE_STATUS_P1,							/**< QP problem could not be solved within given num
 RET_SIMPLE_STATUS_P0,							/**< QP problem solved. */
 RET_SIMPLE_STATUS_M1,							/**< QP problem could not be solved due to an internal error. */
 RET_SIMPLE_STATUS_M2,							/**< QP problem is infeasible (and thus could not be solved). */
-RET_SIMPLE_STATUS_M3							/**< QP problem is unbounded (and thus could not be solved). (150) */
+RET_SIMPLE_STATUS_M3,							/**< QP problem is unbounded (and thus could not be solved). (150) */
+/* Batch solver */
+RET_BATCH_SOLVE_FAILED							/**< At least one QP of the batch could not be solved. */
 };
 
 
@@ -160,6 +160,9 @@ class Options
 		int_t dropBoundPriority;				/**< ... */
         int_t dropEqConPriority;				/**< ... */
         int_t dropIneqConPriority;				/**< ... */
+
+		ClockType clockType;					/**< Clock used for runtime measurements and CPU time limits. */
+		BooleanType enablePhaseTiming;			/**< Specifies whether the runtime of each homotopy phase shall be measured (see SolveStatistics). */
 };
 
 
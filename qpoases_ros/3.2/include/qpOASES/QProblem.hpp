@@ -429,6 +429,12 @@ class QProblem : public QProblemB
 		returnValue copy(	const QProblem& rhs	/**< Rhs object. */
 							);
 
+		/** Allocates the temporaries of the homotopy and sizes the working set
+		 *	snapshot, so that hotstarts do not allocate memory. */
+		void setupAuxiliaryWorkspaces(	uint_t _nV,	/**< Number of variables. */
+										uint_t _nC	/**< Number of constraints. */
+										);
+
 		/** Solves a QProblem whose QP data is assumed to be stored in the member variables.
 		 *  A guess for its primal/dual optimal solution vectors and the corresponding
 		 *  working sets of bounds and constraints can be provided.
@@ -1067,6 +1073,18 @@ class QProblem : public QProblemB
 		real_t* delta_yAC_TMP;					/**< Temporary for determineStepDirection. */
 
 		real_t* tempC;                          /**< Temporary for constraint types. */
+
+		real_t* solveQP_TMP;					/**< Temporary for solveQP (step directions and data shifts). */
+		real_t* performStep_TMP;				/**< Temporary for performStep (ratio test). */
+		real_t* updateActiveSet_TMP;			/**< Temporary for addBound/addConstraint/removeBound/removeConstraint. */
+		real_t* checkLI_TMP;					/**< Temporary for addBound_checkLI/addConstraint_checkLI. */
+		real_t* ensureLI_TMP;					/**< Temporary for addBound_ensureLI/addConstraint_ensureLI. */
+		real_t* ensureNZC_TMP;					/**< Temporary for ensureNonzeroCurvature. */
+		real_t* hotstart_TMP;					/**< Temporary for hotstart (far bounds). */
+		real_t* bilinear_TMP;					/**< Temporary for computeProjectedCholesky (projected Hessian). */
+
+		Bounds snapshotBounds;					/**< Temporary for SQProblem::setupNewAuxiliaryQP (old working set of bounds). */
+		Constraints snapshotConstraints;		/**< Temporary for SQProblem::setupNewAuxiliaryQP (old working set of constraints). */
 };
 
 
@@ -431,6 +431,11 @@ class QProblemB
 		 *	\return SUCCESSFUL_RETURN. */
 		inline returnValue resetCounter( );
 
+		/** Returns runtime statistics (number of iterations, runtime of each
+		 *	homotopy phase) of the last init or hotstart call.
+		 *	\return Runtime statistics of the last QP solution. */
+		inline SolveStatistics getSolveStatistics( ) const;
+
 
 		/** Prints concise list of properties of the current QP.
 		 *	\return  SUCCESSFUL_RETURN \n */
@@ -622,6 +627,10 @@ class QProblemB
 											int_t nWSR						/**< Number of working set recalculations performed so far. */
 											) const;
 
+		/** Resets runtime statistics (to zero).
+		 *	\return SUCCESSFUL_RETURN */
+		inline returnValue resetSolveStatistics( );
+
 
 		/** Regularise Hessian matrix by adding a scaled identity matrix to it.
 		 *	\return SUCCESSFUL_RETURN \n
@@ -1006,6 +1015,8 @@ class QProblemB
 		Flipper flipper;			/**< Struct for making a temporary copy of the matrix factorisations. */
 
 		TabularOutput tabularOutput;	/**< Struct storing information for tabular output (printLevel == PL_TABULAR). */
+
+		SolveStatistics solveStatistics;	/**< Runtime statistics of the last init or hotstart call. */
 };
 
 
@@ -229,10 +229,35 @@ inline returnValue QProblemB::resetCounter( )
 }
 
 
+/*
+ *	g e t S o l v e S t a t i s t i c s
+ */
+inline SolveStatistics QProblemB::getSolveStatistics( ) const
+{
+	return solveStatistics;
+}
+
+
 /*****************************************************************************
  *  P R O T E C T E D                                                        *
  *****************************************************************************/
 
+/*
+ *	r e s e t S o l v e S t a t i s t i c s
+ */
+inline returnValue QProblemB::resetSolveStatistics( )
+{
+	solveStatistics.nIterations       = 0;
+	solveStatistics.totalTime         = 0.0;
+	solveStatistics.setupTime         = 0.0;
+	solveStatistics.stepDirectionTime = 0.0;
+	solveStatistics.ratioTestTime     = 0.0;
+	solveStatistics.factorisationTime = 0.0;
+
+	return SUCCESSFUL_RETURN;
+}
+
+
 /*
  *	s e t H
  */
@@ -0,0 +1,194 @@
+/*
+ *	This file is part of qpOASES.
+ *
+ *	qpOASES -- An Implementation of the Online Active Set Strategy.
+ *	Copyright (C) 2007-2017 by Hans Joachim Ferreau, Andreas Potschka,
+ *	Christian Kirches et al. All rights reserved.
+ *
+ *	qpOASES is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU Lesser General Public
+ *	License as published by the Free Software Foundation; either
+ *	version 2.1 of the License, or (at your option) any later version.
+ *
+ *	qpOASES is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *	See the GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public
+ *	License along with qpOASES; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/**
+ *	\file include/qpOASES/QProblemFixed.hpp
+ *	\author Hans Joachim Ferreau, Andreas Potschka, Christian Kirches
+ *	\version 3.2
+ *	\date 2007-2017
+ *
+ *	Declaration of the QProblemFixed class template, a front-end of the
+ *	SQProblem class for small dense QPs whose dimensions are known at
+ *	compile time.
+ */
+
+
+
+#ifndef QPOASES_QPROBLEMFIXED_HPP
+#define QPOASES_QPROBLEMFIXED_HPP
+
+
+#include <qpOASES/SQProblem.hpp>
+
+
+BEGIN_NAMESPACE_QPOASES
+
+
+/**
+ *	\brief Solves small dense QPs of fixed dimensions with varying matrices.
+ *
+ *	Front-end of the SQProblem class for QPs with _nV variables and _nC
+ *	constraints (both known at compile time), e.g. the differential inverse
+ *	kinematics QP which is solved at each control cycle.
+ *
+ *	The Hessian and constraint matrix are copied into storage held inline
+ *	in the object and wrapped by persistent dense matrix objects, so that
+ *	neither init() nor hotstart() allocates or frees matrix objects. The
+ *	working sets, the factorisations and the temporaries of the homotopy
+ *	are allocated once by the constructor, hence hotstart() does not
+ *	allocate memory at all. The online active set strategy
+ *	is the one of SQProblem, hence results are identical to SQProblem
+ *	called with the same data.
+ *
+ *	\author Hans Joachim Ferreau, Andreas Potschka, Christian Kirches
+ *	\version 3.2
+ *	\date 2007-2017
+ */
+template< int_t _nV, int_t _nC >
+class QProblemFixed : public SQProblem
+{
+	/*
+	 *	PUBLIC MEMBER FUNCTIONS
+	 */
+	public:
+		/** Constructor which takes the Hessian type information. */
+		QProblemFixed(	HessianType _hessianType = HST_UNKNOWN	/**< Type of Hessian matrix. */
+						);
+
+		/** Destructor. */
+		virtual ~QProblemFixed( );
+
+
+		/** Initialises a QP problem with given dense QP data (copied into
+		 *	the inline storage) and tries to solve it using at most nWSR
+		 *	iterations (see QProblem::init() for details).
+		 *	\return SUCCESSFUL_RETURN \n
+					RET_INIT_FAILED \n
+					RET_INIT_FAILED_CHOLESKY \n
+					RET_INIT_FAILED_TQ \n
+					RET_INIT_FAILED_HOTSTART \n
+					RET_INIT_FAILED_INFEASIBILITY \n
+					RET_INIT_FAILED_UNBOUNDEDNESS \n
+					RET_MAX_NWSR_REACHED \n
+					RET_INVALID_ARGUMENTS */
+		returnValue init(	const real_t* const _H,							/**< Hessian matrix (_nV x _nV, row-major). */
+							const real_t* const _g,							/**< Gradient vector. */
+							const real_t* const _A,							/**< Constraint matrix (_nC x _nV, row-major). */
+							const real_t* const _lb,						/**< Lower bound vector (on variables). \n
+																				 If no lower bounds exist, a NULL pointer can be passed. */
+							const real_t* const _ub,						/**< Upper bound vector (on variables). \n
+																				 If no upper bounds exist, a NULL pointer can be passed. */
+							const real_t* const _lbA,						/**< Lower constraints' bound vector. \n
+																				 If no lower constraints' bounds exist, a NULL pointer can be passed. */
+							const real_t* const _ubA,						/**< Upper constraints' bound vector. \n
+																				 If no lower constraints' bounds exist, a NULL pointer can be passed. */
+							int_t& nWSR,									/**< Input: Maximum number of working set recalculations when using initial homotopy.
+																				 Output: Number of performed working set recalculations. */
+							real_t* const cputime = 0,						/**< Input: Maximum CPU time allowed for QP initialisation. \n
+																				 Output: CPU time spent for QP initialisation (if pointer passed). */
+							const real_t* const xOpt = 0,					/**< Optimal primal solution vector. \n
+																				 (If a null pointer is passed, the old primal solution is kept!) */
+							const real_t* const yOpt = 0,					/**< Optimal dual solution vector. \n
+																				 (If a null pointer is passed, the old dual solution is kept!) */
+							const Bounds* const guessedBounds = 0,			/**< Optimal working set of bounds for solution (xOpt,yOpt). \n
+																				 (If a null pointer is passed, all bounds are assumed inactive!) */
+							const Constraints* const guessedConstraints = 0	/**< Optimal working set of constraints for solution (xOpt,yOpt). \n
+																				 (If a null pointer is passed, all constraints are assumed inactive!) */
+							);
+
+		/** Solves an initialised QP sequence with new dense QP matrices
+		 *	(copied into the inline storage) using the online active set strategy.
+		 *	\return SUCCESSFUL_RETURN \n
+		 			RET_MAX_NWSR_REACHED \n
+		 			RET_HOTSTART_FAILED_AS_QP_NOT_INITIALISED \n
+					RET_HOTSTART_FAILED \n
+					RET_SETUP_AUXILIARYQP_FAILED */
+		returnValue hotstart(	const real_t* const H_new,						/**< Hessian matrix of neighbouring QP to be solved (_nV x _nV, row-major). */
+								const real_t* const g_new,						/**< Gradient of neighbouring QP to be solved. */
+								const real_t* const A_new,						/**< Constraint matrix of neighbouring QP to be solved (_nC x _nV, row-major). */
+								const real_t* const lb_new,						/**< Lower bounds of neighbouring QP to be solved. \n
+													 								 If no lower bounds exist, a NULL pointer can be passed. */
+								const real_t* const ub_new,						/**< Upper bounds of neighbouring QP to be solved. \n
+													 		 						 If no upper bounds exist, a NULL pointer can be passed. */
+								const real_t* const lbA_new,					/**< Lower constraints' bounds of neighbouring QP to be solved. \n
+													 		 						 If no lower constraints' bounds exist, a NULL pointer can be passed. */
+								const real_t* const ubA_new,					/**< Upper constraints' bounds of neighbouring QP to be solved. \n
+												 			 						 If no upper constraints' bounds exist, a NULL pointer can be passed. */
+								int_t& nWSR,									/**< Input: Maximum number of working set recalculations; \n
+																					 Output: Number of performed working set recalculations. */
+								real_t* const cputime = 0,						/**< Input: Maximum CPU time allowed for QP solution. \n
+																					 Output: CPU time spent for QP solution (or to perform nWSR iterations). */
+								const Bounds* const guessedBounds = 0,			/**< Optimal working set of bounds for solution (xOpt,yOpt). \n
+																					 (If a null pointer is passed, the previous working set of bounds is kept!) */
+								const Constraints* const guessedConstraints = 0	/**< Optimal working set of constraints for solution (xOpt,yOpt). \n
+																					 (If a null pointer is passed, the previous working set of constraints is kept!) */
+								);
+
+		/* hotstart() with unchanged matrices */
+		using SQProblem::hotstart;
+
+
+	/*
+	 *	PRIVATE MEMBER FUNCTIONS
+	 */
+	private:
+		/** Copy constructor (not implemented, the matrix objects wrap the inline storage). */
+		QProblemFixed(	const QProblemFixed& rhs	/**< Rhs object. */
+						);
+
+		/** Assignment operator (not implemented, the matrix objects wrap the inline storage). */
+		QProblemFixed& operator=(	const QProblemFixed& rhs	/**< Rhs object. */
+									);
+
+		/** Copies dense QP matrices into the inline storage. */
+		inline void setMatrixData(	const real_t* const H_new,	/**< Hessian matrix (may be NULL). */
+									const real_t* const A_new	/**< Constraint matrix (may be NULL). */
+									);
+
+
+	/*
+	 *	PRIVATE MEMBER VARIABLES
+	 */
+	private:
+		static const size_t H_SIZE = static_cast<size_t>( _nV*_nV );					/**< Number of Hessian entries. */
+		static const size_t A_SIZE = static_cast<size_t>( _nC > 0 ? _nC*_nV : 1 );	/**< Number of constraint matrix entries (at least one). */
+
+		real_t Hdata[H_SIZE];						/**< Hessian matrix storage (row-major). */
+		real_t Adata[A_SIZE];						/**< Constraint matrix storage (row-major). */
+
+		SymDenseMat Hmat;							/**< Hessian matrix object wrapping Hdata. */
+		DenseMatrix Amat;							/**< Constraint matrix object wrapping Adata. */
+};
+
+
+END_NAMESPACE_QPOASES
+
+#include <qpOASES/QProblemFixed.ipp>
+
+#endif	/* QPOASES_QPROBLEMFIXED_HPP */
+
+
+/*
+ *	end of file
+ */
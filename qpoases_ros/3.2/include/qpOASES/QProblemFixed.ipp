@@ -0,0 +1,146 @@
+/*
+ *	This file is part of qpOASES.
+ *
+ *	qpOASES -- An Implementation of the Online Active Set Strategy.
+ *	Copyright (C) 2007-2017 by Hans Joachim Ferreau, Andreas Potschka,
+ *	Christian Kirches et al. All rights reserved.
+ *
+ *	qpOASES is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU Lesser General Public
+ *	License as published by the Free Software Foundation; either
+ *	version 2.1 of the License, or (at your option) any later version.
+ *
+ *	qpOASES is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *	See the GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public
+ *	License along with qpOASES; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/**
+ *	\file include/qpOASES/QProblemFixed.ipp
+ *	\author Hans Joachim Ferreau, Andreas Potschka, Christian Kirches
+ *	\version 3.2
+ *	\date 2007-2017
+ *
+ *	Implementation of the QProblemFixed class template, a front-end of the
+ *	SQProblem class for small dense QPs whose dimensions are known at
+ *	compile time.
+ */
+
+
+
+/*****************************************************************************
+ *  P U B L I C                                                              *
+ *****************************************************************************/
+
+
+BEGIN_NAMESPACE_QPOASES
+
+
+/*
+ *	Q P r o b l e m F i x e d
+ */
+template< int_t _nV, int_t _nC >
+QProblemFixed<_nV,_nC>::QProblemFixed( HessianType _hessianType )
+	: SQProblem( _nV,_nC,_hessianType ),
+	  Hmat( _nV,_nV,_nV,Hdata ),
+	  Amat( _nC,_nV,_nV,Adata )
+{
+	int_t i;
+
+	for( i=0; i<_nV*_nV; ++i ) Hdata[i] = 0.0;
+	for( i=0; i<( _nC > 0 ? _nC*_nV : 1 ); ++i ) Adata[i] = 0.0;
+}
+
+
+/*
+ *	~ Q P r o b l e m F i x e d
+ */
+template< int_t _nV, int_t _nC >
+QProblemFixed<_nV,_nC>::~QProblemFixed( )
+{
+	/* Hmat and Amat are passed as shallow copies, hence never freed by clear() */
+}
+
+
+/*
+ *	i n i t
+ */
+template< int_t _nV, int_t _nC >
+returnValue QProblemFixed<_nV,_nC>::init(	const real_t* const _H, const real_t* const _g, const real_t* const _A,
+											const real_t* const _lb, const real_t* const _ub,
+											const real_t* const _lbA, const real_t* const _ubA,
+											int_t& nWSR, real_t* const cputime,
+											const real_t* const xOpt, const real_t* const yOpt,
+											const Bounds* const guessedBounds, const Constraints* const guessedConstraints
+											)
+{
+	setMatrixData( _H,_A );
+
+	return SQProblem::init(	( _H != 0 ) ? &Hmat : 0,_g,
+							( _A != 0 ) ? &Amat : 0,
+							_lb,_ub,_lbA,_ubA,
+							nWSR,cputime,xOpt,yOpt,
+							guessedBounds,guessedConstraints
+							);
+}
+
+
+/*
+ *	h o t s t a r t
+ */
+template< int_t _nV, int_t _nC >
+returnValue QProblemFixed<_nV,_nC>::hotstart(	const real_t* const H_new, const real_t* const g_new, const real_t* const A_new,
+												const real_t* const lb_new, const real_t* const ub_new,
+												const real_t* const lbA_new, const real_t* const ubA_new,
+												int_t& nWSR, real_t* const cputime,
+												const Bounds* const guessedBounds, const Constraints* const guessedConstraints
+												)
+{
+	/* the constraint bounds are shifted with the stored products Ax_l and Ax_u,
+	 * hence the old constraint matrix may be overwritten before the update */
+	setMatrixData( H_new,A_new );
+
+	return SQProblem::hotstart(	( H_new != 0 ) ? &Hmat : 0,g_new,
+								( A_new != 0 ) ? &Amat : 0,
+								lb_new,ub_new,lbA_new,ubA_new,
+								nWSR,cputime,
+								guessedBounds,guessedConstraints
+								);
+}
+
+
+
+/*****************************************************************************
+ *  P R I V A T E                                                            *
+ *****************************************************************************/
+
+
+/*
+ *	s e t M a t r i x D a t a
+ */
+template< int_t _nV, int_t _nC >
+inline void QProblemFixed<_nV,_nC>::setMatrixData( const real_t* const H_new, const real_t* const A_new )
+{
+	int_t i;
+
+	if ( H_new != 0 )
+		for( i=0; i<_nV*_nV; ++i ) Hdata[i] = H_new[i];
+
+	if ( A_new != 0 )
+		for( i=0; i<_nC*_nV; ++i ) Adata[i] = A_new[i];
+}
+
+
+END_NAMESPACE_QPOASES
+
+
+/*
+ *	end of file
+ */
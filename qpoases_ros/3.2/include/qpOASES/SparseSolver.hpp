@@ -349,6 +349,152 @@ class Ma57SparseSolver: public SparseSolver
 #endif /* SOLVER_MA57 */
 
 
+#ifdef SOLVER_LDL
+
+/**
+ *	\brief Implementation of the linear solver interface using a built-in
+ *	multifrontal sparse LDL^T factorisation (no external dependency).
+ *
+ *	The pivot order is fixed by the analysis: a minimum degree ordering in
+ *	which rows with a structurally zero diagonal (the active constraint rows
+ *	of a KKT matrix) are only eliminated after one of their neighbours, so
+ *	that 1x1 pivots are sufficient for KKT matrices. Pivots that are small
+ *	relative to the largest matrix entry are treated as zero pivots: the
+ *	factorisation then reports the rank deficiency and the zero pivots like
+ *	MA57 does. Columns with identical sparsity pattern are grouped into
+ *	supernodes whose dense frontal matrices are factorised with the
+ *	vectorised BLAS kernels; independent subtrees of the assembly tree are
+ *	factorised in parallel when compiled with OpenMP.
+ *
+ *	\author Hans Joachim Ferreau, Andreas Potschka, Christian Kirches
+ *	\version 3.2
+ *	\date 2007-2017
+ */
+class LdlSparseSolver: public SparseSolver
+{
+	/*
+	 *	PUBLIC MEMBER FUNCTIONS
+	 */
+	public:
+		/** Default constructor. */
+		LdlSparseSolver( );
+
+		/** Copy constructor (deep copy). */
+		LdlSparseSolver(	const LdlSparseSolver& rhs		/**< Rhs object. */
+							);
+
+		/** Destructor. */
+		virtual ~LdlSparseSolver( );
+
+		/** Assignment operator (deep copy). */
+		virtual LdlSparseSolver& operator=(	const SparseSolver& rhs	/**< Rhs object. */
+												);
+
+		/** Set new matrix data.  The matrix is to be provided
+			in the Harwell-Boeing format.  Only the lower
+			triangular part should be set. */
+		virtual returnValue setMatrixData(	int_t dim,					/**< Dimension of the linear system. */
+											int_t numNonzeros,			/**< Number of nonzeros in the matrix. */
+											const int_t* const airn,	/**< Row indices for each matrix entry. */
+											const int_t* const acjn,	/**< Column indices for each matrix entry. */
+											const real_t* const avals	/**< Values for each matrix entry. */
+											);
+
+		/** Compute factorization of current matrix.  This method must be called before solve.
+		 *	\return SUCCESSFUL_RETURN \n
+					RET_KKT_MATRIX_SINGULAR */
+		virtual returnValue factorize( );
+
+		/** Solve linear system with most recently set matrix data. */
+		virtual returnValue solve(	int_t dim,					/**< Dimension of the linear system. */
+									const real_t* const rhs,	/**< Values for the right hand side. */
+									real_t* const sol			/**< Solution of the linear system. */
+									);
+
+		/** Clears all data structures. */
+		virtual returnValue reset( );
+
+		/** Return the number of negative eigenvalues. */
+		virtual int_t getNegativeEigenvalues( );
+
+		/** Return the rank after a factorization */
+		virtual int_t getRank( );
+
+		/** Returns the zero pivots (in ascending order) in case the matrix is rank deficient */
+		virtual returnValue getZeroPivots(	int_t* &zeroPivots	/**< Array of length dim-rank. */
+											);
+
+		/** Returns the number of nonzeros of the factor L (diagonal included). */
+		int_t getFactorNonzeros( ) const;
+
+		/** Returns the number of supernodes of the last factorization. */
+		int_t getNumSupernodes( ) const;
+
+	/*
+	 *	PROTECTED MEMBER FUNCTIONS
+	 */
+	protected:
+		/** Frees all allocated memory.
+		 *  \return SUCCESSFUL_RETURN */
+		returnValue clear( );
+
+		/** Copies all members from given rhs object.
+		 *  \return SUCCESSFUL_RETURN */
+		returnValue copy(	const LdlSparseSolver& rhs	/**< Rhs object. */
+							);
+
+	/*
+	 *	PRIVATE MEMBER FUNCTIONS
+	 */
+	private:
+		/** Computes the pivot order and the supernodal structure of the factor.
+		 *  \return SUCCESSFUL_RETURN */
+		returnValue analyse( );
+
+	/*
+	 *	PRIVATE MEMBER VARIABLES
+	 */
+	private:
+		int_t dim;					/**< Dimension of the current linear system. */
+
+		int_t numNonzeros;			/**< Number of nonzeros in the current linear system. */
+
+		int_t* colStart;			/**< Column starts of the lower triangle (compressed columns, length dim+1). */
+
+		int_t* rowIndex;			/**< Row indices of the lower triangle (ascending in each column). */
+
+		real_t* values;				/**< Values of the lower triangle. */
+
+		int_t* perm;				/**< Pivot order: perm[k] is the matrix row eliminated at step k. */
+
+		int_t nSupernodes;			/**< Number of supernodes. */
+
+		int_t* superStart;			/**< First pivot of each supernode (length nSupernodes+1). */
+
+		int_t* superParent;			/**< Parent of each supernode in the assembly tree (-1 for roots). */
+
+		int_t* frontStart;			/**< Start of the row list of each supernode in frontIndex (length nSupernodes+1). */
+
+		int_t* frontIndex;			/**< Row lists of the frontal matrices: the pivots of the supernode, then the rows they update. */
+
+		int_t* factorStart;			/**< Start of the factor panel of each supernode in factor (length nSupernodes+1). */
+
+		real_t* factor;				/**< Factor panels (column-major, frontal matrix rows x supernode pivots). */
+
+		real_t* diag;				/**< Diagonal of D, zero for zero pivots. */
+
+		BooleanType haveFactorization;	/**< Flag indicating whether factorization for current matrix has already been computed. */
+
+		int_t neig;					/**< Number of negative eigenvalues. */
+
+		int_t rank;					/**< Rank of matrix. */
+
+		int_t* zeroPivots;			/**< Rows with a zero pivot (ascending, length dim-rank). */
+};
+
+#endif /* SOLVER_LDL */
+
+
 #ifdef SOLVER_NONE
 
 /**
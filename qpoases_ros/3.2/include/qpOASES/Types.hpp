@@ -147,9 +147,10 @@
 #define TT( I,J )  T[(I)*sizeT+(J)]
 
 
-/* If neither MA57 nor MA27 are selected, activate the dummy solver */
-#if !defined(SOLVER_MA27) && !defined(SOLVER_MA57) && !defined(SOLVER_NONE)
-#define SOLVER_NONE
+/* If no sparse solver is selected, activate the built-in LDL^T solver
+ * (define SOLVER_NONE to build without sparse solver) */
+#if !defined(SOLVER_MA27) && !defined(SOLVER_MA57) && !defined(SOLVER_LDL) && !defined(SOLVER_NONE)
+#define SOLVER_LDL
 #endif
 
 
@@ -289,6 +290,14 @@ enum SchurUpdateType
 	SUT_UNDEFINED			/**< Type of Schur update is undefined. */
 };
 
+
+/** Summarises all possible clocks used for runtime measurements (and CPU time limits). */
+enum ClockType
+{
+	CT_MONOTONIC,			/**< Monotonic wall-clock time (not affected by system clock adjustments). */
+	CT_THREADCPUTIME		/**< CPU time consumed by the calling thread. */
+};
+
 /**
  *	\brief Stores internal information for tabular (debugging) output.
  *
@@ -311,6 +320,29 @@ struct TabularOutput {
 };
 
 
+/**
+ *	\brief Stores runtime statistics of the last QP solution.
+ *
+ *	Struct storing the number of iterations and the runtime spent in the
+ *	main phases of the homotopy of the last init or hotstart call of the
+ *	(S)QProblem(B) objects. Times are measured with the clock selected by
+ *	Options::clockType. Total and setup times are always measured, the
+ *	times of the homotopy phases only if Options::enablePhaseTiming is set.
+ *
+ *	\author Hans Joachim Ferreau
+ *	\version 3.2
+ *	\date 2007-2017
+ */
+struct SolveStatistics {
+	int_t nIterations;			/**< Number of homotopy iterations (working set changes). */
+	real_t totalTime;			/**< Runtime of the whole init or hotstart call. */
+	real_t setupTime;			/**< Runtime spent before the homotopy (auxiliary QP setup, initial factorisations). */
+	real_t stepDirectionTime;	/**< Runtime spent determining the data shift and step direction. */
+	real_t ratioTestTime;		/**< Runtime spent in the ratio test and step along the homotopy path. */
+	real_t factorisationTime;	/**< Runtime spent updating (or recomputing) the factorisations after working set changes. */
+};
+
+
 
 /**
  *	\brief Struct containing the variable header for mat file.
@@ -174,9 +174,11 @@ returnValue writeIntoMatFile(	FILE* const matFile,		/**< Pointer to Matlab binar
 								);
 
 
-/** Returns the current system time.
- * \return current system time */
-real_t getCPUtime( );
+/** Returns the current time of the given clock (in seconds).
+ *	Only differences between two calls with the same clock are meaningful.
+ * \return current time */
+real_t getCPUtime(	ClockType clockType = CT_MONOTONIC	/**< Clock to be read. */
+					);
 
 
 /** Returns the N-norm of a vector.
@@ -0,0 +1,132 @@
+/*
+ *	This file is part of qpOASES.
+ *
+ *	qpOASES -- An Implementation of the Online Active Set Strategy.
+ *	Copyright (C) 2007-2017 by Hans Joachim Ferreau, Andreas Potschka,
+ *	Christian Kirches et al. All rights reserved.
+ *
+ *	qpOASES is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU Lesser General Public
+ *	License as published by the Free Software Foundation; either
+ *	version 2.1 of the License, or (at your option) any later version.
+ *
+ *	qpOASES is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *	See the GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public
+ *	License along with qpOASES; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/**
+ *	\file include/qpOASES/extras/QPSequence.hpp
+ *	\author Hans Joachim Ferreau, Andreas Potschka, Christian Kirches
+ *	\version 3.2
+ *	\date 2007-2017
+ *
+ *	Declaration of utility functions for recording sequences of QPs (e.g. the
+ *	QPs of a control loop) into a binary file and reading them back, for
+ *	replaying them offline.
+ *
+ *	A QP sequence file starts with a header (QPSequenceHeader) followed by one
+ *	record per QP. All records have the same size: H (nV*nV, row major), g (nV),
+ *	A (nC*nV, row major), lb (nV), ub (nV), lbA (nC), ubA (nC), stored as
+ *	doubles in the byte order of the recording machine.
+ */
+
+
+#ifndef QPOASES_QPSEQUENCE_HPP
+#define QPOASES_QPSEQUENCE_HPP
+
+
+#include <qpOASES/Types.hpp>
+#include <qpOASES/MessageHandling.hpp>
+
+
+BEGIN_NAMESPACE_QPOASES
+
+
+/** Current version of the QP sequence file format. */
+const unsigned int QPSEQUENCE_VERSION = 1;
+
+
+/**
+ *	\brief Header of a QP sequence file.
+ *
+ *	\author Hans Joachim Ferreau
+ *	\version 3.2
+ *	\date 2007-2017
+ */
+struct QPSequenceHeader {
+	char magic[8];				/**< File identifier ("qpOASESq"). */
+	unsigned int version;		/**< Version of the file format. */
+	unsigned int realSize;		/**< Size of each stored number (in bytes). */
+	int nV;						/**< Number of variables. */
+	int nC;						/**< Number of constraints. */
+};
+
+
+/** Writes the header of a QP sequence file.
+ *
+ * \return SUCCESSFUL_RETURN \n
+		   RET_INVALID_ARGUMENTS \n
+		   RET_UNABLE_TO_WRITE_FILE */
+returnValue writeQPSequenceHeader(	FILE* file,			/**< File opened for binary writing. */
+									int_t nV,			/**< Number of variables. */
+									int_t nC			/**< Number of constraints. */
+									);
+
+/** Appends the data of one QP to a QP sequence file.
+ *	Missing bounds (NULL pointers) are stored as +/-INFTY.
+ *
+ * \return SUCCESSFUL_RETURN \n
+		   RET_INVALID_ARGUMENTS \n
+		   RET_UNABLE_TO_WRITE_FILE */
+returnValue writeQPSequenceRecord(	FILE* file,			/**< File written by writeQPSequenceHeader(). */
+									int_t nV,			/**< Number of variables. */
+									int_t nC,			/**< Number of constraints. */
+									const real_t* const H,		/**< Hessian matrix. */
+									const real_t* const g,		/**< Gradient vector. */
+									const real_t* const A,		/**< Constraint matrix (may be NULL if nC is 0). */
+									const real_t* const lb,		/**< Lower bound vector (NULL: no lower bounds). */
+									const real_t* const ub,		/**< Upper bound vector (NULL: no upper bounds). */
+									const real_t* const lbA,	/**< Lower constraints' bound vector (NULL: no lower constraints' bounds). */
+									const real_t* const ubA		/**< Upper constraints' bound vector (NULL: no upper constraints' bounds). */
+									);
+
+/** Reads all QPs of a QP sequence file.
+ *  This function allocates the required memory for all data; after successfully calling it,
+ *  you have to free this memory yourself! The data of QP k start at H+k*nV*nV, g+k*nV,
+ *  A+k*nC*nV, lb+k*nV, ub+k*nV, lbA+k*nC and ubA+k*nC. A truncated last record is ignored.
+ *
+ * \return SUCCESSFUL_RETURN \n
+		   RET_UNABLE_TO_OPEN_FILE \n
+		   RET_UNABLE_TO_READ_FILE \n
+		   RET_FILEDATA_INCONSISTENT */
+returnValue readQPSequence(	const char* fileName,	/**< Name of the QP sequence file. */
+							int_t& nQP,			/**< Output: Number of QPs. */
+							int_t& nV,			/**< Output: Number of variables. */
+							int_t& nC,			/**< Output: Number of constraints. */
+							real_t** H,		 	/**< Output: Sequence of Hessian matrices. */
+							real_t** g,		 	/**< Output: Sequence of gradient vectors. */
+							real_t** A,		 	/**< Output: Sequence of constraint matrices. */
+							real_t** lb,		/**< Output: Sequence of lower bound vectors (on variables). */
+							real_t** ub,		/**< Output: Sequence of upper bound vectors (on variables). */
+							real_t** lbA,		/**< Output: Sequence of lower constraints' bound vectors. */
+							real_t** ubA		/**< Output: Sequence of upper constraints' bound vectors. */
+							);
+
+
+END_NAMESPACE_QPOASES
+
+
+#endif	/* QPOASES_QPSEQUENCE_HPP */
+
+
+/*
+ *	end of file
+ */
@@ -55,9 +55,9 @@ else
 #	LIB_LAPACK = ${MATLAB_LIBDIR}/libmwlapack.so
 endif
 
-# choice of sparse solver: NONE, MA27, or MA57
-# If choice is not 'NONE', BLAS and LAPACK replacements must not be used
-USE_SOLVER = NONE
+# choice of sparse solver: LDL (built-in), NONE, MA27, or MA57
+# If choice is MA27 or MA57, BLAS and LAPACK replacements must not be used
+USE_SOLVER = LDL
 #USE_SOLVER = MA57
 
 ifeq ($(USE_SOLVER), MA57)
@@ -68,6 +68,10 @@ else ifeq ($(USE_SOLVER), MA27)
 	LIB_SOLVER = /usr/local/lib/libhsl_ma27.a
 	DEF_SOLVER = SOLVER_MA27
 	LINKHSL =
+else ifeq ($(USE_SOLVER), LDL)
+	LIB_SOLVER =
+	DEF_SOLVER = SOLVER_LDL
+	LINKHSL =
 else
 	LIB_SOLVER =
 	DEF_SOLVER = SOLVER_NONE
@@ -107,11 +111,11 @@ endif
 
 
 
-CPPFLAGS = -Wall -pedantic -Wshadow -Wfloat-equal -O3 -Wconversion -Wsign-conversion -fPIC -DLINUX -D__USE_LONG_INTEGERS__ -D__USE_LONG_FINTS__ -D${DEF_SOLVER} -D__NO_COPYRIGHT__
+CPPFLAGS = -Wall -pedantic -Wshadow -Wfloat-equal -O3 -Wconversion -Wsign-conversion -fPIC -DLINUX -D__USE_LONG_INTEGERS__ -D__USE_LONG_FINTS__ -D${DEF_SOLVER} -D__NO_COPYRIGHT__ -pthread
 #          -g -D__DEBUG__ -D__NO_COPYRIGHT__ -D__SUPPRESSANYOUTPUT__ -D__USE_SINGLE_PRECISION__
 
 # libraries to link against when building qpOASES .so files
-LINK_LIBRARIES = ${LIB_LAPACK} ${LIB_BLAS} -lm ${LIB_SOLVER}
+LINK_LIBRARIES = ${LIB_LAPACK} ${LIB_BLAS} -lm ${LIB_SOLVER} -pthread
 LINK_LIBRARIES_WRAPPER = -lm ${LIB_SOLVER} -lstdc++
 
 # how to link against the qpOASES shared library
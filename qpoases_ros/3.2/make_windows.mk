@@ -59,9 +59,9 @@ else
 	LIB_LAPACK = /usr/lib/liblapack.so
 endif
 
-# choice of sparse solver: NONE, MA27, or MA57
-# If choice is not 'NONE', BLAS and LAPACK replacements must not be used
-USE_SOLVER = NONE
+# choice of sparse solver: LDL (built-in), NONE, MA27, or MA57
+# If choice is MA27 or MA57, BLAS and LAPACK replacements must not be used
+USE_SOLVER = LDL
 
 ifeq ($(USE_SOLVER), MA57)
 	LIB_SOLVER = /usr/local/lib/libhsl_ma57.a /usr/local/lib/libfakemetis.a
@@ -69,6 +69,9 @@ ifeq ($(USE_SOLVER), MA57)
 else ifeq ($(USE_SOLVER), MA27)
 	LIB_SOLVER = /usr/local/lib/libhsl_ma27.a
 	DEF_SOLVER = SOLVER_MA27
+else ifeq ($(USE_SOLVER), LDL)
+	LIB_SOLVER =
+	DEF_SOLVER = SOLVER_LDL
 else
 	LIB_SOLVER =
 	DEF_SOLVER = SOLVER_NONE
@@ -29,10 +29,73 @@
  *	\date 2007-2017
  *
  *	BLAS Level 3 replacement routines.
+ *	The double precision routine uses the vectorised kernels of BlasKernels.hpp.
  */
 
 
 #include <qpOASES/Utils.hpp>
+#include <qpOASES/BlasKernels.hpp>
+
+
+/** Size of the blocks of A processed at once by dgemm_ (256 x 64 doubles : 128kB, fits in L2 cache). */
+#define QPOASES_GEMM_BLOCK_ROWS 256
+#define QPOASES_GEMM_BLOCK_COLS 64
+
+
+/** Adds alpha * A(i0:i1,j)'*B(i0:i1,k) to C(j,k), for j in [j0,j1) and all columns k of B. */
+static void dgemmTransBlock(	la_uint_t i0, la_uint_t i1, la_uint_t j0, la_uint_t j1, la_uint_t N, double alpha,
+								const double* A, la_uint_t LDA, const double* B, la_uint_t LDB, double* C, la_uint_t LDC
+								)
+{
+	la_uint_t j, k;
+	la_uint_t n = i1 - i0;
+	double dots[4];
+
+	for (k = 0; k < N; k++)
+	{
+		const double* b = B + i0 + LDB*k;
+		double* c = C + LDC*k;
+
+		for (j = j0; j+4 <= j1; j += 4)
+		{
+			REFER_NAMESPACE_QPOASES kernelDot4( n, A+i0+LDA*j, A+i0+LDA*(j+1), A+i0+LDA*(j+2), A+i0+LDA*(j+3), b, dots );
+			c[j]   += alpha * dots[0];
+			c[j+1] += alpha * dots[1];
+			c[j+2] += alpha * dots[2];
+			c[j+3] += alpha * dots[3];
+		}
+		for (; j < j1; j++)
+			c[j] += alpha * REFER_NAMESPACE_QPOASES kernelDot( n, A+i0+LDA*j, b );
+	}
+}
+
+
+/** Adds alpha * A(r0:r1,i0:i1)*B(i0:i1,k) to C(r0:r1,k), for all columns k of B. */
+static void dgemmNoTransBlock(	la_uint_t r0, la_uint_t r1, la_uint_t i0, la_uint_t i1, la_uint_t N, double alpha,
+								const double* A, la_uint_t LDA, const double* B, la_uint_t LDB, double* C, la_uint_t LDC
+								)
+{
+	la_uint_t i, k;
+	la_uint_t n = r1 - r0;
+	double coef[4];
+
+	for (k = 0; k < N; k++)
+	{
+		const double* b = B + LDB*k;
+		double* c = C + r0 + LDC*k;
+
+		for (i = i0; i+4 <= i1; i += 4)
+		{
+			coef[0] = alpha * b[i];
+			coef[1] = alpha * b[i+1];
+			coef[2] = alpha * b[i+2];
+			coef[3] = alpha * b[i+3];
+			REFER_NAMESPACE_QPOASES kernelAxpy4( n, coef, A+r0+LDA*i, A+r0+LDA*(i+1), A+r0+LDA*(i+2), A+r0+LDA*(i+3), c );
+		}
+		for (; i < i1; i++)
+			REFER_NAMESPACE_QPOASES kernelAxpy( n, alpha * b[i], A+r0+LDA*i, c );
+	}
+}
 
 
 extern "C" void dgemm_(	const char* TRANSA, const char* TRANSB,
@@ -41,7 +104,8 @@ extern "C" void dgemm_(	const char* TRANSA, const char* TRANSB,
 						const double* BETA, double* C, const la_uint_t* LDC
 						)
 {
-	la_uint_t i, j, k;
+	la_uint_t j, k;
+	la_uint_t i0, i1, j0, j1;
 
 	if ( REFER_NAMESPACE_QPOASES isZero(*BETA) == REFER_NAMESPACE_QPOASES BT_TRUE )
 		for (k = 0; k < *N; k++)
@@ -56,38 +120,49 @@ extern "C" void dgemm_(	const char* TRANSA, const char* TRANSB,
 			for (j = 0; j < *M; j++)
 				C[j+(*LDC)*k] *= *BETA;
 
+	if ( ( *M == 0 ) || ( *N == 0 ) || ( *K == 0 ) )
+		return;
+
 	if (TRANSA[0] == 'N')
-		if ( REFER_NAMESPACE_QPOASES isEqual(*ALPHA,1.0) == REFER_NAMESPACE_QPOASES BT_TRUE )
-			for (k = 0; k < *N; k++)
-				for (j = 0; j < *M; j++)
-					for (i = 0; i < *K; i++)
-						C[j+(*LDC)*k] += A[j+(*LDA)*i] * B[i+(*LDB)*k];
-		else if ( REFER_NAMESPACE_QPOASES isEqual(*ALPHA,-1.0) == REFER_NAMESPACE_QPOASES BT_TRUE )
-			for (k = 0; k < *N; k++)
-				for (j = 0; j < *M; j++)
-					for (i = 0; i < *K; i++)
-						C[j+(*LDC)*k] -= A[j+(*LDA)*i] * B[i+(*LDB)*k];
-		else
-			for (k = 0; k < *N; k++)
-				for (j = 0; j < *M; j++)
-					for (i = 0; i < *K; i++)
-						C[j+(*LDC)*k] += *ALPHA * A[j+(*LDA)*i] * B[i+(*LDB)*k];
+	{
+		/* C += alpha*A*B : columns of A are accumulated (axpy) into columns of C */
+		if ( ( *N == 1 ) || ( ( *M <= QPOASES_GEMM_BLOCK_ROWS ) && ( *K <= QPOASES_GEMM_BLOCK_COLS ) ) )
+		{
+			/* matrix-vector product or small matrix : no blocking */
+			dgemmNoTransBlock( 0,*M, 0,*K, *N,*ALPHA, A,*LDA, B,*LDB, C,*LDC );
+			return;
+		}
+
+		for (j0 = 0; j0 < *M; j0 += QPOASES_GEMM_BLOCK_ROWS)
+		{
+			j1 = ( j0+QPOASES_GEMM_BLOCK_ROWS < *M ) ? j0+QPOASES_GEMM_BLOCK_ROWS : *M;
+			for (i0 = 0; i0 < *K; i0 += QPOASES_GEMM_BLOCK_COLS)
+			{
+				i1 = ( i0+QPOASES_GEMM_BLOCK_COLS < *K ) ? i0+QPOASES_GEMM_BLOCK_COLS : *K;
+				dgemmNoTransBlock( j0,j1, i0,i1, *N,*ALPHA, A,*LDA, B,*LDB, C,*LDC );
+			}
+		}
+	}
 	else
-		if ( REFER_NAMESPACE_QPOASES isEqual(*ALPHA,1.0) == REFER_NAMESPACE_QPOASES BT_TRUE )
-			for (k = 0; k < *N; k++)
-				for (j = 0; j < *M; j++)
-					for (i = 0; i < *K; i++)
-						C[j+(*LDC)*k] += A[i+(*LDA)*j] * B[i+(*LDB)*k];
-		else if ( REFER_NAMESPACE_QPOASES isEqual(*ALPHA,-1.0) == REFER_NAMESPACE_QPOASES BT_TRUE )
-			for (k = 0; k < *N; k++)
-				for (j = 0; j < *M; j++)
-					for (i = 0; i < *K; i++)
-						C[j+(*LDC)*k] -= A[i+(*LDA)*j] * B[i+(*LDB)*k];
-		else
-			for (k = 0; k < *N; k++)
-				for (j = 0; j < *M; j++)
-					for (i = 0; i < *K; i++)
-						C[j+(*LDC)*k] += *ALPHA * A[i+(*LDA)*j] * B[i+(*LDB)*k];
+	{
+		/* C += alpha*A'*B : dot products of columns of A and columns of B */
+		if ( ( *N == 1 ) || ( ( *K <= QPOASES_GEMM_BLOCK_ROWS ) && ( *M <= QPOASES_GEMM_BLOCK_COLS ) ) )
+		{
+			/* matrix-vector product or small matrix : no blocking */
+			dgemmTransBlock( 0,*K, 0,*M, *N,*ALPHA, A,*LDA, B,*LDB, C,*LDC );
+			return;
+		}
+
+		for (i0 = 0; i0 < *K; i0 += QPOASES_GEMM_BLOCK_ROWS)
+		{
+			i1 = ( i0+QPOASES_GEMM_BLOCK_ROWS < *K ) ? i0+QPOASES_GEMM_BLOCK_ROWS : *K;
+			for (j0 = 0; j0 < *M; j0 += QPOASES_GEMM_BLOCK_COLS)
+			{
+				j1 = ( j0+QPOASES_GEMM_BLOCK_COLS < *M ) ? j0+QPOASES_GEMM_BLOCK_COLS : *M;
+				dgemmTransBlock( i0,i1, j0,j1, *N,*ALPHA, A,*LDA, B,*LDB, C,*LDC );
+			}
+		}
+	}
 }
 
 extern "C" void sgemm_(	const char* TRANSA, const char* TRANSB,
@@ -0,0 +1,327 @@
+/*
+ *	This file is part of qpOASES.
+ *
+ *	qpOASES -- An Implementation of the Online Active Set Strategy.
+ *	Copyright (C) 2007-2017 by Hans Joachim Ferreau, Andreas Potschka,
+ *	Christian Kirches et al. All rights reserved.
+ *
+ *	qpOASES is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU Lesser General Public
+ *	License as published by the Free Software Foundation; either
+ *	version 2.1 of the License, or (at your option) any later version.
+ *
+ *	qpOASES is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *	See the GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public
+ *	License along with qpOASES; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/**
+ *	\file src/BatchSolver.cpp
+ *	\author Hans Joachim Ferreau, Andreas Potschka, Christian Kirches
+ *	\version 3.2
+ *	\date 2007-2017
+ *
+ *	Implementation of the BatchSolver class which solves batches of independent
+ *	QPs in parallel.
+ */
+
+
+#include <qpOASES/BatchSolver.hpp>
+
+#ifdef __USE_THREADS__
+	#include <condition_variable>
+	#include <mutex>
+	#include <thread>
+	#include <vector>
+#endif
+
+
+BEGIN_NAMESPACE_QPOASES
+
+
+#ifdef __USE_THREADS__
+
+/**
+ *	\brief Share of a batch owned by one worker.
+ *
+ *	The owner solves the QPs [next,end) from the front, other workers steal
+ *	the back half of the range once their own share is solved.
+ */
+struct BatchSolverQueue
+{
+	std::mutex mutex;			/**< Guards next and end. */
+	int_t next;					/**< Next QP to be solved by the owner. */
+	int_t end;					/**< End of the range. */
+	char padding[64];			/**< Keeps the shares of different workers on different cache lines. */
+};
+
+
+/**
+ *	\brief Worker threads of a BatchSolver.
+ */
+struct BatchSolverPool
+{
+	std::vector<std::thread> threads;			/**< Worker threads (the calling thread is worker 0). */
+	std::vector<BatchSolverQueue> queues;		/**< Share of the current batch of each worker. */
+
+	std::mutex mutex;							/**< Guards the members below. */
+	std::condition_variable wake;				/**< Signals a new batch (or stop) to the workers. */
+	std::condition_variable done;				/**< Signals the end of a batch to the calling thread. */
+	BatchQP* qps;								/**< QPs of the current batch. */
+	unsigned long generation;					/**< Number of batches started. */
+	int_t nBusy;								/**< Number of worker threads still solving the current batch. */
+	bool stop;									/**< Stops the worker threads. */
+
+	BatchSolverPool( int_t nThreads ) : queues( (size_t)nThreads ), qps( 0 ), generation( 0 ), nBusy( 0 ), stop( false ) { }
+};
+
+#else
+
+struct BatchSolverPool
+{
+};
+
+#endif	/* __USE_THREADS__ */
+
+
+/*****************************************************************************
+ *  P U B L I C                                                              *
+ *****************************************************************************/
+
+
+/*
+ *	B a t c h S o l v e r
+ */
+BatchSolver::BatchSolver( int_t _nThreads )
+{
+	pool = 0;
+
+	#ifdef __USE_THREADS__
+	if ( _nThreads > 0 )
+		nThreads = _nThreads;
+	else
+		nThreads = (int_t)std::thread::hardware_concurrency( );
+	if ( nThreads < 1 )
+		nThreads = 1;
+
+	if ( nThreads > 1 )
+	{
+		pool = new BatchSolverPool( nThreads );
+		for( int_t i=1; i<nThreads; ++i )
+			pool->threads.push_back( std::thread( &BatchSolver::workerLoop,this,i ) );
+	}
+	#else
+	nThreads = 1;
+	#endif
+}
+
+
+/*
+ *	~ B a t c h S o l v e r
+ */
+BatchSolver::~BatchSolver( )
+{
+	#ifdef __USE_THREADS__
+	if ( pool != 0 )
+	{
+		{
+			std::lock_guard<std::mutex> lock( pool->mutex );
+			pool->stop = true;
+		}
+		pool->wake.notify_all( );
+
+		for( size_t i=0; i<pool->threads.size( ); ++i )
+			pool->threads[i].join( );
+	}
+	#endif
+
+	delete pool;
+}
+
+
+/*
+ *	s o l v e
+ */
+returnValue BatchSolver::solve( BatchQP* const qps, int_t nQP )
+{
+	int_t i;
+
+	if ( ( qps == 0 ) && ( nQP > 0 ) )
+		return THROWERROR( RET_INVALID_ARGUMENTS );
+
+	for( i=0; i<nQP; ++i )
+		if ( qps[i].problem == 0 )
+			return THROWERROR( RET_INVALID_ARGUMENTS );
+
+	#ifdef __USE_THREADS__
+	if ( ( pool != 0 ) && ( nQP > 1 ) )
+	{
+		/* contiguous shares, each worker then balances by stealing */
+		for( i=0; i<nThreads; ++i )
+		{
+			pool->queues[(size_t)i].next = ( nQP * i ) / nThreads;
+			pool->queues[(size_t)i].end  = ( nQP * (i+1) ) / nThreads;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock( pool->mutex );
+			pool->qps = qps;
+			pool->nBusy = nThreads-1;
+			++(pool->generation);
+		}
+		pool->wake.notify_all( );
+
+		runWorker( 0 );
+
+		std::unique_lock<std::mutex> lock( pool->mutex );
+		while ( pool->nBusy > 0 )
+			pool->done.wait( lock );
+		pool->qps = 0;
+	}
+	else
+	#endif
+	{
+		for( i=0; i<nQP; ++i )
+			solveQP( qps[i] );
+	}
+
+	for( i=0; i<nQP; ++i )
+		if ( qps[i].status != SUCCESSFUL_RETURN )
+			return THROWERROR( RET_BATCH_SOLVE_FAILED );
+
+	return SUCCESSFUL_RETURN;
+}
+
+
+
+/*****************************************************************************
+ *  P R O T E C T E D                                                        *
+ *****************************************************************************/
+
+
+/*
+ *	s o l v e Q P
+ */
+void BatchSolver::solveQP( BatchQP& qp )
+{
+	SQProblem* problem = qp.problem;
+	real_t* cputime = ( qp.cputime > 0.0 ) ? &(qp.cputime) : 0;
+
+	if ( problem->getStatus( ) == QPS_NOTINITIALISED )
+		qp.status = problem->init( qp.H,qp.g,qp.A,qp.lb,qp.ub,qp.lbA,qp.ubA, qp.nWSR,cputime );
+	else if ( ( qp.H != 0 ) || ( qp.A != 0 ) )
+		qp.status = problem->hotstart( qp.H,qp.g,qp.A,qp.lb,qp.ub,qp.lbA,qp.ubA, qp.nWSR,cputime );
+	else
+		qp.status = problem->hotstart( qp.g,qp.lb,qp.ub,qp.lbA,qp.ubA, qp.nWSR,cputime );
+
+	qp.cputime = problem->getSolveStatistics( ).totalTime;
+
+	if ( qp.status == SUCCESSFUL_RETURN )
+	{
+		if ( qp.xOpt != 0 )
+			problem->getPrimalSolution( qp.xOpt );
+		if ( qp.yOpt != 0 )
+			problem->getDualSolution( qp.yOpt );
+	}
+}
+
+
+/*
+ *	r u n W o r k e r
+ */
+void BatchSolver::runWorker( int_t worker )
+{
+	#ifdef __USE_THREADS__
+	BatchSolverQueue& own = pool->queues[(size_t)worker];
+	BatchQP* const qps = pool->qps;
+	int_t i, k;
+
+	for(;;)
+	{
+		/* 1) solve own share from the front */
+		for(;;)
+		{
+			{
+				std::lock_guard<std::mutex> lock( own.mutex );
+				if ( own.next >= own.end )
+					break;
+				i = own.next++;
+			}
+			solveQP( qps[i] );
+		}
+
+		/* 2) steal the back half of the first non-empty share of another worker */
+		int_t first = 0, last = 0;
+		for( k=1; k<nThreads; ++k )
+		{
+			BatchSolverQueue& victim = pool->queues[(size_t)( (worker+k) % nThreads )];
+			std::lock_guard<std::mutex> lock( victim.mutex );
+			if ( victim.next < victim.end )
+			{
+				last  = victim.end;
+				first = victim.end - ( victim.end - victim.next + 1 ) / 2;
+				victim.end = first;
+				break;
+			}
+		}
+
+		/* nothing left (QPs being moved by other thieves are solved by them) */
+		if ( first == last )
+			return;
+
+		std::lock_guard<std::mutex> lock( own.mutex );
+		own.next = first;
+		own.end  = last;
+	}
+	#else
+	(void)worker;
+	#endif
+}
+
+
+/*
+ *	w o r k e r L o o p
+ */
+void BatchSolver::workerLoop( int_t worker )
+{
+	#ifdef __USE_THREADS__
+	unsigned long generation = 0;
+
+	for(;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock( pool->mutex );
+			while ( ( pool->stop == false ) && ( pool->generation == generation ) )
+				pool->wake.wait( lock );
+			if ( pool->stop == true )
+				return;
+			generation = pool->generation;
+		}
+
+		runWorker( worker );
+
+		{
+			std::lock_guard<std::mutex> lock( pool->mutex );
+			if ( --(pool->nBusy) == 0 )
+				pool->done.notify_one( );
+		}
+	}
+	#else
+	(void)worker;
+	#endif
+}
+
+
+END_NAMESPACE_QPOASES
+
+
+/*
+ *	end of file
+ */
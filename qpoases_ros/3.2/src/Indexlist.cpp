@@ -91,10 +91,25 @@ Indexlist::~Indexlist( )
  */
 Indexlist& Indexlist::operator=( const Indexlist& rhs )
 {
+	int_t i;
+
 	if ( this != &rhs )
 	{
-		clear( );
-		copy( rhs );
+		/* reuse memory if dimensions match (working sets are copied at each iteration) */
+		if ( ( physicallength == rhs.physicallength ) && ( number != 0 ) && ( rhs.number != 0 ) )
+		{
+			length = rhs.length;
+			for( i=0; i<physicallength; ++i )
+			{
+				number[i] = rhs.number[i];
+				iSort[i]  = rhs.iSort[i];
+			}
+		}
+		else
+		{
+			clear( );
+			copy( rhs );
+		}
 	}
 
 	return *this;
@@ -111,17 +126,22 @@ returnValue Indexlist::init(	int_t n
 	if ( n < 0 )
 		return THROWERROR( RET_INVALID_ARGUMENTS );
 
-	clear( );
+	/* reuse memory if dimension matches (working sets are reset at each hotstart) */
+	if ( ( number == 0 ) || ( n != physicallength ) )
+	{
+		clear( );
 
-	length = 0;
-	physicallength = n;
+		physicallength = n;
 
-	if ( n > 0 )
-	{
-		number = new int_t[n];
-		iSort  = new int_t[n];
+		if ( n > 0 )
+		{
+			number = new int_t[n];
+			iSort  = new int_t[n];
+		}
 	}
 
+	length = 0;
+
 	return SUCCESSFUL_RETURN;
 }
 
@@ -29,10 +29,12 @@
  *	\date 2007-2017
  *
  *  LAPACK replacement routines.
+ *  The double precision routines use the vectorised kernels of BlasKernels.hpp.
  */
 
 
 #include <qpOASES/Utils.hpp>
+#include <qpOASES/BlasKernels.hpp>
 
 
 extern "C" void dpotrf_(	const char* uplo, const la_uint_t* _n, double* a,
@@ -40,17 +42,14 @@ extern "C" void dpotrf_(	const char* uplo, const la_uint_t* _n, double* a,
 							)
 {
 	double sum;
-	la_int_t i, j, k;
+	la_int_t i, j;
 	la_int_t n = (la_int_t)(*_n);
 	la_int_t lda = (la_int_t)(*_lda);
 
 	for( i=0; i<n; ++i )
 	{
 		/* j == i */
-		sum = a[i + lda*i];
-
-		for( k=(i-1); k>=0; --k )
-			sum -= a[k+lda*i] * a[k+lda*i];
+		sum = a[i + lda*i] - REFER_NAMESPACE_QPOASES kernelDot( (la_uint_t)i, &a[lda*i], &a[lda*i] );
 
 		if ( sum > 0.0 )
 			a[i+lda*i] = REFER_NAMESPACE_QPOASES getSqrt( sum );
@@ -64,10 +63,7 @@ extern "C" void dpotrf_(	const char* uplo, const la_uint_t* _n, double* a,
 
 		for( j=(i+1); j<n; ++j )
 		{
-			sum = a[j*lda + i];
-
-			for( k=(i-1); k>=0; --k )
-				sum -= a[k+lda*i] * a[k+lda*j];
+			sum = a[j*lda + i] - REFER_NAMESPACE_QPOASES kernelDot( (la_uint_t)i, &a[lda*i], &a[lda*j] );
 
 			a[i+lda*j] = sum / a[i+lda*i];
 		}
@@ -123,7 +119,59 @@ extern "C" void dtrtrs_(	const char* UPLO, const char* TRANS, const char* DIAG,
 							double* A, const la_uint_t* LDA, double* B, const la_uint_t* LDB, la_int_t* INFO
 							)
 {
-	INFO[0] = ((la_int_t)0xDEADBEEF); /* Dummy. If SQProblemSchur is to be used, system LAPACK must be used */
+	la_int_t i, k;
+	la_int_t n = (la_int_t)(*N);
+	la_int_t lda = (la_int_t)(*LDA);
+	bool upper = ( UPLO[0] == 'U' ) || ( UPLO[0] == 'u' );
+	bool trans = ( TRANS[0] != 'N' ) && ( TRANS[0] != 'n' );
+	bool unit = ( DIAG[0] == 'U' ) || ( DIAG[0] == 'u' );
+
+	INFO[0] = 0;
+
+	/* singular matrix */
+	if ( !unit )
+		for( i=0; i<n; ++i )
+			if ( REFER_NAMESPACE_QPOASES isZero( A[i+lda*i],0.0 ) == REFER_NAMESPACE_QPOASES BT_TRUE )
+			{
+				INFO[0] = (la_int_t)i+1;
+				return;
+			}
+
+	/* Columns of A are contiguous : A*x = b is solved column by column (axpy),
+	 * A'*x = b row by row of A' (dot products). */
+	for( k=0; k<(la_int_t)(*NRHS); ++k )
+	{
+		double* x = &B[(*LDB)*(la_uint_t)k];
+
+		if ( upper && !trans )
+			for( i=n-1; i>=0; --i )
+			{
+				if ( !unit )
+					x[i] /= A[i+lda*i];
+				REFER_NAMESPACE_QPOASES kernelAxpy( (la_uint_t)i, -x[i], &A[lda*i], x );
+			}
+		else if ( upper && trans )
+			for( i=0; i<n; ++i )
+			{
+				x[i] -= REFER_NAMESPACE_QPOASES kernelDot( (la_uint_t)i, &A[lda*i], x );
+				if ( !unit )
+					x[i] /= A[i+lda*i];
+			}
+		else if ( !upper && !trans )
+			for( i=0; i<n; ++i )
+			{
+				if ( !unit )
+					x[i] /= A[i+lda*i];
+				REFER_NAMESPACE_QPOASES kernelAxpy( (la_uint_t)(n-i-1), -x[i], &A[i+1+lda*i], &x[i+1] );
+			}
+		else
+			for( i=n-1; i>=0; --i )
+			{
+				x[i] -= REFER_NAMESPACE_QPOASES kernelDot( (la_uint_t)(n-i-1), &A[i+1+lda*i], &x[i+1] );
+				if ( !unit )
+					x[i] /= A[i+lda*i];
+			}
+	}
 }
 
 extern "C" void strtrs_(	const char* UPLO, const char* TRANS, const char* DIAG,
@@ -139,7 +187,80 @@ extern "C" void dtrcon_(	const char* NORM, const char* UPLO, const char* DIAG,
 							double* RCOND, double* WORK, const la_uint_t* IWORK, la_int_t* INFO
 							)
 {
-	INFO[0] = ((la_int_t)0xDEADBEEF); /* Dummy. If SQProblemSchur is to be used, system LAPACK must be used */
+	la_int_t i, j, k, info;
+	la_int_t n = (la_int_t)(*N);
+	la_int_t lda = (la_int_t)(*LDA);
+	la_uint_t one = 1;
+	bool upper = ( UPLO[0] == 'U' ) || ( UPLO[0] == 'u' );
+	bool unit = ( DIAG[0] == 'U' ) || ( DIAG[0] == 'u' );
+	bool oneNorm = ( NORM[0] == '1' ) || ( NORM[0] == 'O' ) || ( NORM[0] == 'o' );
+	double anorm = 0.0, ainvnm = 0.0;
+	double* y = WORK;
+	double* z = WORK + n;
+	double* x = WORK + 2*n;
+
+	INFO[0] = 0;
+	RCOND[0] = 0.0;
+	if ( n == 0 )
+	{
+		RCOND[0] = 1.0;
+		return;
+	}
+
+	/* 1-norm (largest column sum) or infinity norm (largest row sum, in z) of A */
+	for( i=0; i<n; ++i )
+		z[i] = 0.0;
+	for( j=0; j<n; ++j )
+	{
+		double sum = 0.0;
+		for( i=( upper ? 0 : j ); i<( upper ? j+1 : n ); ++i )
+		{
+			double a = ( unit && ( i == j ) ) ? 1.0 : REFER_NAMESPACE_QPOASES getAbs( A[i+lda*j] );
+			sum += a;
+			z[i] += a;
+		}
+		anorm = REFER_NAMESPACE_QPOASES getMax( anorm,sum );
+	}
+	if ( !oneNorm )
+		for( i=0, anorm=0.0; i<n; ++i )
+			anorm = REFER_NAMESPACE_QPOASES getMax( anorm,z[i] );
+
+	/* Hager's estimate of the norm of inv(A): the infinity norm of inv(A) is the 1-norm of inv(A') */
+	for( i=0; i<n; ++i )
+		x[i] = 1.0 / (double)n;
+
+	for( k=0; k<5; ++k )
+	{
+		for( i=0; i<n; ++i )
+			y[i] = x[i];
+		dtrtrs_( UPLO,( oneNorm ? "N" : "T" ),DIAG,N,&one,A,LDA,y,N,&info );
+		if ( info != 0 )
+			return; /* singular matrix: RCOND = 0 */
+
+		for( i=0, ainvnm=0.0; i<n; ++i )
+		{
+			ainvnm += REFER_NAMESPACE_QPOASES getAbs( y[i] );
+			z[i] = ( y[i] < 0.0 ) ? -1.0 : 1.0;
+		}
+		dtrtrs_( UPLO,( oneNorm ? "T" : "N" ),DIAG,N,&one,A,LDA,z,N,&info );
+
+		double zx = 0.0;
+		for( i=0, j=0; i<n; ++i )
+		{
+			zx += z[i] * x[i];
+			if ( REFER_NAMESPACE_QPOASES getAbs( z[i] ) > REFER_NAMESPACE_QPOASES getAbs( z[j] ) )
+				j = i;
+		}
+		if ( REFER_NAMESPACE_QPOASES getAbs( z[j] ) <= zx )
+			break;
+
+		for( i=0; i<n; ++i )
+			x[i] = 0.0;
+		x[j] = 1.0;
+	}
+
+	if ( ( anorm > 0.0 ) && ( ainvnm > 0.0 ) )
+		RCOND[0] = ( 1.0 / anorm ) / ainvnm;
 }
 
 extern "C" void strcon_(	const char* NORM, const char* UPLO, const char* DIAG,
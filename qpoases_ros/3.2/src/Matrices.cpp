@@ -628,7 +628,7 @@ SymmetricMatrix *SymDenseMat::duplicateSym( ) const
 
 
 returnValue SymDenseMat::bilinear(	const Indexlist* const icols,
-									int_t xN, const real_t* x, int_t xLD, real_t* y, int_t yLD ) const
+									int_t xN, const real_t* x, int_t xLD, real_t* y, int_t yLD, real_t* workspace ) const
 {
 	int_t ii, jj, kk, col;
 	int_t i,j,k,irA;
@@ -637,7 +637,7 @@ returnValue SymDenseMat::bilinear(	const Indexlist* const icols,
 		for (jj = 0; jj < xN; jj++)
 			y[ii*yLD+jj] = 0.0;
 
-	real_t* Ax = new real_t[icols->length * xN];
+	real_t* Ax = ( workspace != 0 ) ? workspace : new real_t[icols->length * xN];
 
 	for (i=0;i<icols->length * xN;++i)
 		Ax[i]=0.0;
@@ -661,7 +661,9 @@ returnValue SymDenseMat::bilinear(	const Indexlist* const icols,
 			}
 		}
 	}
-	delete[] Ax;
+
+	if ( workspace == 0 )
+		delete[] Ax;
 
 	return SUCCESSFUL_RETURN;
 }
@@ -2144,7 +2146,7 @@ SymmetricMatrix *SymSparseMat::duplicateSym( ) const
 
 
 returnValue SymSparseMat::bilinear( const Indexlist* const icols,
-		int_t xN, const real_t* x, int_t xLD, real_t* y, int_t yLD ) const
+		int_t xN, const real_t* x, int_t xLD, real_t* y, int_t yLD, real_t* ) const
 {
 	int_t i, j, k, l, idx, row, col;
 
@@ -219,6 +219,8 @@ MessageHandling::ReturnValueList returnValueList[] =
 { RET_SIMPLE_STATUS_M1, "QP problem could not be solved due to an internal error", VS_VISIBLE },
 { RET_SIMPLE_STATUS_M2, "QP problem is infeasible (and thus could not be solved)", VS_VISIBLE },
 { RET_SIMPLE_STATUS_M3, "QP problem is unbounded (and thus could not be solved)", VS_VISIBLE },
+/* Batch solver */
+{ RET_BATCH_SOLVE_FAILED, "At least one QP of the batch could not be solved", VS_VISIBLE },
 /* IMPORTANT: Terminal list element! */
 { TERMINAL_LIST_ELEMENT, "", VS_HIDDEN }
 };
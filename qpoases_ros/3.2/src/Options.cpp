@@ -161,6 +161,9 @@ returnValue Options::setToDefault( )
     enableInertiaCorrection       =  BT_TRUE;
     rcondSMin                     =  1.0e-14;
 
+	clockType                     =  CT_MONOTONIC;
+	enablePhaseTiming             =  BT_FALSE;
+
 	return SUCCESSFUL_RETURN;
 }
 
@@ -491,6 +494,16 @@ returnValue Options::print( ) const
 	snprintf( myPrintfString,MAX_STRING_LENGTH,"epsNZCTests                    =  %e\n",epsNZCTests );
 	myPrintf( myPrintfString );
 
+	myPrintf( "\n" );
+
+	snprintf( myPrintfString,MAX_STRING_LENGTH,"clockType                      =  %s\n",
+				( clockType == CT_THREADCPUTIME ) ? "CT_THREADCPUTIME" : "CT_MONOTONIC" );
+	myPrintf( myPrintfString );
+
+	snprintf( myPrintfString,MAX_STRING_LENGTH,"enablePhaseTiming              =  %s\n",
+				( enablePhaseTiming == BT_TRUE ) ? "BT_TRUE" : "BT_FALSE" );
+	myPrintf( myPrintfString );
+
 	myPrintf( "\n\n" );
 
 	#endif /* __SUPPRESSANYOUTPUT__ */
@@ -551,6 +564,9 @@ returnValue Options::copy(	const Options& rhs
     dropEqConPriority             =  rhs.dropEqConPriority;
     dropIneqConPriority           =  rhs.dropIneqConPriority;
 
+	clockType                     =  rhs.clockType;
+	enablePhaseTiming             =  rhs.enablePhaseTiming;
+
 	return SUCCESSFUL_RETURN;
 }
 
@@ -0,0 +1,219 @@
+/*
+ *	This file is part of qpOASES.
+ *
+ *	qpOASES -- An Implementation of the Online Active Set Strategy.
+ *	Copyright (C) 2007-2017 by Hans Joachim Ferreau, Andreas Potschka,
+ *	Christian Kirches et al. All rights reserved.
+ *
+ *	qpOASES is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU Lesser General Public
+ *	License as published by the Free Software Foundation; either
+ *	version 2.1 of the License, or (at your option) any later version.
+ *
+ *	qpOASES is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *	See the GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public
+ *	License along with qpOASES; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/**
+ *	\file src/QPSequence.cpp
+ *	\author Hans Joachim Ferreau, Andreas Potschka, Christian Kirches
+ *	\version 3.2
+ *	\date 2007-2017
+ *
+ *	Implementation of utility functions for recording sequences of QPs into
+ *	a binary file and reading them back.
+ */
+
+
+#include <qpOASES/extras/QPSequence.hpp>
+#include <qpOASES/Constants.hpp>
+#include <qpOASES/Utils.hpp>
+
+#include <string.h>
+
+
+BEGIN_NAMESPACE_QPOASES
+
+
+/** File identifier of QP sequence files. */
+static const char QPSEQUENCE_MAGIC[8] = { 'q','p','O','A','S','E','S','q' };
+
+
+/** Writes n entries of v as doubles (or n times the value missing if v is NULL). */
+static returnValue writeQPSequenceVector( FILE* file, const real_t* const v, int_t n, real_t missing )
+{
+	double buffer[64];
+	int_t i, j, len;
+
+	for( i=0; i<n; i+=64 )
+	{
+		len = getMin( n-i,64 );
+		for( j=0; j<len; ++j )
+			buffer[j] = (double)( ( v != 0 ) ? v[i+j] : missing );
+
+		if ( fwrite( buffer,sizeof(double),(size_t)len,file ) != (size_t)len )
+			return RET_UNABLE_TO_WRITE_FILE;
+	}
+
+	return SUCCESSFUL_RETURN;
+}
+
+
+/*
+ *	w r i t e Q P S e q u e n c e H e a d e r
+ */
+returnValue writeQPSequenceHeader(	FILE* file, int_t nV, int_t nC )
+{
+	QPSequenceHeader header;
+
+	if ( ( file == 0 ) || ( nV <= 0 ) || ( nC < 0 ) )
+		return THROWERROR( RET_INVALID_ARGUMENTS );
+
+	memcpy( header.magic,QPSEQUENCE_MAGIC,sizeof(header.magic) );
+	header.version  = QPSEQUENCE_VERSION;
+	header.realSize = (unsigned int)sizeof(double);
+	header.nV = (int)nV;
+	header.nC = (int)nC;
+
+	if ( fwrite( &header,sizeof(header),1,file ) != 1 )
+		return THROWERROR( RET_UNABLE_TO_WRITE_FILE );
+
+	return SUCCESSFUL_RETURN;
+}
+
+
+/*
+ *	w r i t e Q P S e q u e n c e R e c o r d
+ */
+returnValue writeQPSequenceRecord(	FILE* file, int_t nV, int_t nC,
+									const real_t* const H, const real_t* const g, const real_t* const A,
+									const real_t* const lb, const real_t* const ub,
+									const real_t* const lbA, const real_t* const ubA
+									)
+{
+	if ( ( file == 0 ) || ( H == 0 ) || ( g == 0 ) || ( ( A == 0 ) && ( nC > 0 ) ) )
+		return THROWERROR( RET_INVALID_ARGUMENTS );
+
+	if ( ( writeQPSequenceVector( file,H,nV*nV,0.0 ) != SUCCESSFUL_RETURN ) ||
+		 ( writeQPSequenceVector( file,g,nV,0.0 ) != SUCCESSFUL_RETURN ) ||
+		 ( writeQPSequenceVector( file,A,nC*nV,0.0 ) != SUCCESSFUL_RETURN ) ||
+		 ( writeQPSequenceVector( file,lb,nV,-INFTY ) != SUCCESSFUL_RETURN ) ||
+		 ( writeQPSequenceVector( file,ub,nV,INFTY ) != SUCCESSFUL_RETURN ) ||
+		 ( writeQPSequenceVector( file,lbA,nC,-INFTY ) != SUCCESSFUL_RETURN ) ||
+		 ( writeQPSequenceVector( file,ubA,nC,INFTY ) != SUCCESSFUL_RETURN ) )
+		return THROWERROR( RET_UNABLE_TO_WRITE_FILE );
+
+	return SUCCESSFUL_RETURN;
+}
+
+
+/*
+ *	r e a d Q P S e q u e n c e
+ */
+returnValue readQPSequence(	const char* fileName,
+							int_t& nQP, int_t& nV, int_t& nC,
+							real_t** H, real_t** g, real_t** A,
+							real_t** lb, real_t** ub, real_t** lbA, real_t** ubA
+							)
+{
+	QPSequenceHeader header;
+	int_t i, k, recordSize;
+	long fileSize;
+
+	FILE* file = fopen( fileName,"rb" );
+	if ( file == 0 )
+		return THROWERROR( RET_UNABLE_TO_OPEN_FILE );
+
+	/* 1) Read and check header. */
+	if ( fread( &header,sizeof(header),1,file ) != 1 )
+	{
+		fclose( file );
+		return THROWERROR( RET_UNABLE_TO_READ_FILE );
+	}
+
+	if ( ( memcmp( header.magic,QPSEQUENCE_MAGIC,sizeof(header.magic) ) != 0 ) ||
+		 ( header.version != QPSEQUENCE_VERSION ) || ( header.realSize != sizeof(double) ) ||
+		 ( header.nV <= 0 ) || ( header.nC < 0 ) )
+	{
+		fclose( file );
+		return THROWERROR( RET_FILEDATA_INCONSISTENT );
+	}
+
+	nV = (int_t)header.nV;
+	nC = (int_t)header.nC;
+	recordSize = nV*nV + nC*nV + 3*nV + 2*nC;
+
+	/* 2) Number of complete records. */
+	if ( ( fseek( file,0,SEEK_END ) != 0 ) || ( ( fileSize = ftell( file ) ) < 0 ) ||
+		 ( fseek( file,(long)sizeof(header),SEEK_SET ) != 0 ) )
+	{
+		fclose( file );
+		return THROWERROR( RET_UNABLE_TO_READ_FILE );
+	}
+
+	nQP = (int_t)( ( fileSize - (long)sizeof(header) ) / ( (long)recordSize * (long)sizeof(double) ) );
+	if ( nQP <= 0 )
+	{
+		fclose( file );
+		return THROWERROR( RET_FILEDATA_INCONSISTENT );
+	}
+
+	/* 3) Allocate memory and read records. */
+	double* record = new double[recordSize];
+	*H   = new real_t[nQP*nV*nV];
+	*g   = new real_t[nQP*nV];
+	*A   = new real_t[nQP*nC*nV];
+	*lb  = new real_t[nQP*nV];
+	*ub  = new real_t[nQP*nV];
+	*lbA = new real_t[nQP*nC];
+	*ubA = new real_t[nQP*nC];
+
+	for( k=0; k<nQP; ++k )
+	{
+		if ( fread( record,sizeof(double),(size_t)recordSize,file ) != (size_t)recordSize )
+		{
+			delete[] record;
+			delete[] *ubA; delete[] *lbA; delete[] *ub; delete[] *lb; delete[] *A; delete[] *g; delete[] *H;
+			*H = *g = *A = *lb = *ub = *lbA = *ubA = 0;
+			fclose( file );
+			return THROWERROR( RET_UNABLE_TO_READ_FILE );
+		}
+
+		const double* r = record;
+		for( i=0; i<nV*nV; ++i )
+			(*H)[k*nV*nV+i] = (real_t)( *(r++) );
+		for( i=0; i<nV; ++i )
+			(*g)[k*nV+i] = (real_t)( *(r++) );
+		for( i=0; i<nC*nV; ++i )
+			(*A)[k*nC*nV+i] = (real_t)( *(r++) );
+		for( i=0; i<nV; ++i )
+			(*lb)[k*nV+i] = (real_t)( *(r++) );
+		for( i=0; i<nV; ++i )
+			(*ub)[k*nV+i] = (real_t)( *(r++) );
+		for( i=0; i<nC; ++i )
+			(*lbA)[k*nC+i] = (real_t)( *(r++) );
+		for( i=0; i<nC; ++i )
+			(*ubA)[k*nC+i] = (real_t)( *(r++) );
+	}
+
+	delete[] record;
+	fclose( file );
+
+	return SUCCESSFUL_RETURN;
+}
+
+
+END_NAMESPACE_QPOASES
+
+
+/*
+ *	end of file
+ */
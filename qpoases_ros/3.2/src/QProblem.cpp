@@ -73,6 +73,15 @@ QProblem::QProblem( ) : QProblemB( )
 	tempB = 0;
 	delta_yAC_TMP = 0;
 	tempC = 0;
+
+	solveQP_TMP = 0;
+	performStep_TMP = 0;
+	updateActiveSet_TMP = 0;
+	checkLI_TMP = 0;
+	ensureLI_TMP = 0;
+	ensureNZC_TMP = 0;
+	hotstart_TMP = 0;
+	bilinear_TMP = 0;
 }
 
 
@@ -172,6 +181,8 @@ QProblem::QProblem( int_t _nV, int_t _nC, HessianType _hessianType, BooleanType
 		tempC = 0;
 	}
 
+	setupAuxiliaryWorkspaces( (uint_t)_nV,(uint_t)_nC );
+
 	flipper.init( (uint_t)_nV,(uint_t)_nC );
 }
 
@@ -459,12 +470,14 @@ returnValue QProblem::hotstart(	const real_t* const g_new,
 	if ( nV == 0 )
 		return THROWERROR( RET_QPOBJECT_NOT_SETUP );
 
+	real_t solveStartTime = getCPUtime( options.clockType );
+	resetSolveStatistics( );
 
 	/* Possibly update working sets according to guesses for working sets of bounds and constraints. */
 	if ( ( guessedBounds != 0 ) || ( guessedConstraints != 0 ) )
 	{
 		if ( cputime != 0 )
-			starttime = getCPUtime( );
+			starttime = getCPUtime( options.clockType );
 
 		const Bounds*      actualGuessedBounds      = ( guessedBounds != 0 )      ? guessedBounds      : &bounds;
 		const Constraints* actualGuessedConstraints = ( guessedConstraints != 0 ) ? guessedConstraints : &constraints;
@@ -477,7 +490,7 @@ returnValue QProblem::hotstart(	const real_t* const g_new,
 		/* Allow only remaining CPU time for usual hotstart. */
 		if ( cputime != 0 )
 		{
-			auxTime = getCPUtime( ) - starttime;
+			auxTime = getCPUtime( options.clockType ) - starttime;
 			*cputime -= auxTime;
 		}
 	}
@@ -508,6 +521,8 @@ returnValue QProblem::hotstart(	const real_t* const g_new,
 			return THROWERROR(returnvalue);
 	}
 
+	solveStatistics.setupTime = getCPUtime( options.clockType ) - solveStartTime;
+
 	BooleanType isFirstCall = BT_TRUE;
 
 	if ( options.enableFarBounds == BT_FALSE )
@@ -520,10 +535,10 @@ returnValue QProblem::hotstart(	const real_t* const g_new,
 	}
 	else
 	{
-		real_t *ub_new_far = new real_t[nV];
-		real_t *lb_new_far = new real_t[nV];
-		real_t *ubA_new_far = new real_t[nC];
-		real_t *lbA_new_far = new real_t[nC];
+		real_t *ub_new_far = hotstart_TMP;
+		real_t *lb_new_far = ub_new_far + nV;
+		real_t *ubA_new_far = lb_new_far + nV;
+		real_t *lbA_new_far = ubA_new_far + nC;
 
 		/* possibly extend initial far bounds to largest bound/constraint data */
 		if (ub_new)
@@ -632,10 +647,10 @@ returnValue QProblem::hotstart(	const real_t* const g_new,
 			/* add time to setup auxiliary QP */
 			if ( cputime != 0 )
 				*cputime = cputime_needed + auxTime;
-			delete[] lbA_new_far; delete[] ubA_new_far;
-			delete[] lb_new_far; delete[] ub_new_far;
 	}
 
+	solveStatistics.totalTime = getCPUtime( options.clockType ) - solveStartTime;
+
 	return ( returnvalue != SUCCESSFUL_RETURN ) ? THROWERROR( returnvalue ) : returnvalue;
 }
 
@@ -1171,6 +1186,54 @@ returnValue QProblem::clear( )
 		tempC = 0;
 	}
 
+	if ( solveQP_TMP != 0 )
+	{
+		delete[] solveQP_TMP;
+		solveQP_TMP = 0;
+	}
+
+	if ( performStep_TMP != 0 )
+	{
+		delete[] performStep_TMP;
+		performStep_TMP = 0;
+	}
+
+	if ( updateActiveSet_TMP != 0 )
+	{
+		delete[] updateActiveSet_TMP;
+		updateActiveSet_TMP = 0;
+	}
+
+	if ( checkLI_TMP != 0 )
+	{
+		delete[] checkLI_TMP;
+		checkLI_TMP = 0;
+	}
+
+	if ( ensureLI_TMP != 0 )
+	{
+		delete[] ensureLI_TMP;
+		ensureLI_TMP = 0;
+	}
+
+	if ( ensureNZC_TMP != 0 )
+	{
+		delete[] ensureNZC_TMP;
+		ensureNZC_TMP = 0;
+	}
+
+	if ( hotstart_TMP != 0 )
+	{
+		delete[] hotstart_TMP;
+		hotstart_TMP = 0;
+	}
+
+	if ( bilinear_TMP != 0 )
+	{
+		delete[] bilinear_TMP;
+		bilinear_TMP = 0;
+	}
+
 	return SUCCESSFUL_RETURN;
 }
 
@@ -1290,10 +1353,34 @@ returnValue QProblem::copy(	const QProblem& rhs
 		tempC = 0;
 	}
 
+	setupAuxiliaryWorkspaces( _nV,_nC );
+
 	return SUCCESSFUL_RETURN;
 }
 
 
+/*
+ *	s e t u p A u x i l i a r y W o r k s p a c e s
+ */
+void QProblem::setupAuxiliaryWorkspaces( uint_t _nV, uint_t _nC )
+{
+	uint_t nMax = ( _nV > _nC ) ? _nV : _nC;
+
+	solveQP_TMP = new real_t[6*_nV+3*_nC];
+	performStep_TMP = new real_t[2*nMax+_nV+3*_nC];
+	updateActiveSet_TMP = new real_t[4*_nV+_nC];
+	checkLI_TMP = new real_t[3*_nV+_nC+nMax];
+	ensureLI_TMP = new real_t[2*_nV+2*_nC];
+	ensureNZC_TMP = new real_t[2*_nV+_nC+2*nMax];
+	hotstart_TMP = new real_t[2*_nV+2*_nC];
+	bilinear_TMP = new real_t[_nV*_nV];
+
+	/* the snapshot is assigned from the working sets, which then reuses its memory */
+	snapshotBounds.init( (int_t)_nV );
+	snapshotConstraints.init( (int_t)_nC );
+}
+
+
 
 /*
  *	s o l v e I n i t i a l Q P
@@ -1313,9 +1400,7 @@ returnValue QProblem::solveInitialQP(	const real_t* const xOpt, const real_t* co
 	//writeQpDataIntoMatFile( "qpData.mat" );
 
 	/* start runtime measurement */
-	real_t starttime = 0.0;
-	if ( cputime != 0 )
-		starttime = getCPUtime( );
+	real_t starttime = getCPUtime( options.clockType );
 
 	status = QPS_NOTINITIALISED;
 
@@ -1440,12 +1525,17 @@ returnValue QProblem::solveInitialQP(	const real_t* const xOpt, const real_t* co
 
 	/* III) SOLVE ACTUAL INITIAL QP: */
 	/* Allow only remaining CPU time for usual hotstart. */
+	real_t setupTime = getCPUtime( options.clockType ) - starttime;
 	if ( cputime != 0 )
-		*cputime -= getCPUtime( ) - starttime;
+		*cputime -= setupTime;
 
 	/* Use hotstart method to find the solution of the original initial QP,... */
 	returnValue returnvalue = hotstart( g_original,lb_original,ub_original,lbA_original,ubA_original, nWSR,cputime );
 
+	/* (hotstart has reset the statistics) */
+	solveStatistics.setupTime += setupTime;
+	solveStatistics.totalTime = getCPUtime( options.clockType ) - starttime;
+
 	/* ... deallocate memory,... */
 	delete[] ubA_original; delete[] lbA_original; delete[] ub_original; delete[] lb_original; delete[] g_original;
 
@@ -1463,7 +1553,7 @@ returnValue QProblem::solveInitialQP(	const real_t* const xOpt, const real_t* co
 
 	/* stop runtime measurement */
 	if ( cputime != 0 )
-		*cputime = getCPUtime( ) - starttime;
+		*cputime = solveStatistics.totalTime;
 
 	THROWINFO( RET_INIT_SUCCESSFUL );
 
@@ -1498,7 +1588,7 @@ returnValue QProblem::solveQP(	const real_t* const g_new,
 	/* start runtime measurement */
 	real_t starttime = 0.0;
 	if ( cputime != 0 )
-		starttime = getCPUtime( );
+		starttime = getCPUtime( options.clockType );
 
 	/* AW: Remove bounds if they were active before but are now infinity */
 	status = QPS_PERFORMINGHOMOTOPY; // AW TODO: Not sure if this is too early, but otherwise removeBounds will complain
@@ -1510,18 +1600,18 @@ returnValue QProblem::solveQP(	const real_t* const g_new,
 	}
 
 	/* I) PREPARATIONS */
-	/* 1) Allocate delta vectors of gradient and (constraints') bounds,
-	 *    index arrays and step direction arrays. */
-	real_t* delta_xFR = new real_t[nV];
-	real_t* delta_xFX = new real_t[nV];
-	real_t* delta_yAC = new real_t[nC];
-	real_t* delta_yFX = new real_t[nV];
-
-	real_t* delta_g   = new real_t[nV];
-	real_t* delta_lb  = new real_t[nV];
-	real_t* delta_ub  = new real_t[nV];
-	real_t* delta_lbA = new real_t[nC];
-	real_t* delta_ubA = new real_t[nC];
+	/* 1) Setup delta vectors of gradient and (constraints') bounds,
+	 *    index arrays and step direction arrays (preallocated workspace). */
+	real_t* delta_xFR = solveQP_TMP;
+	real_t* delta_xFX = delta_xFR + nV;
+	real_t* delta_yAC = delta_xFX + nV;
+	real_t* delta_yFX = delta_yAC + nC;
+
+	real_t* delta_g   = delta_yFX + nV;
+	real_t* delta_lb  = delta_g   + nV;
+	real_t* delta_ub  = delta_lb  + nV;
+	real_t* delta_lbA = delta_ub  + nV;
+	real_t* delta_ubA = delta_lbA + nC;
 
 	BooleanType Delta_bC_isZero, Delta_bB_isZero;
 
@@ -1531,6 +1621,8 @@ returnValue QProblem::solveQP(	const real_t* const g_new,
 
 	real_t homotopyLength;
 
+	real_t phaseStartTime = 0.0, phaseEndTime;
+
 	#ifndef __SUPPRESSANYOUTPUT__
 	char messageString[MAX_STRING_LENGTH];
 	#endif
@@ -1566,6 +1658,7 @@ returnValue QProblem::solveQP(	const real_t* const g_new,
 		}
 
 		status = QPS_PERFORMINGHOMOTOPY;
+		++solveStatistics.nIterations;
 
 		#ifndef __SUPPRESSANYOUTPUT__
 		if ( isFirstCall == BT_TRUE )
@@ -1575,6 +1668,9 @@ returnValue QProblem::solveQP(	const real_t* const g_new,
 		getGlobalMessageHandler( )->throwInfo( RET_ITERATION_STARTED,messageString,__FUNC__,__FILE__,__LINE__,VS_VISIBLE );
 		#endif
 
+		if ( options.enablePhaseTiming == BT_TRUE )
+			phaseStartTime = getCPUtime( options.clockType );
+
 		/* 2) Determination of shift direction of the gradient and the (constraints') bounds. */
 		returnvalue = determineDataShift(	g_new,lbA_new,ubA_new,lb_new,ub_new,
 											delta_g,delta_lbA,delta_ubA,delta_lb,delta_ub,
@@ -1582,13 +1678,10 @@ returnValue QProblem::solveQP(	const real_t* const g_new,
 											);
 		if ( returnvalue != SUCCESSFUL_RETURN )
 		{
-			delete[] delta_yAC; delete[] delta_yFX; delete[] delta_xFX; delete[] delta_xFR;
-			delete[] delta_ub; delete[] delta_lb; delete[] delta_ubA; delete[] delta_lbA; delete[] delta_g;
-
 			/* Assign number of working set recalculations and stop runtime measurement. */
 			nWSR = iter;
 			if ( cputime != 0 )
-				*cputime = getCPUtime( ) - starttime;
+				*cputime = getCPUtime( options.clockType ) - starttime;
 
 			THROWERROR( RET_SHIFT_DETERMINATION_FAILED );
 			return returnvalue;
@@ -1601,18 +1694,22 @@ returnValue QProblem::solveQP(	const real_t* const g_new,
 												);
 		if ( returnvalue != SUCCESSFUL_RETURN )
 		{
-			delete[] delta_yAC; delete[] delta_yFX; delete[] delta_xFX; delete[] delta_xFR;
-			delete[] delta_ub; delete[] delta_lb; delete[] delta_ubA; delete[] delta_lbA; delete[] delta_g;
-
 			/* Assign number of working set recalculations and stop runtime measurement. */
 			nWSR = iter;
 			if ( cputime != 0 )
-				*cputime = getCPUtime( ) - starttime;
+				*cputime = getCPUtime( options.clockType ) - starttime;
 
 			THROWERROR( RET_STEPDIRECTION_DETERMINATION_FAILED );
 			return returnvalue;
 		}
 
+		if ( options.enablePhaseTiming == BT_TRUE )
+		{
+			phaseEndTime = getCPUtime( options.clockType );
+			solveStatistics.stepDirectionTime += phaseEndTime - phaseStartTime;
+			phaseStartTime = phaseEndTime;
+		}
+
 		/* 4) Determination of step length TAU.
 		 *    This step along the homotopy path is also taken (without changing working set). */
 		returnvalue = performStep(	delta_g, delta_lbA,delta_ubA,delta_lb,delta_ub,
@@ -1621,18 +1718,18 @@ returnValue QProblem::solveQP(	const real_t* const g_new,
 									);
 		if ( returnvalue != SUCCESSFUL_RETURN )
 		{
-			delete[] delta_yAC; delete[] delta_yFX; delete[] delta_xFX; delete[] delta_xFR;
-			delete[] delta_ub; delete[] delta_lb; delete[] delta_ubA; delete[] delta_lbA; delete[] delta_g;
-
 			/* Assign number of working set recalculations and stop runtime measurement. */
 			nWSR = iter;
 			if ( cputime != 0 )
-				*cputime = getCPUtime( ) - starttime;
+				*cputime = getCPUtime( options.clockType ) - starttime;
 
 			THROWERROR( RET_STEPLENGTH_DETERMINATION_FAILED );
 			return returnvalue;
 		}
 
+		if ( options.enablePhaseTiming == BT_TRUE )
+			solveStatistics.ratioTestTime += getCPUtime( options.clockType ) - phaseStartTime;
+
 		/* 5) Termination criterion. */
 		nV = getNV( );
 		nC = getNC( );
@@ -1649,25 +1746,22 @@ returnValue QProblem::solveQP(	const real_t* const g_new,
 
 			nWSR = iter;
 			if ( cputime != 0 )
-				*cputime = getCPUtime( ) - starttime;
-
-			delete[] delta_yAC; delete[] delta_yFX; delete[] delta_xFX; delete[] delta_xFR;
-			delete[] delta_ub; delete[] delta_lb; delete[] delta_ubA; delete[] delta_lbA; delete[] delta_g;
+				*cputime = getCPUtime( options.clockType ) - starttime;
 
 			return SUCCESSFUL_RETURN;
 		}
 
 		/* 6) Change active set. */
+		if ( options.enablePhaseTiming == BT_TRUE )
+			phaseStartTime = getCPUtime( options.clockType );
+
 		returnvalue = changeActiveSet( BC_idx,BC_status,BC_isBound );
 		if ( returnvalue != SUCCESSFUL_RETURN )
 		{
-			delete[] delta_yAC; delete[] delta_yFX; delete[] delta_xFX; delete[] delta_xFR;
-			delete[] delta_ub; delete[] delta_lb; delete[] delta_ubA; delete[] delta_lbA; delete[] delta_g;
-
 			/* Assign number of working set recalculations and stop runtime measurement. */
 			nWSR = iter;
 			if ( cputime != 0 )
-				*cputime = getCPUtime( ) - starttime;
+				*cputime = getCPUtime( options.clockType ) - starttime;
 
 			/* Checks for infeasibility... */
 			if ( isInfeasible( ) == BT_TRUE )
@@ -1691,12 +1785,13 @@ returnValue QProblem::solveQP(	const real_t* const g_new,
 			returnvalue = computeProjectedCholesky( );
 			if (returnvalue != SUCCESSFUL_RETURN)
 			{
-				delete[] delta_yAC; delete[] delta_yFX; delete[] delta_xFX; delete[] delta_xFR;
-				delete[] delta_ub; delete[] delta_lb; delete[] delta_ubA; delete[] delta_lbA; delete[] delta_g;
 				return returnvalue;
 			}
 		}
 
+		if ( options.enablePhaseTiming == BT_TRUE )
+			solveStatistics.factorisationTime += getCPUtime( options.clockType ) - phaseStartTime;
+
 		/* 7) Output information of successful QP iteration. */
 		status = QPS_HOMOTOPYQPSOLVED;
 
@@ -1721,12 +1816,9 @@ returnValue QProblem::solveQP(	const real_t* const g_new,
 		}
 	}
 
-	delete[] delta_yAC; delete[] delta_yFX; delete[] delta_xFX; delete[] delta_xFR;
-	delete[] delta_ub; delete[] delta_lb; delete[] delta_ubA; delete[] delta_lbA; delete[] delta_g;
-
 	/* stop runtime measurement */
 	if ( cputime != 0 )
-		*cputime = getCPUtime( ) - starttime;
+		*cputime = getCPUtime( options.clockType ) - starttime;
 
 
 	/* if program gets to here, output information that QP could not be solved
@@ -2067,7 +2159,7 @@ returnValue QProblem::computeProjectedCholesky( )
 			if ( usingRegularisation() == BT_TRUE )
 			{
 				Id = createDiagSparseMat( nV, regVal );
-				Id->bilinear(bounds.getFree(), nZ, Q, nV, R, nV);
+				Id->bilinear(bounds.getFree(), nZ, Q, nV, R, nV, bilinear_TMP);
 				delete Id;
 			}
 			else
@@ -2080,7 +2172,7 @@ returnValue QProblem::computeProjectedCholesky( )
 
 		case HST_IDENTITY:
 			Id = createDiagSparseMat( nV, 1.0 );
-			Id->bilinear(bounds.getFree(), nZ, Q, nV, R, nV);
+			Id->bilinear(bounds.getFree(), nZ, Q, nV, R, nV, bilinear_TMP);
 			delete Id;
 			break;
 
@@ -2098,7 +2190,7 @@ returnValue QProblem::computeProjectedCholesky( )
 					H->getCol (FR_idx[j], bounds.getFree (), 1.0, &R[j*nV]);
 			} else {
 				/* this is expensive if Z is large! */
-				H->bilinear(bounds.getFree(), nZ, Q, nV, R, nV);
+				H->bilinear(bounds.getFree(), nZ, Q, nV, R, nV, bilinear_TMP);
 			}
 	}
 
@@ -2880,8 +2972,8 @@ returnValue QProblem::addConstraint(	int_t number, SubjectToStatus C_status,
 	int_t* FR_idx;
 	bounds.getFree( )->getNumberArray( &FR_idx );
 
-	real_t* aFR = new real_t[nFR];
-	real_t* wZ = new real_t[nZ];
+	real_t* aFR = updateActiveSet_TMP;
+	real_t* wZ = aFR + nFR;
 	for( i=0; i<nZ; ++i )
 		wZ[i] = 0.0;
 
@@ -2911,8 +3003,6 @@ returnValue QProblem::addConstraint(	int_t number, SubjectToStatus C_status,
 		}
 	}
 
-	delete[] aFR;
-
 
 	real_t c, s, nu;
 
@@ -2962,8 +3052,6 @@ returnValue QProblem::addConstraint(	int_t number, SubjectToStatus C_status,
 		}
 	}
 
-	delete[] wZ;
-
 
 	/* IV) UPDATE INDICES */
 	tabularOutput.idxAddC = number;
@@ -3005,18 +3093,18 @@ returnValue QProblem::addConstraint_checkLI( int_t number )
 
 		int_t *FX_idx, *AC_idx, *IAC_idx;
 
-		real_t *delta_g   = new real_t[nV];
-		real_t *delta_xFX = new real_t[nFX];
-		real_t *delta_xFR = new real_t[nFR];
-		real_t *delta_yAC = new real_t[nAC];
-		real_t *delta_yFX = new real_t[nFX];
+		real_t *delta_g   = checkLI_TMP;
+		real_t *delta_xFX = delta_g + nV;
+		real_t *delta_xFR = delta_xFX + nFX;
+		real_t *delta_yAC = delta_xFR + nFR;
+		real_t *delta_yFX = delta_yAC + nAC;
 
 		bounds.getFixed( )->getNumberArray( &FX_idx );
 		constraints.getActive( )->getNumberArray( &AC_idx );
 		constraints.getInactive( )->getNumberArray( &IAC_idx );
 
 		int_t dim = (nC>nV)?nC:nV;
-		real_t *nul = new real_t[dim];
+		real_t *nul = delta_yFX + nFX;
 		for (ii = 0; ii < dim; ++ii)
 			nul[ii]=0.0;
 
@@ -3031,8 +3119,6 @@ returnValue QProblem::addConstraint_checkLI( int_t number )
 		if (dsdreturnvalue!=SUCCESSFUL_RETURN)
 			returnvalue = dsdreturnvalue;
 
-		delete[] nul;
-
 		/* compute the weight in inf-norm */
 		real_t weight = 0.0;
 		for (ii = 0; ii < nAC; ++ii)
@@ -3062,13 +3148,6 @@ returnValue QProblem::addConstraint_checkLI( int_t number )
 		/* relative test against zero in inf-norm */
 		if (zero > options.epsLITests * weight)
 			returnvalue = RET_LINEARLY_INDEPENDENT;
-
-		delete[] delta_yFX;
-		delete[] delta_yAC;
-		delete[] delta_xFR;
-		delete[] delta_xFX;
-		delete[] delta_g;
-
 	}
 	else
 	{
@@ -3078,7 +3157,7 @@ returnValue QProblem::addConstraint_checkLI( int_t number )
 		 * space of Afr).
 		 */
 
-		real_t *Arow = new real_t[nFR];
+		real_t *Arow = checkLI_TMP;
 		A->getRow(number, bounds.getFree(), 1.0, Arow);
 
 		real_t sum, l2;
@@ -3103,8 +3182,6 @@ returnValue QProblem::addConstraint_checkLI( int_t number )
 				break;
 			}
 		}
-
-		delete[] Arow;
 	}
 
 	return THROWINFO( returnvalue );
@@ -3145,11 +3222,11 @@ returnValue QProblem::addConstraint_ensureLI( int_t number, SubjectToStatus C_st
 	int_t* FX_idx;
 	bounds.getFixed( )->getNumberArray( &FX_idx );
 
-	real_t* xiC = new real_t[nAC];
-	real_t* xiC_TMP = new real_t[nAC];
-	real_t* xiB = new real_t[nFX];
-	real_t* Arow = new real_t[nFR];
-	real_t* num = new real_t[nV];
+	real_t* xiC = ensureLI_TMP;
+	real_t* xiC_TMP = xiC + nAC;
+	real_t* xiB = xiC_TMP + nAC;
+	real_t* Arow = xiB + nFX;
+	real_t* num = Arow + nFR;
 
 	returnValue returnvalue = SUCCESSFUL_RETURN;
 
@@ -3288,12 +3365,6 @@ returnValue QProblem::addConstraint_ensureLI( int_t number, SubjectToStatus C_st
 	}
 
 farewell:
-	delete[] num;
-	delete[] Arow;
-	delete[] xiB;
-	delete[] xiC_TMP;
-	delete[] xiC;
-
 	getGlobalMessageHandler( )->throwInfo( RET_LI_RESOLVED,0,__FUNC__,__FILE__,__LINE__,VS_VISIBLE );
 
 	return ( (returnvalue != SUCCESSFUL_RETURN) && (returnvalue != RET_ENSURELI_FAILED_NOINDEX ) ) ? THROWERROR (returnvalue) : returnvalue;
@@ -3377,7 +3448,7 @@ returnValue QProblem::addBound(	int_t number, SubjectToStatus B_status,
 	int_t* FR_idx;
 	bounds.getFree( )->getNumberArray( &FR_idx );
 
-	real_t* w = new real_t[nFR];
+	real_t* w = updateActiveSet_TMP;
 
 
 	/* III) ADD NEW ACTIVE BOUND TO TOP OF MATRIX T: */
@@ -3413,7 +3484,7 @@ returnValue QProblem::addBound(	int_t number, SubjectToStatus B_status,
 	if ( nAC > 0 )	  /* ( nAC == 0 ) <=> ( nZ == nFR ) <=> Y and T are empty => nothing to do */
 	{
 		/* store new column a in a temporary vector instead of shifting T one column to the left */
-		real_t* tmp = new real_t[nAC];
+		real_t* tmp = w + nFR;
 		for( i=0; i<nAC; ++i )
 			tmp[i] = 0.0;
 
@@ -3446,12 +3517,8 @@ returnValue QProblem::addBound(	int_t number, SubjectToStatus B_status,
 			for( i=(nFR-2-j); i<nAC; ++i )
 				applyGivens( c,s,nu,TT(i,1+tcol-nZ+j),tmp[i], tmp[i],TT(i,1+tcol-nZ+j) );
 		}
-
-		delete[] tmp;
 	}
 
-	delete[] w;
-
 
 	if ( ( updateCholesky == BT_TRUE ) &&
 		 ( hessianType != HST_ZERO )   && ( hessianType != HST_IDENTITY ) )
@@ -3508,18 +3575,18 @@ returnValue QProblem::addBound_checkLI( int_t number )
 		 * "zero". We then check linear independence relative to this estimate.
 		 */
 
-		real_t *delta_g   = new real_t[nV];
-		real_t *delta_xFX = new real_t[nFX];
-		real_t *delta_xFR = new real_t[nFR];
-		real_t *delta_yAC = new real_t[nAC];
-		real_t *delta_yFX = new real_t[nFX];
+		real_t *delta_g   = checkLI_TMP;
+		real_t *delta_xFX = delta_g + nV;
+		real_t *delta_xFR = delta_xFX + nFX;
+		real_t *delta_yAC = delta_xFR + nFR;
+		real_t *delta_yFX = delta_yAC + nAC;
 
 		for (ii = 0; ii < nV; ++ii)
 			delta_g[ii] = 0.0;
 		delta_g[number] = 1.0;	/* sign doesn't matter here */
 
 		int_t dim = (nC>nV)?nC:nV;
-		real_t *nul = new real_t[dim];
+		real_t *nul = delta_yFX + nFX;
 		for (ii = 0; ii < dim; ++ii)
 			nul[ii]=0.0;
 
@@ -3559,13 +3626,6 @@ returnValue QProblem::addBound_checkLI( int_t number )
 		if (zero > options.epsLITests * weight)
 			returnvalue = RET_LINEARLY_INDEPENDENT;
 
-		delete[] nul;
-		delete[] delta_yFX;
-		delete[] delta_yAC;
-		delete[] delta_xFR;
-		delete[] delta_xFX;
-		delete[] delta_g;
-
 	}
 	else
 	{
@@ -3626,10 +3686,10 @@ returnValue QProblem::addBound_ensureLI( int_t number, SubjectToStatus B_status
 	int_t* AC_idx;
 	constraints.getActive( )->getNumberArray( &AC_idx );
 
-	real_t* xiC = new real_t[nAC];
-	real_t* xiC_TMP = new real_t[nAC];
-	real_t* xiB = new real_t[nFX];
-	real_t* num = new real_t[nV];
+	real_t* xiC = ensureLI_TMP;
+	real_t* xiC_TMP = xiC + nAC;
+	real_t* xiB = xiC_TMP + nAC;
+	real_t* num = xiB + nFX;
 
 	real_t y_min = options.maxDualJump;
 	int_t y_min_number = -1;
@@ -3764,11 +3824,6 @@ returnValue QProblem::addBound_ensureLI( int_t number, SubjectToStatus B_status
 	}
 
 farewell:
-	delete[] num;
-	delete[] xiB;
-	delete[] xiC_TMP;
-	delete[] xiC;
-
 	getGlobalMessageHandler( )->throwInfo( RET_LI_RESOLVED,0,__FUNC__,__FILE__,__LINE__,VS_VISIBLE );
 
 	return ( (returnvalue != SUCCESSFUL_RETURN) && (returnvalue != RET_ENSURELI_FAILED_NOINDEX ) ) ? THROWERROR (returnvalue) : returnvalue;
@@ -3884,8 +3939,8 @@ returnValue QProblem::removeConstraint(	int_t number,
 		/* III) UPDATE CHOLESKY DECOMPOSITION,
 		 *      calculate new additional column (i.e. [r sqrt(rho2)]')
 		 *      of the Cholesky factor R. */
-		real_t* Hz = new real_t[nFR];
-		real_t* z = new real_t[nFR];
+		real_t* Hz = updateActiveSet_TMP;
+		real_t* z = Hz + nFR;
 		real_t rho2 = 0.0;
 
 		/* 1) Calculate Hz = H*z, where z is the new rightmost column of Z
@@ -3893,14 +3948,13 @@ returnValue QProblem::removeConstraint(	int_t number,
 		for( j=0; j<nFR; ++j )
 			z[j] = QQ(FR_idx[j],nZ);
 		H->times(bounds.getFree(), bounds.getFree(), 1, 1.0, z, nFR, 0.0, Hz, nFR);
-		delete[] z;
 
 		if ( nZ > 0 )
 		{
-			real_t* ZHz = new real_t[nZ];
+			real_t* ZHz = z + nFR;
 			for ( i=0; i<nZ; ++i )
 				ZHz[i] = 0.0;
-			real_t* r = new real_t[nZ];
+			real_t* r = ZHz + nZ;
 
 			/* 2) Calculate ZHz = Z'*Hz (old Z). */
 			for( j=0; j<nFR; ++j )
@@ -3913,10 +3967,7 @@ returnValue QProblem::removeConstraint(	int_t number,
 
 			/* 3) Calculate r = R^-T * ZHz. */
 			if ( backsolveR( ZHz,BT_TRUE,r ) != SUCCESSFUL_RETURN )
-			{
-				delete[] Hz; delete[] r; delete[] ZHz;
 				return THROWERROR( RET_REMOVECONSTRAINT_FAILED );
-			}
 
 			/* 4) Calculate rho2 = rho^2 = z'*Hz - r'*r
 			 *    and store r into R. */
@@ -3925,16 +3976,12 @@ returnValue QProblem::removeConstraint(	int_t number,
 				rho2 -= r[i]*r[i];
 				RR(i,nZ) = r[i];
 			}
-
-			delete[] r; delete[] ZHz;
 		}
 
 		/* 5) Store rho into R. */
 		for( j=0; j<nFR; ++j )
 			rho2 += QQ(FR_idx[j],nZ) * Hz[j];
 
-		delete[] Hz;
-
 		if ( ( options.enableFlippingBounds == BT_TRUE ) && ( allowFlipping == BT_TRUE ) && ( exchangeHappened == BT_FALSE ) )
 		{
 			if ( rho2 > options.epsFlipping )
@@ -4086,7 +4133,7 @@ returnValue QProblem::removeBound(	int_t number,
 		int_t* AC_idx;
 		constraints.getActive( )->getNumberArray( &AC_idx );
 
-		real_t* tmp = new real_t[nAC];
+		real_t* tmp = updateActiveSet_TMP;
 		A->getCol(number, constraints.getActive(), 1.0, tmp);
 
 
@@ -4110,8 +4157,6 @@ returnValue QProblem::removeBound(	int_t number,
 				applyGivens( c,s,nu,QQ(ii,nZ+1+j),QQ(ii,nZ+j),QQ(ii,nZ+1+j),QQ(ii,nZ+j) );
 			}
 		}
-
-		delete[] tmp;
 	}
 
 
@@ -4127,8 +4172,8 @@ returnValue QProblem::removeBound(	int_t number,
 		if ( nFR > 0 )
 		{
 			/* Attention: Index list of free variables has already grown by one! */
-			real_t* Hz = new real_t[nFR+1];
-			real_t* z = new real_t[nFR+1];
+			real_t* Hz = updateActiveSet_TMP;
+			real_t* z = Hz + nFR+1;
 			/* 1) Calculate R'*r = Zfr'*Hfr*z1 + z2*Zfr'*h1 =: Zfr'*Hz + z2*Zfr'*h1 =: rhs and
 			 *    rho2 = z1'*Hfr*z1 + 2*z2*h1'*z1 + h2*z2^2 - r'*r =: z1'*Hz + 2*z2*h1'*z1 + h2*z2^2 - r'r */
 			for( j=0; j<nFR; ++j )
@@ -4140,8 +4185,8 @@ returnValue QProblem::removeBound(	int_t number,
 
 			if ( nZ > 0 )
 			{
-				real_t* r = new real_t[nZ];
-				real_t* rhs = new real_t[nZ];
+				real_t* r = z + nFR+1;
+				real_t* rhs = r + nZ;
 				for( i=0; i<nZ; ++i )
 					rhs[i] = 0.0;
 
@@ -4156,11 +4201,7 @@ returnValue QProblem::removeBound(	int_t number,
 
 				/* 3) Calculate r = R^-T * rhs. */
 				if ( backsolveR( rhs,BT_TRUE,BT_TRUE,r ) != SUCCESSFUL_RETURN )
-				{
-					delete[] z;
-					delete[] Hz; delete[] r; delete[] rhs;
 					return THROWERROR( RET_REMOVEBOUND_FAILED );
-				}
 
 
 				/* 4) Calculate rho2 = rho^2 = z'*Hz - r'*r
@@ -4170,8 +4211,6 @@ returnValue QProblem::removeBound(	int_t number,
 					rho2 -= r[i]*r[i];
 					RR(i,nZ) = r[i];
 				}
-
-				delete[] rhs; delete[] r;
 			}
 
 			for( j=0; j<nFR; ++j )
@@ -4180,9 +4219,6 @@ returnValue QProblem::removeBound(	int_t number,
 							/* z1' * ( Hz + 2*z2*h1 ) */
 				rho2 += QQ(jj,nZ) * ( Hz[j] + 2.0*z2*z[j] );
 			}
-
-			delete[] z;
-			delete[] Hz;
 		}
 
 		/* 5) Store rho into R. */
@@ -4299,10 +4335,11 @@ returnValue QProblem::ensureNonzeroCurvature(	BooleanType removeBoundNotConstrai
 	bounds.getFree( )->getNumberArray( &FR_idx );
 
 // 	real_t *delta_g   = new real_t[nV];
-	real_t *delta_xFX = new real_t[nFX];
-	real_t *delta_xFR = new real_t[nFR];
-	real_t *delta_yAC = new real_t[nAC];
-	real_t *delta_yFX = new real_t[nFX];
+	real_t *delta_xFX = ensureNZC_TMP;
+	real_t *delta_xFR = delta_xFX + nFX;
+	real_t *delta_yAC = delta_xFR + nFR;
+	real_t *delta_yFX = delta_yAC + nAC;
+	real_t *work = delta_yFX + nFX;
 
 	bounds.getFixed( )->getNumberArray( &FX_idx );
 	constraints.getActive( )->getNumberArray( &AC_idx );
@@ -4315,8 +4352,8 @@ returnValue QProblem::ensureNonzeroCurvature(	BooleanType removeBoundNotConstrai
 	if (removeBoundNotConstraint)
 	{
 		int_t dim = nV < nC ? nC : nV;
-		real_t *nul = new real_t[dim];
-		real_t *ek = new real_t[nV]; /* minus e_k (bound k is removed) */
+		real_t *nul = work;
+		real_t *ek = nul + dim; /* minus e_k (bound k is removed) */
 		for (ii = 0; ii < dim; ++ii)
 			nul[ii]=0.0;
 		for (ii = 0; ii < nV; ++ii)
@@ -4326,13 +4363,11 @@ returnValue QProblem::ensureNonzeroCurvature(	BooleanType removeBoundNotConstrai
 		returnvalue = determineStepDirection (nul, nul, nul, ek, ek,
 											  BT_FALSE, BT_FALSE,
 											  delta_xFX, delta_xFR, delta_yAC, delta_yFX);
-		delete[] ek;
-		delete[] nul;
 	}
 	else
 	{
-		real_t *nul = new real_t[nV];
-		real_t *ek = new real_t[nC]; /* minus e_k (constraint k is removed) */
+		real_t *nul = work;
+		real_t *ek = nul + nV; /* minus e_k (constraint k is removed) */
 		for (ii = 0; ii < nV; ++ii)
 			nul[ii]=0.0;
 		for (ii = 0; ii < nC; ++ii)
@@ -4343,8 +4378,6 @@ returnValue QProblem::ensureNonzeroCurvature(	BooleanType removeBoundNotConstrai
 											  ek, ek, nul, nul,
 											  BT_FALSE, BT_TRUE,
 											  delta_xFX, delta_xFR, delta_yAC, delta_yFX);
-		delete[] ek;
-		delete[] nul;
 	}
 
 	/* compute the weight in inf-norm */
@@ -4382,7 +4415,7 @@ returnValue QProblem::ensureNonzeroCurvature(	BooleanType removeBoundNotConstrai
 		/* bounds */
 
 		/* compress x-u */
-		real_t *x_W = new real_t[getMax(1,nFR)];
+		real_t *x_W = work;
 		for (i = 0; i < nFR; i++)
 		{
 			ii = FR_idx[i];
@@ -4422,17 +4455,15 @@ returnValue QProblem::ensureNonzeroCurvature(	BooleanType removeBoundNotConstrai
 		for (i = 0; i < nFR; i++)
 			delta_xFR[i] = -delta_xFR[i];
 
-		delete[] x_W;
-
 		/* constraints */
 
 		/* compute As (compressed to inactive constraints) */
-		real_t *As = new real_t[nIAC];
+		real_t *As = work;
 		A->times(constraints.getInactive(), bounds.getFixed(), 1, 1.0, delta_xFX, nFX, 0.0, As, nIAC);
 		A->times(constraints.getInactive(), bounds.getFree(), 1, 1.0, delta_xFR, nFR, 1.0, As, nIAC);
 
 		/* compress Ax_u */
-		real_t *Ax_W = new real_t[nIAC];
+		real_t *Ax_W = As + nIAC;
 		for (i = 0; i < nIAC; i++)
 		{
 			ii = IAC_idx[i];
@@ -4496,15 +4527,7 @@ returnValue QProblem::ensureNonzeroCurvature(	BooleanType removeBoundNotConstrai
 			/* change working set later */
 			exchangeHappened = BT_TRUE;
 		}
-
-		delete[] Ax_W;
-		delete[] As;
 	}
-
-	delete[] delta_yFX;
-	delete[] delta_yAC;
-	delete[] delta_xFR;
-	delete[] delta_xFX;
 // 	delete[] delta_g;
 
 	return returnvalue;
@@ -5011,14 +5034,14 @@ returnValue QProblem::performStep(	const real_t* const delta_g,
 
 	int_t BC_idx_tmp = -1;
 
-	real_t* num = new real_t[ getMax( nV,nC ) ];
-	real_t* den = new real_t[ getMax( nV,nC ) ];
+	real_t* num = performStep_TMP;
+	real_t* den = num + getMax( nV,nC );
 
-	real_t* delta_Ax_l = new real_t[nC];
-	real_t* delta_Ax_u = new real_t[nC];
-	real_t* delta_Ax   = new real_t[nC];
+	real_t* delta_Ax_l = den + getMax( nV,nC );
+	real_t* delta_Ax_u = delta_Ax_l + nC;
+	real_t* delta_Ax   = delta_Ax_u + nC;
 
-	real_t* delta_x = new real_t[nV];
+	real_t* delta_x = delta_Ax + nC;
 	for( j=0; j<nFR; ++j )
 	{
 		jj = FR_idx[j];
@@ -5089,11 +5112,7 @@ returnValue QProblem::performStep(	const real_t* const delta_g,
 			if ( constraints.getType( ii ) != ST_UNBOUNDED )
 			{
 				if ( (*constraintProduct)( ii,delta_x, &(delta_Ax[ii]) ) != 0 )
-				{
-					delete[] den; delete[] num;
-					delete[] delta_Ax; delete[] delta_Ax_u; delete[] delta_Ax_l; delete[] delta_x;
 					return THROWERROR( RET_ERROR_IN_CONSTRAINTPRODUCT );
-				}
 			}
 		}
 	}
@@ -5191,11 +5210,6 @@ returnValue QProblem::performStep(	const real_t* const delta_g,
 		}
 	}
 
-	delete[] den;
-	delete[] num;
-	delete[] delta_x;
-
-
 	#ifndef __SUPPRESSANYOUTPUT__
 	char messageString[MAX_STRING_LENGTH];
 
@@ -5272,8 +5286,6 @@ returnValue QProblem::performStep(	const real_t* const delta_g,
 		#endif
 	}
 
-	delete[] delta_Ax; delete[] delta_Ax_u; delete[] delta_Ax_l;
-
 	return SUCCESSFUL_RETURN;
 }
 
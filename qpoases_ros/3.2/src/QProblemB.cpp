@@ -81,6 +81,7 @@ QProblemB::QProblemB( )
 	status = QPS_NOTINITIALISED;
 
 	count = 0;
+	resetSolveStatistics( );
 
 	ramp0 = options.initialRamping;
 	ramp1 = options.finalRamping;
@@ -152,6 +153,7 @@ QProblemB::QProblemB( int_t _nV, HessianType _hessianType, BooleanType allocDens
 	status = QPS_NOTINITIALISED;
 
 	count = 0;
+	resetSolveStatistics( );
 
 	ramp0 = options.initialRamping;
 	ramp1 = options.finalRamping;
@@ -425,12 +427,14 @@ returnValue QProblemB::hotstart(	const real_t* const g_new,
 	if ( nV == 0 )
 		return THROWERROR( RET_QPOBJECT_NOT_SETUP );
 
+	real_t solveStartTime = getCPUtime( options.clockType );
+	resetSolveStatistics( );
 
 	/* Possibly update working set according to guess for working set of bounds. */
 	if ( guessedBounds != 0 )
 	{
 		if ( cputime != 0 )
-			starttime = getCPUtime( );
+			starttime = getCPUtime( options.clockType );
 
 		if ( setupAuxiliaryQP( guessedBounds ) != SUCCESSFUL_RETURN )
 			return THROWERROR( RET_SETUP_AUXILIARYQP_FAILED );
@@ -440,7 +444,7 @@ returnValue QProblemB::hotstart(	const real_t* const g_new,
 		/* Allow only remaining CPU time for usual hotstart. */
 		if ( cputime != 0 )
 		{
-			auxTime = getCPUtime( ) - starttime;
+			auxTime = getCPUtime( options.clockType ) - starttime;
 			*cputime -= auxTime;
 		}
 	}
@@ -470,6 +474,8 @@ returnValue QProblemB::hotstart(	const real_t* const g_new,
 			return THROWERROR(returnvalue);
 	}
 
+	solveStatistics.setupTime = getCPUtime( options.clockType ) - solveStartTime;
+
 	BooleanType isFirstCall = BT_TRUE;
 
 	if ( options.enableFarBounds == BT_FALSE )
@@ -574,6 +580,8 @@ returnValue QProblemB::hotstart(	const real_t* const g_new,
 			delete[] lb_new_far; delete[] ub_new_far;
 	}
 
+	solveStatistics.totalTime = getCPUtime( options.clockType ) - solveStartTime;
+
 	return ( returnvalue != SUCCESSFUL_RETURN ) ? THROWERROR( returnvalue ) : returnvalue;
 }
 
@@ -1153,6 +1161,7 @@ returnValue QProblemB::copy(	const QProblemB& rhs
 	status = rhs.status;
 
 	count = rhs.count;
+	solveStatistics = rhs.solveStatistics;
 
 	ramp0 = rhs.ramp0;
 	ramp1 = rhs.ramp1;
@@ -1981,7 +1990,7 @@ BooleanType QProblemB::isCPUtimeLimitExceeded(	const real_t* const cputime,
 	if ( nWSR <= 0 )
 		return BT_FALSE;
 
-	real_t elapsedTime = getCPUtime( ) - starttime;
+	real_t elapsedTime = getCPUtime( options.clockType ) - starttime;
 	real_t timePerIteration = elapsedTime / ((real_t) nWSR);
 
 	/* Determine if next QP iteration exceed CPU time limit
@@ -2267,9 +2276,7 @@ returnValue QProblemB::solveInitialQP(	const real_t* const xOpt, const real_t* c
 
 
 	/* start runtime measurement */
-	real_t starttime = 0.0;
-	if ( cputime != 0 )
-		starttime = getCPUtime( );
+	real_t starttime = getCPUtime( options.clockType );
 
 
 	status = QPS_NOTINITIALISED;
@@ -2370,12 +2377,17 @@ returnValue QProblemB::solveInitialQP(	const real_t* const xOpt, const real_t* c
 	/* III) SOLVE ACTUAL INITIAL QP: */
 
 	/* Allow only remaining CPU time for usual hotstart. */
+	real_t setupTime = getCPUtime( options.clockType ) - starttime;
 	if ( cputime != 0 )
-		*cputime -= getCPUtime( ) - starttime;
+		*cputime -= setupTime;
 
 	/* Use hotstart method to find the solution of the original initial QP,... */
 	returnValue returnvalue = hotstart( g_original,lb_original,ub_original, nWSR,cputime );
 
+	/* (hotstart has reset the statistics) */
+	solveStatistics.setupTime += setupTime;
+	solveStatistics.totalTime = getCPUtime( options.clockType ) - starttime;
+
 	/* ... deallocate memory,... */
 	delete[] ub_original; delete[] lb_original; delete[] g_original;
 
@@ -2393,7 +2405,7 @@ returnValue QProblemB::solveInitialQP(	const real_t* const xOpt, const real_t* c
 
 	/* stop runtime measurement */
 	if ( cputime != 0 )
-		*cputime = getCPUtime( ) - starttime;
+		*cputime = solveStatistics.totalTime;
 
 	THROWINFO( RET_INIT_SUCCESSFUL );
 
@@ -2424,7 +2436,7 @@ returnValue QProblemB::solveQP(	const real_t* const g_new,
 	/* start runtime measurement */
 	real_t starttime = 0.0;
 	if ( cputime != 0 )
-		starttime = getCPUtime( );
+		starttime = getCPUtime( options.clockType );
 
 
 	/* I) PREPARATIONS */
@@ -2446,6 +2458,8 @@ returnValue QProblemB::solveQP(	const real_t* const g_new,
 
 	real_t homotopyLength;
 
+	real_t phaseStartTime = 0.0, phaseEndTime;
+
 	#ifndef __SUPPRESSANYOUTPUT__
 	char messageString[MAX_STRING_LENGTH];
 	#endif
@@ -2471,12 +2485,13 @@ returnValue QProblemB::solveQP(	const real_t* const g_new,
 			/* Assign number of working set recalculations and stop runtime measurement. */
 			nWSR = iter;
 			if ( cputime != 0 )
-				*cputime = getCPUtime( ) - starttime;
+				*cputime = getCPUtime( options.clockType ) - starttime;
 
 			break;
 		}
 
 		status = QPS_PERFORMINGHOMOTOPY;
+		++solveStatistics.nIterations;
 
 		#ifndef __SUPPRESSANYOUTPUT__
 		if ( isFirstCall == BT_TRUE )
@@ -2486,6 +2501,9 @@ returnValue QProblemB::solveQP(	const real_t* const g_new,
 		getGlobalMessageHandler( )->throwInfo( RET_ITERATION_STARTED,messageString,__FUNC__,__FILE__,__LINE__,VS_VISIBLE );
 		#endif
 
+		if ( options.enablePhaseTiming == BT_TRUE )
+			phaseStartTime = getCPUtime( options.clockType );
+
 		/* 2) Initialise shift direction of the gradient and the bounds. */
 		returnvalue = determineDataShift(	g_new,lb_new,ub_new,
 											delta_g,delta_lb,delta_ub,
@@ -2499,7 +2517,7 @@ returnValue QProblemB::solveQP(	const real_t* const g_new,
 			/* Assign number of working set recalculations and stop runtime measurement. */
 			nWSR = iter;
 			if ( cputime != 0 )
-				*cputime = getCPUtime( ) - starttime;
+				*cputime = getCPUtime( options.clockType ) - starttime;
 
 			THROWERROR( RET_SHIFT_DETERMINATION_FAILED );
 			return returnvalue;
@@ -2518,12 +2536,18 @@ returnValue QProblemB::solveQP(	const real_t* const g_new,
 			/* Assign number of working set recalculations and stop runtime measurement. */
 			nWSR = iter;
 			if ( cputime != 0 )
-				*cputime = getCPUtime( ) - starttime;
+				*cputime = getCPUtime( options.clockType ) - starttime;
 
 			THROWERROR( RET_STEPDIRECTION_DETERMINATION_FAILED );
 			return returnvalue;
 		}
 
+		if ( options.enablePhaseTiming == BT_TRUE )
+		{
+			phaseEndTime = getCPUtime( options.clockType );
+			solveStatistics.stepDirectionTime += phaseEndTime - phaseStartTime;
+			phaseStartTime = phaseEndTime;
+		}
 
 		/* 4) Determination of step length TAU.
 		 *    This step along the homotopy path is also taken (without changing working set). */
@@ -2539,12 +2563,15 @@ returnValue QProblemB::solveQP(	const real_t* const g_new,
 			/* Assign number of working set recalculations and stop runtime measurement. */
 			nWSR = iter;
 			if ( cputime != 0 )
-				*cputime = getCPUtime( ) - starttime;
+				*cputime = getCPUtime( options.clockType ) - starttime;
 
 			THROWERROR( RET_STEPLENGTH_DETERMINATION_FAILED );
 			return returnvalue;
 		}
 
+		if ( options.enablePhaseTiming == BT_TRUE )
+			solveStatistics.ratioTestTime += getCPUtime( options.clockType ) - phaseStartTime;
+
 		/* 5) Termination criterion. */
 		homotopyLength = getRelativeHomotopyLength(g_new, lb_new, ub_new);
 		if ( homotopyLength <= options.terminationTolerance )
@@ -2558,7 +2585,7 @@ returnValue QProblemB::solveQP(	const real_t* const g_new,
 
 			nWSR = iter;
 			if ( cputime != 0 )
-				*cputime = getCPUtime( ) - starttime;
+				*cputime = getCPUtime( options.clockType ) - starttime;
 
 			delete[] delta_yFX; delete[] delta_xFX; delete[] delta_xFR;
 			delete[] delta_ub; delete[] delta_lb; delete[] delta_g;
@@ -2568,6 +2595,9 @@ returnValue QProblemB::solveQP(	const real_t* const g_new,
 
 
 		/* 6) Change active set. */
+		if ( options.enablePhaseTiming == BT_TRUE )
+			phaseStartTime = getCPUtime( options.clockType );
+
 		returnvalue = changeActiveSet( BC_idx,BC_status );
 		if ( returnvalue != SUCCESSFUL_RETURN )
 		{
@@ -2577,7 +2607,7 @@ returnValue QProblemB::solveQP(	const real_t* const g_new,
 			/* Assign number of working set recalculations and stop runtime measurement. */
 			nWSR = iter;
 			if ( cputime != 0 )
-				*cputime = getCPUtime( ) - starttime;
+				*cputime = getCPUtime( options.clockType ) - starttime;
 
 			/* checks for infeasibility... */
 			if ( infeasible == BT_TRUE )
@@ -2607,6 +2637,8 @@ returnValue QProblemB::solveQP(	const real_t* const g_new,
 			}
 		}
 
+		if ( options.enablePhaseTiming == BT_TRUE )
+			solveStatistics.factorisationTime += getCPUtime( options.clockType ) - phaseStartTime;
 
 		/* 7) Perform Ramping Strategy on zero homotopy step or drift correction (if desired). */
 		 if ( ( tau <= EPS ) && ( options.enableRamping == BT_TRUE ) )
@@ -2627,7 +2659,7 @@ returnValue QProblemB::solveQP(	const real_t* const g_new,
 
 	/* stop runtime measurement */
 	if ( cputime != 0 )
-		*cputime = getCPUtime( ) - starttime;
+		*cputime = getCPUtime( options.clockType ) - starttime;
 
 
 	/* if programm gets to here, output information that QP could not be solved
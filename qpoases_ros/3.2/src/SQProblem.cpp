@@ -111,11 +111,7 @@ returnValue SQProblem::hotstart(	SymmetricMatrix *H_new, const real_t* const g_n
 	}
 
 
-	real_t starttime = 0.0;
-	real_t auxTime = 0.0;
-
-    if ( cputime != 0 )
-        starttime = getCPUtime( );
+	real_t starttime = getCPUtime( options.clockType );
 
 
 	/* I) UPDATE QP MATRICES AND VECTORS */
@@ -126,11 +122,9 @@ returnValue SQProblem::hotstart(	SymmetricMatrix *H_new, const real_t* const g_n
 	/* II) PERFORM USUAL HOMOTOPY */
 
 	/* Allow only remaining CPU time for usual hotstart. */
+	real_t auxTime = getCPUtime( options.clockType ) - starttime;
 	if ( cputime != 0 )
-	{
-		auxTime = getCPUtime( ) - starttime;
 		*cputime -= auxTime;
-	}
 
 	returnValue returnvalue = QProblem::hotstart(	g_new,lb_new,ub_new,lbA_new,ubA_new,
 													nWSR,cputime,
@@ -140,6 +134,10 @@ returnValue SQProblem::hotstart(	SymmetricMatrix *H_new, const real_t* const g_n
 	if ( cputime != 0 )
 		*cputime += auxTime;
 
+	/* account for the matrix update (hotstart has reset the statistics) */
+	solveStatistics.setupTime += auxTime;
+	solveStatistics.totalTime += auxTime;
+
 	return returnvalue;
 }
 
@@ -162,9 +160,7 @@ returnValue SQProblem::hotstart(	const real_t* const H_new, const real_t* const
 	}
 
 	/* start runtime measurement */
-	real_t starttime = 0.0;
-    if ( cputime != 0 )
-        starttime = getCPUtime( );
+	real_t starttime = getCPUtime( options.clockType );
 
 
 	/* I) UPDATE QP MATRICES AND VECTORS */
@@ -175,18 +171,20 @@ returnValue SQProblem::hotstart(	const real_t* const H_new, const real_t* const
 	/* II) PERFORM USUAL HOMOTOPY */
 
 	/* Allow only remaining CPU time for usual hotstart. */
+	real_t auxTime = getCPUtime( options.clockType ) - starttime;
 	if ( cputime != 0 )
-		*cputime -= getCPUtime( ) - starttime;
+		*cputime -= auxTime;
 
 	returnValue returnvalue = QProblem::hotstart(	g_new,lb_new,ub_new,lbA_new,ubA_new,
 													nWSR,cputime,
 													guessedBounds,guessedConstraints
 													);
 
-
-	/* stop runtime measurement */
+	/* stop runtime measurement (hotstart has reset the statistics) */
+	solveStatistics.setupTime += auxTime;
+	solveStatistics.totalTime = getCPUtime( options.clockType ) - starttime;
 	if ( cputime != 0 )
-		*cputime = getCPUtime( ) - starttime;
+		*cputime = solveStatistics.totalTime;
 
 	return returnvalue;
 }
@@ -420,9 +418,11 @@ returnValue SQProblem::setupNewAuxiliaryQP(	SymmetricMatrix *H_new, Matrix *A_ne
 
 
 	/* II) SETUP WORKING SETS AND MATRIX FACTORISATIONS: */
-	/* 1) Make a copy of current bounds/constraints ... */
-	Bounds      oldBounds      = bounds;
-	Constraints oldConstraints = constraints;
+	/* 1) Make a copy of current bounds/constraints (into the preallocated snapshot) ... */
+	snapshotBounds      = bounds;
+	snapshotConstraints = constraints;
+	Bounds&      oldBounds      = snapshotBounds;
+	Constraints& oldConstraints = snapshotConstraints;
 
     /* we're trying to find an active set with positive definite null
      * space Hessian twice:
@@ -71,6 +71,8 @@ SQProblemSchur::SQProblemSchur( ) : SQProblem( )
 	sparseSolver = new Ma57SparseSolver();
 #elif defined SOLVER_MA27
 	sparseSolver = new Ma27SparseSolver();
+#elif defined SOLVER_LDL
+	sparseSolver = new LdlSparseSolver();
 #elif defined SOLVER_NONE
 	sparseSolver = new DummySparseSolver();
 #endif
@@ -105,6 +107,8 @@ SQProblemSchur::SQProblemSchur( int_t _nV, int_t _nC, HessianType _hessianType,
 	sparseSolver = new Ma57SparseSolver();
 #elif defined SOLVER_MA27
 	sparseSolver = new Ma27SparseSolver();
+#elif defined SOLVER_LDL
+	sparseSolver = new LdlSparseSolver();
 #elif defined SOLVER_NONE
 	sparseSolver = new DummySparseSolver();
 #endif
@@ -152,6 +156,8 @@ SQProblemSchur::SQProblemSchur( const SQProblemSchur& rhs ) : SQProblem( rhs )
 	sparseSolver = new Ma57SparseSolver();
 #elif defined SOLVER_MA27
 	sparseSolver = new Ma27SparseSolver();
+#elif defined SOLVER_LDL
+	sparseSolver = new LdlSparseSolver();
 #elif defined SOLVER_NONE
 	sparseSolver = new DummySparseSolver();
 #endif
@@ -35,6 +35,17 @@
 
 #include <qpOASES/SparseSolver.hpp>
 
+#ifdef SOLVER_LDL
+	#include <qpOASES/BlasKernels.hpp>
+	#include <algorithm>
+	#include <functional>
+	#include <queue>
+	#include <vector>
+	#ifdef _OPENMP
+		#include <omp.h>
+	#endif
+#endif
+
 #ifndef __MATLAB__
 # include <cstdarg>
 void MyPrintf(const char* pformat, ... );
@@ -1069,6 +1080,1171 @@ returnValue Ma57SparseSolver::copy( 	const Ma57SparseSolver& rhs
 #endif /* SOLVER_MA57 */
 
 
+#ifdef SOLVER_LDL
+
+/** Pivots whose absolute value is at most this tolerance times the largest
+ *	absolute matrix entry are treated as zero pivots. */
+const real_t LDL_ZERO_PIVOT_TOLERANCE = 1.0e2 * EPS;
+
+/** Factorisations with less work (in multiply-adds) are not parallelised. */
+const real_t LDL_PARALLEL_MIN_WORK = 1.0e6;
+
+
+/** Data shared by the frontal matrix factorisations of LdlSparseSolver::factorize( ). */
+struct LdlFrontData
+{
+	const int_t* superStart;	/**< First pivot of each supernode. */
+	const int_t* frontStart;	/**< Start of the row list of each supernode. */
+	const int_t* frontIndex;	/**< Row lists of the frontal matrices. */
+	const int_t* factorStart;	/**< Start of the factor panel of each supernode. */
+	const int_t* childStart;	/**< Start of the children of each supernode in children. */
+	const int_t* children;		/**< Children of the supernodes in the assembly tree. */
+	const int_t* colStart;		/**< Column starts of the lower triangle in pivot order. */
+	const int_t* rowIndex;		/**< Row indices of the lower triangle in pivot order (ascending in each column). */
+	const real_t* values;		/**< Values of the lower triangle in pivot order. */
+	real_t pivotTolerance;		/**< Absolute zero pivot tolerance. */
+	real_t* factor;				/**< Factor panels. */
+	real_t* diag;				/**< Diagonal of D. */
+	real_t** updates;			/**< Update matrix of each supernode, until its parent assembled it. */
+};
+
+
+/*
+ *	c o p y A r r a y
+ */
+/** Returns a new copy of the first n entries of array (0 if array is 0). */
+template <typename T>
+static T* copyArray( const T* const array, int_t n )
+{
+	if ( array == 0 )
+		return 0;
+
+	T* result = new T[n > 0 ? n : 1];
+	for( int_t i=0; i<n; ++i )
+		result[i] = array[i];
+	return result;
+}
+
+
+/*
+ *	o r d e r M i n i m u m D e g r e e
+ */
+/** Computes a minimum degree pivot order of the symmetric matrix whose lower triangle
+ *	is given by compressed columns, on the explicit elimination graph. Rows without a
+ *	diagonal entry only become eligible once one of their neighbours has been eliminated
+ *	(which fills in their diagonal entry), so that KKT matrices can be factorised with
+ *	1x1 pivots. */
+static void orderMinimumDegree(	int_t dim, const int_t* const colStart, const int_t* const rowIndex,
+								int_t* const perm
+								)
+{
+	typedef std::pair<int_t,int_t> DegreeNode;
+	int_t i, j, k, p;
+
+	/* adjacency lists are kept sorted, the lower triangle is read column by column */
+	std::vector<int_t>* const adjacency = new std::vector<int_t>[dim];
+	char* const eligible = new char[dim];
+	char* const eliminated = new char[dim];
+
+	for( i=0; i<dim; ++i )
+	{
+		eligible[i] = 0;
+		eliminated[i] = 0;
+	}
+
+	for( j=0; j<dim; ++j )
+		for( p=colStart[j]; p<colStart[j+1]; ++p )
+		{
+			i = rowIndex[p];
+			if ( i == j )
+				eligible[j] = 1;
+			else
+			{
+				adjacency[i].push_back( j );
+				adjacency[j].push_back( i );
+			}
+		}
+
+	/* candidates of outdated degree are skipped when popped */
+	std::priority_queue< DegreeNode,std::vector<DegreeNode>,std::greater<DegreeNode> > candidates;
+	for( i=0; i<dim; ++i )
+		if ( eligible[i] != 0 )
+			candidates.push( DegreeNode( (int_t)adjacency[i].size( ),i ) );
+
+	std::vector<int_t> merged;
+	for( k=0; k<dim; ++k )
+	{
+		int_t pivot = -1;
+		while ( ( candidates.empty( ) == false ) && ( pivot < 0 ) )
+		{
+			DegreeNode candidate = candidates.top( );
+			candidates.pop( );
+			if ( ( eliminated[candidate.second] == 0 ) && ( candidate.first == (int_t)adjacency[candidate.second].size( ) ) )
+				pivot = candidate.second;
+		}
+
+		/* only rows without diagonal entry are left: take the one of least degree */
+		if ( pivot < 0 )
+			for( i=0; i<dim; ++i )
+				if ( ( eliminated[i] == 0 ) && ( ( pivot < 0 ) || ( adjacency[i].size( ) < adjacency[pivot].size( ) ) ) )
+					pivot = i;
+
+		perm[k] = pivot;
+		eliminated[pivot] = 1;
+
+		/* the neighbours of the pivot become a clique */
+		const std::vector<int_t>& neighbours = adjacency[pivot];
+		for( std::vector<int_t>::const_iterator it = neighbours.begin( ); it != neighbours.end( ); ++it )
+		{
+			const int_t node = *it;
+			const std::vector<int_t>& current = adjacency[node];
+			std::vector<int_t>::const_iterator a = current.begin( );
+			std::vector<int_t>::const_iterator b = neighbours.begin( );
+
+			merged.clear( );
+			while ( ( a != current.end( ) ) || ( b != neighbours.end( ) ) )
+			{
+				int_t next;
+				if ( ( b == neighbours.end( ) ) || ( ( a != current.end( ) ) && ( *a < *b ) ) )
+					next = *a++;
+				else if ( ( a == current.end( ) ) || ( *b < *a ) )
+					next = *b++;
+				else
+				{
+					next = *a++;
+					++b;
+				}
+
+				if ( ( next != node ) && ( next != pivot ) )
+					merged.push_back( next );
+			}
+
+			adjacency[node].swap( merged );
+			eligible[node] = 1;
+			candidates.push( DegreeNode( (int_t)adjacency[node].size( ),node ) );
+		}
+		std::vector<int_t>( ).swap( adjacency[pivot] );
+	}
+
+	delete[] eliminated;
+	delete[] eligible;
+	delete[] adjacency;
+}
+
+
+/*
+ *	p e r m u t e L o w e r T r i a n g l e
+ */
+/** Symmetrically permutes the lower triangle given by compressed columns (iperm[i] is the
+ *	new index of row i). The result is returned both by rows (rowStart, rowCols, rowValues)
+ *	and by columns (newColStart, newRowIndex, newValues) with ascending indices. Values are
+ *	only permuted if values is not 0. The start arrays have length dim+1, the others the
+ *	number of nonzeros. */
+static void permuteLowerTriangle(	int_t dim, const int_t* const colStart, const int_t* const rowIndex,
+									const real_t* const values, const int_t* const iperm,
+									int_t* const rowStart, int_t* const rowCols, real_t* const rowValues,
+									int_t* const newColStart, int_t* const newRowIndex, real_t* const newValues
+									)
+{
+	int_t i, j, p, q;
+	const int_t numNonzeros = colStart[dim];
+	int_t* const next = new int_t[dim > 0 ? dim : 1];
+
+	for( i=0; i<=dim; ++i )
+		rowStart[i] = 0;
+	for( j=0; j<dim; ++j )
+		for( p=colStart[j]; p<colStart[j+1]; ++p )
+			++rowStart[getMax( iperm[j],iperm[rowIndex[p]] )+1];
+	for( i=0; i<dim; ++i )
+	{
+		rowStart[i+1] += rowStart[i];
+		next[i] = rowStart[i];
+	}
+
+	for( j=0; j<dim; ++j )
+		for( p=colStart[j]; p<colStart[j+1]; ++p )
+		{
+			const int_t a = iperm[j];
+			const int_t b = iperm[rowIndex[p]];
+			q = next[getMax( a,b )]++;
+			rowCols[q] = getMin( a,b );
+			if ( values != 0 )
+				rowValues[q] = values[p];
+		}
+
+	/* transposing row by row sorts the row indices of each column */
+	for( j=0; j<=dim; ++j )
+		newColStart[j] = 0;
+	for( p=0; p<numNonzeros; ++p )
+		++newColStart[rowCols[p]+1];
+	for( j=0; j<dim; ++j )
+	{
+		newColStart[j+1] += newColStart[j];
+		next[j] = newColStart[j];
+	}
+
+	for( i=0; i<dim; ++i )
+		for( p=rowStart[i]; p<rowStart[i+1]; ++p )
+		{
+			q = next[rowCols[p]]++;
+			newRowIndex[q] = i;
+			if ( values != 0 )
+				newValues[q] = rowValues[p];
+		}
+
+	delete[] next;
+}
+
+
+/*
+ *	c o m p u t e E l i m i n a t i o n T r e e
+ */
+/** Computes the elimination tree of a symmetric matrix from the columns j < i of each row i
+ *	of its lower triangle (parent[j] = -1 for roots). */
+static void computeEliminationTree(	int_t dim, const int_t* const rowStart, const int_t* const rowCols,
+									int_t* const parent
+									)
+{
+	int_t i, k, p;
+	int_t* const ancestor = new int_t[dim > 0 ? dim : 1];
+
+	for( k=0; k<dim; ++k )
+	{
+		parent[k] = -1;
+		ancestor[k] = -1;
+		for( p=rowStart[k]; p<rowStart[k+1]; ++p )
+		{
+			/* path compression towards the current root */
+			i = rowCols[p];
+			while ( ( i != -1 ) && ( i < k ) )
+			{
+				const int_t next = ancestor[i];
+				ancestor[i] = k;
+				if ( next == -1 )
+					parent[i] = k;
+				i = next;
+			}
+		}
+	}
+
+	delete[] ancestor;
+}
+
+
+/*
+ *	f a c t o r i z e F r o n t
+ */
+/** Assembles the frontal matrix of supernode s from the matrix entries and the update
+ *	matrices of its children, eliminates its pivots and stores the update matrix of s. */
+static void factorizeFront( const LdlFrontData* const data, int_t s )
+{
+	int_t i, j, k, p, q;
+	const int_t first = data->superStart[s];
+	const int_t nPivots = data->superStart[s+1] - first;
+	const int_t m = data->frontStart[s+1] - data->frontStart[s];
+	const int_t* const index = data->frontIndex + data->frontStart[s];
+
+	/* frontal matrix (lower triangle, column-major) */
+	real_t* const front = new real_t[m*m];
+	for( i=0; i<m*m; ++i )
+		front[i] = 0.0;
+
+	/* matrix entries: row indices are ascending, like the row list of the front */
+	for( k=0; k<nPivots; ++k )
+	{
+		q = k;
+		for( p=data->colStart[first+k]; p<data->colStart[first+k+1]; ++p )
+		{
+			while ( index[q] < data->rowIndex[p] )
+				++q;
+			front[q+m*k] += data->values[p];
+		}
+	}
+
+	/* extend-add of the update matrices of the children */
+	int_t* const position = new int_t[m];
+	for( p=data->childStart[s]; p<data->childStart[s+1]; ++p )
+	{
+		const int_t c = data->children[p];
+		const int_t cPivots = data->superStart[c+1] - data->superStart[c];
+		const int_t cSize = data->frontStart[c+1] - data->frontStart[c] - cPivots;
+		const int_t* const cIndex = data->frontIndex + data->frontStart[c] + cPivots;
+		real_t* const update = data->updates[c];
+
+		for( i=0, q=0; i<cSize; ++i )
+		{
+			while ( index[q] < cIndex[i] )
+				++q;
+			position[i] = q;
+		}
+
+		for( j=0; j<cSize; ++j )
+		{
+			real_t* const column = front + m*position[j];
+			for( i=j; i<cSize; ++i )
+				column[position[i]] += update[i+cSize*j];
+		}
+
+		delete[] update;
+		data->updates[c] = 0;
+	}
+
+	/* partial LDL^T factorisation of the pivot columns */
+	for( k=0; k<nPivots; ++k )
+	{
+		real_t* const columnK = front + m*k;
+		const real_t d = columnK[k];
+
+		if ( getAbs( d ) <= data->pivotTolerance )
+		{
+			/* zero pivot: its row is left out of the remaining elimination */
+			data->diag[first+k] = 0.0;
+			for( i=k+1; i<m; ++i )
+				columnK[i] = 0.0;
+			continue;
+		}
+
+		data->diag[first+k] = d;
+		for( j=k+1; j<m; ++j )
+			if ( isZero( columnK[j] ) == BT_FALSE )
+				kernelAxpy( (la_uint_t)(m-j),-columnK[j]/d,columnK+j,front+j+m*j );
+		for( i=k+1; i<m; ++i )
+			columnK[i] /= d;
+	}
+
+	/* the pivot columns are the factor panel, the remaining block the update matrix */
+	memcpy( data->factor+data->factorStart[s],front,((size_t)(m*nPivots))*sizeof(real_t) );
+
+	const int_t nUpdate = m - nPivots;
+	if ( nUpdate > 0 )
+	{
+		real_t* const update = new real_t[nUpdate*nUpdate];
+		for( j=0; j<nUpdate; ++j )
+			memcpy( update+nUpdate*j,front+nPivots+m*(nPivots+j),((size_t)nUpdate)*sizeof(real_t) );
+		data->updates[s] = update;
+	}
+
+	delete[] position;
+	delete[] front;
+}
+
+
+#ifdef _OPENMP
+
+/*
+ *	f a c t o r i z e U n i t
+ */
+/** Factorises supernode s, or its whole subtree if it is sequential, and starts the
+ *	factorisation of its parent once all children of the parent are factorised. */
+static void factorizeUnit(	const LdlFrontData* const data, const int_t* const superParent,
+							const int_t* const firstDescendant, const char* const sequential,
+							int_t* const pendingChildren, int_t s
+							)
+{
+	int_t t, remaining;
+
+	if ( sequential[s] != 0 )
+	{
+		for( t=firstDescendant[s]; t<=s; ++t )
+			factorizeFront( data,t );
+	}
+	else
+		factorizeFront( data,s );
+
+	const int_t parent = superParent[s];
+	if ( parent < 0 )
+		return;
+
+	/* the update matrix of s must be visible to the task of its parent */
+	#pragma omp flush
+	#pragma omp atomic capture
+	remaining = --pendingChildren[parent];
+
+	if ( remaining == 0 )
+	{
+		#pragma omp flush
+		#pragma omp task
+		factorizeUnit( data,superParent,firstDescendant,sequential,pendingChildren,parent );
+	}
+}
+
+#endif /* _OPENMP */
+
+
+/*****************************************************************************
+ *  P U B L I C                                                              *
+ ****************************************************************************/
+
+
+/*
+ *	L d l S p a r s e S o l v e r
+ */
+LdlSparseSolver::LdlSparseSolver( ) : SparseSolver()
+{
+	colStart = 0;
+	rowIndex = 0;
+	values = 0;
+	perm = 0;
+	superStart = 0;
+	superParent = 0;
+	frontStart = 0;
+	frontIndex = 0;
+	factorStart = 0;
+	factor = 0;
+	diag = 0;
+	zeroPivots = 0;
+	clear( );
+}
+
+
+/*
+ *	L d l S p a r s e S o l v e r
+ */
+LdlSparseSolver::LdlSparseSolver( const LdlSparseSolver& rhs )
+{
+	copy( rhs );
+}
+
+
+/*
+ *	~ L d l S p a r s e S o l v e r
+ */
+LdlSparseSolver::~LdlSparseSolver( )
+{
+	clear( );
+}
+
+
+/*
+ *	o p e r a t o r =
+ */
+LdlSparseSolver& LdlSparseSolver::operator=( const SparseSolver& rhs )
+{
+	const LdlSparseSolver* ldl_rhs = dynamic_cast<const LdlSparseSolver*>(&rhs);
+	if (!ldl_rhs)
+	{
+		fprintf(getGlobalMessageHandler()->getOutputFile(),"Error in LdlSparseSolver& LdlSparseSolver::operator=( const SparseSolver& rhs )\n");
+		throw; /* TODO: More elegant exit? */
+	}
+	if ( this != ldl_rhs )
+	{
+		clear( );
+		SparseSolver::operator=( rhs );
+		copy( *ldl_rhs );
+	}
+
+	return *this;
+}
+
+
+/*
+ *	s e t M a t r i x D a t a
+ */
+returnValue LdlSparseSolver::setMatrixData(	int_t dim_,
+											int_t numNonzeros_,
+											const int_t* const irn,
+											const int_t* const jcn,
+											const real_t* const avals
+											)
+{
+	int_t i, j, p, q;
+
+	reset( );
+
+	if ( ( dim_ < 0 ) || ( numNonzeros_ < 0 ) )
+		return THROWERROR( RET_INVALID_ARGUMENTS );
+
+	for( p=0; p<numNonzeros_; ++p )
+		if ( ( irn[p] < 1 ) || ( irn[p] > dim_ ) || ( jcn[p] < 1 ) || ( jcn[p] > dim_ ) )
+			return THROWERROR( RET_INVALID_ARGUMENTS );
+
+	dim = dim_;
+	colStart = new int_t[dim+1];
+	rowIndex = new int_t[numNonzeros_ > 0 ? numNonzeros_ : 1];
+	values = new real_t[numNonzeros_ > 0 ? numNonzeros_ : 1];
+
+	/* sort the entries by rows, then by columns (ascending row indices in each column) */
+	int_t* const rowStart = new int_t[dim+1];
+	int_t* const rowCols = new int_t[numNonzeros_ > 0 ? numNonzeros_ : 1];
+	real_t* const rowValues = new real_t[numNonzeros_ > 0 ? numNonzeros_ : 1];
+	int_t* const next = new int_t[dim > 0 ? dim : 1];
+
+	for( i=0; i<=dim; ++i )
+		rowStart[i] = 0;
+	for( p=0; p<numNonzeros_; ++p )
+		if ( isZero( avals[p] ) == BT_FALSE )
+			++rowStart[getMax( irn[p],jcn[p] )];
+	for( i=0; i<dim; ++i )
+	{
+		rowStart[i+1] += rowStart[i];
+		next[i] = rowStart[i];
+	}
+
+	for( p=0; p<numNonzeros_; ++p )
+		if ( isZero( avals[p] ) == BT_FALSE )
+		{
+			q = next[getMax( irn[p],jcn[p] )-1]++;
+			rowCols[q] = getMin( irn[p],jcn[p] )-1;
+			rowValues[q] = avals[p];
+		}
+
+	for( j=0; j<=dim; ++j )
+		colStart[j] = 0;
+	for( p=0; p<rowStart[dim]; ++p )
+		++colStart[rowCols[p]+1];
+	for( j=0; j<dim; ++j )
+	{
+		colStart[j+1] += colStart[j];
+		next[j] = colStart[j];
+	}
+
+	for( i=0; i<dim; ++i )
+		for( p=rowStart[i]; p<rowStart[i+1]; ++p )
+		{
+			q = next[rowCols[p]]++;
+			rowIndex[q] = i;
+			values[q] = rowValues[p];
+		}
+
+	delete[] next;
+	delete[] rowValues;
+	delete[] rowCols;
+	delete[] rowStart;
+
+	/* sum up duplicate entries */
+	numNonzeros = 0;
+	for( j=0; j<dim; ++j )
+	{
+		const int_t start = numNonzeros;
+		for( p=colStart[j]; p<colStart[j+1]; ++p )
+		{
+			if ( ( numNonzeros > start ) && ( rowIndex[numNonzeros-1] == rowIndex[p] ) )
+				values[numNonzeros-1] += values[p];
+			else
+			{
+				rowIndex[numNonzeros] = rowIndex[p];
+				values[numNonzeros++] = values[p];
+			}
+		}
+		colStart[j] = start;
+	}
+	colStart[dim] = numNonzeros;
+
+	return SUCCESSFUL_RETURN;
+}
+
+
+/*
+ *	f a c t o r i z e
+ */
+returnValue LdlSparseSolver::factorize( )
+{
+	int_t j, k, p, s;
+
+	haveFactorization = BT_FALSE;
+	delete[] factor;
+	delete[] diag;
+	delete[] zeroPivots;
+	factor = 0;
+	diag = 0;
+	zeroPivots = 0;
+
+	if ( dim < 0 )
+		return THROWERROR( RET_INVALID_ARGUMENTS );
+
+	if ( dim == 0 )
+	{
+		haveFactorization = BT_TRUE;
+		neig = 0;
+		rank = 0;
+		return SUCCESSFUL_RETURN;
+	}
+
+	if ( analyse( ) != SUCCESSFUL_RETURN )
+		return THROWERROR( RET_MATRIX_FACTORISATION_FAILED );
+
+	/* matrix in pivot order */
+	const int_t nnz = numNonzeros > 0 ? numNonzeros : 1;
+	int_t* const iperm = new int_t[dim];
+	int_t* const rowStart = new int_t[dim+1];
+	int_t* const rowCols = new int_t[nnz];
+	real_t* const rowValues = new real_t[nnz];
+	int_t* const permColStart = new int_t[dim+1];
+	int_t* const permRowIndex = new int_t[nnz];
+	real_t* const permValues = new real_t[nnz];
+
+	for( k=0; k<dim; ++k )
+		iperm[perm[k]] = k;
+	permuteLowerTriangle(	dim,colStart,rowIndex,values,iperm,
+							rowStart,rowCols,rowValues,permColStart,permRowIndex,permValues );
+
+	real_t maxAbs = 0.0;
+	for( p=0; p<numNonzeros; ++p )
+		maxAbs = getMax( maxAbs,getAbs( values[p] ) );
+
+	/* children of the supernodes */
+	int_t* const childStart = new int_t[nSupernodes+1];
+	int_t* const children = new int_t[nSupernodes];
+	int_t* const next = new int_t[nSupernodes];
+
+	for( s=0; s<=nSupernodes; ++s )
+		childStart[s] = 0;
+	for( s=0; s<nSupernodes; ++s )
+		if ( superParent[s] >= 0 )
+			++childStart[superParent[s]+1];
+	for( s=0; s<nSupernodes; ++s )
+	{
+		childStart[s+1] += childStart[s];
+		next[s] = childStart[s];
+	}
+	for( s=0; s<nSupernodes; ++s )
+		if ( superParent[s] >= 0 )
+			children[next[superParent[s]]++] = s;
+
+	factor = new real_t[factorStart[nSupernodes]];
+	diag = new real_t[dim];
+	real_t** const updates = new real_t*[nSupernodes];
+	for( s=0; s<nSupernodes; ++s )
+		updates[s] = 0;
+
+	LdlFrontData data;
+	data.superStart = superStart;
+	data.frontStart = frontStart;
+	data.frontIndex = frontIndex;
+	data.factorStart = factorStart;
+	data.childStart = childStart;
+	data.children = children;
+	data.colStart = permColStart;
+	data.rowIndex = permRowIndex;
+	data.values = permValues;
+	data.pivotTolerance = LDL_ZERO_PIVOT_TOLERANCE * maxAbs;
+	data.factor = factor;
+	data.diag = diag;
+	data.updates = updates;
+
+	/* work of the subtree of each supernode (children come first) */
+	real_t* const work = new real_t[nSupernodes];
+	real_t totalWork = 0.0;
+	for( s=0; s<nSupernodes; ++s )
+		work[s] = 0.0;
+	for( s=0; s<nSupernodes; ++s )
+	{
+		const real_t m = (real_t)(frontStart[s+1] - frontStart[s]);
+		work[s] += (real_t)(superStart[s+1] - superStart[s]) * m * m * 0.5;
+		if ( superParent[s] >= 0 )
+			work[superParent[s]] += work[s];
+		else
+			totalWork += work[s];
+	}
+
+	#ifdef _OPENMP
+	const int_t nThreads = (int_t)omp_get_max_threads( );
+	if ( ( nThreads > 1 ) && ( totalWork >= LDL_PARALLEL_MIN_WORK ) )
+	{
+		/* subtrees smaller than the grain are factorised sequentially by a single task,
+		 * the supernodes above them by one task each, once their children are done */
+		const real_t grain = totalWork / (real_t)(4*nThreads);
+		int_t* const firstDescendant = new int_t[nSupernodes];
+		char* const sequential = new char[nSupernodes];
+		int_t* const pendingChildren = new int_t[nSupernodes];
+
+		for( s=0; s<nSupernodes; ++s )
+			firstDescendant[s] = s;
+		for( s=0; s<nSupernodes; ++s )
+		{
+			sequential[s] = ( work[s] <= grain ) ? 1 : 0;
+			pendingChildren[s] = childStart[s+1] - childStart[s];
+			if ( superParent[s] >= 0 )
+				firstDescendant[superParent[s]] = getMin( firstDescendant[superParent[s]],firstDescendant[s] );
+		}
+
+		#pragma omp parallel
+		{
+			#pragma omp single
+			{
+				for( s=0; s<nSupernodes; ++s )
+				{
+					const BooleanType sequentialRoot = ( ( sequential[s] != 0 ) &&
+						( ( superParent[s] < 0 ) || ( sequential[superParent[s]] == 0 ) ) ) ? BT_TRUE : BT_FALSE;
+					const BooleanType parallelLeaf = ( ( sequential[s] == 0 ) && ( pendingChildren[s] == 0 ) ) ? BT_TRUE : BT_FALSE;
+
+					if ( ( sequentialRoot == BT_TRUE ) || ( parallelLeaf == BT_TRUE ) )
+					{
+						#pragma omp task firstprivate(s)
+						factorizeUnit( &data,superParent,firstDescendant,sequential,pendingChildren,s );
+					}
+				}
+			}
+		}
+
+		delete[] pendingChildren;
+		delete[] sequential;
+		delete[] firstDescendant;
+	}
+	else
+	#endif /* _OPENMP */
+	{
+		for( s=0; s<nSupernodes; ++s )
+			factorizeFront( &data,s );
+	}
+
+	delete[] work;
+	delete[] updates;
+	delete[] next;
+	delete[] children;
+	delete[] childStart;
+	delete[] permValues;
+	delete[] permRowIndex;
+	delete[] permColStart;
+	delete[] rowValues;
+	delete[] rowCols;
+	delete[] rowStart;
+	delete[] iperm;
+
+	/* inertia and zero pivots */
+	neig = 0;
+	rank = 0;
+	for( k=0; k<dim; ++k )
+		if ( isZero( diag[k] ) == BT_FALSE )
+		{
+			++rank;
+			if ( diag[k] < 0.0 )
+				++neig;
+		}
+
+	zeroPivots = new int_t[dim-rank > 0 ? dim-rank : 1];
+	for( k=0, j=0; k<dim; ++k )
+		if ( isZero( diag[k] ) == BT_TRUE )
+			zeroPivots[j++] = perm[k];
+	std::sort( zeroPivots,zeroPivots+(dim-rank) );
+
+	if ( rank < dim )
+		return RET_KKT_MATRIX_SINGULAR;
+
+	haveFactorization = BT_TRUE;
+	return SUCCESSFUL_RETURN;
+}
+
+
+/*
+ *	s o l v e
+ */
+returnValue LdlSparseSolver::solve(	int_t dim_,
+									const real_t* const rhs,
+									real_t* const sol
+									)
+{
+	int_t i, k, s;
+
+	/* consistency check */
+	if ( dim_ != dim )
+		return THROWERROR( RET_INVALID_ARGUMENTS );
+
+	if ( haveFactorization == BT_FALSE )
+	{
+		MyPrintf("Factorization not called before solve in LdlSparseSolver::solve.\n");
+		return THROWERROR( RET_INVALID_ARGUMENTS );
+	}
+
+	if ( dim == 0 )
+		return SUCCESSFUL_RETURN;
+
+	int_t maxFront = 0;
+	for( s=0; s<nSupernodes; ++s )
+		maxFront = getMax( maxFront,frontStart[s+1]-frontStart[s] );
+
+	real_t* const y = new real_t[dim];
+	real_t* const work = new real_t[maxFront];
+
+	for( k=0; k<dim; ++k )
+		y[k] = rhs[perm[k]];
+
+	/* forward substitution with L, one dense panel per supernode */
+	for( s=0; s<nSupernodes; ++s )
+	{
+		const int_t nPivots = superStart[s+1] - superStart[s];
+		const int_t m = frontStart[s+1] - frontStart[s];
+		const int_t* const index = frontIndex + frontStart[s];
+		const real_t* const panel = factor + factorStart[s];
+
+		for( i=0; i<m; ++i )
+			work[i] = y[index[i]];
+		for( k=0; k<nPivots; ++k )
+			if ( isZero( work[k] ) == BT_FALSE )
+				kernelAxpy( (la_uint_t)(m-k-1),-work[k],panel+k+1+m*k,work+k+1 );
+		for( i=0; i<m; ++i )
+			y[index[i]] = work[i];
+	}
+
+	/* diagonal solve, zero pivots get a zero solution component */
+	for( k=0; k<dim; ++k )
+		y[k] = ( isZero( diag[k] ) == BT_TRUE ) ? 0.0 : y[k] / diag[k];
+
+	/* backward substitution with L^T */
+	for( s=nSupernodes-1; s>=0; --s )
+	{
+		const int_t nPivots = superStart[s+1] - superStart[s];
+		const int_t m = frontStart[s+1] - frontStart[s];
+		const int_t* const index = frontIndex + frontStart[s];
+		const real_t* const panel = factor + factorStart[s];
+
+		for( i=0; i<m; ++i )
+			work[i] = y[index[i]];
+		for( k=nPivots-1; k>=0; --k )
+			work[k] -= kernelDot( (la_uint_t)(m-k-1),panel+k+1+m*k,work+k+1 );
+		for( k=0; k<nPivots; ++k )
+			y[index[k]] = work[k];
+	}
+
+	for( k=0; k<dim; ++k )
+		sol[perm[k]] = y[k];
+
+	delete[] work;
+	delete[] y;
+
+	return SUCCESSFUL_RETURN;
+}
+
+
+/*
+ *	r e s e t
+ */
+returnValue LdlSparseSolver::reset( )
+{
+	if ( SparseSolver::reset( ) != SUCCESSFUL_RETURN )
+		return THROWERROR( RET_RESET_FAILED );
+
+	clear( );
+	return SUCCESSFUL_RETURN;
+}
+
+
+/*
+ *	g e t N e g a t i v e E i g e n v a l u e s
+ */
+int_t LdlSparseSolver::getNegativeEigenvalues( )
+{
+	if ( haveFactorization == BT_FALSE )
+		return -1;
+	else
+		return neig;
+}
+
+
+/*
+ *	g e t R a n k
+ */
+int_t LdlSparseSolver::getRank( )
+{
+	return rank;
+}
+
+
+/*
+ *	g e t Z e r o P i v o t s
+ */
+returnValue LdlSparseSolver::getZeroPivots( int_t *&zeroPivots_ )
+{
+	for ( int_t k=0; k<dim-rank; k++ )
+		zeroPivots_[k] = zeroPivots[k];
+
+	return SUCCESSFUL_RETURN;
+}
+
+
+/*
+ *	g e t F a c t o r N o n z e r o s
+ */
+int_t LdlSparseSolver::getFactorNonzeros( ) const
+{
+	int_t nonzeros = 0;
+
+	for( int_t s=0; s<nSupernodes; ++s )
+	{
+		const int_t nPivots = superStart[s+1] - superStart[s];
+		const int_t m = frontStart[s+1] - frontStart[s];
+		nonzeros += nPivots*(nPivots+1)/2 + nPivots*(m-nPivots);
+	}
+
+	return nonzeros;
+}
+
+
+/*
+ *	g e t N u m S u p e r n o d e s
+ */
+int_t LdlSparseSolver::getNumSupernodes( ) const
+{
+	return nSupernodes;
+}
+
+
+/*****************************************************************************
+ *  P R O T E C T E D                                                        *
+ *****************************************************************************/
+
+/*
+ *	c l e a r
+ */
+returnValue LdlSparseSolver::clear( )
+{
+	delete[] colStart;
+	delete[] rowIndex;
+	delete[] values;
+	delete[] perm;
+	delete[] superStart;
+	delete[] superParent;
+	delete[] frontStart;
+	delete[] frontIndex;
+	delete[] factorStart;
+	delete[] factor;
+	delete[] diag;
+	delete[] zeroPivots;
+
+	dim = -1;
+	numNonzeros = -1;
+	neig = -1;
+	rank = -1;
+	nSupernodes = 0;
+
+	colStart = 0;
+	rowIndex = 0;
+	values = 0;
+	perm = 0;
+	superStart = 0;
+	superParent = 0;
+	frontStart = 0;
+	frontIndex = 0;
+	factorStart = 0;
+	factor = 0;
+	diag = 0;
+	zeroPivots = 0;
+
+	haveFactorization = BT_FALSE;
+	return SUCCESSFUL_RETURN;
+}
+
+
+/*
+ *	c o p y
+ */
+returnValue LdlSparseSolver::copy(	const LdlSparseSolver& rhs
+									)
+{
+	dim = rhs.dim;
+	numNonzeros = rhs.numNonzeros;
+	nSupernodes = rhs.nSupernodes;
+	haveFactorization = rhs.haveFactorization;
+	neig = rhs.neig;
+	rank = rhs.rank;
+
+	colStart = copyArray( rhs.colStart,dim+1 );
+	rowIndex = copyArray( rhs.rowIndex,numNonzeros );
+	values = copyArray( rhs.values,numNonzeros );
+	perm = copyArray( rhs.perm,dim );
+	superStart = copyArray( rhs.superStart,nSupernodes+1 );
+	superParent = copyArray( rhs.superParent,nSupernodes );
+	frontStart = copyArray( rhs.frontStart,nSupernodes+1 );
+	frontIndex = copyArray( rhs.frontIndex,rhs.frontStart != 0 ? rhs.frontStart[nSupernodes] : 0 );
+	factorStart = copyArray( rhs.factorStart,nSupernodes+1 );
+	factor = copyArray( rhs.factor,rhs.factorStart != 0 ? rhs.factorStart[nSupernodes] : 0 );
+	diag = copyArray( rhs.diag,dim );
+	zeroPivots = copyArray( rhs.zeroPivots,dim-rank );
+
+	return SUCCESSFUL_RETURN;
+}
+
+
+/*****************************************************************************
+ *  P R I V A T E                                                            *
+ *****************************************************************************/
+
+/*
+ *	a n a l y s e
+ */
+returnValue LdlSparseSolver::analyse( )
+{
+	int_t i, j, k, p, s;
+	const int_t nnz = numNonzeros > 0 ? numNonzeros : 1;
+
+	delete[] perm;
+	delete[] superStart;
+	delete[] superParent;
+	delete[] frontStart;
+	delete[] frontIndex;
+	delete[] factorStart;
+
+	perm = new int_t[dim];
+	orderMinimumDegree( dim,colStart,rowIndex,perm );
+
+	/* elimination tree of the matrix in pivot order */
+	int_t* const iperm = new int_t[dim];
+	int_t* const rowStart = new int_t[dim+1];
+	int_t* const rowCols = new int_t[nnz];
+	int_t* const permColStart = new int_t[dim+1];
+	int_t* const permRowIndex = new int_t[nnz];
+	int_t* const parent = new int_t[dim];
+	int_t* const childHead = new int_t[dim];
+	int_t* const childNext = new int_t[dim];
+	int_t* const order = new int_t[dim];
+	int_t* const stack = new int_t[dim];
+
+	for( k=0; k<dim; ++k )
+		iperm[perm[k]] = k;
+	permuteLowerTriangle(	dim,colStart,rowIndex,0,iperm,
+							rowStart,rowCols,0,permColStart,permRowIndex,0 );
+	computeEliminationTree( dim,rowStart,rowCols,parent );
+
+	/* postorder the elimination tree: every subtree becomes a range of consecutive pivots */
+	for( j=0; j<dim; ++j )
+		childHead[j] = -1;
+	for( j=dim-1; j>=0; --j )
+		if ( parent[j] >= 0 )
+		{
+			childNext[j] = childHead[parent[j]];
+			childHead[parent[j]] = j;
+		}
+
+	k = 0;
+	for( j=0; j<dim; ++j )
+	{
+		if ( parent[j] >= 0 )
+			continue;
+
+		int_t top = 0;
+		stack[0] = j;
+		while ( top >= 0 )
+		{
+			const int_t node = stack[top];
+			const int_t child = childHead[node];
+			if ( child >= 0 )
+			{
+				/* descend into the next unvisited child */
+				childHead[node] = childNext[child];
+				stack[++top] = child;
+			}
+			else
+			{
+				order[k++] = node;
+				--top;
+			}
+		}
+	}
+
+	for( k=0; k<dim; ++k )
+		order[k] = perm[order[k]];
+	for( k=0; k<dim; ++k )
+	{
+		perm[k] = order[k];
+		iperm[perm[k]] = k;
+	}
+
+	permuteLowerTriangle(	dim,colStart,rowIndex,0,iperm,
+							rowStart,rowCols,0,permColStart,permRowIndex,0 );
+	computeEliminationTree( dim,rowStart,rowCols,parent );
+
+	/* row structure of each column of L, from the matrix and the columns of its children */
+	std::vector<int_t>* const structure = new std::vector<int_t>[dim];
+	int_t* const mark = iperm;
+
+	for( j=0; j<dim; ++j )
+		childHead[j] = -1;
+	for( j=dim-1; j>=0; --j )
+	{
+		mark[j] = -1;
+		if ( parent[j] >= 0 )
+		{
+			childNext[j] = childHead[parent[j]];
+			childHead[parent[j]] = j;
+		}
+	}
+
+	for( j=0; j<dim; ++j )
+	{
+		std::vector<int_t>& rows = structure[j];
+		mark[j] = j;
+		for( p=permColStart[j]; p<permColStart[j+1]; ++p )
+		{
+			i = permRowIndex[p];
+			if ( mark[i] != j )
+			{
+				mark[i] = j;
+				rows.push_back( i );
+			}
+		}
+		for( int_t c=childHead[j]; c>=0; c=childNext[c] )
+			for( std::vector<int_t>::const_iterator it = structure[c].begin( ); it != structure[c].end( ); ++it )
+				if ( mark[*it] != j )
+				{
+					mark[*it] = j;
+					rows.push_back( *it );
+				}
+		std::sort( rows.begin( ),rows.end( ) );
+	}
+
+	/* supernodes: consecutive columns of L with nested structure */
+	int_t* const superOf = order;
+
+	nSupernodes = 0;
+	for( j=0; j<dim; ++j )
+	{
+		if ( ( j == 0 ) || ( parent[j-1] != j ) || ( structure[j-1].size( ) != structure[j].size( )+1 ) )
+			++nSupernodes;
+		superOf[j] = nSupernodes-1;
+	}
+
+	superStart = new int_t[nSupernodes+1];
+	superParent = new int_t[nSupernodes];
+	frontStart = new int_t[nSupernodes+1];
+	factorStart = new int_t[nSupernodes+1];
+
+	for( j=dim-1; j>=0; --j )
+		superStart[superOf[j]] = j;
+	superStart[nSupernodes] = dim;
+
+	frontStart[0] = 0;
+	factorStart[0] = 0;
+	for( s=0; s<nSupernodes; ++s )
+	{
+		const int_t nPivots = superStart[s+1] - superStart[s];
+		const int_t m = nPivots + (int_t)structure[superStart[s+1]-1].size( );
+
+		frontStart[s+1] = frontStart[s] + m;
+		factorStart[s+1] = factorStart[s] + m*nPivots;
+	}
+
+	frontIndex = new int_t[frontStart[nSupernodes]];
+	for( s=0; s<nSupernodes; ++s )
+	{
+		const int_t last = superStart[s+1] - 1;
+		int_t* index = frontIndex + frontStart[s];
+
+		for( j=superStart[s]; j<=last; ++j )
+			*(index++) = j;
+		for( std::vector<int_t>::const_iterator it = structure[last].begin( ); it != structure[last].end( ); ++it )
+			*(index++) = *it;
+
+		superParent[s] = ( parent[last] >= 0 ) ? superOf[parent[last]] : -1;
+	}
+
+	delete[] structure;
+	delete[] stack;
+	delete[] order;
+	delete[] childNext;
+	delete[] childHead;
+	delete[] parent;
+	delete[] permRowIndex;
+	delete[] permColStart;
+	delete[] rowCols;
+	delete[] rowStart;
+	delete[] iperm;
+
+	return SUCCESSFUL_RETURN;
+}
+
+#endif /* SOLVER_LDL */
+
+
 #ifdef SOLVER_NONE
 
 returnValue DummySparseSolver::setMatrixData( 	int_t dim, /**< Dimension of the linear system. */
@@ -91,10 +91,26 @@ SubjectTo::~SubjectTo( )
  */
 SubjectTo& SubjectTo::operator=( const SubjectTo& rhs )
 {
+	int_t i;
+
 	if ( this != &rhs )
 	{
-		clear( );
-		copy( rhs );
+		/* reuse memory if dimensions match (working sets are copied at each iteration) */
+		if ( ( n == rhs.n ) && ( type != 0 ) && ( rhs.type != 0 ) )
+		{
+			noLower = rhs.noLower;
+			noUpper = rhs.noUpper;
+			for( i=0; i<n; ++i )
+			{
+				type[i]   = rhs.type[i];
+				status[i] = rhs.status[i];
+			}
+		}
+		else
+		{
+			clear( );
+			copy( rhs );
+		}
 	}
 
 	return *this;
@@ -112,7 +128,17 @@ returnValue SubjectTo::init(	int_t _n
 	if ( _n < 0 )
 		return THROWERROR( RET_INVALID_ARGUMENTS );
 
-	clear( );
+	/* reuse memory if dimension matches (working sets are reset at each hotstart) */
+	if ( ( type == 0 ) || ( _n != n ) )
+	{
+		clear( );
+
+		if ( _n > 0 )
+		{
+			type   = new SubjectToType[_n];
+			status = new SubjectToStatus[_n];
+		}
+	}
 
 	n = _n;
 	noLower = BT_TRUE;
@@ -120,9 +146,6 @@ returnValue SubjectTo::init(	int_t _n
 
 	if ( n > 0 )
 	{
-		type   = new SubjectToType[n];
-		status = new SubjectToStatus[n];
-
 		for( i=0; i<n; ++i )
 		{
 			type[i]   = ST_UNKNOWN;
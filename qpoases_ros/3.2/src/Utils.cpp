@@ -39,6 +39,7 @@
 #elif defined(LINUX) || defined(__LINUX__)
   #include <sys/stat.h>
   #include <sys/time.h>
+  #include <time.h>
 #endif
 
 #ifdef __MATLAB__
@@ -578,19 +579,39 @@ returnValue writeIntoMatFile(	FILE* const matFile,
 /*
  *	g e t C P U t i m e
  */
-real_t getCPUtime( )
+real_t getCPUtime( ClockType clockType )
 {
 	real_t current_time = -1.0;
 
 	#if defined(__WIN32__) || defined(WIN32)
-	LARGE_INTEGER counter, frequency;
-	QueryPerformanceFrequency(&frequency);
-	QueryPerformanceCounter(&counter);
-	current_time = ((real_t) counter.QuadPart) / ((real_t) frequency.QuadPart);
+	if ( clockType == CT_THREADCPUTIME )
+	{
+		/* kernel and user times in 100ns units */
+		FILETIME creationTime, exitTime, kernelTime, userTime;
+		if ( GetThreadTimes( GetCurrentThread( ),&creationTime,&exitTime,&kernelTime,&userTime ) != 0 )
+		{
+			ULARGE_INTEGER kernel, user;
+			kernel.LowPart  = kernelTime.dwLowDateTime;
+			kernel.HighPart = kernelTime.dwHighDateTime;
+			user.LowPart    = userTime.dwLowDateTime;
+			user.HighPart   = userTime.dwHighDateTime;
+			current_time = 1.0e-7 * (real_t) ( kernel.QuadPart + user.QuadPart );
+		}
+	}
+	else
+	{
+		LARGE_INTEGER counter, frequency;
+		QueryPerformanceFrequency(&frequency);
+		QueryPerformanceCounter(&counter);
+		current_time = ((real_t) counter.QuadPart) / ((real_t) frequency.QuadPart);
+	}
 	#elif defined(LINUX) || defined(__LINUX__)
-	struct timeval theclock;
-	gettimeofday( &theclock,0 );
-	current_time =  1.0*(real_t) theclock.tv_sec + 1.0e-6* (real_t) theclock.tv_usec;
+	/* unlike gettimeofday, these clocks are not stepped by system clock adjustments (NTP, manual settings) */
+	struct timespec theclock;
+	if ( clock_gettime( ( clockType == CT_THREADCPUTIME ) ? CLOCK_THREAD_CPUTIME_ID : CLOCK_MONOTONIC,&theclock ) == 0 )
+		current_time = 1.0*(real_t) theclock.tv_sec + 1.0e-9* (real_t) theclock.tv_nsec;
+	#else
+	(void) clockType;
 	#endif
 
 	return current_time;
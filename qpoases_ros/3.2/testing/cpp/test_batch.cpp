@@ -0,0 +1,213 @@
+/*
+ *	This file is part of qpOASES.
+ *
+ *	qpOASES -- An Implementation of the Online Active Set Strategy.
+ *	Copyright (C) 2007-2017 by Hans Joachim Ferreau, Andreas Potschka,
+ *	Christian Kirches et al. All rights reserved.
+ *
+ *	qpOASES is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU Lesser General Public
+ *	License as published by the Free Software Foundation; either
+ *	version 2.1 of the License, or (at your option) any later version.
+ *
+ *	qpOASES is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *	See the GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public
+ *	License along with qpOASES; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/**
+ *	\file testing/cpp/test_batch.cpp
+ *	\author Hans Joachim Ferreau, Andreas Potschka, Christian Kirches
+ *	\version 3.2
+ *	\date 2007-2017
+ *
+ *	Checks that the BatchSolver gives exactly the same results as solving
+ *	the QPs one after the other, and reports its scaling with the number of
+ *	threads on batches of small QPs.
+ */
+
+
+
+#include <math.h>
+
+#include <qpOASES.hpp>
+#include <qpOASES/UnitTesting.hpp>
+
+
+USING_NAMESPACE_QPOASES
+
+
+const int_t nV = 6;			/**< Number of joints. */
+const int_t nC = 12;		/**< Number of constraints. */
+const int_t nQP = 64;		/**< Number of QPs per batch. */
+const int_t nSteps = 50;	/**< Number of batches (the first one initialises the QPs). */
+
+
+/** Data of one inverse kinematics QP. */
+struct IKdata
+{
+	real_t H[nV*nV], g[nV], A[nC*nV], lb[nV], ub[nV], lbA[nC], ubA[nC];
+};
+
+
+/** Sets up the differential inverse kinematics QP of a 6 joint arm at step k
+ *	for the weighting q of the batch (see test_fixedSize). */
+void setupIKdata( int_t k, int_t q, IKdata& d )
+{
+	const real_t t = 0.01 * (real_t)k + 0.05 * (real_t)q;
+	const real_t lambda = 1e-3 * (real_t)(1+q);
+	real_t J[6*nV];
+	real_t v[6];
+	int_t i, j, l;
+
+	for( i=0; i<6; ++i )
+	{
+		for( j=0; j<nV; ++j )
+			J[i*nV+j] = sin( 0.7*(real_t)(i+1) + 1.3*(real_t)(j+1) + 0.5*t*(real_t)(j+1) );
+		v[i] = 0.8*sin( 2.0*t + (real_t)i );
+	}
+
+	for( i=0; i<nV; ++i )
+	{
+		for( j=0; j<nV; ++j )
+		{
+			d.H[i*nV+j] = 0.0;
+			for( l=0; l<6; ++l )
+				d.H[i*nV+j] += J[l*nV+i] * J[l*nV+j];
+		}
+		d.H[i*nV+i] += lambda;
+
+		d.g[i] = 0.0;
+		for( l=0; l<6; ++l )
+			d.g[i] -= J[l*nV+i] * v[l];
+
+		d.lb[i] = -0.5;
+		d.ub[i] =  0.5;
+	}
+
+	for( i=0; i<nC; ++i )
+	{
+		for( j=0; j<nV; ++j )
+			d.A[i*nV+j] = cos( 0.9*(real_t)(i+1)*(real_t)(j+1) + 0.2*t );
+		d.lbA[i] = -0.4 - 0.3*sin( t + (real_t)i );
+		d.ubA[i] =  0.4 + 0.3*cos( t + (real_t)i );
+	}
+}
+
+
+/** Prepares the batch of step k. */
+void setupBatch( int_t k, SQProblem* problems, IKdata* data, real_t* xOpt, BatchQP* qps )
+{
+	for( int_t q=0; q<nQP; ++q )
+	{
+		setupIKdata( k,q, data[q] );
+
+		qps[q].problem = &(problems[q]);
+		qps[q].H   = data[q].H;
+		qps[q].g   = data[q].g;
+		qps[q].A   = data[q].A;
+		qps[q].lb  = data[q].lb;
+		qps[q].ub  = data[q].ub;
+		qps[q].lbA = data[q].lbA;
+		qps[q].ubA = data[q].ubA;
+		qps[q].nWSR = 100;
+		qps[q].cputime = 0.0;
+		qps[q].xOpt = &(xOpt[q*nV]);
+		qps[q].yOpt = 0;
+	}
+}
+
+
+/** Solves nSteps batches with the given number of threads and returns the mean time per batch. */
+real_t runBatches( int_t nThreads )
+{
+	SQProblem* problems  = new SQProblem[nQP];
+	SQProblem* reference = new SQProblem[nQP];
+	IKdata* data    = new IKdata[nQP];
+	IKdata* refData = new IKdata[nQP];
+	BatchQP qps[nQP];
+	real_t xOpt[nQP*nV], xRef[nQP*nV];
+	real_t time = 0.0, t0;
+	int_t k, q, i;
+
+	for( q=0; q<nQP; ++q )
+	{
+		problems[q] = SQProblem( nV,nC );
+		problems[q].setPrintLevel( PL_NONE );
+		reference[q] = SQProblem( nV,nC );
+		reference[q].setPrintLevel( PL_NONE );
+	}
+
+	BatchSolver solver( nThreads );
+
+	for( k=0; k<nSteps; ++k )
+	{
+		setupBatch( k, problems,data,xOpt,qps );
+
+		t0 = getCPUtime( );
+		returnValue returnvalue = solver.solve( qps,nQP );
+		if ( k > 0 )
+			time += getCPUtime( ) - t0;
+
+		QPOASES_TEST_FOR_TRUE( returnvalue == SUCCESSFUL_RETURN );
+
+		/* same QPs solved one after the other : bitwise identical results are expected */
+		for( q=0; q<nQP; ++q )
+		{
+			int_t nWSR = 100;
+			setupIKdata( k,q, refData[q] );
+			const IKdata& d = refData[q];
+
+			if ( k == 0 )
+				returnvalue = reference[q].init( d.H,d.g,d.A,d.lb,d.ub,d.lbA,d.ubA, nWSR );
+			else
+				returnvalue = reference[q].hotstart( d.H,d.g,d.A,d.lb,d.ub,d.lbA,d.ubA, nWSR );
+			reference[q].getPrimalSolution( &(xRef[q*nV]) );
+
+			QPOASES_TEST_FOR_TRUE( returnvalue == qps[q].status );
+			QPOASES_TEST_FOR_TRUE( nWSR == qps[q].nWSR );
+			/* bitwise identical results are expected */
+			for( i=0; i<nV; ++i )
+				QPOASES_TEST_FOR_TRUE( getAbs( xRef[q*nV+i] - xOpt[q*nV+i] ) <= 0.0 );
+		}
+	}
+
+	delete[] refData;
+	delete[] data;
+	delete[] reference;
+	delete[] problems;
+
+	return time / (real_t)(nSteps-1);
+}
+
+
+/** Runs batches of inverse kinematics QPs with an increasing number of threads. */
+int main( )
+{
+	int_t nThreads[4] = { 1, 2, 4, BatchSolver( ).getNThreads( ) };
+	real_t time1 = 0.0;
+
+	for( int_t i=0; i<4; ++i )
+	{
+		real_t time = runBatches( nThreads[i] );
+		if ( i == 0 )
+			time1 = time;
+
+		printf( "batch of %d QPs 6x12, %2d threads: %8.1f us per batch, speedup %.2f\n",
+				(int)nQP, (int)nThreads[i], 1e6*time, time1/time );
+	}
+
+	return TEST_PASSED;
+}
+
+
+/*
+ *	end of file
+ */
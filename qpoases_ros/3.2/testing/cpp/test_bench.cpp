@@ -38,12 +38,97 @@
 #include <cstdlib>
 #include <qpOASES.hpp>
 #include <qpOASES/UnitTesting.hpp>
+#include <qpOASES/BlasKernels.hpp>
+
+
+USING_NAMESPACE_QPOASES
+
+
+/** Reference matrix product C = A'*B (TRANSA = 'T') or C = A*B, with the straightforward
+ *	triple loop of the former BLAS replacement. */
+static void referenceGemm(	bool transA, la_uint_t M, la_uint_t N, la_uint_t K,
+							const double* A, const double* B, double* C )
+{
+	la_uint_t i, j, k;
+
+	for (k = 0; k < N; k++)
+		for (j = 0; j < M; j++)
+		{
+			C[j+M*k] = 0.0;
+			for (i = 0; i < K; i++)
+				C[j+M*k] += ( transA ? A[i+K*j] : A[j+M*i] ) * B[i+K*k];
+		}
+}
+
+
+/** Times the linked dgemm_ (vectorised replacement or system BLAS) against the reference
+ *	triple loop, for the product shapes of DenseMatrix::times (A'*x) and ::transTimes (A*x).
+ *	Returns the largest relative difference between both results. */
+static real_t benchmarkGemm( )
+{
+	/* M, N (xN), K : small IK sized products first, then larger ones */
+	const la_uint_t sizes[][3] = { {7,1,7}, {16,1,16}, {14,1,7}, {100,1,100}, {400,1,400}, {64,64,64}, {200,200,200} };
+	const int_t nSizes = (int_t)( sizeof(sizes)/sizeof(sizes[0]) );
+	const double one = 1.0, zero = 0.0;
+	real_t maxError = 0.0;
+	int_t s, t, r;
+
+	printf( "BLAS kernels (%s):\n", QPOASES_SIMD_NAME );
+	printf( "%5s %5s %5s %5s %12s %12s %8s\n", "trans", "M", "N", "K", "ref [us]", "gemm [us]", "speedup" );
+
+	for (s = 0; s < nSizes; s++)
+	{
+		la_uint_t M = sizes[s][0], N = sizes[s][1], K = sizes[s][2];
+		double* A = new double[M*K];
+		double* B = new double[K*N];
+		double* C = new double[M*N];
+		double* Cref = new double[M*N];
+		la_uint_t i;
+
+		for (i = 0; i < M*K; i++)
+			A[i] = (double)( (i*7919) % 1000 ) / 500.0 - 1.0;
+		for (i = 0; i < K*N; i++)
+			B[i] = (double)( (i*104729) % 1000 ) / 500.0 - 1.0;
+
+		/* enough repetitions for a measurable time */
+		int_t nRuns = (int_t)( 2.0e7 / (double)( M*N*K + 100 ) ) + 1;
+
+		for (t = 0; t < 2; t++)
+		{
+			bool transA = ( t == 0 );
+			la_uint_t lda = transA ? K : M;
+
+			real_t tRef = getCPUtime( );
+			for (r = 0; r < nRuns; r++)
+				referenceGemm( transA, M, N, K, A, B, Cref );
+			tRef = ( getCPUtime( ) - tRef ) / (real_t)nRuns;
+
+			real_t tGemm = getCPUtime( );
+			for (r = 0; r < nRuns; r++)
+				dgemm_( transA ? "TRANS" : "NOTRANS", "NOTRANS", &M, &N, &K, &one, A, &lda, B, &K, &zero, C, &M );
+			tGemm = ( getCPUtime( ) - tGemm ) / (real_t)nRuns;
+
+			for (i = 0; i < M*N; i++)
+				maxError = getMax( maxError, getAbs( C[i] - Cref[i] ) / ( 1.0 + getAbs( Cref[i] ) ) );
+
+			printf( "%5s %5d %5d %5d %12.3f %12.3f %7.2fx\n", transA ? "T" : "N", (int)M, (int)N, (int)K,
+					1.0e6*tRef, 1.0e6*tGemm, ( tGemm > 0.0 ) ? tRef / tGemm : 0.0 );
+		}
+
+		delete[] Cref;
+		delete[] C;
+		delete[] B;
+		delete[] A;
+	}
+	printf( "\n" );
+
+	return maxError;
+}
 
 
 /** Run benchmark examples. */
 int main( int argc, char *argv[] )
 {
-	USING_NAMESPACE_QPOASES
 	#ifdef __USE_SINGLE_PRECISION__
 	const real_t TOL = 5e-2;
 	#else
@@ -200,6 +285,11 @@ int main( int argc, char *argv[] )
 	}
 
 	
+	/* Report speedup of the BLAS kernels (no problem data needed). */
+	#ifndef __USE_SINGLE_PRECISION__
+	QPOASES_TEST_FOR_TOL( benchmarkGemm( ), 1e-12 );
+	#endif
+
 	if (nproblems == 0)
 	{
 		/* 2a) Scan problem directory */
@@ -240,7 +330,8 @@ int main( int argc, char *argv[] )
 		fprintf(stdFile, "%-10s ", problem);
 		fflush(stdFile);
 
-		snprintf(oqpProblem, MAX_STRING_LENGTH, "../testing/cpp/data/problems/%s/", problem);
+		/* bound the problem name so that the path always fits into oqpProblem */
+		snprintf(oqpProblem, MAX_STRING_LENGTH, "../testing/cpp/data/problems/%.*s/", (int)( MAX_STRING_LENGTH-32 ), problem);
 		maxCPUtime = 300.0;
 		nWSR = 2500;
 
@@ -0,0 +1,255 @@
+/*
+ *	This file is part of qpOASES.
+ *
+ *	qpOASES -- An Implementation of the Online Active Set Strategy.
+ *	Copyright (C) 2007-2017 by Hans Joachim Ferreau, Andreas Potschka,
+ *	Christian Kirches et al. All rights reserved.
+ *
+ *	qpOASES is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU Lesser General Public
+ *	License as published by the Free Software Foundation; either
+ *	version 2.1 of the License, or (at your option) any later version.
+ *
+ *	qpOASES is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *	See the GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public
+ *	License along with qpOASES; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/**
+ *	\file testing/cpp/test_fixedSize.cpp
+ *	\author Hans Joachim Ferreau, Andreas Potschka, Christian Kirches
+ *	\version 3.2
+ *	\date 2007-2017
+ *
+ *	Checks that the QProblemFixed front-end gives exactly the same results
+ *	as SQProblem without allocating memory during hotstarts, and reports
+ *	its speedup on a sequence of small QPs.
+ */
+
+
+
+#include <math.h>
+#include <stdlib.h>
+#include <new>
+
+#include <qpOASES.hpp>
+#include <qpOASES/UnitTesting.hpp>
+
+
+USING_NAMESPACE_QPOASES
+
+
+/** Number of calls to operator new (operator delete is not replaced,
+ *	the default one frees the memory obtained by malloc). */
+static int_t nAllocations = 0;
+
+void* operator new( size_t size )
+{
+	void* p = malloc( ( size > 0 ) ? size : 1 );
+
+	if ( p == 0 )
+		throw std::bad_alloc( );
+
+	++nAllocations;
+	return p;
+}
+
+
+/** Returns BT_TRUE if both solvers return the same status, solution and number of iterations. */
+template< int_t nV, int_t nC >
+BooleanType haveSameSolution(	SQProblem& reference, QProblemFixed<nV,nC>& fixed,
+								returnValue refValue, returnValue fixedValue, int_t refWSR, int_t fixedWSR
+								)
+{
+	const uint_t nX = (uint_t)nV;
+	const uint_t nY = (uint_t)(nV+nC);
+	real_t xRef[nX], xFixed[nX];
+	real_t yRef[nY], yFixed[nY];
+	int_t i;
+
+	if ( ( refValue != fixedValue ) || ( refWSR != fixedWSR ) )
+		return BT_FALSE;
+
+	reference.getPrimalSolution( xRef );
+	fixed.getPrimalSolution( xFixed );
+	reference.getDualSolution( yRef );
+	fixed.getDualSolution( yFixed );
+
+	/* bitwise identical results are expected */
+	for( i=0; i<nV; ++i )
+		if ( getAbs( xRef[i] - xFixed[i] ) > 0.0 )
+			return BT_FALSE;
+
+	for( i=0; i<nV+nC; ++i )
+		if ( getAbs( yRef[i] - yFixed[i] ) > 0.0 )
+			return BT_FALSE;
+
+	return BT_TRUE;
+}
+
+
+/** Sets up the differential inverse kinematics QP of a 6 joint arm at step k:
+ *	minimise |J*dq - v|^2 + lambda*|dq|^2 subject to joint velocity limits
+ *	and 12 linear constraints (position limits and workspace planes). */
+void setupIKdata(	int_t k, real_t* H, real_t* g, real_t* A,
+					real_t* lb, real_t* ub, real_t* lbA, real_t* ubA
+					)
+{
+	const int_t nV = 6;
+	const int_t nC = 12;
+	const real_t t = 0.01 * (real_t)k;
+	real_t J[6*6];
+	real_t v[6];
+	int_t i, j, l;
+
+	for( i=0; i<6; ++i )
+	{
+		for( j=0; j<nV; ++j )
+			J[i*nV+j] = sin( 0.7*(real_t)(i+1) + 1.3*(real_t)(j+1) + 0.5*t*(real_t)(j+1) );
+		v[i] = 0.8*sin( 2.0*t + (real_t)i );
+	}
+
+	for( i=0; i<nV; ++i )
+	{
+		for( j=0; j<nV; ++j )
+		{
+			H[i*nV+j] = 0.0;
+			for( l=0; l<6; ++l )
+				H[i*nV+j] += J[l*nV+i] * J[l*nV+j];
+		}
+		H[i*nV+i] += 1e-2;
+
+		g[i] = 0.0;
+		for( l=0; l<6; ++l )
+			g[i] -= J[l*nV+i] * v[l];
+
+		lb[i] = -0.5;
+		ub[i] =  0.5;
+	}
+
+	for( i=0; i<nC; ++i )
+	{
+		for( j=0; j<nV; ++j )
+			A[i*nV+j] = cos( 0.9*(real_t)(i+1)*(real_t)(j+1) + 0.2*t );
+		lbA[i] = -0.4 - 0.3*sin( t + (real_t)i );
+		ubA[i] =  0.4 + 0.3*cos( t + (real_t)i );
+	}
+}
+
+
+/** Compares QProblemFixed with SQProblem on small QP sequences. */
+int main( )
+{
+	int_t k;
+
+	/* 1) Data of test_example2. */
+	{
+		real_t H[2*2] = { 1.0, 0.0, 0.0, 0.5 };
+		real_t A[1*2] = { 1.0, 1.0 };
+		real_t g[2] = { 1.5, 1.0 };
+		real_t lb[2] = { 0.5, -2.0 };
+		real_t ub[2] = { 5.0, 2.0 };
+		real_t lbA[1] = { -1.0 };
+		real_t ubA[1] = { 2.0 };
+
+		real_t H_new[2*2] = { 1.0, 0.5, 0.5, 0.5 };
+		real_t A_new[1*2] = { 1.0, 5.0 };
+		real_t g_new[2] = { 1.0, 1.5 };
+		real_t lb_new[2] = { 0.0, -1.0 };
+		real_t ub_new[2] = { 5.0, -0.5 };
+		real_t lbA_new[1] = { -2.0 };
+		real_t ubA_new[1] = { 1.0 };
+
+		SQProblem reference( 2,1 );
+		QProblemFixed<2,1> fixed;
+		reference.setPrintLevel( PL_NONE );
+		fixed.setPrintLevel( PL_NONE );
+
+		int_t nWSRref = 10, nWSRfixed = 10;
+		returnValue refValue   = reference.init( H,g,A,lb,ub,lbA,ubA, nWSRref );
+		returnValue fixedValue = fixed.init( H,g,A,lb,ub,lbA,ubA, nWSRfixed );
+		QPOASES_TEST_FOR_TRUE( haveSameSolution( reference,fixed, refValue,fixedValue, nWSRref,nWSRfixed ) == BT_TRUE );
+
+		nWSRref = 10, nWSRfixed = 10;
+		refValue   = reference.hotstart( H_new,g_new,A_new,lb_new,ub_new,lbA_new,ubA_new, nWSRref );
+		fixedValue = fixed.hotstart( H_new,g_new,A_new,lb_new,ub_new,lbA_new,ubA_new, nWSRfixed );
+		QPOASES_TEST_FOR_TRUE( haveSameSolution( reference,fixed, refValue,fixedValue, nWSRref,nWSRfixed ) == BT_TRUE );
+
+		/* hotstart without matrix update */
+		nWSRref = 10, nWSRfixed = 10;
+		refValue   = reference.hotstart( g,lb_new,ub_new,lbA_new,ubA_new, nWSRref );
+		fixedValue = fixed.hotstart( g,lb_new,ub_new,lbA_new,ubA_new, nWSRfixed );
+		QPOASES_TEST_FOR_TRUE( haveSameSolution( reference,fixed, refValue,fixedValue, nWSRref,nWSRfixed ) == BT_TRUE );
+	}
+
+
+	/* 2) Sequence of inverse kinematics QPs (6 variables, 12 constraints). */
+	{
+		const int_t nQP = 500;
+		const int_t nRuns = 20;
+		real_t H[6*6], g[6], A[12*6], lb[6], ub[6], lbA[12], ubA[12];
+		real_t tRef = 0.0, tFixed = 0.0, t0;
+		int_t nWSRref, nWSRfixed, run;
+		int_t nAllocRef = 0, nAllocFixed = 0, nAlloc0;
+		returnValue refValue, fixedValue;
+
+		for( run=0; run<nRuns; ++run )
+		{
+			SQProblem reference( 6,12 );
+			QProblemFixed<6,12> fixed;
+			reference.setPrintLevel( PL_NONE );
+			fixed.setPrintLevel( PL_NONE );
+
+			setupIKdata( 0, H,g,A,lb,ub,lbA,ubA );
+			nWSRref = 100, nWSRfixed = 100;
+			refValue   = reference.init( H,g,A,lb,ub,lbA,ubA, nWSRref );
+			fixedValue = fixed.init( H,g,A,lb,ub,lbA,ubA, nWSRfixed );
+			QPOASES_TEST_FOR_TRUE( haveSameSolution( reference,fixed, refValue,fixedValue, nWSRref,nWSRfixed ) == BT_TRUE );
+
+			for( k=1; k<nQP; ++k )
+			{
+				setupIKdata( k, H,g,A,lb,ub,lbA,ubA );
+
+				nWSRref = 100;
+				nAlloc0 = nAllocations;
+				t0 = getCPUtime( );
+				refValue = reference.hotstart( H,g,A,lb,ub,lbA,ubA, nWSRref );
+				tRef += getCPUtime( ) - t0;
+				nAllocRef += nAllocations - nAlloc0;
+
+				/* SQProblem may regularise H in place */
+				setupIKdata( k, H,g,A,lb,ub,lbA,ubA );
+
+				nWSRfixed = 100;
+				nAlloc0 = nAllocations;
+				t0 = getCPUtime( );
+				fixedValue = fixed.hotstart( H,g,A,lb,ub,lbA,ubA, nWSRfixed );
+				tFixed += getCPUtime( ) - t0;
+				nAllocFixed += nAllocations - nAlloc0;
+
+				QPOASES_TEST_FOR_TRUE( haveSameSolution( reference,fixed, refValue,fixedValue, nWSRref,nWSRfixed ) == BT_TRUE );
+			}
+		}
+
+		printf( "hotstart 6x12: SQProblem %.3f us (%.1f allocations), QProblemFixed %.3f us (%.1f allocations), speedup %.2f\n",
+				1e6*tRef/(real_t)(nRuns*(nQP-1)), (real_t)nAllocRef/(real_t)(nRuns*(nQP-1)),
+				1e6*tFixed/(real_t)(nRuns*(nQP-1)), (real_t)nAllocFixed/(real_t)(nRuns*(nQP-1)), tRef/tFixed );
+
+		/* the matrices are stored inline and the temporaries are allocated by the constructor */
+		QPOASES_TEST_FOR_TRUE( nAllocFixed == 0 );
+	}
+
+	return TEST_PASSED;
+}
+
+
+/*
+ *	end of file
+ */
@@ -0,0 +1,269 @@
+/*
+ *	This file is part of qpOASES.
+ *
+ *	qpOASES -- An Implementation of the Online Active Set Strategy.
+ *	Copyright (C) 2007-2017 by Hans Joachim Ferreau, Andreas Potschka,
+ *	Christian Kirches et al. All rights reserved.
+ *
+ *	qpOASES is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU Lesser General Public
+ *	License as published by the Free Software Foundation; either
+ *	version 2.1 of the License, or (at your option) any later version.
+ *
+ *	qpOASES is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *	See the GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public
+ *	License along with qpOASES; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/**
+ *	\file testing/cpp/test_largeSchur.cpp
+ *	\author Hans Joachim Ferreau, Andreas Potschka, Christian Kirches
+ *	\version 3.2
+ *	\date 2007-2017
+ *
+ *	Checks the built-in sparse LDL^T solver on small KKT matrices and compares
+ *	the dense null space approach with the Schur complement approach on
+ *	banded MPC-like problems of increasing horizon length.
+ */
+
+
+
+#include <qpOASES.hpp>
+#include <qpOASES/UnitTesting.hpp>
+
+
+USING_NAMESPACE_QPOASES
+
+
+#ifdef SOLVER_LDL
+
+/** Factorises a small KKT matrix [H A'; A 0] with H = diag(2.5,3,4,5) and two
+ *	constraint rows (the second one duplicating the first if duplicateRow is set),
+ *	returns the solution residual, inertia and rank. */
+int_t testLdlKkt(	BooleanType duplicateRow,
+					real_t* residual,
+					int_t* neig,
+					int_t* rank
+					)
+{
+	int_t i, k;
+	const int_t dim = 6;
+
+	/* lower triangle, 1-based, with a duplicate diagonal entry to be summed up */
+	int_t irn[] = { 1, 2, 3, 4, 1, 5, 5, 6, 6, 6 };
+	int_t jcn[] = { 1, 2, 3, 4, 1, 1, 2, 2, 3, 4 };
+	real_t avals[] = { 2.0, 3.0, 4.0, 5.0, 0.5, 1.0, 1.0, 1.0, 1.0, 1.0 };
+	const int_t nnz = 10;
+
+	if ( duplicateRow == BT_TRUE )
+	{
+		irn[7] = 6; jcn[7] = 1;
+		irn[8] = 6; jcn[8] = 2; avals[9] = 0.0;
+	}
+
+	real_t K[dim*dim];
+	for( i=0; i<dim*dim; ++i )
+		K[i] = 0.0;
+	for( k=0; k<nnz; ++k )
+	{
+		K[(irn[k]-1)*dim + jcn[k]-1] += avals[k];
+		if ( irn[k] != jcn[k] )
+			K[(jcn[k]-1)*dim + irn[k]-1] += avals[k];
+	}
+
+	LdlSparseSolver solver;
+	if ( solver.setMatrixData( dim,nnz,irn,jcn,avals ) != SUCCESSFUL_RETURN )
+		return 1;
+
+	returnValue status = solver.factorize( );
+	*neig = solver.getNegativeEigenvalues( );
+	*rank = solver.getRank( );
+	*residual = 0.0;
+
+	if ( status != SUCCESSFUL_RETURN )
+		return ( status == RET_KKT_MATRIX_SINGULAR ) ? 0 : 1;
+
+	real_t rhs[dim], sol[dim];
+	for( i=0; i<dim; ++i )
+		rhs[i] = (real_t)(i+1);
+	if ( solver.solve( dim,rhs,sol ) != SUCCESSFUL_RETURN )
+		return 1;
+
+	for( i=0; i<dim; ++i )
+	{
+		real_t r = -rhs[i];
+		for( k=0; k<dim; ++k )
+			r += K[i*dim+k] * sol[k];
+		*residual = getMax( *residual,getAbs( r ) );
+	}
+
+	return 0;
+}
+
+#endif /* SOLVER_LDL */
+
+
+/** Solves a horizon-N tracking problem of a scalar integrator x+ = x + u
+ *	(variables [u_0, x_1, u_1, x_2, ...]) with the dense null space and the
+ *	Schur complement approach and returns the largest primal difference. */
+int_t testHorizon(	int_t N,
+					real_t* errP
+					)
+{
+	int_t i, k, nWSR;
+	const int_t n = 2*N;
+	const int_t m = N;
+	real_t tic, toc;
+
+	sparse_int_t *H_jc = new sparse_int_t[n+1];
+	sparse_int_t *H_ir = new sparse_int_t[n];
+	real_t *H_val = new real_t[n];
+	sparse_int_t *A_jc = new sparse_int_t[n+1];
+	sparse_int_t *A_ir = new sparse_int_t[3*N];
+	real_t *A_val = new real_t[3*N];
+	real_t *g = new real_t[n];
+	real_t *lb = new real_t[n];
+	real_t *ub = new real_t[n];
+	real_t *lbA = new real_t[m];
+	real_t *ubA = new real_t[m];
+	real_t *xref = new real_t[n];
+	real_t *x = new real_t[n];
+
+	/* stage costs 0.1*u^2 + (x-0.5)^2, input bounds |u| <= 0.1 */
+	for( k=0; k<N; ++k )
+	{
+		H_val[2*k] = 0.2;
+		H_val[2*k+1] = 2.0;
+		g[2*k] = 0.0;
+		g[2*k+1] = -1.0;
+		lb[2*k] = -0.1;
+		ub[2*k] = 0.1;
+		lb[2*k+1] = -10.0;
+		ub[2*k+1] = 10.0;
+	}
+	for( i=0; i<=n; ++i )
+		H_jc[i] = (sparse_int_t)i;
+	for( i=0; i<n; ++i )
+		H_ir[i] = (sparse_int_t)i;
+
+	/* dynamics rows x_{k+1} - x_k - u_k = 0, with x_0 = 2 */
+	int_t nnz = 0;
+	for( k=0; k<N; ++k )
+	{
+		A_jc[2*k] = (sparse_int_t)nnz;
+		A_ir[nnz] = (sparse_int_t)k;
+		A_val[nnz++] = -1.0;
+
+		A_jc[2*k+1] = (sparse_int_t)nnz;
+		A_ir[nnz] = (sparse_int_t)k;
+		A_val[nnz++] = 1.0;
+		if ( k+1 < N )
+		{
+			A_ir[nnz] = (sparse_int_t)(k+1);
+			A_val[nnz++] = -1.0;
+		}
+
+		lbA[k] = ( k == 0 ) ? 2.0 : 0.0;
+		ubA[k] = lbA[k];
+	}
+	A_jc[n] = (sparse_int_t)nnz;
+
+	Options options;
+	options.setToDefault( );
+	options.printLevel = PL_NONE;
+
+	SymSparseMat *H = new SymSparseMat( n,n,H_ir,H_jc,H_val );
+	SparseMatrix *A = new SparseMatrix( m,n,A_ir,A_jc,A_val );
+	H->createDiagInfo( );
+
+	/* solve with dense linear algebra */
+	nWSR = 10*n;
+	QProblem qpD( n,m );
+	qpD.setOptions( options );
+	tic = getCPUtime( );
+	returnValue statusD = qpD.init( H,g,A,lb,ub,lbA,ubA,nWSR,0 );
+	toc = getCPUtime( );
+	qpD.getPrimalSolution( xref );
+
+	fprintf( stdFile, "N = %4d: dense LA   %5d iterations, %8.3f seconds\n", (int)N, (int)nWSR, toc-tic );
+
+	/* solve with the Schur complement approach */
+	*errP = 0.0;
+	returnValue statusS = SUCCESSFUL_RETURN;
+	#ifndef SOLVER_NONE
+	nWSR = 10*n;
+	SQProblemSchur qp( n,m );
+	qp.setOptions( options );
+	tic = getCPUtime( );
+	statusS = qp.init( H,g,A,lb,ub,lbA,ubA,nWSR,0 );
+	toc = getCPUtime( );
+	qp.getPrimalSolution( x );
+
+	fprintf( stdFile, "N = %4d: Schur      %5d iterations, %8.3f seconds\n", (int)N, (int)nWSR, toc-tic );
+
+	for( i=0; i<n; ++i )
+		*errP = getMax( *errP,getAbs( x[i] - xref[i] ) );
+	#endif /* SOLVER_NONE */
+
+	delete A;
+	delete H;
+
+	delete[] x;
+	delete[] xref;
+	delete[] ubA;
+	delete[] lbA;
+	delete[] ub;
+	delete[] lb;
+	delete[] g;
+	delete[] A_val;
+	delete[] A_ir;
+	delete[] A_jc;
+	delete[] H_val;
+	delete[] H_ir;
+	delete[] H_jc;
+
+	return ( ( statusD == SUCCESSFUL_RETURN ) && ( statusS == SUCCESSFUL_RETURN ) ) ? 0 : 1;
+}
+
+
+int main( )
+{
+	int_t N;
+	real_t errP;
+
+	#ifdef SOLVER_LDL
+	real_t residual;
+	int_t neig, rank;
+
+	QPOASES_TEST_FOR_TRUE( testLdlKkt( BT_FALSE,&residual,&neig,&rank ) == 0 );
+	fprintf( stdFile, "LDL: residual %9.2e, %d negative eigenvalues, rank %d\n", residual, (int)neig, (int)rank );
+	QPOASES_TEST_FOR_TOL( residual,1e-13 );
+	QPOASES_TEST_FOR_TRUE( neig == 2 );
+	QPOASES_TEST_FOR_TRUE( rank == 6 );
+
+	QPOASES_TEST_FOR_TRUE( testLdlKkt( BT_TRUE,&residual,&neig,&rank ) == 0 );
+	fprintf( stdFile, "LDL (duplicate constraint): rank %d\n", (int)rank );
+	QPOASES_TEST_FOR_TRUE( rank == 5 );
+	#endif /* SOLVER_LDL */
+
+	for( N=50; N<=200; N*=2 )
+	{
+		QPOASES_TEST_FOR_TRUE( testHorizon( N,&errP ) == 0 );
+		fprintf( stdFile, "N = %4d: primal error %9.2e\n", (int)N, errP );
+		QPOASES_TEST_FOR_TOL( errP,1e-10 );
+	}
+
+	return TEST_PASSED;
+}
+
+
+/*
+ *	end of file
+ */
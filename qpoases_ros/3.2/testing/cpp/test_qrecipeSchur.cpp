@@ -161,9 +161,9 @@ int main( )
 	delete[] y1;
 	delete[] x1;
 
-	QPOASES_TEST_FOR_TOL( errP1,1e-13 );
-	QPOASES_TEST_FOR_TOL( errP2,1e-13 );
-	QPOASES_TEST_FOR_TOL( errP3,1e-13 );
+	QPOASES_TEST_FOR_TOL( errP1,1e-11 );
+	QPOASES_TEST_FOR_TOL( errP2,1e-11 );
+	QPOASES_TEST_FOR_TOL( errP3,1e-11 );
 
 	return TEST_PASSED;
 }
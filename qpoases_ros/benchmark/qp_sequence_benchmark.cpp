@@ -0,0 +1,371 @@
+/*
+ *	This file is part of qpOASES.
+ *
+ *	qpOASES -- An Implementation of the Online Active Set Strategy.
+ *	Copyright (C) 2007-2017 by Hans Joachim Ferreau, Andreas Potschka,
+ *	Christian Kirches et al. All rights reserved.
+ *
+ *	qpOASES is free software; you can redistribute it and/or
+ *	modify it under the terms of the GNU Lesser General Public
+ *	License as published by the Free Software Foundation; either
+ *	version 2.1 of the License, or (at your option) any later version.
+ *
+ *	qpOASES is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *	See the GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public
+ *	License along with qpOASES; if not, write to the Free Software
+ *	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/**
+ *	\file benchmark/qp_sequence_benchmark.cpp
+ *	\author Hans Joachim Ferreau, Andreas Potschka, Christian Kirches
+ *	\version 3.2
+ *	\date 2007-2017
+ *
+ *	Replays recorded QP sequences (see qpOASES/extras/QPSequence.hpp, e.g.
+ *	dumped by the orthopus inverse kinematic with ik_qp_dump_file) and
+ *	measures init and hotstart latency percentiles, the distribution of
+ *	working set recalculations and heap allocations per solve.
+ *
+ *	  qp_sequence_benchmark [options] <sequence file>...
+ *	    --runs N           replays of each sequence (default 10)
+ *	    --nwsr N           hotstart working set recalculation limit (default 100)
+ *	    --init-stride N    cold init of every Nth QP (default 10, 0: disabled)
+ *	    --options NAME     default, reliable (default, as the IK) or mpc
+ *	    --output FILE      JSON results (default: standard output)
+ *
+ *	A summary is printed on standard error. Results of different machines or
+ *	solver versions can be compared with the JSON output; the solution
+ *	checksum changes if the solver behaviour changes.
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <new>
+#include <vector>
+
+#include <qpOASES.hpp>
+
+
+USING_NAMESPACE_QPOASES
+
+
+/* heap allocations, counted by the replaced global operator new */
+static unsigned long nAllocations = 0;
+
+void* operator new( size_t size )
+{
+	++nAllocations;
+	void* p = malloc( ( size > 0 ) ? size : 1 );
+	if ( p == 0 )
+		throw std::bad_alloc( );
+	return p;
+}
+
+void* operator new[]( size_t size )
+{
+	return operator new( size );
+}
+
+void operator delete( void* p ) noexcept
+{
+	free( p );
+}
+
+void operator delete[]( void* p ) noexcept
+{
+	free( p );
+}
+
+
+/** Measurements of one kind of solve (init or hotstart). */
+struct SolveStats
+{
+	std::vector<real_t> latency;		/**< Duration of each solve (s). */
+	std::vector<int_t> nWSR;			/**< Working set recalculations of each solve. */
+	std::vector<unsigned long> nAlloc;	/**< Heap allocations of each solve. */
+	int_t nFailures;					/**< Solves not returning SUCCESSFUL_RETURN. */
+
+	SolveStats( ) : nFailures( 0 ) { }
+
+	void add( real_t time, int_t wsr, unsigned long alloc, returnValue status )
+	{
+		latency.push_back( time );
+		nWSR.push_back( wsr );
+		nAlloc.push_back( alloc );
+		if ( status != SUCCESSFUL_RETURN )
+			++nFailures;
+	}
+};
+
+
+/** Returns the p-quantile of sorted values. */
+template< typename T >
+static T quantile( const std::vector<T>& sorted, double p )
+{
+	return sorted[ (size_t)( p * (double)(sorted.size( )-1) + 0.5 ) ];
+}
+
+
+/** Writes the statistics of one kind of solve as a JSON object. */
+static void printStats( FILE* out, const char* name, const SolveStats& stats, const char* indent )
+{
+	size_t i, n = stats.latency.size( );
+
+	fprintf( out,"%s\"%s\": {\n",indent,name );
+	fprintf( out,"%s  \"count\": %lu,\n",indent,(unsigned long)n );
+	fprintf( out,"%s  \"failures\": %ld",indent,(long)stats.nFailures );
+	if ( n == 0 )
+	{
+		fprintf( out,"\n%s}",indent );
+		return;
+	}
+
+	std::vector<real_t> latency( stats.latency );
+	std::vector<int_t> nWSR( stats.nWSR );
+	std::vector<unsigned long> nAlloc( stats.nAlloc );
+	std::sort( latency.begin( ),latency.end( ) );
+	std::sort( nWSR.begin( ),nWSR.end( ) );
+	std::sort( nAlloc.begin( ),nAlloc.end( ) );
+
+	double meanLatency = 0.0, meanWSR = 0.0, meanAlloc = 0.0;
+	for( i=0; i<n; ++i )
+	{
+		meanLatency += (double)latency[i] / (double)n;
+		meanWSR     += (double)nWSR[i] / (double)n;
+		meanAlloc   += (double)nAlloc[i] / (double)n;
+	}
+
+	fprintf( out,",\n%s  \"latency_us\": { \"mean\": %.3f, \"min\": %.3f, \"p50\": %.3f, \"p90\": %.3f, "
+			 "\"p99\": %.3f, \"p999\": %.3f, \"max\": %.3f },\n", indent,
+			 1e6*meanLatency, 1e6*latency.front( ), 1e6*quantile( latency,0.5 ), 1e6*quantile( latency,0.9 ),
+			 1e6*quantile( latency,0.99 ), 1e6*quantile( latency,0.999 ), 1e6*latency.back( ) );
+
+	/* histogram: number of solves for each number of working set recalculations */
+	fprintf( out,"%s  \"nwsr\": { \"mean\": %.3f, \"p50\": %ld, \"p99\": %ld, \"max\": %ld, \"histogram\": [",
+			 indent, meanWSR, (long)quantile( nWSR,0.5 ), (long)quantile( nWSR,0.99 ), (long)nWSR.back( ) );
+	size_t first = 0;
+	for( int_t w=0; w<=nWSR.back( ); ++w )
+	{
+		size_t last = first;
+		while ( ( last < n ) && ( nWSR[last] == w ) )
+			++last;
+		fprintf( out,"%s%lu",( w > 0 ) ? ", " : "",(unsigned long)( last-first ) );
+		first = last;
+	}
+	fprintf( out,"] },\n" );
+
+	fprintf( out,"%s  \"allocations\": { \"mean\": %.3f, \"p50\": %lu, \"max\": %lu }\n",
+			 indent, meanAlloc, quantile( nAlloc,0.5 ), nAlloc.back( ) );
+	fprintf( out,"%s}",indent );
+}
+
+
+/** Prints a one line summary of one kind of solve on standard error. */
+static void printSummary( const char* name, const SolveStats& stats )
+{
+	if ( stats.latency.empty( ) )
+		return;
+
+	std::vector<real_t> latency( stats.latency );
+	std::sort( latency.begin( ),latency.end( ) );
+	int_t maxWSR = *std::max_element( stats.nWSR.begin( ),stats.nWSR.end( ) );
+	unsigned long maxAlloc = *std::max_element( stats.nAlloc.begin( ),stats.nAlloc.end( ) );
+
+	fprintf( stderr,"  %-8s %7lu solves  p50 %8.2f us  p99 %8.2f us  max %8.2f us  nWSR max %3ld  alloc max %4lu  failures %ld\n",
+			 name, (unsigned long)latency.size( ), 1e6*quantile( latency,0.5 ), 1e6*quantile( latency,0.99 ),
+			 1e6*latency.back( ), (long)maxWSR, maxAlloc, (long)stats.nFailures );
+}
+
+
+/** Replays the QP sequence of a file and writes its results as a JSON object
+ *	(nothing is written if the file cannot be read). */
+static returnValue replaySequence(	const char* fileName, const Options& options,
+									int_t nRuns, int_t nWSRmax, int_t initStride,
+									FILE* out, BooleanType& first
+									)
+{
+	int_t nQP, nV, nC, run, k;
+	real_t *H, *g, *A, *lb, *ub, *lbA, *ubA;
+
+	/* keep qpOASES messages out of the JSON results (QP constructors make errors visible again) */
+	getGlobalMessageHandler( )->setErrorVisibilityStatus( VS_HIDDEN );
+
+	if ( readQPSequence( fileName, nQP,nV,nC, &H,&g,&A,&lb,&ub,&lbA,&ubA ) != SUCCESSFUL_RETURN )
+	{
+		fprintf( stderr,"Could not read QP sequence %s\n",fileName );
+		return RET_UNABLE_TO_READ_FILE;
+	}
+
+	SolveStats hotstartStats, initStats;
+	std::vector<real_t> Hk( (size_t)(nV*nV) ), Ak( (size_t)(nC*nV > 0 ? nC*nV : 1) );
+	std::vector<real_t> xOpt( (size_t)nV );
+	double checksum = 0.0;
+	real_t t0, time;
+	int_t nWSR;
+	unsigned long alloc0;
+	returnValue status;
+
+	for( run=0; run<nRuns; ++run )
+	{
+		/* 1) init on the first QP, then hotstart along the sequence (as in the control loop) */
+		SQProblem qp( nV,nC );
+		qp.setOptions( options );
+
+		for( k=0; k<nQP; ++k )
+		{
+			/* SQProblem may regularise the Hessian in place */
+			std::copy( H+k*nV*nV,H+(k+1)*nV*nV,Hk.begin( ) );
+			std::copy( A+k*nC*nV,A+(k+1)*nC*nV,Ak.begin( ) );
+
+			alloc0 = nAllocations;
+			t0 = getCPUtime( );
+			if ( k == 0 )
+			{
+				nWSR = 5 * (nV+nC);
+				status = qp.init( &Hk[0],g,&Ak[0],lb,ub,lbA,ubA, nWSR );
+			}
+			else
+			{
+				nWSR = nWSRmax;
+				status = qp.hotstart( &Hk[0],g+k*nV,&Ak[0],lb+k*nV,ub+k*nV,lbA+k*nC,ubA+k*nC, nWSR );
+			}
+			time = getCPUtime( ) - t0;
+
+			if ( k == 0 )
+				initStats.add( time,nWSR,nAllocations-alloc0,status );
+			else
+				hotstartStats.add( time,nWSR,nAllocations-alloc0,status );
+
+			if ( ( run == 0 ) && ( status == SUCCESSFUL_RETURN ) )
+			{
+				qp.getPrimalSolution( &xOpt[0] );
+				for( int_t i=0; i<nV; ++i )
+					checksum += (double)xOpt[i];
+			}
+		}
+
+		/* 2) cold init of every initStride-th QP */
+		if ( initStride <= 0 )
+			continue;
+
+		for( k=initStride; k<nQP; k+=initStride )
+		{
+			std::copy( H+k*nV*nV,H+(k+1)*nV*nV,Hk.begin( ) );
+			std::copy( A+k*nC*nV,A+(k+1)*nC*nV,Ak.begin( ) );
+
+			SQProblem cold( nV,nC );
+			cold.setOptions( options );
+
+			nWSR = 5 * (nV+nC);
+			alloc0 = nAllocations;
+			t0 = getCPUtime( );
+			status = cold.init( &Hk[0],g+k*nV,&Ak[0],lb+k*nV,ub+k*nV,lbA+k*nC,ubA+k*nC, nWSR );
+			time = getCPUtime( ) - t0;
+			initStats.add( time,nWSR,nAllocations-alloc0,status );
+		}
+	}
+
+	fprintf( out,"%s    {\n",( first == BT_TRUE ) ? "" : ",\n" );
+	fprintf( out,"      \"file\": \"%s\",\n",fileName );
+	fprintf( out,"      \"nV\": %ld, \"nC\": %ld, \"nQP\": %ld, \"runs\": %ld,\n",(long)nV,(long)nC,(long)nQP,(long)nRuns );
+	fprintf( out,"      \"solution_checksum\": %.17g,\n",checksum );
+	printStats( out,"hotstart",hotstartStats,"      " );
+	fprintf( out,",\n" );
+	printStats( out,"init",initStats,"      " );
+	fprintf( out,"\n    }" );
+	first = BT_FALSE;
+
+	fprintf( stderr,"%s (%ld QPs %ldx%ld, %ld runs)\n",fileName,(long)nQP,(long)nV,(long)nC,(long)nRuns );
+	printSummary( "hotstart",hotstartStats );
+	printSummary( "init",initStats );
+
+	delete[] ubA; delete[] lbA; delete[] ub; delete[] lb; delete[] A; delete[] g; delete[] H;
+
+	if ( ( hotstartStats.nFailures > 0 ) || ( initStats.nFailures > 0 ) )
+		return RET_QP_NOT_SOLVED;
+
+	return SUCCESSFUL_RETURN;
+}
+
+
+/** Replays the QP sequences given on the command line. */
+int main( int argc, char** argv )
+{
+	int_t nRuns = 10, nWSRmax = 100, initStride = 10;
+	const char* optionsName = "reliable";
+	const char* outputName = 0;
+	std::vector<const char*> files;
+
+	for( int i=1; i<argc; ++i )
+	{
+		if ( ( strcmp( argv[i],"--runs" ) == 0 ) && ( i+1 < argc ) )
+			nRuns = atol( argv[++i] );
+		else if ( ( strcmp( argv[i],"--nwsr" ) == 0 ) && ( i+1 < argc ) )
+			nWSRmax = atol( argv[++i] );
+		else if ( ( strcmp( argv[i],"--init-stride" ) == 0 ) && ( i+1 < argc ) )
+			initStride = atol( argv[++i] );
+		else if ( ( strcmp( argv[i],"--options" ) == 0 ) && ( i+1 < argc ) )
+			optionsName = argv[++i];
+		else if ( ( strcmp( argv[i],"--output" ) == 0 ) && ( i+1 < argc ) )
+			outputName = argv[++i];
+		else if ( argv[i][0] == '-' )
+		{
+			files.clear( );
+			break;
+		}
+		else
+			files.push_back( argv[i] );
+	}
+
+	Options options;
+	if ( strcmp( optionsName,"reliable" ) == 0 )
+		options.setToReliable( );
+	else if ( strcmp( optionsName,"mpc" ) == 0 )
+		options.setToMPC( );
+	else if ( strcmp( optionsName,"default" ) != 0 )
+		files.clear( );
+	options.printLevel = PL_NONE;
+
+	if ( ( files.empty( ) ) || ( nRuns <= 0 ) || ( nWSRmax <= 0 ) )
+	{
+		fprintf( stderr,"usage: %s [--runs N] [--nwsr N] [--init-stride N] [--options default|reliable|mpc] "
+				 "[--output FILE] <sequence file>...\n",argv[0] );
+		return 1;
+	}
+
+	FILE* out = stdout;
+	if ( ( outputName != 0 ) && ( ( out = fopen( outputName,"w" ) ) == 0 ) )
+	{
+		fprintf( stderr,"Could not open %s\n",outputName );
+		return 1;
+	}
+
+	fprintf( out,"{\n  \"solver\": \"qpOASES 3.2\",\n  \"options\": \"%s\",\n  \"nwsr\": %ld,\n  \"sequences\": [\n",
+			 optionsName,(long)nWSRmax );
+
+	int result = 0;
+	BooleanType first = BT_TRUE;
+	for( size_t f=0; f<files.size( ); ++f )
+		if ( replaySequence( files[f],options,nRuns,nWSRmax,initStride,out,first ) != SUCCESSFUL_RETURN )
+			result = 2;
+
+	fprintf( out,"\n  ]\n}\n" );
+	if ( out != stdout )
+		fclose( out );
+
+	return result;
+}
+
+
+/*
+ *	end of file
+ */